@@ -6,12 +6,23 @@ layout(set = 0, binding = 0) uniform UBO {
 } ubo;
 
 layout(set=1, binding=2, std430) readonly buffer Positions { vec4 X[]; };
-layout(set=1, binding=3, std430) readonly buffer Indices   { uint I[]; }; // ← 새로 추가
+layout(set=1, binding=3, std430) readonly buffer Previous  { vec4 Xprev[]; }; // frame #version 450
+
+layout(set = 0, binding = 0) uniform UBO {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+layout(set=1, binding=2, std430) readonly buffer Positions { vec4 X[]; };
+layout(set=1, binding=3, std430) readonly buffer Previous  { vec4 Xprev[]; }; // frame 의 마지막 step 직전 position
+
+// 0 = previous, 1 = position (SimScheduler::Alpha)
+layout(push_constant) uniform Push { float alpha; } pc;
 
 void main() {
 
     uint vid = gl_VertexIndex;
-    vec3 p = X[vid].xyz;
+    vec3 p = mix(Xprev[vid].xyz, X[vid].xyz, pc.alpha);
 
     gl_Position = ubo.proj * ubo.view * vec4(p, 1.0);
 }
\ No newline at end of file
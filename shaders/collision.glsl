@@ -0,0 +1,54 @@
+// 천 충돌 공용 : Collider buffer / SDF buffer 와 거리 함수 (collider_set.cpp 의 ColliderDistance 와 같은 계산).
+// particle_layout.h 다음에 include 한다.
+
+struct Collider {
+    vec4 sphere;        // world space bounding sphere (xyz = 중심, w = 반지름)
+    vec4 velocity;      // xyz = 평균 속도, w = local 거리 -> world 거리 scale
+    mat4 worldToLocal;
+    vec4 sdfOrigin;     // xyz = local 격자 원점, w = 격자 간격
+    uvec4 sdf;          // x = SDF 배열 안의 시작, yzw = 축마다 격자점 수 (0 이면 sphere)
+};
+
+layout(set = 1, binding = CLOTH_BINDING_COLLIDERS, std430) readonly buffer Colliders { Collider colliders[]; };
+layout(set = 1, binding = CLOTH_BINDING_SDF,       std430) readonly buffer SdfValues { float sdfValues[]; };
+
+float SampleSdf(uint base, uvec3 res, vec3 g){
+    uvec3 i0 = min(uvec3(g), res - 2u);
+    vec3 f = g - vec3(i0);
+    uint row = res.x;
+    uint slice = res.x * res.y;
+    uint i = base + i0.z * slice + i0.y * row + i0.x;
+    float c00 = mix(sdfValues[i],                 sdfValues[i + 1u],                 f.x);
+    float c10 = mix(sdfValues[i + row],           sdfValues[i + row + 1u],           f.x);
+    float c01 = mix(sdfValues[i + slice],         sdfValues[i + slice + 1u],         f.x);
+    float c11 = mix(sdfValues[i + slice + row],   sdfValues[i + slice + row + 1u],   f.x);
+    return mix(mix(c00, c10, f.y), mix(c01, c11, f.y), f.z);
+}
+
+// p 에서 표면까지의 거리 (안쪽이 음수) 와 바깥 방향 normal. bounding sphere 밖이면 sphere 거리 (실제 거리 이하)
+float ColliderDistance(Collider c, vec3 p, out vec3 n){
+    vec3 fromCenter = p - c.sphere.xyz;
+    float centerDistance = length(fromCenter);
+    n = centerDistance > 1e-6 ? fromCenter / centerDistance : vec3(0.0, 1.0, 0.0);
+    float sphereDistance = centerDistance - c.sphere.w;
+
+    uvec3 res = c.sdf.yzw;
+    // 격자 간격은 local 이므로 instance scale 을 곱해 world 거리로 비교
+    if (res.x < 2u || sphereDistance > c.sdfOrigin.w * c.velocity.w) return sphereDistance;
+
+    vec3 local = (c.worldToLocal * vec4(p, 1.0)).xyz;
+    vec3 g = (local - c.sdfOrigin.xyz) / c.sdfOrigin.w;
+    vec3 maxG = vec3(res - 1u);
+    vec3 gc = clamp(g, vec3(0.0), maxG);
+    float d = SampleSdf(c.sdf.x, res, gc) + length(g - gc) * c.sdfOrigin.w;
+
+    vec3 grad = vec3(
+        SampleSdf(c.sdf.x, res, min(gc + vec3(0.5, 0.0, 0.0), maxG)) - SampleSdf(c.sdf.x, res, max(gc - vec3(0.5, 0.0, 0.0), vec3(0.0))),
+        SampleSdf(c.sdf.x, res, min(gc + vec3(0.0, 0.5, 0.0), maxG)) - SampleSdf(c.sdf.x, res, max(gc - vec3(0.0, 0.5, 0.0), vec3(0.0))),
+        SampleSdf(c.sdf.x, res, min(gc + vec3(0.0, 0.0, 0.5), maxG)) - SampleSdf(c.sdf.x, res, max(gc - vec3(0.0, 0.0, 0.5), vec3(0.0))));
+    vec3 worldGrad = transpose(mat3(c.worldToLocal)) * grad;
+    float gradLength = length(worldGrad);
+    if (gradLength > 1e-8) n = worldGrad / gradLength;
+
+    return d * c.velocity.w;
+}
@@ -1,14 +1,39 @@
 #version 450
 
 layout(set=0, binding=0) uniform GlobalUBO { mat4 view; mat4 proj; } global;
-layout(set=1, binding=0) uniform ObjectUBO { mat4 model; } object;
+
+struct Instance {
+    mat4 world;
+    vec4 sphere;
+    uint slot;
+    uint lodCount;
+    uint pad0, pad1;
+};
+
+// 媛숈#version 450
+
+layout(set=0, binding=0) uniform GlobalUBO { mat4 view; mat4 proj; } global;
+
+struct Instance {
+    mat4 world;
+    vec4 sphere;
+    uint slot;
+    uint lodCount;
+    uint pad0, pad1;
+};
+
+// 같은 mesh, 같은 LOD 의 instance 들이 한 draw 로 그려진다. gl_InstanceIndex 는 firstInstance (draw slot 구간 시작) 를 포함하고,
+// visible 의 slot 구간에는 culling 에서 살아남은 instance 번호가 들어 있다
+layout(set=1, binding=0, std430) readonly buffer Instances { Instance instances[]; };
+layout(set=1, binding=2, std430) readonly buffer Visible { uint visible[]; };
 
 layout(location = 0) in vec4 inPos;   // VSInput.pos
 layout(location = 1) in vec4 inUV;    // VSInput.uv (float4였으니 vec4로 받되 .xy만 사용)
+layout(location = 2) in vec3 inNormal; // 아직 lighting 에는 쓰지 않음
 
 layout(location = 0) out vec2 vUV;
 
 void main() {
-    gl_Position = global.proj * global.view * object.model * inPos;
+    gl_Position = global.proj * global.view * instances[visible[gl_InstanceIndex]].world * inPos;
     vUV = vec2(inUV.x, 1.0 - inUV.y); // 기존과 동일한 Y flip
 }
\ No newline at end of file
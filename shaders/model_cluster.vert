@@ -0,0 +1,37 @@
+#version 450
+
+layout(set=0, binding=0) uniform GlobalUBO { mat4 view; mat4 proj; } global;
+
+struct Instance {
+    mat4 world;
+    vec4 sphere;
+    uint slot;
+    uint lodCount;
+    uint pad0, pad1;
+};
+
+// cull_clusters.comp 媛#version 450
+
+layout(set=0, binding=0) uniform GlobalUBO { mat4 view; mat4 proj; } global;
+
+struct Instance {
+    mat4 world;
+    vec4 sphere;
+    uint slot;
+    uint lodCount;
+    uint pad0, pad1;
+};
+
+// cull_clusters.comp 가 만든 meshlet draw. firstInstance 에 instance 번호가 그대로 들어 있다 (visible 구간을 거치지 않음)
+layout(set=1, binding=0, std430) readonly buffer Instances { Instance instances[]; };
+
+layout(location = 0) in vec4 inPos;
+layout(location = 1) in vec4 inUV;
+layout(location = 2) in vec3 inNormal;
+
+layout(location = 0) out vec2 vUV;
+
+void main() {
+    gl_Position = global.proj * global.view * instances[gl_InstanceIndex].world * inPos;
+    vUV = vec2(inUV.x, 1.0 - inUV.y); // model.vert 와 같은 Y flip
+}
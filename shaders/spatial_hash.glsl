@@ -0,0 +1,20 @@
+// hash_count.comp / self_collide.comp 공용. spatial_hash_layout.h 다음에 include.
+// SpatialHashBucket (spatial_hash.h) 과 같은 계산
+
+layout(push_constant) uniform Push {
+    uint particleCount;
+    uint tableMask;      // bucket 수 - 1 (bucket 수는 2 의 거듭제곱)
+    float cellSize;      // >= distance : 이웃 27 cell 만 보면 된다
+    float distance;      // particle 사이 최소 거리 (천 두께)
+} pc;
+
+ivec3 HashCell(vec3 p)
+{
+    return ivec3(floor(p / pc.cellSize));
+}
+
+uint HashBucket(ivec3 cell)
+{
+    uvec3 c = uvec3(cell);
+    return ((c.x * HASH_PRIME_X) ^ (c.y * HASH_PRIME_Y) ^ (c.z * HASH_PRIME_Z)) & pc.tableMask;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// #pragma once
+
+// 실행 인자로 정하는 옵션 (main.cpp 에서 parse)
+struct AppOptions
+{
+	bool cpu_simulation = false;      // --cpu-sim : compute queue 대신 CPU solver 로 천을 시뮬레이션
+	uint32_t cpu_reference_steps = 0; // --cpu-reference <steps> : 창/GPU 없이 CPU solver 를 SIMD 경로마다 돌려 비교하고 종료
+	uint32_t validate_steps = 0;      // --validate-gpu <steps> : 창 없이 GPU solver 를 CPU reference 와 비교하고 종료 (다르면 exit code 1)
+	float validate_tolerance = 1e-3f; // --tolerance <t> : --validate-gpu 의 위치 최대 오차
+
+	// --headless <frames> : GLFW 창 / surface / swapchain 없이 offscreen image 에 그리고 고정 frame 수 만큼 진행
+	bool headless = false;
+	uint32_t headless_frames = 0;
+	bool headless_render = true;      // --no-render : headless 에서 그리기 생략, 시뮬레이션만
+	std::string headless_output;      // --output <file.ppm> : 마지막 frame 을 PPM 으로 저장
+	uint32_t width = 1400;            // --size <w>x<h>
+	uint32_t height = 900;
+	uint32_t cloth_resolution = 30;   // --cloth <n> : 천을 n x n particle 로 (크기는 그대로, 간격을 줄인다)
+	float sim_rate = 60.0f;           // --sim-rate <hz> : 시뮬레이션 고정 step 빈도. 화면 갱신 빈도와 무관
+	uint32_t sim_substeps = 1;        // --substeps <n> : step 마다 XPBD small step 수 (dt = 1 / (rate * n))
+	uint32_t sim_max_steps = 4;       // --max-sim-steps <n> : 한 frame 에 따라잡는 최대 step 수. 넘으면 버린다
+	uint32_t scene_objects = 3;       // --objects <n> : 구를 n 개 격자로 배치 (instancing stress test)
+	bool cpu_culling = false;         // --cpu-cull : instance culling 을 compute 대신 CPU 에서 (drawIndirectCount 가 없으면 자동)
+	bool occlusion_culling = true;    // --no-occlusion : Hi-Z occlusion culling 없이 frustum culling 만
+	float lod_pixel_error = 1.0f;     // --lod-error <pixels> : LOD 를 고를 때 허용하는 화면 오차. 0 이면 항상 원본 mesh
+	uint32_t cluster_triangles = 8192; // --cluster-tris <n> : triangle 이 n 개 이상인 mesh 는 meshlet 단위로 cull (GPU culling). 0 이면 끔
+	bool mesh_shader = true;          // --no-mesh-shader : VK_EXT_mesh_shader 가 있어도 cluster 를 compute cull + indirect draw 로
+
+	std::string gpu_profile_csv;                    // --gpu-profile <file.csv> : 종료 시 GPU timestamp 를 CSV 로 기록. 주지 않으면 쓰지 않는다
+	std::string cpu_trace_output;                    // --cpu-trace <file.json> : 종료 시 CPU 구간 기록을 Chrome trace 로 저장 (POWERENGINE_CPU_PROFILER 빌드)
+};
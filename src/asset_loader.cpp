@@ -0,0 +1,117 @@
+#include "mesh_import.h"
+#include "mesh_lod.h"
+#include "meshlet.h"
+#include "mesh_sdf.h"
+#include "thread_pool.h"
+#include "texture_2d.h"
+#include "cpu_profiler.h"
+
+#include "asset_loader.h"
+
+namespace {
+	// "assets/models/../models/a.gltf" #include "mesh_import.h"
+#include "mesh_lod.h"
+#include "meshlet.h"
+#include "mesh_sdf.h"
+#include "thread_pool.h"
+#include "texture_2d.h"
+#include "cpu_profiler.h"
+
+#include "asset_loader.h"
+
+namespace {
+	// "assets/models/../models/a.gltf" 와 "assets/models/a.gltf" 를 같은 asset 으로 본다
+	std::string NormalizePath(const std::string& path)
+	{
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+}
+
+std::shared_ptr<MeshData> MeshData::Load(const std::string& path)
+{
+	auto mesh = std::make_shared<MeshData>();
+
+	const std::string cachePath = pmesh::CachePathFor(path);
+	const pmesh::SourceStamp sourceStamp = pmesh::StampSource(path);
+
+	// 내용 hash 는 원본 전체를 읽어야 하므로 stamp 가 다를 때 / cache 를 새로 쓸 때만 한 번 계산
+	uint64_t sourceHash = 0;
+	bool hashed = false;
+	auto hashSource = [&]() {
+		if (!hashed) {
+			sourceHash = pmesh::HashSource(path);
+			hashed = true;
+		}
+		return sourceHash;
+	};
+
+	mesh->mapped = pmesh::MappedMesh::Open(cachePath, sourceStamp, hashSource);
+	if (mesh->mapped) return mesh;
+
+	ImportGltfMesh(path, mesh->vertices, mesh->indices);
+	BuildLodChain(mesh->vertices, mesh->indices, mesh->lods);
+	BuildMeshlets(mesh->vertices, mesh->indices.data(), mesh->lods[0].index_count, mesh->meshlets);
+	BakeSdf(mesh->vertices, mesh->indices, mesh->lods, mesh->sdf);
+	try {
+		pmesh::Write(cachePath, hashSource(), sourceStamp, mesh->vertices, mesh->indices, mesh->lods, mesh->meshlets, mesh->sdf);
+	}
+	catch (const std::exception& e) {
+		// 읽기 전용 위치 등. cache 없이도 동작은 한다
+		std::cerr << "mesh cache not written: " << e.what() << std::endl;
+	}
+	return mesh;
+}
+
+AssetLoader::AssetLoader(ThreadPool& pool, vku::Allocator& allocator, UploadService& uploads)
+	: pool_(pool), allocator_(allocator), uploads_(uploads)
+{
+}
+
+AssetLoader::MeshFuture AssetLoader::LoadMesh(const std::string& path)
+{
+	const std::string key = NormalizePath(path);
+
+	std::lock_guard lock(mutex_);
+	++request_count_;
+	if (auto it = meshes_.find(key); it != meshes_.end()) {
+		return it->second;
+	}
+
+	MeshFuture future = pool_.Submit([key]() -> std::shared_ptr<const MeshData> {
+		PE_CPU_SCOPE("AssetLoader mesh");
+		return MeshData::Load(key);
+	}).share();
+	meshes_.emplace(key, future);
+	return future;
+}
+
+AssetLoader::TextureFuture AssetLoader::LoadTexture(const std::string& path)
+{
+	const std::string key = NormalizePath(path);
+
+	std::lock_guard lock(mutex_);
+	++request_count_;
+	if (auto it = textures_.find(key); it != textures_.end()) {
+		return it->second;
+	}
+
+	// KTX decode, image 생성, upload 기록까지 worker 에서 (Allocator / UploadService 는 thread safe)
+	TextureFuture future = pool_.Submit([&allocator = allocator_, &uploads = uploads_, key]() {
+		PE_CPU_SCOPE("AssetLoader texture");
+		return std::make_shared<Texture2D>(key, allocator, uploads);
+	}).share();
+	textures_.emplace(key, future);
+	return future;
+}
+
+uint32_t AssetLoader::RequestCount() const
+{
+	std::lock_guard lock(mutex_);
+	return request_count_;
+}
+
+uint32_t AssetLoader::UniqueCount() const
+{
+	std::lock_guard lock(mutex_);
+	return static_cast<uint32_t>(meshes_.size() + textures_.size());
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "vertex.h"
+#include "mesh_cache.h"
+
+class ThreadPool;
+class UploadService;
+class Texture2D;
+namespace vku { class Allocator; }
+
+// decode 媛#pragma once
+
+#include "vertex.h"
+#include "mesh_cache.h"
+
+class ThreadPool;
+class UploadService;
+class Texture2D;
+namespace vku { class Allocator; }
+
+// decode 가 끝난 mesh (CPU 쪽). .pmesh cache 가 최신이면 mmap 을 그대로 들고 있고, 아니면 glTF import 결과
+struct MeshData
+{
+	std::unique_ptr<pmesh::MappedMesh> mapped;
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices; // 모든 LOD 의 index 가 이어져 있다
+	std::vector<pmesh::Lod> lods;
+	pmesh::Meshlets meshlets;      // LOD 0 의 meshlet
+	pmesh::Sdf sdf;                // 천 충돌용 distance field
+
+	// cache 가 없거나 stale 이면 import + LOD chain / meshlet / SDF 생성 후 cache 를 새로 쓴다
+	static std::shared_ptr<MeshData> Load(const std::string& path);
+
+	const void* VertexData() const { return mapped ? static_cast<const void*>(mapped->VertexData()) : vertices.data(); }
+	uint64_t VertexBytes() const { return mapped ? mapped->VertexBytes() : vertices.size() * sizeof(Vertex); }
+	const void* IndexData() const { return mapped ? static_cast<const void*>(mapped->IndexData()) : indices.data(); }
+	uint64_t IndexBytes() const { return mapped ? mapped->IndexBytes() : indices.size() * sizeof(uint32_t); }
+	uint32_t IndexCount() const { return mapped ? mapped->IndexCount() : static_cast<uint32_t>(indices.size()); }
+	const pmesh::Lod* LodData() const { return mapped ? mapped->LodData() : lods.data(); }
+	uint32_t LodCount() const { return mapped ? mapped->LodCount() : static_cast<uint32_t>(lods.size()); }
+	const pmesh::Meshlet* MeshletData() const { return mapped ? mapped->MeshletData() : meshlets.meshlets.data(); }
+	uint32_t MeshletCount() const { return mapped ? mapped->MeshletCount() : static_cast<uint32_t>(meshlets.meshlets.size()); }
+	const uint32_t* MeshletVertexData() const { return mapped ? mapped->MeshletVertexData() : meshlets.vertices.data(); }
+	uint32_t MeshletVertexCount() const { return mapped ? mapped->MeshletVertexCount() : static_cast<uint32_t>(meshlets.vertices.size()); }
+	const uint32_t* MeshletTriangleData() const { return mapped ? mapped->MeshletTriangleData() : meshlets.triangles.data(); }
+	uint32_t MeshletTriangleCount() const { return mapped ? mapped->MeshletTriangleCount() : static_cast<uint32_t>(meshlets.triangles.size()); }
+	const pmesh::SdfVolume& GetSdfVolume() const { return mapped ? mapped->GetSdfVolume() : sdf.volume; }
+	const float* SdfData() const { return mapped ? mapped->SdfData() : sdf.distances.data(); }
+};
+
+// 시작 시 asset 을 thread pool 에서 병렬로 decode 한다.
+// 같은 경로는 한 번만 읽고 같은 future 를 돌려준다. texture 는 worker 에서 image 생성과 upload 기록까지 끝낸다.
+// loader 는 먼저 없어져도 되지만 pool / allocator / uploads 는 future 가 모두 끝날 때까지 살아있어야 한다.
+class AssetLoader
+{
+public:
+	using MeshFuture = std::shared_future<std::shared_ptr<const MeshData>>;
+	using TextureFuture = std::shared_future<std::shared_ptr<Texture2D>>;
+
+	AssetLoader(ThreadPool& pool, vku::Allocator& allocator, UploadService& uploads);
+	AssetLoader(const AssetLoader& rhs) = delete;
+	AssetLoader(AssetLoader&& rhs) = delete;
+	AssetLoader& operator=(const AssetLoader& rhs) = delete;
+	AssetLoader& operator=(AssetLoader&& rhs) = delete;
+	~AssetLoader() = default;
+
+	MeshFuture LoadMesh(const std::string& path);
+	TextureFuture LoadTexture(const std::string& path);
+
+	uint32_t RequestCount() const;
+	uint32_t UniqueCount() const;
+
+private:
+	ThreadPool& pool_;
+	vku::Allocator& allocator_;
+	UploadService& uploads_;
+
+	mutable std::mutex mutex_;
+	std::unordered_map<std::string, MeshFuture> meshes_;
+	std::unordered_map<std::string, TextureFuture> textures_;
+	uint32_t request_count_ = 0;
+};
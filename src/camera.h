@@ -1,5 +1,19 @@
 #pragma once
 
+struct Camera {
+
+    Camera() = default;
+    ~Camera() = default;
+    Camera(const Camera&) = delete;
+    Camera& operator=(const Camera&) = delete;
+    Camera(Camera&&) = delete;
+    Camera& operator=(Camera&&) = delete;
+
+    glm::vec3 position{ 0.0f, 0.0f, 4.0f };
+    float yaw = -90.0f;
+    float pitch = 0.0f;
+    float fov = 60.0f;    // 以#pragma once
+
 struct Camera {
 
     Camera() = default;
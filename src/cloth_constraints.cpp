@@ -0,0 +1,156 @@
+#include "cloth_constraints.h"
+
+std::vector<glm::vec4> BuildClothParticles(int nx, int ny, float spacing)
+{
+	// 泥쒖쓽 #include "cloth_constraints.h"
+
+std::vector<glm::vec4> BuildClothParticles(int nx, int ny, float spacing)
+{
+	// 천의 실제 크기
+	const float width = spacing * (nx - 1);
+	const float height = spacing * (ny - 1);
+
+	// 카메라가 (0,0,4) 에 있고 -Z를 보니, 천을 z=0 평면에 두면 정면으로 보임.
+	// 화면 중심에 천 중심이 오도록 (가운데 정렬)
+	const float originX = -width * 0.5f;
+	const float originY = -height * 0.5f;
+	const float zPlane = 0.0f;
+
+	std::vector<glm::vec4> positions(static_cast<size_t>(nx) * ny);
+	for (int y = 0; y < ny; ++y)
+		for (int x = 0; x < nx; ++x) {
+			// w = inverse mass, 윗줄 양 끝 두 점은 고정(0)
+			const bool pinned = (y == ny - 1) && (x == 0 || x == nx - 1);
+			positions[y * nx + x] = { originX + x * spacing, originY + y * spacing, zPlane, pinned ? 0.0f : 1.0f };
+		}
+	return positions;
+}
+
+void ClothConstraints::Build(int nx, int ny, float spacing)
+{
+	constraints_.clear();
+	batches_.clear();
+
+	auto idx = [&](int x, int y) { return static_cast<uint32_t>(y * nx + x); };
+	auto add = [&](int x0, int y0, int x1, int y1, float restLength, ConstraintType type) {
+		constraints_.push_back({ idx(x0, y0), idx(x1, y1), restLength, static_cast<uint32_t>(type) });
+	};
+
+	const float diagonal = spacing * std::sqrt(2.0f);
+
+	// 가까운 constraint 끼리 붙어있도록 family / parity 순서로 만든다.
+	// greedy coloring 결과도 이 순서에 따라 color 수가 적게 나온다.
+
+	// Structural : (x,y)-(x+1,y), (x,y)-(x,y+1)
+	for (int parity = 0; parity < 2; ++parity)
+		for (int y = 0; y < ny; ++y)
+			for (int x = parity; x + 1 < nx; x += 2)
+				add(x, y, x + 1, y, spacing, ConstraintType::Structural);
+	for (int parity = 0; parity < 2; ++parity)
+		for (int y = parity; y + 1 < ny; y += 2)
+			for (int x = 0; x < nx; ++x)
+				add(x, y, x, y + 1, spacing, ConstraintType::Structural);
+
+	// Shear : (x,y)-(x+1,y+1), (x+1,y)-(x,y+1)
+	for (int parity = 0; parity < 2; ++parity)
+		for (int y = 0; y + 1 < ny; ++y)
+			for (int x = parity; x + 1 < nx; x += 2)
+				add(x, y, x + 1, y + 1, diagonal, ConstraintType::Shear);
+	for (int parity = 0; parity < 2; ++parity)
+		for (int y = 0; y + 1 < ny; ++y)
+			for (int x = parity; x + 1 < nx; x += 2)
+				add(x + 1, y, x, y + 1, diagonal, ConstraintType::Shear);
+
+	// Bending : (x,y)-(x+2,y), (x,y)-(x,y+2)
+	for (int parity = 0; parity < 2; ++parity)
+		for (int y = 0; y < ny; ++y)
+			for (int x = 0; x + 2 < nx; ++x)
+				if (((x >> 1) & 1) == parity)
+					add(x, y, x + 2, y, spacing * 2.0f, ConstraintType::Bending);
+	for (int parity = 0; parity < 2; ++parity)
+		for (int y = 0; y + 2 < ny; ++y)
+			if (((y >> 1) & 1) == parity)
+				for (int x = 0; x < nx; ++x)
+					add(x, y, x, y + 2, spacing * 2.0f, ConstraintType::Bending);
+
+	ColorAndSort(static_cast<uint32_t>(nx * ny));
+}
+
+void ClothConstraints::ColorAndSort(uint32_t particleCount)
+{
+	// particle 마다 이미 사용된 color 를 bitmask 로 기록하고,
+	// 두 particle 모두 비어있는 가장 작은 color 를 고른다 (greedy edge coloring).
+	std::vector<uint64_t> usedColors(particleCount, 0);
+	std::vector<uint32_t> colorOf(constraints_.size());
+	uint32_t colorCount = 0;
+
+	for (size_t i = 0; i < constraints_.size(); ++i) {
+		const auto& c = constraints_[i];
+		const uint64_t used = usedColors[c.a] | usedColors[c.b];
+		if (used == ~0ull) {
+			throw std::runtime_error("cloth constraint coloring ran out of colors!");
+		}
+
+		uint32_t color = 0;
+		while (used & (1ull << color)) ++color;
+
+		usedColors[c.a] |= (1ull << color);
+		usedColors[c.b] |= (1ull << color);
+		colorOf[i] = color;
+		colorCount = std::max(colorCount, color + 1);
+	}
+
+	// color 별로 연속되도록 counting sort
+	batches_.assign(colorCount, ConstraintBatch{ 0, 0 });
+	for (uint32_t color : colorOf) batches_[color].count++;
+
+	uint32_t offset = 0;
+	for (auto& batch : batches_) {
+		batch.first = offset;
+		offset += batch.count;
+	}
+
+	std::vector<DistanceConstraint> sorted(constraints_.size());
+	std::vector<uint32_t> cursor(colorCount);
+	for (uint32_t color = 0; color < colorCount; ++color) cursor[color] = batches_[color].first;
+	for (size_t i = 0; i < constraints_.size(); ++i) {
+		sorted[cursor[colorOf[i]]++] = constraints_[i];
+	}
+	constraints_ = std::move(sorted);
+}
+
+bool ClothConstraints::Validate(const std::vector<DistanceConstraint>& constraints, const std::vector<ConstraintBatch>& batches, uint32_t particleCount)
+{
+	// lastBatch[p] = particle p 를 마지막으로 사용한 batch 번호 + 1
+	std::vector<uint32_t> lastBatch(particleCount, 0);
+	size_t covered = 0;
+
+	for (uint32_t b = 0; b < batches.size(); ++b) {
+		const auto& batch = batches[b];
+		if (batch.first != covered || static_cast<size_t>(batch.first) + batch.count > constraints.size()) {
+			std::cerr << "constraint batch " << b << " is out of range" << std::endl;
+			return false;
+		}
+
+		for (uint32_t i = batch.first; i < batch.first + batch.count; ++i) {
+			const auto& c = constraints[i];
+			if (c.a >= particleCount || c.b >= particleCount || c.a == c.b) {
+				std::cerr << "constraint " << i << " has invalid particles (" << c.a << ", " << c.b << ")" << std::endl;
+				return false;
+			}
+			if (lastBatch[c.a] == b + 1 || lastBatch[c.b] == b + 1) {
+				std::cerr << "constraint " << i << " shares a particle with another constraint in batch " << b << std::endl;
+				return false;
+			}
+			lastBatch[c.a] = b + 1;
+			lastBatch[c.b] = b + 1;
+		}
+		covered += batch.count;
+	}
+
+	if (covered != constraints.size()) {
+		std::cerr << "constraint batches cover " << covered << " of " << constraints.size() << " constraints" << std::endl;
+		return false;
+	}
+	return true;
+}
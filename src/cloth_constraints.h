@@ -0,0 +1,59 @@
+#pragma once
+
+enum class ConstraintType : uint32_t
+{
+	Structural = 0,
+	Shear = 1,
+	Bending = 2
+};
+
+// solve_distance.comp #pragma once
+
+enum class ConstraintType : uint32_t
+{
+	Structural = 0,
+	Shear = 1,
+	Bending = 2
+};
+
+// solve_distance.comp 의 DistanceConstraint 와 같은 layout (std430, 16 bytes)
+struct DistanceConstraint
+{
+	uint32_t a;
+	uint32_t b;
+	float rest_length;
+	uint32_t type;
+};
+
+// 같은 batch(color) 안의 constraint 들은 particle 을 공유하지 않으므로 한 번의 dispatch 로 처리
+struct ConstraintBatch
+{
+	uint32_t first;
+	uint32_t count;
+};
+
+// idx = y * nx + x 로 배치된 grid 의 초기 위치. xyz = 위치 (z=0 평면, 가운데 정렬), w = inverse mass (윗줄 양 끝 고정)
+std::vector<glm::vec4> BuildClothParticles(int nx, int ny, float spacing);
+
+class ClothConstraints
+{
+public:
+	ClothConstraints() = default;
+	ClothConstraints(const ClothConstraints& rhs) = delete;
+	ClothConstraints(ClothConstraints&& rhs) = delete;
+	ClothConstraints& operator=(const ClothConstraints& rhs) = delete;
+	ClothConstraints& operator=(ClothConstraints&& rhs) = delete;
+	~ClothConstraints() = default;
+
+	// idx = y * nx + x 로 배치된 grid 에서 structural / shear / bending constraint 를 만들고 color 별로 정렬
+	void Build(int nx, int ny, float spacing);
+
+	// 같은 batch 안에서 particle 을 공유하는 constraint 가 없는지 검사
+	static bool Validate(const std::vector<DistanceConstraint>& constraints, const std::vector<ConstraintBatch>& batches, uint32_t particleCount);
+
+	std::vector<DistanceConstraint> constraints_;
+	std::vector<ConstraintBatch> batches_;
+
+private:
+	void ColorAndSort(uint32_t particleCount);
+};
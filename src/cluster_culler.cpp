@@ -0,0 +1,307 @@
+#include "cpu_profiler.h"
+#include "vertex.h"
+#include "mesh_asset.h"
+#include "mesh_instance.h"
+#include "mesh_pool.h"
+#include "mesh_cache.h"
+#include "gpu_profiler.h"
+#include "frustum.h"
+
+#include "cluster_culler.h"
+
+namespace
+{
+	static_assert(sizeof(Vertex) == VERTEX_FLOATS * sizeof(float));
+
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+}
+
+ClusterCuller::ClusterCuller(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vku::Allocator& allocator, const MeshPool& pool, bool meshShader)
+	: device_(device), allocator_(allocator), pool_(pool), mesh_shader_(meshShader)
+{
+	static_assert(sizeof(Params) == 192);
+
+	if (mesh_shader_) {
+		const auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceMeshShaderPropertiesEXT>();
+		max_task_work_groups_ = properties.get<vk::PhysicalDeviceMeshShaderPropertiesEXT>().maxTaskWorkGroupCount[0];
+	}
+
+	// mesh shader 寃쎈줈硫#include "cpu_profiler.h"
+#include "vertex.h"
+#include "mesh_asset.h"
+#include "mesh_instance.h"
+#include "mesh_pool.h"
+#include "mesh_cache.h"
+#include "gpu_profiler.h"
+#include "frustum.h"
+
+#include "cluster_culler.h"
+
+namespace
+{
+	static_assert(sizeof(Vertex) == VERTEX_FLOATS * sizeof(float));
+
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+}
+
+ClusterCuller::ClusterCuller(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vku::Allocator& allocator, const MeshPool& pool, bool meshShader)
+	: device_(device), allocator_(allocator), pool_(pool), mesh_shader_(meshShader)
+{
+	static_assert(sizeof(Params) == 192);
+
+	if (mesh_shader_) {
+		const auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceMeshShaderPropertiesEXT>();
+		max_task_work_groups_ = properties.get<vk::PhysicalDeviceMeshShaderPropertiesEXT>().maxTaskWorkGroupCount[0];
+	}
+
+	// mesh shader 경로면 task / mesh stage 도 같은 set 을 읽는다
+	vk::ShaderStageFlags stages = vk::ShaderStageFlagBits::eCompute;
+	if (mesh_shader_) {
+		stages |= vk::ShaderStageFlagBits::eTaskEXT | vk::ShaderStageFlagBits::eMeshEXT;
+	}
+	std::array<vk::DescriptorSetLayoutBinding, CLUSTER_BINDING_COUNT> layoutBindings;
+	for (uint32_t binding = 0; binding < CLUSTER_BINDING_COUNT; ++binding) {
+		const vk::DescriptorType type = binding == CLUSTER_BINDING_PARAMS ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer;
+		layoutBindings[binding] = vk::DescriptorSetLayoutBinding{ binding, type, 1, stages };
+	}
+	vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = static_cast<uint32_t>(layoutBindings.size()), .pBindings = layoutBindings.data() };
+	set_layout_ = vk::raii::DescriptorSetLayout(device_, layoutInfo);
+
+	std::array poolSizes{
+		vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, (CLUSTER_BINDING_COUNT - 1) * MAX_FRAMES_IN_FLIGHT },
+		vk::DescriptorPoolSize{ vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT }
+	};
+	vk::DescriptorPoolCreateInfo poolInfo{
+		.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+		.maxSets = MAX_FRAMES_IN_FLIGHT,
+		.poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+		.pPoolSizes = poolSizes.data()
+	};
+	descriptor_pool_ = vk::raii::DescriptorPool(device_, poolInfo);
+	for (Frame& frame : frames_) {
+		vk::DescriptorSetAllocateInfo allocInfo{ .descriptorPool = *descriptor_pool_, .descriptorSetCount = 1, .pSetLayouts = &*set_layout_ };
+		frame.set = std::move(vk::raii::DescriptorSets{ device_, allocInfo }.front());
+
+		// 크기가 고정인 것은 여기서 한 번 만든다
+		Reserve(frame.params, 1, sizeof(Params), vk::BufferUsageFlagBits::eUniformBuffer, true);
+		Reserve(frame.counts, CLUSTER_COUNTER_COUNT, sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst |
+			vk::BufferUsageFlagBits::eIndirectBuffer, false);
+		Reserve(frame.readback, CLUSTER_COUNTER_COUNT, sizeof(uint32_t), vk::BufferUsageFlagBits::eTransferDst, true);
+	}
+
+	vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 1, .pSetLayouts = &*set_layout_ };
+	pipeline_layout_ = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
+
+	// mesh shader 경로는 cull 이 task shader 안에서 일어난다
+	if (!mesh_shader_) {
+		vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device_, vku::ReadFile("shaders/cull_clusters.comp.spv"));
+		vk::PipelineShaderStageCreateInfo stageInfo{ .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main" };
+		vk::ComputePipelineCreateInfo pipelineInfo{ .stage = stageInfo, .layout = *pipeline_layout_ };
+		cull_pipeline_ = vk::raii::Pipeline(device_, nullptr, pipelineInfo);
+	}
+}
+
+bool ClusterCuller::Reserve(MappedBuffer& target, size_t required, vk::DeviceSize elementSize, vk::BufferUsageFlags usage, bool hostVisible)
+{
+	if (*target.buffer && target.capacity >= required) return false;
+
+	uint32_t capacity = std::max(target.capacity, 64u);
+	while (capacity < required) capacity *= 2;
+
+	const vk::MemoryPropertyFlags properties = hostVisible
+		? vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+		: vk::MemoryPropertyFlagBits::eDeviceLocal;
+	vku::CreateBuffer(allocator_, elementSize * capacity, usage, properties, target.buffer, target.memory);
+	target.capacity = capacity;
+	return true;
+}
+
+void ClusterCuller::SetInstanceBuffer(uint32_t frameIndex, const vk::DescriptorBufferInfo& instances)
+{
+	vk::WriteDescriptorSet write{
+		.dstSet = *frames_[frameIndex].set,
+		.dstBinding = CLUSTER_BINDING_INSTANCES,
+		.dstArrayElement = 0,
+		.descriptorCount = 1,
+		.descriptorType = vk::DescriptorType::eStorageBuffer,
+		.pBufferInfo = &instances
+	};
+	device_.updateDescriptorSets(write, {});
+}
+
+void ClusterCuller::WriteDescriptors(Frame& frame)
+{
+	// instance 는 SetInstanceBuffer 가 따로 쓴다
+	std::array<vk::DescriptorBufferInfo, CLUSTER_BINDING_COUNT> infos;
+	infos[CLUSTER_BINDING_PARAMS] = { *frame.params.buffer, 0, sizeof(Params) };
+	infos[CLUSTER_BINDING_MESHLETS] = pool_.MeshletBufferInfo();
+	infos[CLUSTER_BINDING_MESHLET_VERTICES] = pool_.MeshletVertexBufferInfo();
+	infos[CLUSTER_BINDING_MESHLET_TRIANGLES] = pool_.MeshletTriangleBufferInfo();
+	infos[CLUSTER_BINDING_VERTICES] = pool_.VertexBufferInfo();
+	infos[CLUSTER_BINDING_WORK] = { *frame.work.buffer, 0, VK_WHOLE_SIZE };
+	infos[CLUSTER_BINDING_DRAWS] = { *frame.draws.buffer, 0, VK_WHOLE_SIZE };
+	infos[CLUSTER_BINDING_INDICES] = { *frame.indices.buffer, 0, VK_WHOLE_SIZE };
+	infos[CLUSTER_BINDING_COUNTS] = { *frame.counts.buffer, 0, VK_WHOLE_SIZE };
+
+	std::vector<vk::WriteDescriptorSet> writes;
+	for (uint32_t binding = 0; binding < CLUSTER_BINDING_COUNT; ++binding) {
+		if (binding == CLUSTER_BINDING_INSTANCES) continue;
+		writes.push_back(vk::WriteDescriptorSet{
+			.dstSet = *frame.set,
+			.dstBinding = binding,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = binding == CLUSTER_BINDING_PARAMS ? vk::DescriptorType::eUniformBuffer : vk::DescriptorType::eStorageBuffer,
+			.pBufferInfo = &infos[binding]
+		});
+	}
+	device_.updateDescriptorSets(writes, {});
+}
+
+void ClusterCuller::Prepare(uint32_t frameIndex, const std::vector<DrawBatch>& batches, const glm::mat4& viewProj, const glm::vec3& cameraPosition)
+{
+	PE_CPU_SCOPE("ClusterCuller::Prepare");
+
+	Frame& frame = frames_[frameIndex];
+	// 지난번 이 slot 에서 GPU 가 잡으려던 draw 수 (drawCapacity 를 넘었어도 그만큼 커져 있다)
+	uint32_t lastDrawCount = 0;
+	if (frame.has_result) {
+		const auto* counts = static_cast<const uint32_t*>(frame.readback.memory.Mapped());
+		lastDrawCount = counts[0];
+		visible_clusters_ = counts[2];
+		frustum_culled_ = counts[3];
+		cone_culled_ = counts[4];
+		overflow_clusters_ = counts[5];
+		visible_triangles_ = counts[1] / 3;
+	}
+
+	// work 수 / 최악의 경우 draw, index 수
+	uint32_t workCount = 0;
+	uint32_t clusterCount = 0;
+	uint64_t indexCount = 0;
+	for (const DrawBatch& batch : batches) {
+		const MeshAsset& mesh = *batch.mesh;
+		if (!mesh.clustered_) continue;
+		workCount += batch.instance_count * ((mesh.meshlet_count_ + CLUSTER_GROUP_SIZE - 1) / CLUSTER_GROUP_SIZE);
+		clusterCount += batch.instance_count * mesh.meshlet_count_;
+		indexCount += static_cast<uint64_t>(batch.instance_count) * mesh.index_count_;
+	}
+	const uint32_t indexCapacity = static_cast<uint32_t>(std::min<uint64_t>(indexCount, kMaxIndices));
+	frame.work_count = workCount;
+	frame.cluster_count = clusterCount;
+	cluster_count_ = clusterCount;
+	if (workCount == 0) {
+		visible_clusters_ = frustum_culled_ = cone_culled_ = overflow_clusters_ = 0;
+		visible_triangles_ = 0;
+		return;
+	}
+
+	bool recreated = false;
+	recreated |= Reserve(frame.work, workCount, sizeof(ClusterWork), vk::BufferUsageFlagBits::eStorageBuffer, true);
+	// mesh shader 경로는 draw command / index 를 쓰지 않는다 (descriptor 가 유효하도록 작게만 만든다).
+	// draw 는 meshlet 마다 하나라 clusterCount 면 넘치지 않지만, 지난 readback 이 더 많았으면 그만큼 키운다
+	recreated |= Reserve(frame.draws, mesh_shader_ ? 1 : std::max(clusterCount, lastDrawCount), sizeof(vk::DrawIndexedIndirectCommand),
+		vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer, false);
+	recreated |= Reserve(frame.indices, mesh_shader_ ? 1 : indexCapacity, sizeof(uint32_t),
+		vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndexBuffer, false);
+	if (recreated) {
+		WriteDescriptors(frame);
+	}
+
+	auto* work = static_cast<ClusterWork*>(frame.work.memory.Mapped());
+	uint32_t next = 0;
+	for (const DrawBatch& batch : batches) {
+		const MeshAsset& mesh = *batch.mesh;
+		if (!mesh.clustered_) continue;
+		for (uint32_t i = batch.first_instance; i < batch.first_instance + batch.instance_count; ++i) {
+			for (uint32_t m = 0; m < mesh.meshlet_count_; m += CLUSTER_GROUP_SIZE) {
+				work[next++] = ClusterWork{
+					.instance = i,
+					.first_meshlet = mesh.first_meshlet_ + m,
+					.meshlet_count = std::min<uint32_t>(CLUSTER_GROUP_SIZE, mesh.meshlet_count_ - m),
+					.vertex_offset = mesh.vertex_offset_
+				};
+			}
+		}
+	}
+
+	Params params{ .viewProj = viewProj };
+	const Frustum frustum = Frustum::FromViewProj(viewProj);
+	std::copy(frustum.planes.begin(), frustum.planes.end(), params.planes);
+	params.camera = glm::vec4(cameraPosition, 0.0f);
+	params.workCount = workCount;
+	params.drawCapacity = mesh_shader_ ? 0u : frame.draws.capacity;
+	params.indexCapacity = mesh_shader_ ? 0u : frame.indices.capacity;
+	std::memcpy(frame.params.memory.Mapped(), &params, sizeof(Params));
+}
+
+void ClusterCuller::RecordCull(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, GpuProfiler* profiler)
+{
+	Frame& frame = frames_[frameIndex];
+	if (frame.work_count == 0) return;
+
+	GpuScope scope(profiler, cmd, "Cluster cull");
+	// task stage 는 mesh shader feature 를 켰을 때만 barrier 에 쓸 수 있다
+	const vk::PipelineStageFlags2 cullStage = mesh_shader_ ? vk::PipelineStageFlagBits2::eTaskShaderEXT : vk::PipelineStageFlagBits2::eComputeShader;
+
+	// 이 slot 의 지난 결과 (그 frame 의 draw 까지 끝났다) 를 옮긴 뒤 비운다
+	if (frame.counts_written) {
+		AddBarrier(cmd,
+			cullStage | vk::PipelineStageFlagBits2::eDrawIndirect,
+			vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eIndirectCommandRead,
+			vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferRead);
+		cmd.copyBuffer(*frame.counts.buffer, *frame.readback.buffer, vk::BufferCopy(0, 0, CLUSTER_COUNTER_COUNT * sizeof(uint32_t)));
+		AddBarrier(cmd,
+			vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite,
+			vk::PipelineStageFlagBits2::eTransfer | vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eHostRead);
+		frame.has_result = true;
+	}
+	cmd.fillBuffer(*frame.counts.buffer, 0, CLUSTER_COUNTER_COUNT * sizeof(uint32_t), 0);
+	frame.counts_written = true;
+
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+		cullStage, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+	if (mesh_shader_) return;
+
+	cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *frame.set }, {});
+	cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *cull_pipeline_);
+	cmd.dispatch(frame.work_count, 1, 1);
+
+	// draws / counts 는 indirect 로, indices 는 index buffer 로 읽힌다
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+		vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eIndexInput,
+		vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eIndexRead);
+}
+
+void ClusterCuller::RecordDraw(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, const vk::raii::PipelineLayout& layout) const
+{
+	const Frame& frame = frames_[frameIndex];
+	if (frame.work_count == 0) return;
+
+	cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *layout, 2, { *frame.set }, {});
+	if (mesh_shader_) {
+		// task workgroup 하나가 work 하나. 한 번에 maxTaskWorkGroupCount[0] 개까지라 firstWork 를 옮기며 나눠 그린다
+		for (uint32_t first = 0; first < frame.work_count; first += max_task_work_groups_) {
+			cmd.pushConstants<uint32_t>(*layout, vk::ShaderStageFlagBits::eTaskEXT, 0, first);
+			cmd.drawMeshTasksEXT(std::min(frame.work_count - first, max_task_work_groups_), 1, 1);
+		}
+		return;
+	}
+
+	pool_.BindVertices(cmd);
+	cmd.bindIndexBuffer(*frame.indices.buffer, 0, vk::IndexType::eUint32);
+	// cull_clusters.comp 는 drawCapacity 안쪽 slot 만 쓴다
+	cmd.drawIndexedIndirectCount(*frame.draws.buffer, 0, *frame.counts.buffer, 0, frame.draws.capacity, sizeof(vk::DrawIndexedIndirectCommand));
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+class MeshPool;
+class GpuProfiler;
+struct DrawBatch;
+
+#include "vulkan_utils.h"
+#include "meshlet_layout.h"
+
+// #pragma once
+
+class MeshPool;
+class GpuProfiler;
+struct DrawBatch;
+
+#include "vulkan_utils.h"
+#include "meshlet_layout.h"
+
+// 큰 mesh (MeshAsset::clustered_) 의 instance 를 meshlet 단위로 cull 해서 그린다.
+// instance 하나가 화면에 걸쳐 있어도 frustum 밖이나 뒤를 향한 (normal cone) meshlet 은 버린다.
+// work : (instance, meshlet 최대 CLUSTER_GROUP_SIZE 개) 묶음. Prepare 가 CPU 에서 만들고 workgroup 하나가 하나를 맡는다.
+// compute 경로 : cull_clusters.comp 가 살아남은 meshlet 의 index 를 frame slot 의 index buffer 에 이어 쓰고
+//               meshlet 마다 draw command 를 만든다. model_cluster.vert + drawIndexedIndirectCount (firstInstance = instance 번호).
+// mesh shader 경로 (VK_EXT_mesh_shader) : cluster.task 가 같은 판정으로 살아남은 meshlet 만 cluster.mesh 로 내보낸다. index buffer 없음.
+// GPU culling 경로에서만 쓴다. 통계는 frame slot 을 다시 기록할 때 읽으므로 MAX_FRAMES_IN_FLIGHT frame 늦다.
+class ClusterCuller
+{
+public:
+	ClusterCuller(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vku::Allocator& allocator, const MeshPool& pool, bool meshShader);
+	ClusterCuller(const ClusterCuller& rhs) = delete;
+	ClusterCuller(ClusterCuller&& rhs) = delete;
+	ClusterCuller& operator=(const ClusterCuller& rhs) = delete;
+	ClusterCuller& operator=(ClusterCuller&& rhs) = delete;
+	~ClusterCuller() = default;
+
+	// frame slot 의 instance buffer (InstanceCuller::InstanceBufferInfo). 그쪽 buffer 가 다시 만들어질 때마다
+	void SetInstanceBuffer(uint32_t frame, const vk::DescriptorBufferInfo& instances);
+	// clustered_ batch 의 work 를 만든다. frame slot 의 이전 GPU 작업이 끝난 뒤에
+	void Prepare(uint32_t frame, const std::vector<DrawBatch>& batches, const glm::mat4& viewProj, const glm::vec3& cameraPosition);
+	// rendering 밖에서. 이 slot 의 지난 통계를 readback 으로 옮기고 counts 를 비운 뒤, compute 경로면 cull dispatch
+	void RecordCull(const vk::raii::CommandBuffer& cmd, uint32_t frame, GpuProfiler* profiler);
+	// pipeline (SetLayout 을 set 2 로 가진 layout) 과 set 0, 1 은 호출하는 쪽이 bind. set 2 와 index / vertex buffer 는 여기서.
+	// mesh shader 경로면 layout 에 task stage push constant (uint firstWork, offset 0) 가 있어야 한다
+	void RecordDraw(const vk::raii::CommandBuffer& cmd, uint32_t frame, const vk::raii::PipelineLayout& layout) const;
+
+	const vk::raii::DescriptorSetLayout& SetLayout() const { return set_layout_; }
+	bool MeshShader() const { return mesh_shader_; }
+
+	// 마지막 Prepare 의 (instance x meshlet) 수와, 마지막으로 읽은 결과
+	uint32_t ClusterCount() const { return cluster_count_; }
+	uint32_t VisibleClusters() const { return visible_clusters_; }
+	uint32_t FrustumCulled() const { return frustum_culled_; }
+	uint32_t ConeCulled() const { return cone_culled_; }
+	// 살아남았지만 draw / index buffer 가 모자라 그 frame 에 그리지 못한 meshlet 수 (compute 경로)
+	uint32_t OverflowClusters() const { return overflow_clusters_; }
+	uint64_t VisibleTriangles() const { return visible_triangles_; }
+
+private:
+	// frame 당 compact index buffer 의 상한 (원소 수). 넘치는 workgroup 은 그 frame 에 그리지 않는다
+	static constexpr uint32_t kMaxIndices = 1u << 24;
+
+	// std140 : cull_clusters.comp / cluster.task / cluster.mesh 의 Params
+	struct Params {
+		glm::mat4 viewProj;
+		glm::vec4 planes[6];
+		glm::vec4 camera; // xyz = camera 위치
+		uint32_t workCount;
+		uint32_t drawCapacity;
+		uint32_t indexCapacity;
+		uint32_t pad;
+	};
+	struct ClusterWork {
+		uint32_t instance;
+		uint32_t first_meshlet;
+		uint32_t meshlet_count;
+		int32_t vertex_offset;
+	};
+	struct MappedBuffer {
+		vk::raii::Buffer buffer{ nullptr };
+		vku::Allocation memory;
+		uint32_t capacity = 0; // 원소 수
+	};
+	struct Frame {
+		MappedBuffer params;   // host visible
+		MappedBuffer work;     // host visible
+		MappedBuffer draws;    // compute 경로
+		MappedBuffer indices;  // compute 경로
+		MappedBuffer counts;   // [0] = draw 수, [1] = index 수, [2] = 살아남은 meshlet 수, [3] = frustum 으로 버린 수, [4] = cone 으로 버린 수, [5] = 넘친 수
+		MappedBuffer readback;
+		vk::raii::DescriptorSet set{ nullptr };
+		uint32_t work_count = 0;
+		uint32_t cluster_count = 0;
+		bool counts_written = false; // counts 에 이전 cull 결과가 있다 (처음 한 번은 readback 으로 옮기지 않는다)
+		bool has_result = false;
+	};
+
+	bool Reserve(MappedBuffer& target, size_t required, vk::DeviceSize elementSize, vk::BufferUsageFlags usage, bool hostVisible);
+	void WriteDescriptors(Frame& frame);
+
+	vk::raii::Device& device_;
+	vku::Allocator& allocator_;
+	const MeshPool& pool_;
+	bool mesh_shader_;
+	// drawMeshTasksEXT 의 x 상한 (maxTaskWorkGroupCount[0]). 넘으면 firstWork push constant 로 나눠 그린다
+	uint32_t max_task_work_groups_ = 0;
+
+	std::array<Frame, MAX_FRAMES_IN_FLIGHT> frames_;
+
+	vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+	vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+	vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+	vk::raii::Pipeline cull_pipeline_{ nullptr };
+
+	uint32_t cluster_count_ = 0;
+	uint32_t visible_clusters_ = 0;
+	uint32_t frustum_culled_ = 0;
+	uint32_t cone_culled_ = 0;
+	uint32_t overflow_clusters_ = 0;
+	uint64_t visible_triangles_ = 0;
+};
@@ -0,0 +1,102 @@
+#include "mesh_asset.h"
+#include "mesh_instance.h"
+
+#include "collider_set.h"
+
+namespace {
+	// 寃⑹옄 醫뚰몴 g (cell #include "mesh_asset.h"
+#include "mesh_instance.h"
+
+#include "collider_set.h"
+
+namespace {
+	// 격자 좌표 g (cell 단위) 에서 trilinear. g 는 [0, resolution - 1] 안으로 clamp 된 값
+	float SampleSdf(const float* values, const glm::uvec3& resolution, const glm::vec3& g)
+	{
+		const glm::uvec3 i0 = glm::min(glm::uvec3(g), resolution - 2u);
+		const glm::vec3 f = g - glm::vec3(i0);
+		auto at = [&](uint32_t x, uint32_t y, uint32_t z) {
+			return values[(z * resolution.y + y) * resolution.x + x];
+		};
+		const float c00 = glm::mix(at(i0.x, i0.y, i0.z), at(i0.x + 1, i0.y, i0.z), f.x);
+		const float c10 = glm::mix(at(i0.x, i0.y + 1, i0.z), at(i0.x + 1, i0.y + 1, i0.z), f.x);
+		const float c01 = glm::mix(at(i0.x, i0.y, i0.z + 1), at(i0.x + 1, i0.y, i0.z + 1), f.x);
+		const float c11 = glm::mix(at(i0.x, i0.y + 1, i0.z + 1), at(i0.x + 1, i0.y + 1, i0.z + 1), f.x);
+		return glm::mix(glm::mix(c00, c10, f.y), glm::mix(c01, c11, f.y), f.z);
+	}
+}
+
+float ColliderDistance(const Collider& collider, const float* sdfValues, const glm::vec3& p, glm::vec3& normal)
+{
+	const glm::vec3 fromCenter = p - glm::vec3(collider.sphere);
+	const float centerDistance = glm::length(fromCenter);
+	normal = centerDistance > 1e-6f ? fromCenter / centerDistance : glm::vec3(0.0f, 1.0f, 0.0f);
+	const float sphereDistance = centerDistance - collider.sphere.w;
+
+	const glm::uvec3 resolution(collider.sdf.y, collider.sdf.z, collider.sdf.w);
+	// SDF 가 없거나 bounding sphere 밖 (격자 간격만큼 여유) 이면 sphere 거리로 충분하다. 격자 간격은 local 이라 scale 을 곱한다
+	if (resolution.x < 2 || sphereDistance > collider.sdf_origin.w * collider.velocity.w) return sphereDistance;
+
+	const float* values = sdfValues + collider.sdf.x;
+	const glm::vec3 local = glm::vec3(collider.world_to_local * glm::vec4(p, 1.0f));
+	const glm::vec3 grid = (local - glm::vec3(collider.sdf_origin)) / collider.sdf_origin.w;
+	const glm::vec3 maxGrid = glm::vec3(resolution - 1u);
+	const glm::vec3 clamped = glm::clamp(grid, glm::vec3(0.0f), maxGrid);
+	// 격자 밖은 가장자리 값 + 격자까지의 거리 (bounds 밖으로 padding 을 두었으므로 거의 쓰이지 않는다)
+	const float distance = SampleSdf(values, resolution, clamped) + glm::length(grid - clamped) * collider.sdf_origin.w;
+
+	// 중앙 차분 gradient. local -> world 는 world_to_local 의 transpose (회전 + scale)
+	const glm::vec3 h(0.5f);
+	const glm::vec3 gradient(
+		SampleSdf(values, resolution, glm::min(clamped + glm::vec3(h.x, 0, 0), maxGrid)) - SampleSdf(values, resolution, glm::max(clamped - glm::vec3(h.x, 0, 0), glm::vec3(0.0f))),
+		SampleSdf(values, resolution, glm::min(clamped + glm::vec3(0, h.y, 0), maxGrid)) - SampleSdf(values, resolution, glm::max(clamped - glm::vec3(0, h.y, 0), glm::vec3(0.0f))),
+		SampleSdf(values, resolution, glm::min(clamped + glm::vec3(0, 0, h.z), maxGrid)) - SampleSdf(values, resolution, glm::max(clamped - glm::vec3(0, 0, h.z), glm::vec3(0.0f))));
+	const glm::vec3 worldGradient = glm::transpose(glm::mat3(collider.world_to_local)) * gradient;
+	const float gradientLength = glm::length(worldGradient);
+	if (gradientLength > 1e-8f) normal = worldGradient / gradientLength;
+
+	return distance * collider.velocity.w;
+}
+
+ColliderSet::ColliderSet(vku::Allocator& allocator, uint32_t capacity)
+	: capacity_(std::max(capacity, 1u))
+{
+	vku::CreateBuffer(allocator, sizeof(Collider) * capacity_ * MAX_FRAMES_IN_FLIGHT, vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer_, memory_);
+	colliders_.reserve(capacity_);
+}
+
+uint32_t ColliderSet::Prepare(uint32_t frame, const std::vector<MeshInstance>& instances, float dt, const glm::vec3& reachCenter, float reachRadius)
+{
+	if (previous_centers_.size() != instances.size()) {
+		previous_centers_.resize(instances.size());
+		for (size_t i = 0; i < instances.size(); ++i) previous_centers_[i] = instances[i].BoundsCenter();
+	}
+
+	// capacity 를 넘은 instance 도 previous center 는 갱신한다. 안 그러면 나중에 자리가 났을 때 오래된 center 로 큰 속도가 나온다
+	colliders_.clear();
+	for (size_t i = 0; i < instances.size(); ++i) {
+		const MeshInstance& instance = instances[i];
+		const glm::vec3 center = instance.BoundsCenter();
+		const float radius = instance.BoundsRadius();
+		const glm::vec3 velocity = (center - previous_centers_[i]) / dt;
+		previous_centers_[i] = center;
+		if (colliders_.size() >= capacity_) continue;
+		if (glm::length(center - reachCenter) > reachRadius + radius) continue;
+
+		const MeshAsset& mesh = *instance.mesh_;
+		// 비균일 scale 이면 local 거리에 가장 작은 축을 곱한다 (실제 거리보다 작게 : 덜 밀어낼 뿐 뚫지는 않는다)
+		const float scale = std::min({ instance.scale_.x, instance.scale_.y, instance.scale_.z });
+		colliders_.push_back(Collider{
+			.sphere = glm::vec4(center, radius),
+			.velocity = glm::vec4(velocity, scale),
+			.world_to_local = glm::inverse(instance.world_),
+			.sdf_origin = glm::vec4(mesh.sdf_.origin, mesh.sdf_.cell),
+			.sdf = glm::uvec4(mesh.first_sdf_value_, mesh.sdf_.resolution)
+		});
+	}
+
+	auto* dst = static_cast<Collider*>(memory_.Mapped()) + FirstCollider(frame);
+	std::memcpy(dst, colliders_.data(), colliders_.size() * sizeof(Collider));
+	return static_cast<uint32_t>(colliders_.size());
+}
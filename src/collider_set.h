@@ -0,0 +1,61 @@
+#pragma once
+
+class MeshInstance;
+
+#include "vulkan_utils.h"
+#include "particle_layout.h"
+
+// collision.glsl #pragma once
+
+class MeshInstance;
+
+#include "vulkan_utils.h"
+#include "particle_layout.h"
+
+// collision.glsl 의 Collider 와 같은 layout (std430)
+struct Collider
+{
+	glm::vec4 sphere;         // world space bounding sphere (xyz = 중심, w = 반지름)
+	glm::vec4 velocity;       // xyz = 지난 frame 부터의 평균 속도, w = local 거리를 world 거리로 바꾸는 scale
+	glm::mat4 world_to_local;
+	glm::vec4 sdf_origin;     // xyz = local space 격자 원점, w = 격자 간격
+	glm::uvec4 sdf;           // x = pool SDF 배열 안의 시작, yzw = 축마다 격자점 수 (0 이면 sphere 로 충돌)
+};
+static_assert(sizeof(Collider) == COLLIDER_STRIDE);
+
+// collision.glsl 의 ColliderDistance 의 CPU 구현. p 에서 collider 표면까지의 거리 (안쪽이 음수) 와 바깥 방향 normal.
+// sphere 바깥이면 SDF 를 읽지 않고 sphere 거리를 돌려준다 (항상 실제 거리 이하)
+float ColliderDistance(const Collider& collider, const float* sdfValues, const glm::vec3& p, glm::vec3& normal);
+
+// scene object 를 천 충돌용 collider 로 모은다.
+// frame slot 마다 host visible buffer 의 capacity 개 구간을 하나씩 쓰므로 descriptor 는 처음 한 번만 쓰고,
+// shader 는 SimParams::firstCollider 부터 numColliders 개를 읽는다.
+// 천이 닿을 수 없는 object 는 넣지 않으므로 object 가 많아도 particle 하나가 보는 collider 는 몇 개 안 된다.
+class ColliderSet
+{
+public:
+	// capacity : 한 frame 의 최대 collider 수 (scene 의 instance 수)
+	ColliderSet(vku::Allocator& allocator, uint32_t capacity);
+	ColliderSet(const ColliderSet& rhs) = delete;
+	ColliderSet(ColliderSet&& rhs) = delete;
+	ColliderSet& operator=(const ColliderSet& rhs) = delete;
+	ColliderSet& operator=(ColliderSet&& rhs) = delete;
+	~ColliderSet() = default;
+
+	// reach (천이 닿을 수 있는 범위의 구) 와 bounding sphere 가 겹치는 instance 를 frame slot 에 쓴다. 반환 = collider 수.
+	// 속도는 지난 Prepare 때의 위치와의 차이 / dt. frame slot 의 이전 GPU 작업이 끝난 뒤에 불러야 한다
+	uint32_t Prepare(uint32_t frame, const std::vector<MeshInstance>& instances, float dt, const glm::vec3& reachCenter, float reachRadius);
+
+	uint32_t FirstCollider(uint32_t frame) const { return frame * capacity_; }
+	// 마지막 Prepare 결과 (CPU solver 용)
+	const std::vector<Collider>& Colliders() const { return colliders_; }
+	vk::DescriptorBufferInfo BufferInfo() const { return { *buffer_, 0, VK_WHOLE_SIZE }; }
+
+private:
+	uint32_t capacity_;
+	vk::raii::Buffer buffer_{ nullptr };
+	vku::Allocation memory_;
+
+	std::vector<Collider> colliders_;
+	std::vector<glm::vec3> previous_centers_; // instance 번호마다
+};
@@ -2,33 +2,96 @@
 #include "vulkan_utils.h"
 #include "vertex.h"
 #include "camera.h"
-#include "model.h"
+#include "mesh_asset.h"
+#include "mesh_instance.h"
+#include "mesh_pool.h"
+#include "instance_culler.h"
+#include "cluster_culler.h"
+#include "hiz_pyramid.h"
 #include "texture_2d.h"
 #include "mouse_interactor.h"
+#include "cloth_constraints.h"
+#include "particle_store.h"
+#include "thread_pool.h"
+#include "cpu_cloth_solver.h"
+#include "collider_set.h"
+#include "spatial_hash.h"
+#include "gpu_profiler.h"
+#include "cpu_profiler.h"
+#include "asset_loader.h"
 
 #include "context.h"
 
-Context::Context(GLFWwindow* glfwWindow, uint32_t width, uint32_t height)
-	: glfw_window_(glfwWindow)
+Context::Context(GLFWwindow* glfwWindow, uint32_t width, uint32_t height, const AppOptions& options)
+	: glfw_window_(glfwWindow), headless_(glfwWindow == nullptr),
+	Nx(static_cast<int>(options.cloth_resolution)), Ny(static_cast<int>(options.cloth_resolution)), spacing(kClothSpacing * (kClothNx - 1) / (options.cloth_resolution - 1)),
+	sim_scheduler_(options.sim_rate, options.sim_substeps, options.sim_max_steps),
+	cpu_simulation_(options.cpu_simulation), gpu_profile_csv_(options.gpu_profile_csv), scene_objects_(options.scene_objects), cpu_culling_(options.cpu_culling), occlusion_culling_(options.occlusion_culling), lod_pixel_error_(options.lod_pixel_error), cluster_triangles_(options.cluster_triangles), allow_mesh_shader_(options.mesh_shader)
 {
+	render_ = !headless_ || options.headless_render;
+	if (headless_) {
+		// present 瑜#include "swapchain.h"
+#include "vulkan_utils.h"
+#include "vertex.h"
+#include "camera.h"
+#include "mesh_asset.h"
+#include "mesh_instance.h"
+#include "mesh_pool.h"
+#include "instance_culler.h"
+#include "cluster_culler.h"
+#include "hiz_pyramid.h"
+#include "texture_2d.h"
+#include "mouse_interactor.h"
+#include "cloth_constraints.h"
+#include "particle_store.h"
+#include "thread_pool.h"
+#include "cpu_cloth_solver.h"
+#include "collider_set.h"
+#include "spatial_hash.h"
+#include "gpu_profiler.h"
+#include "cpu_profiler.h"
+#include "asset_loader.h"
+
+#include "context.h"
+
+Context::Context(GLFWwindow* glfwWindow, uint32_t width, uint32_t height, const AppOptions& options)
+	: glfw_window_(glfwWindow), headless_(glfwWindow == nullptr),
+	Nx(static_cast<int>(options.cloth_resolution)), Ny(static_cast<int>(options.cloth_resolution)), spacing(kClothSpacing * (kClothNx - 1) / (options.cloth_resolution - 1)),
+	sim_scheduler_(options.sim_rate, options.sim_substeps, options.sim_max_steps),
+	cpu_simulation_(options.cpu_simulation), gpu_profile_csv_(options.gpu_profile_csv), scene_objects_(options.scene_objects), cpu_culling_(options.cpu_culling), occlusion_culling_(options.occlusion_culling), lod_pixel_error_(options.lod_pixel_error), cluster_triangles_(options.cluster_triangles), allow_mesh_shader_(options.mesh_shader)
+{
+	render_ = !headless_ || options.headless_render;
+	if (headless_) {
+		// present 를 하지 않으므로 swapchain extension 없이 (lavapipe 등 software ICD 포함) 장치를 고른다
+		std::erase_if(required_device_extension_, [](const char* name) { return std::strcmp(name, vk::KHRSwapchainExtensionName) == 0; });
+	}
+
 	CreateInstance();
 	SetupDebugMessenger();
-	CreateSurface();
+	if (!headless_) {
+		CreateSurface();
+	}
 	PickPhysicalDevice();
 	//msaa_samples_ = GetMaxUsableSampleCount();
 	CreateLogicalDevice();
-	swapchain_ = std::make_unique<Swapchain>(glfw_window_, device_, physical_device_, msaa_samples_, surface_);
+	allocator_ = std::make_unique<vku::Allocator>(physical_device_, device_);
+	if (headless_) {
+		CreateOffscreenTarget(width, height);
+	}
+	else {
+		swapchain_ = std::make_unique<Swapchain>(glfw_window_, device_, physical_device_, msaa_samples_, surface_);
+	}
 	CreateCommandPool();
 	CreateCommandBuffers();
-
-	{
-		models.reserve(kMaxObjects);
-
-		models.emplace_back(std::make_unique<Model>("assets/models/sphere.gltf", physical_device_, device_, queue_, command_pool_, model_count_, glm::vec3(-2.0f, 2.0f, 0.0f)));
-		models.emplace_back(std::make_unique<Model>("assets/models/sphere.gltf", physical_device_, device_, queue_, command_pool_, model_count_, glm::vec3(0.0f, 2.0f, 0.0f)));
-		models.emplace_back(std::make_unique<Model>("assets/models/sphere.gltf", physical_device_, device_, queue_, command_pool_, model_count_, glm::vec3(2.0f, 2.0f, 0.0f)));
-
-		texture_ = std::make_unique<Texture2D>("assets/textures/vulkan_cloth_rgba.ktx", physical_device_, device_, queue_, command_pool_);
+	gpu_profiler_ = std::make_unique<GpuProfiler>(physical_device_, device_, queue_index_);
+	upload_service_ = std::make_unique<UploadService>(*allocator_, queue_, queue_index_,
+		transfer_queue_index_ != ~0u ? &transfer_queue_ : nullptr, transfer_queue_index_);
+
+	thread_pool_ = std::make_unique<ThreadPool>();
+	LoadSceneAssets();
+	instance_culler_ = std::make_unique<InstanceCuller>(device_, *allocator_, *thread_pool_, gpu_culling_);
+	if (gpu_culling_) {
+		cluster_culler_ = std::make_unique<ClusterCuller>(physical_device_, device_, *allocator_, *mesh_pool_, mesh_shader_);
 	}
 
 	CreateDescriptorSetLayout();
@@ -36,146 +99,280 @@ Context::Context(GLFWwindow* glfwWindow, uint32_t width, uint32_t height)
 
 	CreateUniformBuffers();
 	CreateSSBOs();
+	CreateCpuSolver();
+
+	// 위에서 기록한 model / texture / SSBO upload 를 한 번에 submit
+	upload_service_->Wait(upload_service_->Flush());
 
 	CreateDescriptorSets();
-	//CreateComputePipelines();
+	CreateComputePipelines();
 	CreateGraphicsPipelines();
 	CreateSyncObjects();
 
+	// Hi-Z 는 GPU culling 경로에서만, depth 를 compute 에서 sampling 할 수 있을 때 (single sample)
+	const vk::FormatProperties depthProperties = physical_device_.getFormatProperties(vku::FindDepthFormat(physical_device_));
+	if (gpu_culling_ && msaa_samples_ == vk::SampleCountFlagBits::e1 &&
+		(depthProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImage)) {
+		hiz_pyramid_ = std::make_unique<HiZPyramid>(device_, *allocator_);
+	}
 	CreateDepthResources();
 
-	SetupImgui(swapchain_->swapchain_extent_.width, swapchain_->swapchain_extent_.height);
+	if (!headless_) {
+		SetupImgui(RenderExtent().width, RenderExtent().height);
+	}
 }
 
 void Context::WaitIdle()
 {
+	std::lock_guard queueLock(upload_service_->QueueMutex());
 	device_.waitIdle();
 }
 
 Context::~Context()
 {
-	ImGui_ImplVulkan_Shutdown();
-	ImGui_ImplGlfw_Shutdown();
-	ImGui::DestroyContext();
+	if (gpu_profiler_ && !gpu_profile_csv_.empty()) {
+		std::lock_guard queueLock(upload_service_->QueueMutex());
+		device_.waitIdle();
+		gpu_profiler_->WriteCsv(gpu_profile_csv_);
+	}
+
+	if (!headless_) {
+		ImGui_ImplVulkan_Shutdown();
+		ImGui_ImplGlfw_Shutdown();
+		ImGui::DestroyContext();
+	}
+}
+
+vk::Extent2D Context::RenderExtent() const
+{
+	return headless_ ? offscreen_.extent : swapchain_->swapchain_extent_;
+}
+
+vk::Format Context::ColorFormat() const
+{
+	return headless_ ? offscreen_.format : swapchain_->swapchain_surface_format_.format;
+}
+
+vk::Image Context::ColorImage(uint32_t imageIndex) const
+{
+	return headless_ ? *offscreen_.image : swapchain_->swapchain_images_[imageIndex];
+}
+
+vk::ImageView Context::ColorImageView(uint32_t imageIndex) const
+{
+	return headless_ ? *offscreen_.image_view : *swapchain_->swapchain_image_views_[imageIndex];
 }
 
 void Context::Update(Camera& camera, MouseInteractor& mouse_interactor, float dt)
 {
+	PE_CPU_SCOPE("Context::Update");
+
+	// 아래에서 current_frame_ slot 의 UBO 를 쓰므로 그 slot 의 이전 frame 이 끝났는지 먼저 확인
+	WaitForFrameSlot();
+
 	UpdateMouseInteractor(camera, mouse_interactor);
+	sim_steps_ = sim_scheduler_.Advance(dt);
+	UpdateComputeUBO();
 	UpdateGraphicsUBO(camera);
+
+	if (cpu_simulation_) {
+		PE_CPU_SCOPE("CpuClothSolver::Step");
+		for (uint32_t step = 0; step < sim_steps_; ++step) {
+			if (step + 1 == sim_steps_) {
+				cpu_previous_positions_ = cpu_solver_->Positions();
+			}
+			for (uint32_t substep = 0; substep < sim_scheduler_.Substeps(); ++substep) {
+				cpu_solver_->Step(compute_.sim_params);
+			}
+		}
+	}
 }
 
 void Context::Draw()
 {
-	DrawImgui();
-
-	auto [result, imageIndex] = swapchain_->swapchain_.acquireNextImage(UINT64_MAX, nullptr, in_flight_fences_[current_frame_]);
-
-	while (vk::Result::eTimeout == device_.waitForFences(*in_flight_fences_[current_frame_], vk::True, UINT64_MAX));
-	device_.resetFences(*in_flight_fences_[current_frame_]);
-
-	//uint64_t computeWaitValue = timeline_value_;
-	//uint64_t computeSignalValue = ++timeline_value_;
-	//uint64_t graphicsWaitValue = computeSignalValue;
-	//uint64_t graphicsSignalValue = ++timeline_value_;
-
-	//RecordXPBDComputeCommandBuffer();
-	//{
-	//	// Submit compute work
-	//	vk::TimelineSemaphoreSubmitInfo computeTimelineInfo{
-	//		.waitSemaphoreValueCount = 1,
-	//		.pWaitSemaphoreValues = &computeWaitValue,
-	//		.signalSemaphoreValueCount = 1,
-	//		.pSignalSemaphoreValues = &computeSignalValue
-	//	};
-
-	//	vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eComputeShader };
-
-	//	vk::SubmitInfo computeSubmitInfo{
-	//		.pNext = &computeTimelineInfo,
-	//		.waitSemaphoreCount = 1,
-	//		.pWaitSemaphores = &*semaphore_,
-	//		.pWaitDstStageMask = waitStages,
-	//		.commandBufferCount = 1,
-	//		.pCommandBuffers = &*compute_.command_buffers[current_frame_],
-	//		.signalSemaphoreCount = 1,
-	//		.pSignalSemaphores = &*semaphore_
-	//	};
-
-	//	queue_.submit(computeSubmitInfo, nullptr);
-	//}
-
-	uint64_t graphicsWaitValue = timeline_value_;
-	uint64_t graphicsSignalValue = ++timeline_value_;
-
-	RecordGraphicsCommandBuffer(imageIndex);
+	PE_CPU_SCOPE("Context::Draw");
+
+	RecordFrameTime();
+	WaitForFrameSlot();
+
+	uint32_t imageIndex = 0;
+
+	if (!headless_) {
+		DrawImgui();
+
+		// fence 없이 binary semaphore 로만 acquire. 실제 image 사용은 graphics submit 이 GPU 에서 기다린다
+		try {
+			PE_CPU_SCOPE("AcquireNextImage");
+			vk::Result result;
+			std::tie(result, imageIndex) = swapchain_->swapchain_.acquireNextImage(UINT64_MAX, *image_available_semaphores_[current_frame_], nullptr);
+		}
+		catch (const vk::OutOfDateKHRError&) {
+			RecreateSwapchainResources();
+			return;
+		}
+	}
+
+	uint64_t computeWaitValue = timeline_value_;
+	uint64_t computeSignalValue = ++timeline_value_;
+
+	RecordComputeCommandBuffer();
 	{
-		vk::PipelineStageFlags graphicsWaitStage = vk::PipelineStageFlagBits::eVertexInput;
-		vk::TimelineSemaphoreSubmitInfo timelineInfo{
+		// Submit compute work
+		vk::TimelineSemaphoreSubmitInfo computeTimelineInfo{
 			.waitSemaphoreValueCount = 1,
-			.pWaitSemaphoreValues = &graphicsWaitValue,
+			.pWaitSemaphoreValues = &computeWaitValue,
 			.signalSemaphoreValueCount = 1,
-			.pSignalSemaphoreValues = &graphicsSignalValue
+			.pSignalSemaphoreValues = &computeSignalValue
 		};
 
-		vk::SubmitInfo submitInfo{
-			.pNext = &timelineInfo,
+		// CPU 모드에서는 compute 대신 transfer(copy) 가 이전 frame 의 graphics 를 기다린다.
+		// GPU 모드도 previous stream 으로의 copy 가 이전 frame 의 vertex shader 읽기 뒤에 와야 한다
+		vk::PipelineStageFlags waitStages[] = { cpu_simulation_ ? vk::PipelineStageFlagBits::eTransfer : vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eTransfer };
+
+		vk::SubmitInfo computeSubmitInfo{
+			.pNext = &computeTimelineInfo,
 			.waitSemaphoreCount = 1,
 			.pWaitSemaphores = &*semaphore_,
-			.pWaitDstStageMask = &graphicsWaitStage,
+			.pWaitDstStageMask = waitStages,
 			.commandBufferCount = 1,
-			.pCommandBuffers = &*graphics_.command_buffers[current_frame_],
+			.pCommandBuffers = &*compute_.command_buffers[current_frame_],
 			.signalSemaphoreCount = 1,
 			.pSignalSemaphores = &*semaphore_
 		};
+
+		std::lock_guard queueLock(upload_service_->QueueMutex());
+		queue_.submit(computeSubmitInfo, nullptr);
+	}
+
+	uint64_t graphicsSignalValue = render_ ? ++timeline_value_ : computeSignalValue;
+
+	if (render_) {
+		// ImGui backend 가 texture upload 를 queue_ 에 직접 submit 할 수 있으므로 기록할 때부터 잡는다
+		std::lock_guard queueLock(upload_service_->QueueMutex());
+		RecordGraphicsCommandBuffer(imageIndex);
+
+		// timeline (compute 결과) + acquire 한 image. headless 는 swapchain semaphore 없이 timeline 만
+		std::array<vk::Semaphore, 2> waitSemaphores{ *semaphore_, nullptr };
+		std::array<uint64_t, 2> waitValues{ computeSignalValue, 0 };
+		std::array<vk::PipelineStageFlags, 2> waitStages{ vk::PipelineStageFlagBits::eVertexInput, vk::PipelineStageFlagBits::eColorAttachmentOutput };
+		std::array<vk::Semaphore, 2> signalSemaphores{ *semaphore_, nullptr };
+		std::array<uint64_t, 2> signalValues{ graphicsSignalValue, 0 };
+		uint32_t binaryCount = 0;
+		if (!headless_) {
+			waitSemaphores[1] = *image_available_semaphores_[current_frame_];
+			signalSemaphores[1] = *render_finished_semaphores_[imageIndex];
+			binaryCount = 1;
+		}
+
+		vk::TimelineSemaphoreSubmitInfo timelineInfo{
+			.waitSemaphoreValueCount = 1 + binaryCount,
+			.pWaitSemaphoreValues = waitValues.data(),
+			.signalSemaphoreValueCount = 1 + binaryCount,
+			.pSignalSemaphoreValues = signalValues.data()
+		};
+
+		vk::SubmitInfo submitInfo{
+			.pNext = &timelineInfo,
+			.waitSemaphoreCount = 1 + binaryCount,
+			.pWaitSemaphores = waitSemaphores.data(),
+			.pWaitDstStageMask = waitStages.data(),
+			.commandBufferCount = 1,
+			.pCommandBuffers = &*graphics_.command_buffers[current_frame_],
+			.signalSemaphoreCount = 1 + binaryCount,
+			.pSignalSemaphores = signalSemaphores.data()
+		};
 		queue_.submit(submitInfo, nullptr);
 	}
+	gpu_profiler_->EndFrame();
 
-	{
+	// 이 slot 은 graphicsSignalValue 에 도달해야 다시 쓸 수 있다 (MAX_FRAMES_IN_FLIGHT frame 뒤에 WaitForFrameSlot 에서 확인)
+	frame_timeline_values_[current_frame_] = graphicsSignalValue;
+
+	if (serialize_frames_) {
+		// 비교용 : 예전처럼 매 frame GPU 가 끝날 때까지 기다린다
 		vk::SemaphoreWaitInfo waitInfo{
 			.semaphoreCount = 1,
 			.pSemaphores = &*semaphore_,
 			.pValues = &graphicsSignalValue
 		};
+		PE_CPU_SCOPE("WaitSemaphores");
 		while (vk::Result::eTimeout == device_.waitSemaphores(waitInfo, UINT64_MAX));
+	}
+
+	current_frame_ = (current_frame_ + 1) % MAX_FRAMES_IN_FLIGHT;
+
+	if (!headless_) {
 		vk::PresentInfoKHR presentInfo{
-				.waitSemaphoreCount = 0, // No binary semaphores needed
-				.pWaitSemaphores = nullptr,
+				.waitSemaphoreCount = 1,
+				.pWaitSemaphores = &*render_finished_semaphores_[imageIndex],
 				.swapchainCount = 1,
 				.pSwapchains = &*swapchain_->swapchain_,
 				.pImageIndices = &imageIndex
 		};
 
 		try {
-			result = queue_.presentKHR(presentInfo);
-			if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || framebuffer_resized_) {
+			PE_CPU_SCOPE("Present");
+			vk::Result result;
+			{
+				// RecreateSwapchainResources 가 다시 잡으므로 present 만
+				std::lock_guard queueLock(upload_service_->QueueMutex());
+				result = queue_.presentKHR(presentInfo);
+			}
+			if (result == vk::Result::eSuboptimalKHR || framebuffer_resized_) {
 				framebuffer_resized_ = false;
-				swapchain_->RecreateSwapChain(physical_device_, device_, surface_);
-				depth_image_ = nullptr;
-				depth_image_memory_ = nullptr;
-				depth_image_view_ = nullptr;
-				CreateDepthResources();
+				RecreateSwapchainResources();
 			}
 			else if (result != vk::Result::eSuccess) {
 				throw std::runtime_error("failed to present swap chain image!");
 			}
 		}
-		catch (const vk::SystemError& e) {
-			if (e.code().value() == static_cast<int>(vk::Result::eErrorOutOfDateKHR)) {
-				swapchain_->RecreateSwapChain(physical_device_, device_, surface_);
-				depth_image_ = nullptr;
-				depth_image_memory_ = nullptr;
-				depth_image_view_ = nullptr;
-				CreateDepthResources();
-				return;
-			}
-			else {
-				throw;
-			}
+		catch (const vk::OutOfDateKHRError&) {
+			RecreateSwapchainResources();
 		}
 	}
+}
 
-	current_frame_ = (current_frame_ + 1) % MAX_FRAMES_IN_FLIGHT;
+void Context::WaitForFrameSlot()
+{
+	// 이 slot 의 UBO / command buffer / upload buffer 를 마지막으로 쓴 frame (N - MAX_FRAMES_IN_FLIGHT) 만 기다린다
+	const uint64_t value = frame_timeline_values_[current_frame_];
+	if (value == 0) return;
+
+	vk::SemaphoreWaitInfo waitInfo{
+		.semaphoreCount = 1,
+		.pSemaphores = &*semaphore_,
+		.pValues = &value
+	};
+	PE_CPU_SCOPE("WaitFrameSlot");
+	while (vk::Result::eTimeout == device_.waitSemaphores(waitInfo, UINT64_MAX));
+}
+
+void Context::RecreateSwapchainResources()
+{
+	// RecreateSwapChain 안에서 waitIdle 하므로 present semaphore 도 안전하게 다시 만들 수 있다
+	swapchain_->RecreateSwapChain(physical_device_, device_, surface_, upload_service_->QueueMutex());
+	for (DepthTarget& depth : depth_targets_) {
+		depth.view = nullptr;
+		depth.image = nullptr;
+		depth.memory = nullptr;
+	}
+	CreateDepthResources();
+
+	render_finished_semaphores_.clear();
+	for (size_t i = 0; i < swapchain_->swapchain_images_.size(); ++i) {
+		render_finished_semaphores_.emplace_back(device_, vk::SemaphoreCreateInfo{});
+	}
+}
+
+void Context::RecordFrameTime()
+{
+	const auto now = std::chrono::steady_clock::now();
+	if (last_frame_time_ != std::chrono::steady_clock::time_point{}) {
+		frame_times_ms_[frame_time_next_] = std::chrono::duration<float, std::milli>(now - last_frame_time_).count();
+		frame_time_next_ = (frame_time_next_ + 1) % kFrameTimeHistory;
+		frame_time_count_ = std::min(frame_time_count_ + 1, kFrameTimeHistory);
+	}
+	last_frame_time_ = now;
 }
 
 // vk::Image Transition
@@ -256,6 +453,8 @@ void Context::TransitionImageLayoutCustom(
 
 void Context::DrawImgui()
 {
+	PE_CPU_SCOPE("Context::DrawImgui");
+
 	ImGui_ImplVulkan_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
@@ -266,19 +465,168 @@ void Context::DrawImgui()
 		ImGuiIO& io = ImGui::GetIO(); (void)io;
 		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
 
+		if (ImGui::CollapsingHeader("Cloth", ImGuiTreeNodeFlags_DefaultOpen)) {
+			auto& sim = compute_.sim_params;
+
+			sim_scheduler_.DrawImgui();
+
+			const char* solverModes[] = { "Gauss-Seidel (graph coloring)", "Jacobi (atomic)" };
+			int solverMode = static_cast<int>(sim.solverMode);
+			if (ImGui::Combo("Solver", &solverMode, solverModes, IM_ARRAYSIZE(solverModes))) {
+				sim.solverMode = static_cast<SolverMode>(solverMode);
+			}
+
+			int numIters = static_cast<int>(sim.numIters);
+			if (ImGui::SliderInt("Iterations", &numIters, 1, 64)) {
+				sim.numIters = static_cast<uint32_t>(numIters);
+			}
+			if (sim.solverMode == SolverMode::Jacobi) {
+				ImGui::SliderFloat("Relaxation", &sim.relaxation, 0.1f, 2.0f);
+			}
+
+			ImGui::Checkbox("Collisions", &cloth_collisions_);
+			if (cloth_collisions_) {
+				ImGui::SameLine();
+				ImGui::Text("(%u colliders)", sim.numColliders);
+				ImGui::SliderFloat("Friction", &sim.friction, 0.0f, 1.0f);
+				ImGui::SliderFloat("Restitution", &sim.restitution, 0.0f, 1.0f);
+				ImGui::SliderFloat("Thickness", &sim.collisionMargin, 0.0f, 0.05f, "%.3f");
+			}
+
+			ImGui::Checkbox("Self collision", &cloth_self_collision_);
+			if (cloth_self_collision_) {
+				ImGui::SameLine();
+				ImGui::Text("(%u buckets)", spatial_hash_->TableSize());
+				ImGui::SliderFloat("Self distance", &self_collision_distance_, 0.1f * spacing, spacing, "%.4f");
+			}
+
+			const uint32_t dispatchesPerIter = (sim.solverMode == SolverMode::GaussSeidel
+				? static_cast<uint32_t>(cloth_constraints_->batches_.size())
+				: 2u) + (sim.numColliders > 0 ? 1u : 0u) + (sim.selfCollisionDistance > 0.0f ? 2u : 0u);
+			ImGui::Text("Particles %d, Constraints %zu, Colors %zu", max_particle_size, cloth_constraints_->constraints_.size(), cloth_constraints_->batches_.size());
+			if (cpu_simulation_) {
+				ImGui::Text("Backend : CPU (%u worker threads)", thread_pool_->ThreadCount());
+			}
+			else {
+				ImGui::Text("Solver dispatches / frame : %u", dispatchesPerIter * sim.numIters * sim_steps_ * sim_scheduler_.Substeps());
+
+				// GPU 결과를 CPU reference solver 와 비교
+				ImGui::SeparatorText("CPU reference");
+				ImGui::InputInt("Steps", &cpu_validation_steps_);
+				cpu_validation_steps_ = std::max(cpu_validation_steps_, 1);
+				ImGui::InputFloat("Tolerance", &cpu_validation_tolerance_, 0.0f, 0.0f, "%.1e");
+				if (ImGui::Button("Validate GPU vs CPU")) {
+					ValidateAgainstCpu(static_cast<uint32_t>(cpu_validation_steps_), cpu_validation_tolerance_);
+				}
+				if (!cpu_validation_result_.empty()) {
+					ImGui::TextUnformatted(cpu_validation_result_.c_str());
+				}
+			}
+		}
+
+		if (ImGui::CollapsingHeader("Scene")) {
+			ImGui::Text("Meshes %zu, Instances %zu", draw_batches_.size(), instances_.size());
+			ImGui::Text("Visible : %u instances, %u draws (%s culling)", instance_culler_->VisibleInstances(), instance_culler_->VisibleDraws(),
+				instance_culler_->GpuCulling() ? "GPU" : "CPU");
+			if (hiz_pyramid_) {
+				ImGui::Checkbox("Occlusion culling (Hi-Z)", &occlusion_culling_);
+				ImGui::Text("Occluded : %u instances, Hi-Z %u levels", instance_culler_->OccludedInstances(), hiz_pyramid_->LevelCount());
+			}
+			ImGui::SliderFloat("LOD pixel error", &lod_pixel_error_, 0.0f, 8.0f, "%.1f px");
+			uint64_t triangles = instance_culler_->VisibleTriangles();
+			if (cluster_culler_ && cluster_culler_->ClusterCount() > 0) {
+				ImGui::Text("Clusters : %u / %u visible, %u frustum, %u backface (%s)", cluster_culler_->VisibleClusters(), cluster_culler_->ClusterCount(),
+					cluster_culler_->FrustumCulled(), cluster_culler_->ConeCulled(), cluster_culler_->MeshShader() ? "mesh shader" : "compute");
+				if (cluster_culler_->OverflowClusters() > 0) {
+					ImGui::Text("Clusters not drawn (buffer full) : %u", cluster_culler_->OverflowClusters());
+				}
+				triangles += cluster_culler_->VisibleTriangles();
+			}
+			ImGui::Text("Triangles : %llu", static_cast<unsigned long long>(triangles));
+		}
+
+		if (ImGui::CollapsingHeader("Frame Pacing", ImGuiTreeNodeFlags_DefaultOpen)) {
+			DrawFramePacingImgui();
+		}
+
+		if (ImGui::CollapsingHeader("GPU Memory")) {
+			allocator_->DrawImgui();
+			ImGui::Text("Uploads: %u submits, %.2f MiB (%s queue)", upload_service_->SubmitCount(),
+				upload_service_->UploadedBytes() / (1024.0 * 1024.0), upload_service_->UsesTransferQueue() ? "transfer" : "graphics");
+		}
+
+		if (ImGui::CollapsingHeader("GPU Profiler", ImGuiTreeNodeFlags_DefaultOpen)) {
+			gpu_profiler_->DrawImgui();
+		}
+
+#if PE_CPU_PROFILER_ENABLED
+		if (ImGui::Button("Export CPU trace (F9)")) {
+			CpuProfiler::WriteChromeTrace("cpu_trace.json");
+		}
+#endif
+
 		ImGui::End();
 	}
 
 	ImGui::Render();
 }
 
+void Context::DrawFramePacingImgui()
+{
+	ImGui::Checkbox("Serialize CPU / GPU", &serialize_frames_);
+	ImGui::Text("Frames in flight : %d", serialize_frames_ ? 1 : MAX_FRAMES_IN_FLIGHT);
+	if (frame_time_count_ == 0) return;
+
+	// 시간 순서대로 펼친 최근 frame time
+	std::array<float, kFrameTimeHistory> ordered{};
+	const uint32_t first = (frame_time_next_ + kFrameTimeHistory - frame_time_count_) % kFrameTimeHistory;
+	for (uint32_t i = 0; i < frame_time_count_; ++i) {
+		ordered[i] = frame_times_ms_[(first + i) % kFrameTimeHistory];
+	}
+
+	std::vector<float> sorted(ordered.begin(), ordered.begin() + frame_time_count_);
+	std::sort(sorted.begin(), sorted.end());
+	float sum = 0.0f;
+	for (float ms : sorted) sum += ms;
+	const float avg = sum / sorted.size();
+	const float p99 = sorted[std::min(sorted.size() - 1, static_cast<size_t>(sorted.size() * 0.99f))];
+	ImGui::Text("avg %.2f ms, min %.2f ms, p99 %.2f ms", avg, sorted.front(), p99);
+
+	ImGui::PlotLines("##frame_times", ordered.data(), static_cast<int>(frame_time_count_), 0, "frame time (ms)", 0.0f, std::max(33.3f, sorted.back()), ImVec2(0, 60));
+
+	// 0.5 ms 단위 분포. 마지막 bucket 은 그 이상 전부
+	constexpr int kBuckets = 66;
+	std::array<float, kBuckets> histogram{};
+	for (float ms : sorted) {
+		histogram[std::min(static_cast<int>(ms * 2.0f), kBuckets - 1)] += 1.0f;
+	}
+	ImGui::PlotHistogram("##frame_histogram", histogram.data(), kBuckets, 0, "0 - 33 ms (0.5 ms buckets)", 0.0f, FLT_MAX, ImVec2(0, 60));
+}
+
 void Context::UpdateMouseInteractor(Camera& camera, MouseInteractor& mouse_interactor)
 {
-	mouse_interactor.Update(camera, glm::vec2(swapchain_->swapchain_extent_.width, swapchain_->swapchain_extent_.height), models);
+	mouse_interactor.Update(camera, glm::vec2(RenderExtent().width, RenderExtent().height), instances_);
 }
 
 void Context::UpdateComputeUBO()
 {
+	// substep 하나의 dt. 프레임이 길게 멈춰도 step 수는 SimScheduler 가 제한한다
+	compute_.sim_params.dt = sim_scheduler_.SubstepDt();
+	compute_.sim_params.numParticles = static_cast<uint32_t>(max_particle_size);
+
+	// 마우스로 옮긴 object 도 이번 step 부터 바로 반영 (속도는 collider 기준 상대 속도 계산용).
+	// step 이 없는 frame 은 건너뛰어서 그동안 움직인 거리는 다음 step 이 있는 frame 이 꺼낸 시간으로 나눈다.
+	// 진행한 step 만이 아니라 버린 step 의 시간도 포함해야 밀린 frame 에서 속도가 부풀지 않는다
+	if (sim_steps_ > 0) {
+		const uint32_t colliderCount = collider_set_->Prepare(current_frame_, instances_, sim_scheduler_.ElapsedTime(), cloth_reach_center_, cloth_reach_radius_);
+		compute_.sim_params.numColliders = cloth_collisions_ ? colliderCount : 0u;
+	}
+	compute_.sim_params.firstCollider = collider_set_->FirstCollider(current_frame_);
+	compute_.sim_params.selfCollisionDistance = cloth_self_collision_ ? self_collision_distance_ : 0.0f;
+
+	const uint32_t simOffset = static_cast<uint32_t>(current_frame_ * compute_.sim_params_slot_size);
+	auto* dst = static_cast<std::byte*>(compute_.sim_params_ubo_mapped) + simOffset;
+	std::memcpy(dst, &compute_.sim_params, sizeof(SimParams));
 }
 
 void Context::AddComputeToComputeBarrier(const vk::raii::CommandBuffer& cmd, vk::Buffer buffer)
@@ -287,7 +635,7 @@ void Context::AddComputeToComputeBarrier(const vk::raii::CommandBuffer& cmd, vk:
 		.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
 		.srcAccessMask = vk::AccessFlagBits2::eShaderWrite, // 이전 작업: 셰이더 쓰기
 		.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
-		.dstAccessMask = vk::AccessFlagBits2::eShaderRead,  // 다음 작업: 셰이더 읽기
+		.dstAccessMask = vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite,  // 다음 작업: 셰이더 읽기/쓰기
 		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
 		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
 		.buffer = buffer,
@@ -316,6 +664,24 @@ void Context::AddGraphicsToComputeBarrier(const vk::raii::CommandBuffer& cmd, vk
 	cmd.pipelineBarrier2(dependencyInfo);
 }
 
+// CPU solver 결과 copy -> 그래픽스 (vertex shader 읽기)
+void Context::AddTransferToGraphicsBarrier(const vk::raii::CommandBuffer& cmd, vk::Buffer buffer)
+{
+	vk::BufferMemoryBarrier2 bufferBarrier{
+		.srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+		.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+		.dstStageMask = vk::PipelineStageFlagBits2::eVertexShader,
+		.dstAccessMask = vk::AccessFlagBits2::eShaderRead,
+		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.buffer = buffer,
+		.offset = 0,
+		.size = VK_WHOLE_SIZE
+	};
+	vk::DependencyInfo dependencyInfo{ .bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &bufferBarrier };
+	cmd.pipelineBarrier2(dependencyInfo);
+}
+
 // 컴퓨트 -> 그래픽스 큐로 자원 소유권 이전 (Release)
 void Context::AddComputeToGraphicsBarrier(const vk::raii::CommandBuffer& cmd, vk::Buffer buffer)
 {
@@ -336,85 +702,337 @@ void Context::AddComputeToGraphicsBarrier(const vk::raii::CommandBuffer& cmd, vk
 
 void Context::UpdateGraphicsUBO(Camera& camera)
 {
+	PE_CPU_SCOPE("Context::UpdateGraphicsUBO");
+
 	// Global UBO 쓰기
 	{
 		const uint32_t globalOffset = static_cast<uint32_t>(current_frame_ * graphics_.global_slot_size);
 		auto* dst = static_cast<std::byte*>(graphics_.global_ubo_mapped) + globalOffset;
 
 		graphics_.global_ubo_data.view = camera.View();
-		graphics_.global_ubo_data.proj = camera.Proj(swapchain_->swapchain_extent_.width, swapchain_->swapchain_extent_.height);
+		graphics_.global_ubo_data.proj = camera.Proj(RenderExtent().width, RenderExtent().height);
 
 		std::memcpy(dst, &graphics_.global_ubo_data, sizeof(Graphics::GlobalUboData));
 		// HostCoherent라 flush 생략, 비-coherent면 flush 필요
 	}
 
-	// Object UBO 쓰기
+	// Instance 쓰기 (CPU culling 이면 판정까지). buffer 가 커졌으면 이 slot 의 object set 도 다시 쓴다
 	{
-		const uint32_t baseObjectOffset = static_cast<uint32_t>(current_frame_ * graphics_.object_slot_size * kMaxObjects);
-		for (uint32_t i = 0; i < model_count_; i++)
-		{
-			const uint32_t objOff = baseObjectOffset + i * static_cast<uint32_t>(graphics_.object_slot_size);
-			auto* dst = static_cast<std::byte*>(graphics_.object_ubo_mapped) + objOff;
+		const glm::mat4 viewProj = graphics_.global_ubo_data.proj * graphics_.global_ubo_data.view;
+		const float lodScale = InstanceCuller::LodScale(camera.fov, RenderExtent().height, lod_pixel_error_);
+		if (instance_culler_->Prepare(current_frame_, instances_, draw_batches_, viewProj, camera.position, lodScale)) {
+			WriteInstanceDescriptor(current_frame_);
+		}
+		if (cluster_culler_) {
+			cluster_culler_->Prepare(current_frame_, draw_batches_, viewProj, camera.position);
+		}
+	}
+}
+
+void Context::RecordComputeCommandBuffer()
+{
+	PE_CPU_SCOPE("Context::RecordComputeCommandBuffer");
+
+	const auto& cmd = compute_.command_buffers[current_frame_];
 
-			graphics_.object_ubo_data.model = models[i]->world_;
+	cmd.reset();
+	cmd.begin({});
 
-			std::memcpy(dst, &graphics_.object_ubo_data, sizeof(Graphics::ObjectUboData));
+	// frame 의 첫 command buffer 이므로 여기서 이 slot 의 timestamp query 를 회수 / reset
+	gpu_profiler_->BeginFrame(cmd, current_frame_);
+
+	if (cpu_simulation_) {
+		// Update() 에서 진행한 CPU solver 결과를 position / previous stream 으로 복사
+		const vk::DeviceSize range = particle_store_->Range();
+		auto* dst = static_cast<std::byte*>(cpu_upload_buffers_mapped_[current_frame_]);
+		std::memcpy(dst, cpu_solver_->Positions().data(), range);
+		std::memcpy(dst + range, cpu_previous_positions_.data(), range);
+		GpuScope scope(gpu_profiler_.get(), cmd, "Cloth upload");
+		std::array copies{
+			vk::BufferCopy(0, particle_store_->Offset(ParticleStore::Stream::Positions), range),
+			vk::BufferCopy(range, particle_store_->Offset(ParticleStore::Stream::Previous), range)
+		};
+		cmd.copyBuffer(*cpu_upload_buffers_[current_frame_], particle_store_->Buffer(), copies);
+		AddTransferToGraphicsBarrier(cmd, particle_store_->Buffer());
+	}
+	else {
+		// step x substep. 단계별 scope 는 첫 substep 만 재고 frame 전체는 "Cloth sim" 으로
+		GpuScope scope(gpu_profiler_.get(), cmd, "Cloth sim");
+		const uint32_t simOffset = static_cast<uint32_t>(current_frame_ * compute_.sim_params_slot_size);
+		for (uint32_t step = 0; step < sim_steps_; ++step) {
+			if (step + 1 == sim_steps_) {
+				RecordSavePreviousPositions(cmd);
+			}
+			for (uint32_t substep = 0; substep < sim_scheduler_.Substeps(); ++substep) {
+				RecordClothStep(cmd, simOffset, step == 0 && substep == 0);
+				AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+			}
 		}
+		AddComputeToGraphicsBarrier(cmd, particle_store_->Buffer());
 	}
+
+	cmd.end();
+}
+
+// position -> previous. 마지막 step 의 velocity pass 가 position 을 덮어쓰기 전에 (그릴 때 두 상태를 보간)
+void Context::RecordSavePreviousPositions(const vk::raii::CommandBuffer& cmd)
+{
+	const vk::Buffer buffer = particle_store_->Buffer();
+	vk::BufferMemoryBarrier2 before{
+		.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+		.srcAccessMask = vk::AccessFlagBits2::eShaderWrite,
+		.dstStageMask = vk::PipelineStageFlagBits2::eTransfer,
+		.dstAccessMask = vk::AccessFlagBits2::eTransferRead,
+		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.buffer = buffer,
+		.offset = 0,
+		.size = VK_WHOLE_SIZE
+	};
+	cmd.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &before });
+
+	cmd.copyBuffer(buffer, buffer, vk::BufferCopy(particle_store_->Offset(ParticleStore::Stream::Positions),
+		particle_store_->Offset(ParticleStore::Stream::Previous), particle_store_->Range()));
+
+	// 이후 velocity pass 의 position 쓰기가 copy 의 읽기를 앞지르지 않도록
+	vk::BufferMemoryBarrier2 after{
+		.srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+		.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+		.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+		.dstAccessMask = vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite,
+		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.buffer = buffer,
+		.offset = 0,
+		.size = VK_WHOLE_SIZE
+	};
+	cmd.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &after });
+}
+
+void Context::RecordClothStep(const vk::raii::CommandBuffer& cmd, uint32_t simOffset, bool profile)
+{
+	GpuProfiler* profiler = profile ? gpu_profiler_.get() : nullptr;
+	const uint32_t particleGroups = (static_cast<uint32_t>(max_particle_size) + 127) / 128;
+
+	const float selfDistance = compute_.sim_params.selfCollisionDistance;
+
+	// SpatialHash 가 자기 set 을 bind 하므로 그 뒤에 다시
+	auto bindClothSets = [&]() {
+		cmd.bindDescriptorSets(
+			vk::PipelineBindPoint::eCompute,
+			compute_.pipeline_layouts.cloth,
+			0,
+			{ *compute_.sim_params_set, *compute_.cloth_compute_set },
+			{ simOffset }
+		);
+	};
+
+	// iteration 마다 distance constraint 다음에 collider 밖으로 밀어내고, 천끼리 겹친 곳을 밀어낸다
+	auto recordCollisions = [&]() {
+		if (compute_.sim_params.numColliders > 0) {
+			cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_.pipelines.collide);
+			cmd.dispatch(particleGroups, 1, 1);
+			AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+		}
+		if (selfDistance > 0.0f) {
+			spatial_hash_->RecordSolve(cmd, selfDistance);
+			bindClothSets();
+			cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_.pipelines.self_collision_apply);
+			cmd.dispatch(particleGroups, 1, 1);
+			AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+		}
+	};
+
+	bindClothSets();
+
+	// 1. Predict : v += g*dt, p = x + v*dt
+	{
+		GpuScope scope(profiler, cmd, "Cloth integrate");
+		cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_.pipelines.integrate);
+		cmd.dispatch(particleGroups, 1, 1);
+		AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+	}
+
+	// 1.5. Self-collision hash grid : predicted 위치 기준으로 step 에 한 번
+	if (selfDistance > 0.0f) {
+		GpuScope scope(profiler, cmd, "Cloth hash build");
+		spatial_hash_->RecordBuild(cmd, selfDistance);
+		bindClothSets();
+	}
+
+	// 2. Constraint projection
+	{
+		GpuScope scope(profiler, cmd, "Cloth solve");
+		if (compute_.sim_params.solverMode == SolverMode::GaussSeidel) {
+			// numIters x color 마다 dispatch 1번
+			for (uint32_t iter = 0; iter < compute_.sim_params.numIters; ++iter) {
+				cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_.pipelines.solve);
+				for (const auto& batch : cloth_constraints_->batches_) {
+					Compute::SolvePushConstants pc{ .first = batch.first, .count = batch.count, .iteration = iter };
+					cmd.pushConstants<Compute::SolvePushConstants>(*compute_.pipeline_layouts.cloth, vk::ShaderStageFlagBits::eCompute, 0, pc);
+					cmd.dispatch((batch.count + 127) / 128, 1, 1);
+					AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+					AddComputeToComputeBarrier(cmd, *lambdas_ssbo_);
+				}
+				recordCollisions();
+			}
+		}
+		else {
+			// numIters x (전체 constraint 누적 dispatch + particle 별 적용 dispatch)
+			const uint32_t constraintCount = static_cast<uint32_t>(cloth_constraints_->constraints_.size());
+			for (uint32_t iter = 0; iter < compute_.sim_params.numIters; ++iter) {
+				Compute::SolvePushConstants pc{ .first = 0, .count = constraintCount, .iteration = iter };
+				cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_.pipelines.jacobi_solve);
+				cmd.pushConstants<Compute::SolvePushConstants>(*compute_.pipeline_layouts.cloth, vk::ShaderStageFlagBits::eCompute, 0, pc);
+				cmd.dispatch((constraintCount + 127) / 128, 1, 1);
+				AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+				AddComputeToComputeBarrier(cmd, *lambdas_ssbo_);
+
+				cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_.pipelines.jacobi_apply);
+				cmd.dispatch(particleGroups, 1, 1);
+				AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+				recordCollisions();
+			}
+		}
+	}
+
+	// 3. Velocity update : v = (p - x) / dt, x = p (접촉 중이면 restitution / friction)
+	{
+		GpuScope scope(profiler, cmd, "Cloth velocity");
+		cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_.pipelines.velocity);
+		cmd.dispatch(particleGroups, 1, 1);
+	}
+}
+
+bool Context::ValidateAgainstCpu(uint32_t steps, float tolerance)
+{
+	if (cpu_simulation_) {
+		cpu_validation_result_ = "FAIL : no GPU solver (CPU simulation)";
+		std::cout << "cloth validation " << cpu_validation_result_ << std::endl;
+		return false;
+	}
+
+	{
+		std::lock_guard queueLock(upload_service_->QueueMutex());
+		device_.waitIdle();
+	}
+
+	// GPU 와 CPU 를 같은 초기 상태, 같은 고정 dt (substep 하나) 로 N step 진행
+	const std::vector<glm::vec4> initial = BuildClothParticles(Nx, Ny, spacing);
+	particle_store_->Upload(*upload_service_, initial);
+	upload_service_->Wait(upload_service_->Flush());
+
+	SimParams params = compute_.sim_params;
+	params.dt = sim_scheduler_.SubstepDt();
+	params.numParticles = static_cast<uint32_t>(max_particle_size);
+
+	const uint32_t simOffset = static_cast<uint32_t>(current_frame_ * compute_.sim_params_slot_size);
+	std::memcpy(static_cast<std::byte*>(compute_.sim_params_ubo_mapped) + simOffset, &params, sizeof(SimParams));
+
+	const auto& cmd = compute_.command_buffers[current_frame_];
+	cmd.reset();
+	cmd.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+	for (uint32_t step = 0; step < steps; ++step) {
+		RecordClothStep(cmd, simOffset);
+		AddComputeToComputeBarrier(cmd, particle_store_->Buffer());
+	}
+	cmd.end();
+
+	std::vector<glm::vec4> gpuPositions;
+	{
+		std::lock_guard queueLock(upload_service_->QueueMutex());
+		queue_.submit(vk::SubmitInfo{ .commandBufferCount = 1, .pCommandBuffers = &*cmd }, nullptr);
+		queue_.waitIdle();
+		gpuPositions = particle_store_->Download(*allocator_, queue_, command_pool_, ParticleStore::Stream::Positions);
+	}
+
+	CpuClothSolver reference(initial, *cloth_constraints_, *thread_pool_);
+	reference.SetColliders(collider_set_->Colliders(), mesh_pool_->SdfValues());
+	for (uint32_t step = 0; step < steps; ++step) {
+		reference.Step(params);
+	}
+
+	const float maxDiff = CpuClothSolver::MaxDifference(gpuPositions, reference.Positions());
+	const bool pass = maxDiff <= tolerance;
+	char result[128];
+	std::snprintf(result, sizeof(result), "%s : %u steps, max |gpu - cpu| = %.3g (tolerance %.3g)",
+		pass ? "PASS" : "FAIL", steps, maxDiff, tolerance);
+	cpu_validation_result_ = result;
+	std::cout << "cloth validation " << cpu_validation_result_ << std::endl;
+	return pass;
 }
 
 void Context::RecordGraphicsCommandBuffer(uint32_t imageIndex)
 {
+	PE_CPU_SCOPE("Context::RecordGraphicsCommandBuffer");
+
 	const auto& cmd = graphics_.command_buffers[current_frame_];
 
 	cmd.reset();
 	cmd.begin({});
 
-	TransitionImageLayout(
-		swapchain_->swapchain_images_[imageIndex],
-		cmd,
-		vk::ImageLayout::eUndefined,
-		vk::ImageLayout::eColorAttachmentOptimal,
-		{},
-		vk::AccessFlagBits2::eColorAttachmentWrite,
-		vk::PipelineStageFlagBits2::eTopOfPipe,
-		vk::PipelineStageFlagBits2::eColorAttachmentOutput
-	);
+	vk::Image colorImage = ColorImage(imageIndex);
+	const vk::Extent2D extent = RenderExtent();
 
-	// Transition the depth image to DEPTH_ATTACHMENT_OPTIMAL
-	TransitionImageLayoutCustom(
-		depth_image_,
-		cmd,
-		vk::ImageLayout::eUndefined,
-		vk::ImageLayout::eDepthAttachmentOptimal,
-		{},
-		vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
-		vk::PipelineStageFlagBits2::eTopOfPipe,
-		vk::PipelineStageFlagBits2::eEarlyFragmentTests,
-		vk::ImageAspectFlagBits::eDepth
-	);
+	DepthTarget& depth = depth_targets_[current_frame_];
+	const bool occlusion = hiz_pyramid_ && occlusion_culling_;
+
+	// rendering 밖에서 instance cull / compact (CPU culling 이면 아무 것도 기록하지 않음).
+	// occlusion culling 이면 지난번에 보였던 instance 만 먼저 그리고, 나머지는 그 depth 로 만든 Hi-Z 로 판정한다
+	instance_culler_->RecordCull(cmd, current_frame_, gpu_profiler_.get(),
+		occlusion ? InstanceCuller::Pass::PreviouslyVisible : InstanceCuller::Pass::Frustum);
+	if (cluster_culler_) {
+		cluster_culler_->RecordCull(cmd, current_frame_, gpu_profiler_.get());
+	}
+
+	{
+		GpuScope scope(gpu_profiler_.get(), cmd, "Layout transitions (begin)");
+		TransitionImageLayout(
+			colorImage,
+			cmd,
+			vk::ImageLayout::eUndefined,
+			vk::ImageLayout::eColorAttachmentOptimal,
+			{},
+			vk::AccessFlagBits2::eColorAttachmentWrite,
+			vk::PipelineStageFlagBits2::eTopOfPipe,
+			vk::PipelineStageFlagBits2::eColorAttachmentOutput
+		);
+
+		// Transition the depth image to DEPTH_ATTACHMENT_OPTIMAL
+		TransitionImageLayoutCustom(
+			depth.image,
+			cmd,
+			vk::ImageLayout::eUndefined,
+			vk::ImageLayout::eDepthAttachmentOptimal,
+			{},
+			vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+			vk::PipelineStageFlagBits2::eTopOfPipe,
+			vk::PipelineStageFlagBits2::eEarlyFragmentTests,
+			vk::ImageAspectFlagBits::eDepth
+		);
+	}
 
 	vk::ClearValue clearColor = vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f);
 	vk::ClearValue clearDepth = vk::ClearDepthStencilValue(1.0f, 0);
 
 	vk::RenderingAttachmentInfo colorAttachmentInfo = {
-		.imageView = swapchain_->swapchain_image_views_[imageIndex],
+		.imageView = ColorImageView(imageIndex),
 		.imageLayout = vk::ImageLayout::eColorAttachmentOptimal,
 		.loadOp = vk::AttachmentLoadOp::eClear,
 		.storeOp = vk::AttachmentStoreOp::eStore,
 		.clearValue = clearColor
 	};
-	// Depth attachment
+	// Depth attachment. Hi-Z 가 읽으므로 store
 	vk::RenderingAttachmentInfo depthAttachmentInfo = {
-		.imageView = depth_image_view_,
+		.imageView = depth.view,
 		.imageLayout = vk::ImageLayout::eDepthAttachmentOptimal,
 		.loadOp = vk::AttachmentLoadOp::eClear,
-		.storeOp = vk::AttachmentStoreOp::eDontCare,
+		.storeOp = vk::AttachmentStoreOp::eStore,
 		.clearValue = clearDepth
 	};
 	vk::RenderingInfo renderingInfo = {
 		.renderArea = {.offset = { 0, 0 },
-		.extent = swapchain_->swapchain_extent_ },
+		.extent = extent },
 		.layerCount = 1,
 		.colorAttachmentCount = 1,
 		.pColorAttachments = &colorAttachmentInfo,
@@ -424,19 +1042,20 @@ void Context::RecordGraphicsCommandBuffer(uint32_t imageIndex)
 
 	vk::Viewport vp(
 		0.0f,
-		static_cast<float>(swapchain_->swapchain_extent_.height), // y = H
-		static_cast<float>(swapchain_->swapchain_extent_.width),
-		-static_cast<float>(swapchain_->swapchain_extent_.height), // height = -H
+		static_cast<float>(extent.height), // y = H
+		static_cast<float>(extent.width),
+		-static_cast<float>(extent.height), // height = -H
 		0.0f, 1.0f
 	);
 	cmd.setViewport(0, vp);
-	cmd.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), swapchain_->swapchain_extent_));
+	cmd.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
 
 	uint32_t globalOffset = static_cast<uint32_t>(current_frame_ * graphics_.global_slot_size);
-	const uint32_t baseObjectOffset = static_cast<uint32_t>(current_frame_ * graphics_.object_slot_size * kMaxObjects);
 
 	// Cloth
 	{
+		GpuScope scope(gpu_profiler_.get(), cmd, "Cloth draw");
+
 		cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *graphics_.pipelines.cloth);
 
 		// Global Set
@@ -452,65 +1071,144 @@ void Context::RecordGraphicsCommandBuffer(uint32_t imageIndex)
 			graphics_.pipeline_layouts.cloth,
 			1,
 			{ *graphics_.cloth_set },
-			{ 0 }
+			{}
 		);
+		cmd.pushConstants<float>(*graphics_.pipeline_layouts.cloth, vk::ShaderStageFlagBits::eVertex, 0, sim_scheduler_.Alpha());
 
 		cmd.bindIndexBuffer(*particle_index_buffer_, 0, vk::IndexType::eUint32);
 		cmd.drawIndexed(indices_size, 1, 0, 0, 0);
 	}
 
-	// Model
-	{
-		cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *graphics_.pipelines.model);
-
-		// Global Set
-		cmd.bindDescriptorSets(
-			vk::PipelineBindPoint::eGraphics,
-			graphics_.pipeline_layouts.model,
-			0,
-			{ *graphics_.global_set },
-			{ globalOffset }
+	RecordModelDraw(cmd, globalOffset, "Model draw");
+	// cluster 는 첫 pass 에서만 그린다 (occlusion pass 의 Hi-Z occluder 가 된다)
+	RecordClusterDraw(cmd, globalOffset);
+
+	if (occlusion) {
+		cmd.endRendering();
+
+		// cloth + 지난번에 보였던 model 의 depth 로 Hi-Z 를 만들고 나머지 instance 를 판정
+		TransitionImageLayoutCustom(
+			depth.image,
+			cmd,
+			vk::ImageLayout::eDepthAttachmentOptimal,
+			vk::ImageLayout::eShaderReadOnlyOptimal,
+			vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+			vk::AccessFlagBits2::eShaderSampledRead,
+			vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+			vk::PipelineStageFlagBits2::eComputeShader,
+			vk::ImageAspectFlagBits::eDepth
 		);
+		hiz_pyramid_->Build(cmd, current_frame_, gpu_profiler_.get());
+		TransitionImageLayoutCustom(
+			depth.image,
+			cmd,
+			vk::ImageLayout::eShaderReadOnlyOptimal,
+			vk::ImageLayout::eDepthAttachmentOptimal,
+			{},
+			vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+			vk::PipelineStageFlagBits2::eComputeShader,
+			vk::PipelineStageFlagBits2::eEarlyFragmentTests,
+			vk::ImageAspectFlagBits::eDepth
+		);
+		instance_culler_->RecordCull(cmd, current_frame_, gpu_profiler_.get(), InstanceCuller::Pass::Occlusion);
 
-		for (uint32_t i = 0; i < model_count_; ++i) {
-			uint32_t objectOffset = baseObjectOffset + i * static_cast<uint32_t>(graphics_.object_slot_size);
+		// 첫 pass 의 color / depth 위에 이어서 그린다. 이후로 depth 를 읽는 곳은 없다
+		colorAttachmentInfo.loadOp = vk::AttachmentLoadOp::eLoad;
+		depthAttachmentInfo.loadOp = vk::AttachmentLoadOp::eLoad;
+		depthAttachmentInfo.storeOp = vk::AttachmentStoreOp::eDontCare;
+		cmd.beginRendering(renderingInfo);
+		cmd.setViewport(0, vp);
+		cmd.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), extent));
 
-			std::array<uint32_t, 2> dynOffsets{ globalOffset, objectOffset };
+		RecordModelDraw(cmd, globalOffset, "Model draw (occlusion)");
+	}
 
-			// Object set
-			cmd.bindDescriptorSets(
-				vk::PipelineBindPoint::eGraphics,
-				graphics_.pipeline_layouts.model,
-				1,
-				{ *graphics_.object_set },
-				{ objectOffset }   // ← Set 1에도 동적 바인딩 1개 → 오프셋 1개만
-			);
+	// Imgui Render
+	if (!headless_) {
+		GpuScope scope(gpu_profiler_.get(), cmd, "ImGui");
+		ImDrawData* draw_data = ImGui::GetDrawData();
+		ImGui_ImplVulkan_RenderDrawData(draw_data, *cmd);
+	}
+
+	cmd.endRendering();
 
-			cmd.bindVertexBuffers(0, { models[i]->vertex_buffer_ }, { 0 });
-			cmd.bindIndexBuffer(*models[i]->index_buffer_, 0, vk::IndexType::eUint32);
-			cmd.drawIndexed(models[i]->indices_.size(), 1, 0, 0, 0);
+	{
+		GpuScope scope(gpu_profiler_.get(), cmd, "Layout transitions (end)");
+		if (headless_) {
+			// offscreen image 는 SaveOffscreenImage 에서 읽을 수 있도록 TRANSFER_SRC 로
+			TransitionImageLayout(
+				colorImage,
+				cmd,
+				vk::ImageLayout::eColorAttachmentOptimal,
+				vk::ImageLayout::eTransferSrcOptimal,
+				vk::AccessFlagBits2::eColorAttachmentWrite,
+				vk::AccessFlagBits2::eTransferRead,
+				vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+				vk::PipelineStageFlagBits2::eTransfer
+			);
+		}
+		else {
+			// After rendering, transition the swapchain image to PRESENT_SRC
+			TransitionImageLayout(
+				colorImage,
+				cmd,
+				vk::ImageLayout::eColorAttachmentOptimal,
+				vk::ImageLayout::ePresentSrcKHR,
+				vk::AccessFlagBits2::eColorAttachmentWrite,
+				{},
+				vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+				vk::PipelineStageFlagBits2::eBottomOfPipe
+			);
 		}
 	}
+	cmd.end();
 
-	// Imgui Render
-	ImDrawData* draw_data = ImGui::GetDrawData();
-	ImGui_ImplVulkan_RenderDrawData(draw_data, *cmd);
+}
 
-	cmd.endRendering();
+void Context::RecordModelDraw(const vk::raii::CommandBuffer& cmd, uint32_t globalOffset, const char* scopeName)
+{
+	GpuScope scope(gpu_profiler_.get(), cmd, scopeName);
 
-	// After rendering, transition the swapchain image to PRESENT_SRC
-	TransitionImageLayout(
-		swapchain_->swapchain_images_[imageIndex],
-		cmd,
-		vk::ImageLayout::eColorAttachmentOptimal,
-		vk::ImageLayout::ePresentSrcKHR,
-		vk::AccessFlagBits2::eColorAttachmentWrite,
-		{},
-		vk::PipelineStageFlagBits2::eColorAttachmentOutput,
-		vk::PipelineStageFlagBits2::eBottomOfPipe
+	cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *graphics_.pipelines.model);
+
+	// Global Set
+	cmd.bindDescriptorSets(
+		vk::PipelineBindPoint::eGraphics,
+		graphics_.pipeline_layouts.model,
+		0,
+		{ *graphics_.global_set },
+		{ globalOffset }
 	);
-	cmd.end();
 
+	// Object set : 이 frame slot 의 instance / visible SSBO + sampler. object 수와 무관하게 한 번만 bind
+	cmd.bindDescriptorSets(
+		vk::PipelineBindPoint::eGraphics,
+		graphics_.pipeline_layouts.model,
+		1,
+		{ *graphics_.object_sets[current_frame_] },
+		{}
+	);
+
+	// 모든 mesh 가 한 pool 에 있으므로 bind 한 번 + culling 에서 살아남은 draw 를 indirect 로 한 번에
+	mesh_pool_->Bind(cmd);
+	instance_culler_->RecordDraw(cmd, current_frame_);
+}
+
+void Context::RecordClusterDraw(const vk::raii::CommandBuffer& cmd, uint32_t globalOffset)
+{
+	if (!cluster_culler_ || cluster_culler_->ClusterCount() == 0) return;
+
+	GpuScope scope(gpu_profiler_.get(), cmd, "Cluster draw");
+
+	cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, *graphics_.pipelines.cluster);
+	cmd.bindDescriptorSets(
+		vk::PipelineBindPoint::eGraphics,
+		graphics_.pipeline_layouts.cluster,
+		0,
+		{ *graphics_.global_set, *graphics_.object_sets[current_frame_] },
+		{ globalOffset }
+	);
+	cluster_culler_->RecordDraw(cmd, current_frame_, graphics_.pipeline_layouts.cluster);
 }
 
 void Context::CreateInstance() {
@@ -564,10 +1262,12 @@ void Context::CreateInstance() {
 }
 
 std::vector<const char*> Context::GetRequiredExtensions() {
-	uint32_t glfwExtensionCount = 0;
-	auto glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-	std::vector extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+	std::vector<const char*> extensions;
+	if (!headless_) {
+		uint32_t glfwExtensionCount = 0;
+		auto glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+	}
 	if (enableValidationLayers) {
 		extensions.push_back(vk::EXTDebugUtilsExtensionName);
 	}
@@ -631,13 +1331,15 @@ void Context::PickPhysicalDevice() {
 					});
 
 			auto features = device.template getFeatures2<vk::PhysicalDeviceFeatures2,
+				vk::PhysicalDeviceVulkan12Features,
 				vk::PhysicalDeviceVulkan13Features,
-				vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-				vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>();
+				vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
 			bool supportsRequiredFeatures = features.template get<vk::PhysicalDeviceFeatures2>().features.samplerAnisotropy &&
+				features.template get<vk::PhysicalDeviceFeatures2>().features.multiDrawIndirect &&
+				features.template get<vk::PhysicalDeviceFeatures2>().features.drawIndirectFirstInstance &&
+				features.template get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore &&
 				features.template get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering &&
-				features.template get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState &&
-				features.template get<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>().timelineSemaphore;
+				features.template get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState;
 
 			return supportsVulkan1_3 && supportsGraphics && supportsAllRequiredExtensions && supportsRequiredFeatures;
 		});
@@ -673,7 +1375,7 @@ void Context::CreateLogicalDevice() {
 	{
 		if ((queueFamilyProperties[qfpIndex].queueFlags & vk::QueueFlagBits::eGraphics) &&
 			(queueFamilyProperties[qfpIndex].queueFlags & vk::QueueFlagBits::eCompute) &&
-			physical_device_.getSurfaceSupportKHR(qfpIndex, *surface_))
+			(headless_ || physical_device_.getSurfaceSupportKHR(qfpIndex, *surface_)))
 		{
 			// found a queue family that supports both graphics and present
 			queue_index_ = qfpIndex;
@@ -681,22 +1383,74 @@ void Context::CreateLogicalDevice() {
 		}
 	}
 	if (queue_index_ == ~0)
+	{
+		// compute 를 지원하는 queue 가 없으면 CPU solver 로 시뮬레이션
+		for (uint32_t qfpIndex = 0; qfpIndex < queueFamilyProperties.size(); qfpIndex++)
+		{
+			if ((queueFamilyProperties[qfpIndex].queueFlags & vk::QueueFlagBits::eGraphics) &&
+				(headless_ || physical_device_.getSurfaceSupportKHR(qfpIndex, *surface_)))
+			{
+				queue_index_ = qfpIndex;
+				cpu_simulation_ = true;
+				std::cout << "no graphics + compute queue, falling back to the CPU cloth solver" << std::endl;
+				break;
+			}
+		}
+	}
+	if (queue_index_ == ~0)
 	{
 		throw std::runtime_error("Could not find a queue for graphics and present -> terminating");
 	}
 
+	// 전용 transfer family (보통 DMA engine) 가 있으면 upload 를 graphics queue 와 겹쳐 돌린다
+	for (uint32_t qfpIndex = 0; qfpIndex < queueFamilyProperties.size(); qfpIndex++)
+	{
+		const vk::QueueFlags flags = queueFamilyProperties[qfpIndex].queueFlags;
+		if ((flags & vk::QueueFlagBits::eTransfer) && !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute)))
+		{
+			transfer_queue_index_ = qfpIndex;
+			break;
+		}
+	}
+
+	// drawIndirectCount 가 있으면 instance culling 을 compute 로, 없으면 CPU 에서
+	auto supported = physical_device_.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>();
+	gpu_culling_ = !cpu_culling_ && supported.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount;
+
+	// VK_EXT_mesh_shader (task + mesh) 가 있으면 cluster 를 mesh shader 로 그린다. cluster 는 GPU culling 경로에서만
+	if (gpu_culling_ && allow_mesh_shader_) {
+		const auto extensions = physical_device_.enumerateDeviceExtensionProperties();
+		const bool hasExtension = std::ranges::any_of(extensions,
+			[](const vk::ExtensionProperties& extension) { return std::strcmp(extension.extensionName, vk::EXTMeshShaderExtensionName) == 0; });
+		if (hasExtension) {
+			auto meshFeatures = physical_device_.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceMeshShaderFeaturesEXT>();
+			mesh_shader_ = meshFeatures.get<vk::PhysicalDeviceMeshShaderFeaturesEXT>().taskShader &&
+				meshFeatures.get<vk::PhysicalDeviceMeshShaderFeaturesEXT>().meshShader;
+		}
+	}
+	if (mesh_shader_) {
+		required_device_extension_.push_back(vk::EXTMeshShaderExtensionName);
+	}
+
 	// query for Vulkan 1.3 features
 	vk::StructureChain<vk::PhysicalDeviceFeatures2,
+		vk::PhysicalDeviceVulkan12Features,
 		vk::PhysicalDeviceVulkan13Features,
 		vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
-		vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>
+		vk::PhysicalDeviceMeshShaderFeaturesEXT>
 		featureChain = {
 			{
 				.features = {
 					.sampleRateShading = vk::True,
+					.multiDrawIndirect = vk::True,
+					.drawIndirectFirstInstance = vk::True,
 					.samplerAnisotropy = vk::True
 				}
 			},
+			{
+				.drawIndirectCount = gpu_culling_ ? vk::True : vk::False,
+				.timelineSemaphore = vk::True
+			},
 			{
 				.synchronization2 = vk::True,
 				.dynamicRendering = vk::True
@@ -705,21 +1459,31 @@ void Context::CreateLogicalDevice() {
 				.extendedDynamicState = vk::True
 			},
 			{
-				.timelineSemaphore = true
+				.taskShader = vk::True,
+				.meshShader = vk::True
 			}
 	};
+	if (!mesh_shader_) {
+		featureChain.unlink<vk::PhysicalDeviceMeshShaderFeaturesEXT>();
+	}
 
 	// create a Device
 	float                     queuePriority = 0.0f;
-	vk::DeviceQueueCreateInfo deviceQueueCreateInfo{ .queueFamilyIndex = queue_index_, .queueCount = 1, .pQueuePriorities = &queuePriority };
+	std::vector<vk::DeviceQueueCreateInfo> deviceQueueCreateInfos{ { .queueFamilyIndex = queue_index_, .queueCount = 1, .pQueuePriorities = &queuePriority } };
+	if (transfer_queue_index_ != ~0u) {
+		deviceQueueCreateInfos.push_back({ .queueFamilyIndex = transfer_queue_index_, .queueCount = 1, .pQueuePriorities = &queuePriority });
+	}
 	vk::DeviceCreateInfo      deviceCreateInfo{ .pNext = &featureChain.get<vk::PhysicalDeviceFeatures2>(),
-												.queueCreateInfoCount = 1,
-												.pQueueCreateInfos = &deviceQueueCreateInfo,
+												.queueCreateInfoCount = static_cast<uint32_t>(deviceQueueCreateInfos.size()),
+												.pQueueCreateInfos = deviceQueueCreateInfos.data(),
 												.enabledExtensionCount = static_cast<uint32_t>(required_device_extension_.size()),
 												.ppEnabledExtensionNames = required_device_extension_.data() };
 
 	device_ = vk::raii::Device(physical_device_, deviceCreateInfo);
 	queue_ = vk::raii::Queue(device_, queue_index_, 0);
+	if (transfer_queue_index_ != ~0u) {
+		transfer_queue_ = vk::raii::Queue(device_, transfer_queue_index_, 0);
+	}
 }
 
 
@@ -740,6 +1504,16 @@ void Context::CreateCommandBuffers()
 		allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
 		graphics_.command_buffers = vk::raii::CommandBuffers(device_, allocInfo);
 	}
+
+	// Compute
+	{
+		compute_.command_buffers.clear();
+		vk::CommandBufferAllocateInfo allocInfo{};
+		allocInfo.commandPool = *command_pool_;
+		allocInfo.level = vk::CommandBufferLevel::ePrimary;
+		allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+		compute_.command_buffers = vk::raii::CommandBuffers(device_, allocInfo);
+	}
 }
 
 void Context::CreateDescriptorSetLayout()
@@ -756,15 +1530,17 @@ void Context::CreateDescriptorSetLayout()
 		graphics_.global_set_layout = vk::raii::DescriptorSetLayout(device_, layoutInfo);
 	}
 
-	// Object UBO + Sampler - Graphics
+	// Instance / Visible SSBO + Sampler - Graphics
 	{
 		std::array layoutBindings{
-			vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex, nullptr),
-			vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment, nullptr)
+			vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex, nullptr),
+			vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment, nullptr),
+			vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eVertex, nullptr)
 		};
-		counts_.ubo_dynamic += 1;
-		counts_.sampler += 1;
-		counts_.layout += 1;
+		// frame slot 마다 set 하나
+		counts_.sb += 2 * MAX_FRAMES_IN_FLIGHT;
+		counts_.sampler += MAX_FRAMES_IN_FLIGHT;
+		counts_.layout += MAX_FRAMES_IN_FLIGHT;
 
 		vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = static_cast<uint32_t>(layoutBindings.size()), .pBindings = layoutBindings.data() };
 		graphics_.object_set_layout = vk::raii::DescriptorSetLayout(device_, layoutInfo);
@@ -786,12 +1562,12 @@ void Context::CreateDescriptorSetLayout()
 
 		// Cloth Compute - Compute
 		{
-			std::array layoutBindings{
-				vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute },
-				vk::DescriptorSetLayoutBinding{ 1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute },
-				vk::DescriptorSetLayoutBinding{ 2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute }
-			};
-			counts_.sb += 3;
+			// particle_layout.h : particle stream 들 + constraints + lambdas + colliders + SDF
+			std::array<vk::DescriptorSetLayoutBinding, CLOTH_BINDING_COUNT> layoutBindings;
+			for (uint32_t binding = 0; binding < CLOTH_BINDING_COUNT; ++binding) {
+				layoutBindings[binding] = vk::DescriptorSetLayoutBinding{ binding, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute };
+			}
+			counts_.sb += CLOTH_BINDING_COUNT;
 			counts_.layout += 1;
 
 			vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = static_cast<uint32_t>(layoutBindings.size()), .pBindings = layoutBindings.data() };
@@ -801,13 +1577,12 @@ void Context::CreateDescriptorSetLayout()
 		// Cloth Rendering - Graphics
 		{
 			std::array<vk::DescriptorSetLayoutBinding, 3> layoutBindings{
-				vk::DescriptorSetLayoutBinding{ 0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex },
 				vk::DescriptorSetLayoutBinding{ 1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment },
-				vk::DescriptorSetLayoutBinding{ 2, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eVertex }
+				vk::DescriptorSetLayoutBinding{ 2, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eVertex },
+				vk::DescriptorSetLayoutBinding{ 3, vk::DescriptorType::eStorageBuffer,        1, vk::ShaderStageFlagBits::eVertex }
 			};
-			counts_.ubo_dynamic += 1;
 			counts_.sampler += 1;
-			counts_.sb += 1;
+			counts_.sb += 2;
 			counts_.layout += 1;
 
 			vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = static_cast<uint32_t>(layoutBindings.size()), .pBindings = layoutBindings.data() };
@@ -871,7 +1646,7 @@ void Context::CreateUniformBuffers()
 	// Global
 	{
 		graphics_.global_ubo.clear();
-		graphics_.global_ubo_memory.clear();
+		graphics_.global_ubo_memory.Reset();
 		graphics_.global_ubo_mapped = nullptr;
 
 		auto limits = physical_device_.getProperties().limits;
@@ -880,49 +1655,35 @@ void Context::CreateUniformBuffers()
 		vk::DeviceSize totalSize = graphics_.global_slot_size * MAX_FRAMES_IN_FLIGHT;
 
 		vk::raii::Buffer buffer({});
-		vk::raii::DeviceMemory bufferMem({});
-		vku::CreateBuffer(physical_device_, device_, totalSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, bufferMem);
+		vku::Allocation bufferMem;
+		vku::CreateBuffer(*allocator_, totalSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, bufferMem);
 		graphics_.global_ubo = std::move(buffer);
 		graphics_.global_ubo_memory = std::move(bufferMem);
-		graphics_.global_ubo_mapped = graphics_.global_ubo_memory.mapMemory(0, totalSize);
+		graphics_.global_ubo_mapped = graphics_.global_ubo_memory.Mapped();
 	}
 
-	// Object
-	{
-		graphics_.object_ubo.clear();
-		graphics_.object_ubo_memory.clear();
-		graphics_.object_ubo_mapped = nullptr;
-
-		auto limits = physical_device_.getProperties().limits;
-		graphics_.object_slot_size = (sizeof(Graphics::ObjectUboData) + limits.minUniformBufferOffsetAlignment - 1)
-			& ~(limits.minUniformBufferOffsetAlignment - 1);
-		vk::DeviceSize totalSize = graphics_.object_slot_size * MAX_FRAMES_IN_FLIGHT * kMaxObjects;
-
-		vk::raii::Buffer buffer({});
-		vk::raii::DeviceMemory bufferMem({});
-		vku::CreateBuffer(physical_device_, device_, totalSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, bufferMem);
-		graphics_.object_ubo = std::move(buffer);
-		graphics_.object_ubo_memory = std::move(bufferMem);
-		graphics_.object_ubo_mapped = graphics_.object_ubo_memory.mapMemory(0, totalSize);
+	// Instance / culling buffer (frame slot 마다, 이후 Update 에서 필요할 때 키움)
+	for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+		instance_culler_->Prepare(frame, instances_, draw_batches_, glm::mat4(1.0f));
 	}
 
 	// Sim Params
 	{
 		compute_.sim_params_ubo.clear();
-		compute_.sim_params_ubo_memory.clear();
+		compute_.sim_params_ubo_memory.Reset();
 		compute_.sim_params_ubo_mapped = nullptr;
 
 		auto limits = physical_device_.getProperties().limits;
-		compute_.sim_params_slot_size = (sizeof(Compute::SimParams) + limits.minUniformBufferOffsetAlignment - 1)
+		compute_.sim_params_slot_size = (sizeof(SimParams) + limits.minUniformBufferOffsetAlignment - 1)
 			& ~(limits.minUniformBufferOffsetAlignment - 1);
 		vk::DeviceSize totalSize = compute_.sim_params_slot_size * MAX_FRAMES_IN_FLIGHT;
 
 		vk::raii::Buffer buffer({});
-		vk::raii::DeviceMemory bufferMem({});
-		vku::CreateBuffer(physical_device_, device_, totalSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, bufferMem);
+		vku::Allocation bufferMem;
+		vku::CreateBuffer(*allocator_, totalSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, bufferMem);
 		compute_.sim_params_ubo = std::move(buffer);
 		compute_.sim_params_ubo_memory = std::move(bufferMem);
-		compute_.sim_params_ubo_mapped = compute_.sim_params_ubo_memory.mapMemory(0, totalSize);
+		compute_.sim_params_ubo_mapped = compute_.sim_params_ubo_memory.Mapped();
 	}
 }
 
@@ -931,36 +1692,23 @@ void Context::CreateSSBOs()
 	// Particle
 	{
 		{
-			// 천의 실제 크기
-			const float width = spacing * (Nx - 1);
-			const float height = spacing * (Ny - 1);
-
-			// 카메라가 (0,0,4) 에 있고 -Z를 보니, 천을 z=0 평면에 두면 정면으로 보임.
-			// 배치 방식 2가지 중 택1:
-
-			// (A) 화면 중심에 천 중심이 오도록 (가운데 정렬)
-			const float originX = -width * 0.5f;
-			const float originY = -height * 0.5f;
-			const float zPlane = 0.0f;
-
 			auto idx = [&](int x, int y) { return y * Nx + x; };
 
-			positions_.resize(Nx * Ny);
-			velocities_.resize(Nx * Ny);
-			predicted_.resize(Nx * Ny);
-			for (int y = 0; y < Ny; ++y)
-				for (int x = 0; x < Nx; ++x) {
-					const int id = idx(x, y);
-
-					// XY 평면(z=0), 카메라 정면(-Z)에서 보임
-					float px = originX + x * spacing;
-					float py = originY + y * spacing;
-					float pz = zPlane;
-
-					positions_[id] = { originX + x * spacing, originY + y * spacing, 0.0f, 1.0f };
-					velocities_[id] = { 0,0,0,0 };
-					predicted_[id] = { 0,0,0,0 };
-				}
+			std::vector<glm::vec4> positions = BuildClothParticles(Nx, Ny, spacing);
+			particle_store_ = std::make_unique<ParticleStore>(*allocator_, *upload_service_, positions);
+			spatial_hash_ = std::make_unique<SpatialHash>(device_, *allocator_, *upload_service_, *particle_store_, positions);
+			self_collision_distance_ = 0.5f * spacing;
+
+			// 모든 particle 은 constraint 로 고정점에 이어져 있으므로 고정점에서 격자 대각선 (늘어나는 여유 25%) 이상 멀어지지 않는다
+			std::vector<glm::vec3> pinned;
+			for (const glm::vec4& p : positions) {
+				if (p.w == 0.0f) pinned.emplace_back(p);
+			}
+			cloth_reach_center_ = glm::vec3(0.0f);
+			for (const glm::vec3& p : pinned) cloth_reach_center_ += p / static_cast<float>(pinned.size());
+			cloth_reach_radius_ = 0.0f;
+			for (const glm::vec3& p : pinned) cloth_reach_radius_ = std::max(cloth_reach_radius_, glm::length(p - cloth_reach_center_));
+			cloth_reach_radius_ += 1.25f * spacing * std::sqrt(static_cast<float>((Nx - 1) * (Nx - 1) + (Ny - 1) * (Ny - 1)));
 
 			indices_size = (Nx - 1) * (Ny - 1) * 6;
 			indices_.reserve(indices_size);
@@ -977,45 +1725,182 @@ void Context::CreateSSBOs()
 				}
 			}
 
-			vku::CreateIndexBuffer(physical_device_, device_, queue_, command_pool_, indices_, particle_index_buffer_, particle_index_buffer_memory_);
+			vku::CreateIndexBuffer(*allocator_, *upload_service_, indices_, particle_index_buffer_, particle_index_buffer_memory_);
 		}
 
-		// SSBO
+		// Constraint
 		{
-			vk::DeviceSize bufferSize = sizeof(glm::vec4) * max_particle_size;
-
-			// Position
-			vku::CreateSSBO(physical_device_, device_, queue_, command_pool_,
-				bufferSize,
-				vk::BufferUsageFlagBits::eTransferSrc,
-				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-				positions_,
-				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
-				vk::MemoryPropertyFlagBits::eDeviceLocal,
-				positions_ssbo_, positions_ssbo_memory_);
-
-			// Velocity
-			vku::CreateSSBO(physical_device_, device_, queue_, command_pool_,
-				bufferSize,
-				vk::BufferUsageFlagBits::eTransferSrc,
-				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-				velocities_,
+			cloth_constraints_ = std::make_unique<ClothConstraints>();
+			cloth_constraints_->Build(Nx, Ny, spacing);
+			if (!ClothConstraints::Validate(cloth_constraints_->constraints_, cloth_constraints_->batches_, static_cast<uint32_t>(max_particle_size))) {
+				throw std::runtime_error("failed to build race-free cloth constraint batches!");
+			}
+
+			auto& constraints = cloth_constraints_->constraints_;
+			lambdas_.assign(constraints.size(), 0.0f);
+
+			vku::CreateSSBO(*allocator_, *upload_service_,
+				sizeof(DistanceConstraint) * constraints.size(),
+				constraints,
 				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
 				vk::MemoryPropertyFlagBits::eDeviceLocal,
-				velocities_ssbo_, velocities_ssbo_memory_);
-
-			// Predicted position
-			vku::CreateSSBO(physical_device_, device_, queue_, command_pool_,
-				bufferSize,
-				vk::BufferUsageFlagBits::eTransferSrc,
-				vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-				predicted_,
+				constraints_ssbo_, constraints_ssbo_memory_);
+
+			vku::CreateSSBO(*allocator_, *upload_service_,
+				sizeof(float) * lambdas_.size(),
+				lambdas_,
 				vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
 				vk::MemoryPropertyFlagBits::eDeviceLocal,
-				predicted_ssbo_, predicted_ssbo_memory_);
+				lambdas_ssbo_, lambdas_ssbo_memory_);
+		}
+	}
+}
+
+void Context::LoadSceneAssets()
+{
+	PE_CPU_SCOPE("Context::LoadSceneAssets");
 
+	// object 는 (mesh 번호, 위치) 만 가진다. object 수가 많아도 decode / GPU buffer 는 mesh 경로 수만큼
+	const std::vector<std::string> meshPaths = { "assets/models/sphere.gltf" };
+	struct ObjectRequest {
+		uint32_t mesh;
+		glm::vec3 position;
+	};
+	// 가로 최소 3 칸 격자. 기본값 3 이면 예전처럼 (-2,2,0) (0,2,0) (2,2,0) 한 줄
+	std::vector<ObjectRequest> requests(scene_objects_);
+	{
+		constexpr float kSpacing = 2.0f;
+		const uint32_t columns = std::max(3u, static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(scene_objects_)))));
+		for (uint32_t i = 0; i < scene_objects_; ++i) {
+			const float x = (static_cast<float>(i % columns) - static_cast<float>(columns - 1) * 0.5f) * kSpacing;
+			const float z = -static_cast<float>(i / columns) * kSpacing;
+			requests[i] = { 0, glm::vec3(x, 2.0f, z) };
 		}
+	}
+
+	// 모든 decode 를 먼저 pool 에 던져두고 (같은 경로는 한 번만) 기다린다
+	AssetLoader loader(*thread_pool_, *allocator_, *upload_service_);
+	AssetLoader::TextureFuture texture = loader.LoadTexture("assets/textures/vulkan_cloth_rgba.ktx");
+	std::vector<AssetLoader::MeshFuture> meshes;
+	for (const auto& path : meshPaths) {
+		meshes.push_back(loader.LoadMesh(path));
+	}
 
+	// 같은 MeshData 를 받은 경로는 MeshAsset 도 하나를 나눠 쓴다.
+	// MeshPool 크기를 정하려면 모든 mesh 의 decode 가 끝나야 한다 (decode 자체는 병렬)
+	std::vector<const MeshData*> uniqueMeshes;
+	MeshPool::Sizes poolSizes;
+	for (const auto& future : meshes) {
+		const MeshData* mesh = future.get().get();
+		if (std::find(uniqueMeshes.begin(), uniqueMeshes.end(), mesh) != uniqueMeshes.end()) continue;
+		uniqueMeshes.push_back(mesh);
+		poolSizes.vertices += mesh->VertexBytes() / sizeof(Vertex);
+		poolSizes.indices += mesh->IndexCount();
+		poolSizes.meshlets += mesh->MeshletCount();
+		poolSizes.meshlet_vertices += mesh->MeshletVertexCount();
+		poolSizes.meshlet_triangles += mesh->MeshletTriangleCount();
+		poolSizes.sdf_values += mesh->GetSdfVolume().Count();
+	}
+
+	mesh_pool_ = std::make_unique<MeshPool>(*allocator_, poolSizes);
+	std::unordered_map<const MeshData*, std::shared_ptr<MeshAsset>> assets;
+	for (const MeshData* mesh : uniqueMeshes) {
+		auto asset = mesh_pool_->Add(*mesh, *upload_service_);
+		// 큰 mesh 는 instance 단위 LOD 대신 LOD 0 의 meshlet 단위로 cull (ClusterCuller)
+		asset->clustered_ = gpu_culling_ && cluster_triangles_ > 0 && asset->meshlet_count_ > 0 && asset->index_count_ / 3 >= cluster_triangles_;
+		assets[mesh] = std::move(asset);
+	}
+	std::vector<std::shared_ptr<MeshAsset>> pathAssets;
+	for (const auto& future : meshes) {
+		pathAssets.push_back(assets.at(future.get().get()));
+	}
+
+	instances_.clear();
+	instances_.reserve(requests.size());
+	for (const auto& request : requests) {
+		instances_.emplace_back(pathAssets[request.mesh], request.position);
+	}
+	RebuildDrawBatches();
+	collider_set_ = std::make_unique<ColliderSet>(*allocator_, static_cast<uint32_t>(instances_.size()));
+
+	texture_ = texture.get();
+	std::cout << "loaded " << loader.UniqueCount() << " unique assets for " << loader.RequestCount() << " requests, "
+		<< assets.size() << " meshes / " << instances_.size() << " instances" << std::endl;
+}
+
+void Context::RebuildDrawBatches()
+{
+	// 같은 mesh 의 instance 가 연속하도록 mesh 가 처음 나온 순서로 정렬 (mesh 안의 순서는 유지)
+	std::unordered_map<const MeshAsset*, uint32_t> order;
+	for (const auto& instance : instances_) {
+		order.try_emplace(instance.mesh_.get(), static_cast<uint32_t>(order.size()));
+	}
+	std::stable_sort(instances_.begin(), instances_.end(), [&](const MeshInstance& a, const MeshInstance& b) {
+		return order.at(a.mesh_.get()) < order.at(b.mesh_.get());
+	});
+
+	draw_batches_.clear();
+	for (uint32_t i = 0; i < static_cast<uint32_t>(instances_.size()); ++i) {
+		const MeshAsset* mesh = instances_[i].mesh_.get();
+		if (draw_batches_.empty() || draw_batches_.back().mesh != mesh) {
+			draw_batches_.push_back({ mesh, i, 0 });
+		}
+		draw_batches_.back().instance_count++;
+	}
+}
+
+void Context::WriteInstanceDescriptor(uint32_t frame)
+{
+	vk::DescriptorBufferInfo instanceBufferInfo = instance_culler_->InstanceBufferInfo(frame);
+	vk::DescriptorBufferInfo visibleBufferInfo = instance_culler_->VisibleBufferInfo(frame);
+	std::array writes{
+		vk::WriteDescriptorSet{
+			.dstSet = *graphics_.object_sets[frame],
+			.dstBinding = 0,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.pBufferInfo = &instanceBufferInfo
+		},
+		vk::WriteDescriptorSet{
+			.dstSet = *graphics_.object_sets[frame],
+			.dstBinding = 2,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.pBufferInfo = &visibleBufferInfo
+		}
+	};
+	device_.updateDescriptorSets(writes, {});
+
+	if (cluster_culler_) {
+		cluster_culler_->SetInstanceBuffer(frame, instanceBufferInfo);
+	}
+}
+
+void Context::CreateCpuSolver()
+{
+	if (!cpu_simulation_) return;
+
+	cpu_solver_ = std::make_unique<CpuClothSolver>(BuildClothParticles(Nx, Ny, spacing), *cloth_constraints_, *thread_pool_);
+	cpu_solver_->SetColliders(collider_set_->Colliders(), mesh_pool_->SdfValues());
+	cpu_previous_positions_ = cpu_solver_->Positions();
+
+	// frame 마다 CPU 결과 (position, previous) 를 올릴 host visible buffer (persistently mapped)
+	const vk::DeviceSize size = particle_store_->Range() * 2;
+	cpu_upload_buffers_.clear();
+	cpu_upload_buffers_memory_.clear();
+	cpu_upload_buffers_mapped_.clear();
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		vk::raii::Buffer buffer({});
+		vku::Allocation bufferMemory;
+		vku::CreateBuffer(*allocator_, size,
+			vk::BufferUsageFlagBits::eTransferSrc,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			buffer, bufferMemory);
+		cpu_upload_buffers_mapped_.emplace_back(bufferMemory.Mapped());
+		cpu_upload_buffers_.emplace_back(std::move(buffer));
+		cpu_upload_buffers_memory_.emplace_back(std::move(bufferMemory));
 	}
 }
 
@@ -1047,42 +1932,34 @@ void Context::CreateDescriptorSets()
 		device_.updateDescriptorSets(descriptorWrites, {});
 	}
 	
-	// Object UBO + Sampler
+	// Instance SSBO + Sampler
 	{
+		std::array<vk::DescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+		layouts.fill(*graphics_.object_set_layout);
 		vk::DescriptorSetAllocateInfo allocInfo{
 			.descriptorPool = *descriptor_pool_,
-			.descriptorSetCount = 1,
-			.pSetLayouts = &*graphics_.object_set_layout
+			.descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+			.pSetLayouts = layouts.data()
 		};
+		graphics_.object_sets = vk::raii::DescriptorSets{ device_, allocInfo };
 
-		auto sets = vk::raii::DescriptorSets{ device_, allocInfo };
-		graphics_.object_set = std::move(sets.front());
-
-		vk::DescriptorBufferInfo objectUboBufferInfo{ *graphics_.object_ubo, 0, sizeof(Graphics::ObjectUboData) };
 		vk::DescriptorImageInfo imageInfo{
 			.sampler = *texture_->texture_sampler_,
 			.imageView = *texture_->texture_image_view_,
 			.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
 		};
-		std::array descriptorWrites{
-			vk::WriteDescriptorSet{
-				.dstSet = *graphics_.object_set,
-				.dstBinding = 0,
-				.dstArrayElement = 0,
-				.descriptorCount = 1,
-				.descriptorType = vk::DescriptorType::eUniformBufferDynamic,
-				.pBufferInfo = &objectUboBufferInfo
-			},
-			vk::WriteDescriptorSet{
-				.dstSet = *graphics_.object_set,
+		for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+			vk::WriteDescriptorSet samplerWrite{
+				.dstSet = *graphics_.object_sets[frame],
 				.dstBinding = 1,
 				.dstArrayElement = 0,
 				.descriptorCount = 1,
 				.descriptorType = vk::DescriptorType::eCombinedImageSampler,
 				.pImageInfo = &imageInfo
-			}
-		};
-		device_.updateDescriptorSets(descriptorWrites, {});
+			};
+			device_.updateDescriptorSets(samplerWrite, {});
+			WriteInstanceDescriptor(frame);
+		}
 	}
 
 	// Sim Params
@@ -1096,7 +1973,7 @@ void Context::CreateDescriptorSets()
 		auto sets = vk::raii::DescriptorSets{ device_, allocInfo };
 		compute_.sim_params_set = std::move(sets.front());
 
-		vk::DescriptorBufferInfo simParamsUboInfo{ *compute_.sim_params_ubo, 0, sizeof(Compute::SimParams) };
+		vk::DescriptorBufferInfo simParamsUboInfo{ *compute_.sim_params_ubo, 0, sizeof(SimParams) };
 		std::array descriptorWrites{
 			vk::WriteDescriptorSet{
 				.dstSet = *compute_.sim_params_set,
@@ -1121,35 +1998,27 @@ void Context::CreateDescriptorSets()
 		auto sets = vk::raii::DescriptorSets{ device_, allocInfo };
 		compute_.cloth_compute_set = std::move(sets.front());
 
-		vk::DescriptorBufferInfo positions(*positions_ssbo_, 0, VK_WHOLE_SIZE);
-		vk::DescriptorBufferInfo velocities(*velocities_ssbo_, 0, VK_WHOLE_SIZE);
-		vk::DescriptorBufferInfo predictedPositions(*predicted_ssbo_, 0, VK_WHOLE_SIZE);
-		std::array descriptorWrites{
-			vk::WriteDescriptorSet{
-				.dstSet = *compute_.cloth_compute_set,
-				.dstBinding = 0,
-				.dstArrayElement = 0,
-				.descriptorCount = 1,
-				.descriptorType = vk::DescriptorType::eStorageBuffer,
-				.pBufferInfo = &positions
-			},
-			vk::WriteDescriptorSet{
-				.dstSet = *compute_.cloth_compute_set,
-				.dstBinding = 1,
-				.dstArrayElement = 0,
-				.descriptorCount = 1,
-				.descriptorType = vk::DescriptorType::eStorageBuffer,
-				.pBufferInfo = &velocities
-			},
-			vk::WriteDescriptorSet{
+		// particle stream 은 같은 buffer 의 sub-range 를 offset 으로 bind
+		std::array<vk::DescriptorBufferInfo, CLOTH_BINDING_COUNT> bufferInfos;
+		for (uint32_t stream = 0; stream < PARTICLE_STREAM_COUNT; ++stream) {
+			bufferInfos[stream] = particle_store_->DescriptorInfo(static_cast<ParticleStore::Stream>(stream));
+		}
+		bufferInfos[CLOTH_BINDING_CONSTRAINTS] = vk::DescriptorBufferInfo{ *constraints_ssbo_, 0, VK_WHOLE_SIZE };
+		bufferInfos[CLOTH_BINDING_LAMBDAS] = vk::DescriptorBufferInfo{ *lambdas_ssbo_, 0, VK_WHOLE_SIZE };
+		bufferInfos[CLOTH_BINDING_COLLIDERS] = collider_set_->BufferInfo();
+		bufferInfos[CLOTH_BINDING_SDF] = mesh_pool_->SdfBufferInfo();
+
+		std::array<vk::WriteDescriptorSet, CLOTH_BINDING_COUNT> descriptorWrites;
+		for (uint32_t binding = 0; binding < CLOTH_BINDING_COUNT; ++binding) {
+			descriptorWrites[binding] = vk::WriteDescriptorSet{
 				.dstSet = *compute_.cloth_compute_set,
-				.dstBinding = 2,
+				.dstBinding = binding,
 				.dstArrayElement = 0,
 				.descriptorCount = 1,
 				.descriptorType = vk::DescriptorType::eStorageBuffer,
-				.pBufferInfo = &predictedPositions
-			}
-		};
+				.pBufferInfo = &bufferInfos[binding]
+			};
+		}
 		device_.updateDescriptorSets(descriptorWrites, {});
 	}
 
@@ -1164,22 +2033,14 @@ void Context::CreateDescriptorSets()
 		auto sets = vk::raii::DescriptorSets{ device_, allocInfo };
 		graphics_.cloth_set = std::move(sets.front());
 
-		vk::DescriptorBufferInfo objectUboBufferInfo{ *graphics_.object_ubo, 0, sizeof(Graphics::ObjectUboData) };
 		vk::DescriptorImageInfo imageInfo{
 			.sampler = *texture_->texture_sampler_,
 			.imageView = *texture_->texture_image_view_,
 			.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
 		};
-		vk::DescriptorBufferInfo positions(positions_ssbo_, 0, VK_WHOLE_SIZE);
+		vk::DescriptorBufferInfo positions = particle_store_->DescriptorInfo(ParticleStore::Stream::Positions);
+		vk::DescriptorBufferInfo previous = particle_store_->DescriptorInfo(ParticleStore::Stream::Previous);
 		std::array descriptorWrites{
-			vk::WriteDescriptorSet{
-				.dstSet = *graphics_.cloth_set,
-				.dstBinding = 0,
-				.dstArrayElement = 0,
-				.descriptorCount = 1,
-				.descriptorType = vk::DescriptorType::eUniformBufferDynamic,
-				.pBufferInfo = &objectUboBufferInfo
-			},
 			vk::WriteDescriptorSet{
 				.dstSet = *graphics_.cloth_set,
 				.dstBinding = 1,
@@ -1195,6 +2056,14 @@ void Context::CreateDescriptorSets()
 				.descriptorCount = 1,
 				.descriptorType = vk::DescriptorType::eStorageBuffer,
 				.pBufferInfo = &positions
+			},
+			vk::WriteDescriptorSet{
+				.dstSet = *graphics_.cloth_set,
+				.dstBinding = 3,
+				.dstArrayElement = 0,
+				.descriptorCount = 1,
+				.descriptorType = vk::DescriptorType::eStorageBuffer,
+				.pBufferInfo = &previous
 			}
 
 		};
@@ -1205,19 +2074,39 @@ void Context::CreateDescriptorSets()
 
 void Context::CreateComputePipelines()
 {
+	// Pipeline Layout (predict / solve / velocity 공용)
 	{
-		vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device_, vku::ReadFile("shaders/integrate.comp.spv"));
+		std::array<vk::DescriptorSetLayout, 2> setLayouts(*compute_.sim_params_set_layout, *compute_.cloth_compute_set_layout);
+		vk::PushConstantRange pushConstantRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = sizeof(Compute::SolvePushConstants) };
 
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 2, .pSetLayouts = setLayouts.data(), .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange };
+		compute_.pipeline_layouts.cloth = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
+	}
+
+	auto createPipeline = [&](const std::string& path) {
+		vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device_, vku::ReadFile(path));
 		vk::PipelineShaderStageCreateInfo computeShaderStageInfo{ .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main" };
+		vk::ComputePipelineCreateInfo pipelineInfo{ .stage = computeShaderStageInfo, .layout = *compute_.pipeline_layouts.cloth };
+		return vk::raii::Pipeline(device_, nullptr, pipelineInfo);
+	};
 
-		std::array<vk::DescriptorSetLayout, 2> setLayouts(*compute_.sim_params_set_layout, *compute_.cloth_compute_set_layout);
+	compute_.pipelines.integrate = createPipeline("shaders/integrate.comp.spv");
+	compute_.pipelines.solve = createPipeline("shaders/solve_distance.comp.spv");
+	compute_.pipelines.velocity = createPipeline("shaders/update_velocity.comp.spv");
+	compute_.pipelines.jacobi_solve = createPipeline("shaders/jacobi_solve.comp.spv");
+	compute_.pipelines.jacobi_apply = createPipeline("shaders/jacobi_apply.comp.spv");
+	compute_.pipelines.collide = createPipeline("shaders/solve_collisions.comp.spv");
 
-		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 2, .pSetLayouts = setLayouts.data(), .pushConstantRangeCount = 0 };
-		compute_.pipeline_layouts.integrate = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
-		vk::ComputePipelineCreateInfo pipelineInfo{ .stage = computeShaderStageInfo, .layout = *compute_.pipeline_layouts.integrate };
-		compute_.pipelines.integrate = vk::raii::Pipeline(device_, nullptr, pipelineInfo);
+	// jacobi_apply.comp 의 APPLY_RELAXATION (constant_id 0) = false
+	{
+		const vk::Bool32 applyRelaxation = vk::False;
+		vk::SpecializationMapEntry specEntry{ .constantID = 0, .offset = 0, .size = sizeof(vk::Bool32) };
+		vk::SpecializationInfo specInfo{ .mapEntryCount = 1, .pMapEntries = &specEntry, .dataSize = sizeof(vk::Bool32), .pData = &applyRelaxation };
+		vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device_, vku::ReadFile("shaders/jacobi_apply.comp.spv"));
+		vk::PipelineShaderStageCreateInfo computeShaderStageInfo{ .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main", .pSpecializationInfo = &specInfo };
+		vk::ComputePipelineCreateInfo pipelineInfo{ .stage = computeShaderStageInfo, .layout = *compute_.pipeline_layouts.cloth };
+		compute_.pipelines.self_collision_apply = vk::raii::Pipeline(device_, nullptr, pipelineInfo);
 	}
-
 }
 
 void Context::CreateGraphicsPipelines()
@@ -1268,6 +2157,7 @@ void Context::CreateGraphicsPipelines()
 	vk::PipelineDynamicStateCreateInfo dynamicState{ .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()), .pDynamicStates = dynamicStates.data() };
 
 	vk::Format depthFormat = vku::FindDepthFormat(physical_device_);
+	vk::Format colorFormat = ColorFormat();
 
 
 	// Model
@@ -1320,11 +2210,67 @@ void Context::CreateGraphicsPipelines()
 			.pDynamicState = &dynamicState,
 			.layout = graphics_.pipeline_layouts.model,
 			.renderPass = nullptr },
-		  {.colorAttachmentCount = 1, .pColorAttachmentFormats = &swapchain_->swapchain_surface_format_.format, .depthAttachmentFormat = depthFormat }
+		  {.colorAttachmentCount = 1, .pColorAttachmentFormats = &colorFormat, .depthAttachmentFormat = depthFormat }
 		};
 		graphics_.pipelines.model = vk::raii::Pipeline(device_, nullptr, pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>());
 	}
 
+	// Cluster (ClusterCuller) : mesh shader 경로면 task + mesh, 아니면 cull_clusters.comp 가 만든 index 를 model_cluster.vert 로
+	if (cluster_culler_) {
+		const bool meshShader = cluster_culler_->MeshShader();
+
+		std::vector<vk::raii::ShaderModule> modules;
+		std::vector<vk::PipelineShaderStageCreateInfo> stages;
+		auto addStage = [&](vk::ShaderStageFlagBits stage, const std::string& path) {
+			modules.push_back(vku::CreateShaderModule(device_, vku::ReadFile(path)));
+			stages.push_back({ .stage = stage, .module = *modules.back(), .pName = "main" });
+		};
+		if (meshShader) {
+			addStage(vk::ShaderStageFlagBits::eTaskEXT, "shaders/cluster.task.spv");
+			addStage(vk::ShaderStageFlagBits::eMeshEXT, "shaders/cluster.mesh.spv");
+		}
+		else {
+			addStage(vk::ShaderStageFlagBits::eVertex, "shaders/model_cluster.vert.spv");
+		}
+		addStage(vk::ShaderStageFlagBits::eFragment, "shaders/model.frag.spv");
+
+		// Vectex Input (mesh shader 는 vertex buffer 를 storage buffer 로 직접 읽는다)
+		auto bindingDescription = Vertex::GetBindingDescription();
+		auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+		vk::PipelineVertexInputStateCreateInfo vertexInputInfo{
+			.vertexBindingDescriptionCount = 1,
+			.pVertexBindingDescriptions = &bindingDescription,
+			.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
+			.pVertexAttributeDescriptions = attributeDescriptions.data()
+		};
+
+		// Pipeline Layout : model 과 같은 set 0, 1 + cluster set
+		// mesh shader 경로는 cluster.task 의 firstWork (ClusterCuller::RecordDraw 가 나눠 그릴 때)
+		std::array<vk::DescriptorSetLayout, 3> setLayouts{ *graphics_.global_set_layout, *graphics_.object_set_layout, *cluster_culler_->SetLayout() };
+		vk::PushConstantRange pushConstantRange{ .stageFlags = vk::ShaderStageFlagBits::eTaskEXT, .offset = 0, .size = sizeof(uint32_t) };
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 3, .pSetLayouts = setLayouts.data(),
+			.pushConstantRangeCount = meshShader ? 1u : 0u, .pPushConstantRanges = &pushConstantRange };
+		graphics_.pipeline_layouts.cluster = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
+
+		// Pipeline
+		vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineRenderingCreateInfo> pipelineCreateInfoChain = {
+		  {.stageCount = static_cast<uint32_t>(stages.size()),
+			.pStages = stages.data(),
+			.pVertexInputState = meshShader ? nullptr : &vertexInputInfo,
+			.pInputAssemblyState = meshShader ? nullptr : &inputAssembly,
+			.pViewportState = &viewportState,
+			.pRasterizationState = &rasterizer,
+			.pMultisampleState = &multisampling,
+			.pDepthStencilState = &depthStencil,
+			.pColorBlendState = &colorBlending,
+			.pDynamicState = &dynamicState,
+			.layout = graphics_.pipeline_layouts.cluster,
+			.renderPass = nullptr },
+		  {.colorAttachmentCount = 1, .pColorAttachmentFormats = &colorFormat, .depthAttachmentFormat = depthFormat }
+		};
+		graphics_.pipelines.cluster = vk::raii::Pipeline(device_, nullptr, pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>());
+	}
+
 	// Cloth
 	{
 		// Shader
@@ -1355,8 +2301,10 @@ void Context::CreateGraphicsPipelines()
 		};
 
 		// Pipeline Layout
+		// push constant : previous -> position 보간 비율 (SimScheduler::Alpha)
 		std::array<vk::DescriptorSetLayout, 2> setLayouts(*graphics_.global_set_layout, *graphics_.cloth_set_layout);
-		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 2, .pSetLayouts = setLayouts.data(), .pushConstantRangeCount = 0 };
+		vk::PushConstantRange pushConstantRange{ .stageFlags = vk::ShaderStageFlagBits::eVertex, .offset = 0, .size = sizeof(float) };
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 2, .pSetLayouts = setLayouts.data(), .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange };
 		graphics_.pipeline_layouts.cloth = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
 
 		rasterizer.frontFace = vk::FrontFace::eClockwise;
@@ -1376,7 +2324,7 @@ void Context::CreateGraphicsPipelines()
 			.pDynamicState = &dynamicState,
 			.layout = graphics_.pipeline_layouts.cloth,
 			.renderPass = nullptr },
-		  {.colorAttachmentCount = 1, .pColorAttachmentFormats = &swapchain_->swapchain_surface_format_.format, .depthAttachmentFormat = depthFormat }
+		  {.colorAttachmentCount = 1, .pColorAttachmentFormats = &colorFormat, .depthAttachmentFormat = depthFormat }
 		};
 		graphics_.pipelines.cloth = vk::raii::Pipeline(device_, nullptr, pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>());
 	}
@@ -1385,24 +2333,113 @@ void Context::CreateGraphicsPipelines()
 
 void Context::CreateSyncObjects()
 {
-	in_flight_fences_.clear();
-
 	vk::SemaphoreTypeCreateInfo semaphoreType{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
 	semaphore_ = vk::raii::Semaphore(device_, { .pNext = &semaphoreType });
 	timeline_value_ = 0;
+	frame_timeline_values_.fill(0);
 
+	if (headless_) return;
+
+	// acquire 용은 frame slot 마다, present 용은 swapchain image 마다 (같은 image 를 다시 acquire 해야 재사용 가능)
+	image_available_semaphores_.clear();
 	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-		vk::FenceCreateInfo fenceInfo{};
-		in_flight_fences_.emplace_back(device_, fenceInfo);
+		image_available_semaphores_.emplace_back(device_, vk::SemaphoreCreateInfo{});
+	}
+
+	render_finished_semaphores_.clear();
+	for (size_t i = 0; i < swapchain_->swapchain_images_.size(); i++) {
+		render_finished_semaphores_.emplace_back(device_, vk::SemaphoreCreateInfo{});
+	}
+}
+
+void Context::CreateOffscreenTarget(uint32_t width, uint32_t height)
+{
+	offscreen_.extent = vk::Extent2D{ width, height };
+	vku::CreateImage(*allocator_, width, height, 1, msaa_samples_, offscreen_.format, vk::ImageTiling::eOptimal,
+		vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+		vk::MemoryPropertyFlagBits::eDeviceLocal,
+		offscreen_.image, offscreen_.image_memory);
+	offscreen_.image_view = vku::CreateImageView(device_, offscreen_.image, offscreen_.format, vk::ImageAspectFlagBits::eColor, 1);
+}
+
+void Context::SaveOffscreenImage(const std::string& path)
+{
+	if (!headless_ || !render_) {
+		throw std::runtime_error("offscreen image is only available in headless rendering mode!");
 	}
 
+	std::lock_guard queueLock(upload_service_->QueueMutex());
+	device_.waitIdle();
+
+	const vk::Extent2D extent = offscreen_.extent;
+	const vk::DeviceSize size = static_cast<vk::DeviceSize>(extent.width) * extent.height * 4;
+
+	vk::raii::Buffer stagingBuffer(nullptr);
+	vku::Allocation stagingMemory;
+	vku::CreateBuffer(*allocator_, size,
+		vk::BufferUsageFlagBits::eTransferDst,
+		vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+		stagingBuffer, stagingMemory);
+
+	// 마지막 frame 이 TRANSFER_SRC 로 남겨둔 image 를 buffer 로 복사
+	vk::CommandBufferAllocateInfo allocInfo{ .commandPool = command_pool_, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 };
+	vk::raii::CommandBuffer cmd = std::move(device_.allocateCommandBuffers(allocInfo).front());
+	cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+	vk::BufferImageCopy region{
+		.bufferOffset = 0,
+		.bufferRowLength = 0,
+		.bufferImageHeight = 0,
+		.imageSubresource = { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+		.imageOffset = { 0, 0, 0 },
+		.imageExtent = { extent.width, extent.height, 1 }
+	};
+	cmd.copyImageToBuffer(*offscreen_.image, vk::ImageLayout::eTransferSrcOptimal, *stagingBuffer, region);
+	cmd.end();
+	queue_.submit(vk::SubmitInfo{ .commandBufferCount = 1, .pCommandBuffers = &*cmd }, nullptr);
+	queue_.waitIdle();
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("failed to open " + path);
+	}
+	file << "P6\n" << extent.width << " " << extent.height << "\n255\n";
+
+	const auto* pixels = static_cast<const uint8_t*>(stagingMemory.Mapped());
+	std::vector<uint8_t> row(static_cast<size_t>(extent.width) * 3);
+	for (uint32_t y = 0; y < extent.height; ++y) {
+		for (uint32_t x = 0; x < extent.width; ++x) {
+			const uint8_t* rgba = pixels + (static_cast<size_t>(y) * extent.width + x) * 4;
+			row[x * 3 + 0] = rgba[0];
+			row[x * 3 + 1] = rgba[1];
+			row[x * 3 + 2] = rgba[2];
+		}
+		file.write(reinterpret_cast<const char*>(row.data()), row.size());
+	}
 }
 
 void Context::CreateDepthResources() {
 	vk::Format depthFormat = vku::FindDepthFormat(physical_device_);
 
-	vku::CreateImage(physical_device_, device_, swapchain_->swapchain_extent_.width, swapchain_->swapchain_extent_.height, 1, msaa_samples_, depthFormat, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eDepthStencilAttachment, vk::MemoryPropertyFlagBits::eDeviceLocal, depth_image_, depth_image_memory_);
-	depth_image_view_ = vku::CreateImageView(device_, depth_image_, depthFormat, vk::ImageAspectFlagBits::eDepth, 1);
+	// Hi-Z build 가 depth 를 sampling 한다
+	vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eDepthStencilAttachment;
+	if (hiz_pyramid_) {
+		usage |= vk::ImageUsageFlagBits::eSampled;
+	}
+
+	std::array<vk::ImageView, MAX_FRAMES_IN_FLIGHT> depthViews;
+	for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+		DepthTarget& depth = depth_targets_[frame];
+		vku::CreateImage(*allocator_, RenderExtent().width, RenderExtent().height, 1, msaa_samples_, depthFormat, vk::ImageTiling::eOptimal, usage, vk::MemoryPropertyFlagBits::eDeviceLocal, depth.image, depth.memory);
+		depth.view = vku::CreateImageView(device_, depth.image, depthFormat, vk::ImageAspectFlagBits::eDepth, 1);
+		depthViews[frame] = *depth.view;
+	}
+
+	if (hiz_pyramid_) {
+		hiz_pyramid_->Resize(RenderExtent(), depthViews);
+		for (uint32_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; ++frame) {
+			instance_culler_->SetHiZ(frame, hiz_pyramid_->SampledInfo(frame));
+		}
+	}
 }
 
 void Context::SetupImgui(uint32_t width, uint32_t height)
@@ -3,16 +3,32 @@
 class Swapchain;
 struct Vertex;
 struct Camera;
-class Model;
+class MeshAsset;
+class MeshInstance;
+class MeshPool;
+class InstanceCuller;
+class ClusterCuller;
+class HiZPyramid;
+struct DrawBatch;
 class Texture2D;
 class MouseInteractor;
+class ClothConstraints;
+class ParticleStore;
+class ThreadPool;
+class CpuClothSolver;
+class ColliderSet;
+class SpatialHash;
+class GpuProfiler;
 
 #include "vulkan_utils.h"
+#include "sim_params.h"
+#include "sim_scheduler.h"
+#include "app_options.h"
 
 class Context
 {
 public:
-	Context(GLFWwindow* glfwWindow, uint32_t width, uint32_t height);
+	Context(GLFWwindow* glfwWindow, uint32_t width, uint32_t height, const AppOptions& options);
 	Context(const Context& rhs) = delete;
 	Context(Context&& rhs) = delete;
 	Context& operator=(const Context& rhs) = delete;
@@ -23,34 +39,112 @@ public:
 	void Draw();
 	void WaitIdle();
 
+	// headless #pragma once
+
+class Swapchain;
+struct Vertex;
+struct Camera;
+class MeshAsset;
+class MeshInstance;
+class MeshPool;
+class InstanceCuller;
+class ClusterCuller;
+class HiZPyramid;
+struct DrawBatch;
+class Texture2D;
+class MouseInteractor;
+class ClothConstraints;
+class ParticleStore;
+class ThreadPool;
+class CpuClothSolver;
+class ColliderSet;
+class SpatialHash;
+class GpuProfiler;
+
+#include "vulkan_utils.h"
+#include "sim_params.h"
+#include "sim_scheduler.h"
+#include "app_options.h"
+
+class Context
+{
+public:
+	Context(GLFWwindow* glfwWindow, uint32_t width, uint32_t height, const AppOptions& options);
+	Context(const Context& rhs) = delete;
+	Context(Context&& rhs) = delete;
+	Context& operator=(const Context& rhs) = delete;
+	Context& operator=(Context&& rhs) = delete;
+	~Context();
+
+	void Update(Camera& camera, MouseInteractor& mouse_interactor, float dt);
+	void Draw();
+	void WaitIdle();
+
+	// headless 에서 마지막으로 그린 offscreen image 를 PPM (P6) 으로 저장
+	void SaveOffscreenImage(const std::string& path);
+
+	// GPU 와 CPU reference solver 를 같은 초기 상태에서 steps 만큼 진행하고 위치 최대 오차가 tolerance 이하인지.
+	// CPU 시뮬레이션 모드 (compute queue 없음) 에서는 비교할 GPU 결과가 없으므로 false
+	bool ValidateAgainstCpu(uint32_t steps, float tolerance);
+
 private:
 	GLFWwindow* glfw_window_;
 
+	// glfw_window_ 가 없으면 surface / swapchain / ImGui 없이 offscreen image 에 그린다
+	bool headless_ = false;
+	bool render_ = true;
+
 	vk::raii::Instance               instance_{ nullptr };
 	vk::raii::DebugUtilsMessengerEXT debug_messenger_{ nullptr };
 	vk::raii::SurfaceKHR             surface_{ nullptr };
 	vk::raii::PhysicalDevice         physical_device_{ nullptr };
 	vk::SampleCountFlagBits			 msaa_samples_ = vk::SampleCountFlagBits::e1;
 	vk::raii::Device                 device_{ nullptr };
+	// 모든 buffer / image memory 는 여기서 sub-allocation (아래 member 들보다 늦게 파괴되어야 함)
+	std::unique_ptr<vku::Allocator>  allocator_{ nullptr };
 
 	uint32_t                         queue_index_ = ~0;
 	vk::raii::Queue                  queue_{ nullptr };
+	// graphics / compute 가 없는 transfer 전용 family (없으면 ~0, upload 는 queue_ 에서)
+	uint32_t                         transfer_queue_index_ = ~0;
+	vk::raii::Queue                  transfer_queue_{ nullptr };
 
 	vk::raii::CommandPool			 command_pool_{ nullptr };
+	// 초기화 / reset 때의 host -> device copy 를 한 번의 submit 으로 모은다
+	std::unique_ptr<UploadService>   upload_service_{ nullptr };
 
 	vk::raii::DescriptorPool		 descriptor_pool_{ nullptr };
 	vk::raii::DescriptorPool		 imgui_pool_{ nullptr };
 
 	std::unique_ptr<Swapchain>       swapchain_{ nullptr };
 
+	struct Offscreen {
+		vk::raii::Image image{ nullptr };
+		vku::Allocation image_memory;
+		vk::raii::ImageView image_view{ nullptr };
+		vk::Format format = vk::Format::eR8G8B8A8Unorm;
+		vk::Extent2D extent;
+	} offscreen_;
+
+	// compute / graphics 순서는 timeline semaphore 하나로, swapchain acquire / present 는 binary semaphore 로
 	vk::raii::Semaphore semaphore_{ nullptr };
 	uint64_t timeline_value_{ 0 };
-	std::vector<vk::raii::Fence> in_flight_fences_;
+	std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> frame_timeline_values_{}; // slot 을 마지막으로 쓴 frame 의 graphics signal 값
+	std::vector<vk::raii::Semaphore> image_available_semaphores_;       // frame slot 마다
+	std::vector<vk::raii::Semaphore> render_finished_semaphores_;       // swapchain image 마다
 	uint32_t current_frame_{ 0 };
 	uint32_t read_set_{ 0 };
 
 	bool framebuffer_resized_{ false };
 
+	// |===== Frame Pacing =====|
+	static constexpr uint32_t kFrameTimeHistory = 240;
+	std::array<float, kFrameTimeHistory> frame_times_ms_{};
+	uint32_t frame_time_count_ = 0;
+	uint32_t frame_time_next_ = 0;
+	std::chrono::steady_clock::time_point last_frame_time_{};
+	bool serialize_frames_ = false; // 비교용 : 매 frame GPU 완료까지 기다림
+
 	std::vector<const char*> required_device_extension_ = {
 		vk::KHRSwapchainExtensionName,
 		vk::KHRSpirv14ExtensionName,
@@ -62,40 +156,54 @@ private:
 	vku::Counts counts_;
 
 	// |===== Particle Info =====|
-	const int Nx = 30;
-	const int Ny = 30;
-	const float spacing = 0.1f;
+	// --cloth <n> 이면 n x n. spacing 은 천의 크기가 같도록 줄인다
+	const int Nx = kClothNx;
+	const int Ny = kClothNy;
+	const float spacing = kClothSpacing;
 
 	int max_particle_size = Nx * Ny;
 	int indices_size = 0;
 
-	std::vector<glm::vec4> positions_;
-	vk::raii::Buffer positions_ssbo_{ nullptr };
-	vk::raii::DeviceMemory positions_ssbo_memory_{ nullptr };
-
-	std::vector<glm::vec4> velocities_;
-	vk::raii::Buffer velocities_ssbo_{ nullptr };
-	vk::raii::DeviceMemory velocities_ssbo_memory_{ nullptr };
-	
-	std::vector<glm::vec4> predicted_;
-	vk::raii::Buffer predicted_ssbo_{ nullptr };
-	vk::raii::DeviceMemory predicted_ssbo_memory_{ nullptr };
-	
+	// positions / velocities / predicted / deltas / previous 를 하나의 allocation 에 SoA 로
+	std::unique_ptr<ParticleStore> particle_store_{ nullptr };
+
 	std::vector<uint32_t> indices_;
 	vk::raii::Buffer particle_index_buffer_{ nullptr };
-	vk::raii::DeviceMemory particle_index_buffer_memory_{ nullptr };
+	vku::Allocation particle_index_buffer_memory_;
+
+	// |===== Constraint Info =====|
+	std::unique_ptr<ClothConstraints> cloth_constraints_{ nullptr };
+	vk::raii::Buffer constraints_ssbo_{ nullptr };
+	vku::Allocation constraints_ssbo_memory_;
+
+	std::vector<float> lambdas_;
+	vk::raii::Buffer lambdas_ssbo_{ nullptr };
+	vku::Allocation lambdas_ssbo_memory_;
+
+	// |===== Cloth Collision =====|
+	// scene object 의 bounding sphere / SDF 를 frame 마다 모아 solver iteration 마다 충돌 pass 를 돈다.
+	// reach : 고정점에 매달린 천이 닿을 수 있는 범위. 밖의 object 는 collider 로 넣지 않는다
+	std::unique_ptr<ColliderSet> collider_set_{ nullptr };
+	bool cloth_collisions_ = true;
+	glm::vec3 cloth_reach_center_{ 0.0f };
+	float cloth_reach_radius_ = 0.0f;
+
+	// |===== Cloth Self Collision =====|
+	// step 마다 predicted 위치로 hash grid 를 만들고 iteration 마다 가까운 particle 끼리 밀어낸다
+	std::unique_ptr<SpatialHash> spatial_hash_{ nullptr };
+	bool cloth_self_collision_ = true;
+	float self_collision_distance_ = 0.0f; // CreateSSBOs 에서 0.5 * spacing
+
+	// |===== Sim Scheduler =====|
+	// frame dt 를 고정 step 으로 나눈다. Update 에서 이번 frame 의 step 수를 정하고 CPU / GPU 모두 그만큼 step x substep 을 돈다
+	SimScheduler sim_scheduler_;
+	uint32_t sim_steps_ = 0;
 
 	// |===== Compute =====|
 	struct Compute {
-		struct SimParams {
-			float dt;
-			float gravityY;
-			uint32_t numIters;
-			float stretchCompliance; // α_stretch
-			float restitution;       // 충돌 반발
-		} sim_params;
+		SimParams sim_params;
 		vk::raii::Buffer sim_params_ubo{ nullptr };
-		vk::raii::DeviceMemory sim_params_ubo_memory{ nullptr };
+		vku::Allocation sim_params_ubo_memory;
 		void* sim_params_ubo_mapped{ nullptr };
 		vk::DeviceSize sim_params_slot_size;
 
@@ -105,15 +213,48 @@ private:
 		vk::raii::DescriptorSetLayout cloth_compute_set_layout{ nullptr };
 		vk::raii::DescriptorSet cloth_compute_set{ nullptr };
 
+		struct SolvePushConstants {
+			uint32_t first;
+			uint32_t count;
+			uint32_t iteration;
+		};
+
 		struct PipelineLayouts {
-			vk::raii::PipelineLayout integrate{ nullptr };
+			vk::raii::PipelineLayout cloth{ nullptr };
 		} pipeline_layouts;
 
 		struct Pipelines {
 			vk::raii::Pipeline integrate{ nullptr };
+			vk::raii::Pipeline solve{ nullptr };
+			vk::raii::Pipeline velocity{ nullptr };
+			vk::raii::Pipeline jacobi_solve{ nullptr };
+			vk::raii::Pipeline jacobi_apply{ nullptr };
+			vk::raii::Pipeline self_collision_apply{ nullptr }; // jacobi_apply.comp, relaxation 없이
+			vk::raii::Pipeline collide{ nullptr };
 		} pipelines;
+
+		std::vector<vk::raii::CommandBuffer> command_buffers;
 	} compute_;
 
+	// |===== CPU Solver =====|
+	// cpu_simulation_ 이면 compute dispatch 대신 CPU solver 결과를 position stream 으로 복사
+	bool cpu_simulation_ = false;
+	std::unique_ptr<ThreadPool> thread_pool_{ nullptr };
+	std::unique_ptr<CpuClothSolver> cpu_solver_{ nullptr };
+	std::vector<vk::raii::Buffer> cpu_upload_buffers_;
+	std::vector<vku::Allocation> cpu_upload_buffers_memory_;
+	std::vector<void*> cpu_upload_buffers_mapped_;
+	std::vector<glm::vec4> cpu_previous_positions_; // frame 의 마지막 step 직전 position (previous stream 으로 같이 올린다)
+
+	// GPU 결과를 CPU reference 와 비교 (ImGui)
+	int cpu_validation_steps_ = 120;
+	float cpu_validation_tolerance_ = 1e-3f;
+	std::string cpu_validation_result_;
+
+	// |===== Profiler =====|
+	// frame slot 마다 timestamp query 를 따로 두고, 종료 시 CSV 로 기록
+	std::unique_ptr<GpuProfiler> gpu_profiler_{ nullptr };
+	std::string gpu_profile_csv_;
 
 	// |===== Graphics Info =====|
 	struct Graphics {
@@ -122,51 +263,78 @@ private:
 			glm::mat4 proj;
 		} global_ubo_data;
 		vk::raii::Buffer global_ubo{ nullptr };
-		vk::raii::DeviceMemory global_ubo_memory{ nullptr };
+		vku::Allocation global_ubo_memory;
 		void* global_ubo_mapped{ nullptr };
 		vk::DeviceSize global_slot_size;
 
-		struct ObjectUboData {
-			glm::mat4 model;
-		} object_ubo_data;
-		vk::raii::Buffer object_ubo{ nullptr };
-		vk::raii::DeviceMemory object_ubo_memory{ nullptr };
-		void* object_ubo_mapped{ nullptr };
-		vk::DeviceSize object_slot_size;
-
 		vk::raii::DescriptorSetLayout global_set_layout{ nullptr };
 		vk::raii::DescriptorSet global_set{ nullptr };
 		vk::raii::DescriptorSetLayout object_set_layout{ nullptr };
-		vk::raii::DescriptorSet object_set{ nullptr };
+		std::vector<vk::raii::DescriptorSet> object_sets; // frame slot 마다 하나 (instance / visible buffer 가 slot 마다 다름)
 		vk::raii::DescriptorSetLayout cloth_set_layout{ nullptr };
 		vk::raii::DescriptorSet cloth_set{ nullptr };
 
 		struct PipelineLayouts {
 			vk::raii::PipelineLayout model{ nullptr };
+			vk::raii::PipelineLayout cluster{ nullptr }; // model 의 set 0, 1 + ClusterCuller set
 			vk::raii::PipelineLayout cloth{ nullptr };
 		} pipeline_layouts;
 
 		struct Pipelines {
 			vk::raii::Pipeline model{ nullptr };
+			vk::raii::Pipeline cluster{ nullptr };       // model_cluster.vert 또는 cluster.task + cluster.mesh
 			vk::raii::Pipeline cloth{ nullptr };
 		} pipelines;
 
 		std::vector<vk::raii::CommandBuffer> command_buffers;
 	} graphics_;
 
-	// |===== Model & Texture =====|
-	static constexpr uint32_t kMaxObjects = 8;
-	uint32_t model_count_ = 0;
-	std::vector<std::unique_ptr<Model>> models;
-	std::unique_ptr<Texture2D> texture_{ nullptr };
+	// |===== Mesh & Texture =====|
+	uint32_t scene_objects_ = 3;
+	std::vector<MeshInstance> instances_;
+	std::vector<DrawBatch> draw_batches_;
+	std::unique_ptr<MeshPool> mesh_pool_{ nullptr };
+	std::shared_ptr<Texture2D> texture_{ nullptr };
+
+	// |===== Instance Culling =====|
+	// drawIndirectCount 를 지원하고 --cpu-cull 이 아니면 compute 로 cull + compact, 아니면 CPU 에서 같은 판정
+	bool cpu_culling_ = false;
+	bool gpu_culling_ = false;
+	std::unique_ptr<InstanceCuller> instance_culler_{ nullptr };
+	// GPU culling 이고 depth 를 sampling 할 수 있으면 Hi-Z 를 만든다. occlusion_culling_ 은 ImGui / --no-occlusion 으로 끈다
+	std::unique_ptr<HiZPyramid> hiz_pyramid_{ nullptr };
+	bool occlusion_culling_ = true;
+	// LOD 를 고를 때 허용하는 화면 오차 (pixel). 0 이면 LOD 0 만
+	float lod_pixel_error_ = 1.0f;
+	// GPU culling 이면 triangle 이 cluster_triangles_ 개 이상인 mesh 는 meshlet 단위로 cull.
+	// VK_EXT_mesh_shader 가 있고 --no-mesh-shader 가 아니면 task / mesh shader 로, 아니면 compute + indirect draw 로 그린다
+	uint32_t cluster_triangles_ = 8192;
+	bool allow_mesh_shader_ = true;
+	bool mesh_shader_ = false;
+	std::unique_ptr<ClusterCuller> cluster_culler_{ nullptr };
 
 	// |===== Depth Image =====|
-	vk::raii::Image depth_image_ = nullptr;
-	vk::raii::DeviceMemory depth_image_memory_ = nullptr;
-	vk::raii::ImageView depth_image_view_ = nullptr;
+	// frame slot 마다 하나. Hi-Z 가 이 frame 의 depth 를 읽는 동안 다음 frame 은 다른 image 에 그린다
+	struct DepthTarget {
+		vk::raii::Image image{ nullptr };
+		vku::Allocation memory;
+		vk::raii::ImageView view{ nullptr };
+	};
+	std::array<DepthTarget, MAX_FRAMES_IN_FLIGHT> depth_targets_;
 
 private:
+	// swapchain 또는 headless offscreen target
+	vk::Extent2D RenderExtent() const;
+	vk::Format ColorFormat() const;
+	vk::Image ColorImage(uint32_t imageIndex) const;
+	vk::ImageView ColorImageView(uint32_t imageIndex) const;
+
 	void DrawImgui();
+	void DrawFramePacingImgui();
+
+	void WaitForFrameSlot();
+	void RecreateSwapchainResources();
+	void RecordFrameTime();
 
 	void UpdateMouseInteractor(Camera& camera, MouseInteractor& mouse_interactor);
 	void UpdateComputeUBO();
@@ -175,8 +343,14 @@ private:
 	void AddComputeToComputeBarrier(const vk::raii::CommandBuffer& cmd, vk::Buffer buffer);
 	void AddGraphicsToComputeBarrier(const vk::raii::CommandBuffer& cmd, vk::Buffer buffer);
 	void AddComputeToGraphicsBarrier(const vk::raii::CommandBuffer& cmd, vk::Buffer buffer);
+	void AddTransferToGraphicsBarrier(const vk::raii::CommandBuffer& cmd, vk::Buffer buffer);
 
+	void RecordComputeCommandBuffer();
+	void RecordClothStep(const vk::raii::CommandBuffer& cmd, uint32_t simOffset, bool profile = true);
+	void RecordSavePreviousPositions(const vk::raii::CommandBuffer& cmd);
 	void RecordGraphicsCommandBuffer(uint32_t imageIndex);
+	void RecordModelDraw(const vk::raii::CommandBuffer& cmd, uint32_t globalOffset, const char* scopeName);
+	void RecordClusterDraw(const vk::raii::CommandBuffer& cmd, uint32_t globalOffset);
 	void TransitionImageLayout(
 		vk::Image& image,
 		const vk::raii::CommandBuffer& cmd,
@@ -216,6 +390,12 @@ private:
 
 	void CreateUniformBuffers();
 	void CreateSSBOs();
+	// model / texture 를 thread pool 에서 병렬로 decode 하고 upload batch 에 기록
+	void LoadSceneAssets();
+	void RebuildDrawBatches();
+	// object set 의 instance / visible binding 을 culler 의 현재 buffer 로
+	void WriteInstanceDescriptor(uint32_t frame);
+	void CreateCpuSolver();
 
 	void CreateDescriptorSets();
 	void CreateComputePipelines();
@@ -223,6 +403,7 @@ private:
 	void CreateSyncObjects();
 
 	void CreateDepthResources();
+	void CreateOffscreenTarget(uint32_t width, uint32_t height);
 
 	void SetupImgui(uint32_t width, uint32_t height);
 
@@ -0,0 +1,543 @@
+#include "cloth_constraints.h"
+#include "thread_pool.h"
+#include "particle_layout.h"
+#include "collider_set.h"
+#include "spatial_hash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLOTH_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#define CLOTH_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+
+#include "cpu_cloth_solver.h"
+
+namespace
+{
+	// thread #include "cloth_constraints.h"
+#include "thread_pool.h"
+#include "particle_layout.h"
+#include "collider_set.h"
+#include "spatial_hash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLOTH_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#define CLOTH_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+
+#include "cpu_cloth_solver.h"
+
+namespace
+{
+	// thread 하나가 맡는 최소 개수. 작은 천에서는 worker 를 깨우는 비용이 계산보다 크다
+	constexpr uint32_t kParticleGrain = 4096;
+	constexpr uint32_t kConstraintGrain = 1024;
+
+	float Compliance(const SimParams& params, uint32_t type)
+	{
+		switch (static_cast<ConstraintType>(type)) {
+		case ConstraintType::Shear:   return params.shearCompliance;
+		case ConstraintType::Bending: return params.bendCompliance;
+		default:                      return params.stretchCompliance;
+		}
+	}
+
+#if CLOTH_SIMD_SSE
+	// vec4 하나 = __m128 하나. w 는 inverse mass 이므로 xyz 만 연산하고 w 는 보존한다
+	inline __m128 Load(const glm::vec4& v) { return _mm_loadu_ps(&v.x); }
+	inline void Store(glm::vec4& dst, __m128 v) { _mm_storeu_ps(&dst.x, v); }
+	inline __m128 XyzMask() { return _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)); }
+	inline __m128 Select(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+	inline __m128 SplatW(__m128 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+	// 아래 scalar Dot3 와 같은 (x + y) + z 순서
+	inline float Dot3(__m128 a, __m128 b)
+	{
+		const __m128 m = _mm_mul_ps(a, b);
+		const __m128 xy = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(_mm_add_ss(xy, _mm_movehl_ps(m, m)));
+	}
+
+	// integrate.comp : 고정점이면 P = X, 아니면 v += g*dt, P = X + v*dt
+	inline void IntegrateOne(const glm::vec4& x4, glm::vec4& v4, glm::vec4& p4, __m128 gdt, __m128 dt)
+	{
+		const __m128 x = Load(x4);
+		const __m128 v = Load(v4);
+		const __m128 fixed = _mm_cmpeq_ps(SplatW(x), _mm_setzero_ps());
+		const __m128 vNew = _mm_and_ps(_mm_add_ps(v, gdt), XyzMask());
+		const __m128 pNew = _mm_add_ps(x, _mm_mul_ps(vNew, dt));
+		Store(p4, Select(fixed, x, pNew));
+		Store(v4, Select(fixed, v, vNew));
+	}
+
+	// update_velocity.comp : v = (p - x) / dt, x = p (w 유지)
+	inline void UpdateVelocityOne(glm::vec4& x4, glm::vec4& v4, const glm::vec4& p4, __m128 dt)
+	{
+		const __m128 x = Load(x4);
+		const __m128 v = Load(v4);
+		const __m128 p = Load(p4);
+		const __m128 fixed = _mm_cmpeq_ps(SplatW(x), _mm_setzero_ps());
+		const __m128 vNew = _mm_and_ps(_mm_div_ps(_mm_sub_ps(p, x), dt), XyzMask());
+		const __m128 xNew = Select(XyzMask(), p, x);
+		Store(v4, Select(fixed, v, vNew));
+		Store(x4, Select(fixed, x, xNew));
+	}
+#endif
+
+#if CLOTH_SIMD_AVX
+	// __m256 하나에 particle 2개. 128-bit lane 하나가 vec4 하나
+	inline __m256 XyzMask8() { return _mm256_castsi256_ps(_mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1)); }
+
+	inline void IntegrateTwo(const glm::vec4* x4, glm::vec4* v4, glm::vec4* p4, __m256 gdt, __m256 dt)
+	{
+		const __m256 x = _mm256_loadu_ps(&x4->x);
+		const __m256 v = _mm256_loadu_ps(&v4->x);
+		const __m256 fixed = _mm256_cmp_ps(_mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3)), _mm256_setzero_ps(), _CMP_EQ_OQ);
+		const __m256 vNew = _mm256_and_ps(_mm256_add_ps(v, gdt), XyzMask8());
+		const __m256 pNew = _mm256_add_ps(x, _mm256_mul_ps(vNew, dt));
+		_mm256_storeu_ps(&p4->x, _mm256_blendv_ps(pNew, x, fixed));
+		_mm256_storeu_ps(&v4->x, _mm256_blendv_ps(vNew, v, fixed));
+	}
+
+	inline void UpdateVelocityTwo(glm::vec4* x4, glm::vec4* v4, const glm::vec4* p4, __m256 dt)
+	{
+		const __m256 x = _mm256_loadu_ps(&x4->x);
+		const __m256 v = _mm256_loadu_ps(&v4->x);
+		const __m256 p = _mm256_loadu_ps(&p4->x);
+		const __m256 fixed = _mm256_cmp_ps(_mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3)), _mm256_setzero_ps(), _CMP_EQ_OQ);
+		const __m256 vNew = _mm256_and_ps(_mm256_div_ps(_mm256_sub_ps(p, x), dt), XyzMask8());
+		const __m256 xNew = _mm256_blendv_ps(x, p, XyzMask8());
+		_mm256_storeu_ps(&v4->x, _mm256_blendv_ps(vNew, v, fixed));
+		_mm256_storeu_ps(&x4->x, _mm256_blendv_ps(xNew, x, fixed));
+	}
+#endif
+
+	// glm::length 는 내부 순서가 구현에 달려 있으므로 SIMD 경로와 같은 순서를 직접 적는다.
+	// 곱셈 + 덧셈이 FMA 로 합쳐지지 않도록 CMakeLists.txt 에서 -ffp-contract=off (MSVC 는 /fp:precise) 로 빌드한다
+	inline float Dot3(const glm::vec3& a, const glm::vec3& b)
+	{
+		return (a.x * b.x + a.y * b.y) + a.z * b.z;
+	}
+
+	// solve_distance.comp / jacobi_solve.comp 공통 : dLambda 와 방향 n 을 구한다. 풀 필요가 없으면 false
+	inline bool ComputeDistanceCorrection(const glm::vec4& pa, const glm::vec4& pb, const DistanceConstraint& dc, float lambda, float dt, float compliance,
+		bool simd, float& dLambda, glm::vec4& n)
+	{
+		const float wSum = pa.w + pb.w;
+#if CLOTH_SIMD_SSE
+		if (simd) {
+			const __m128 d = _mm_and_ps(_mm_sub_ps(Load(pa), Load(pb)), XyzMask());
+			const float len = std::sqrt(Dot3(d, d));
+			if (wSum == 0.0f || len < 1e-6f) return false;
+
+			const float alpha = compliance / (dt * dt);
+			const float err = len - dc.rest_length;
+			dLambda = (-err - alpha * lambda) / (wSum + alpha);
+			Store(n, _mm_div_ps(d, _mm_set1_ps(len)));
+			return true;
+		}
+#endif
+		const glm::vec3 d = glm::vec3(pa) - glm::vec3(pb);
+		const float len = std::sqrt(Dot3(d, d));
+		if (wSum == 0.0f || len < 1e-6f) return false;
+
+		const float alpha = compliance / (dt * dt);
+		const float err = len - dc.rest_length;
+		dLambda = (-err - alpha * lambda) / (wSum + alpha);
+		n = glm::vec4(d / len, 0.0f);
+		return true;
+	}
+}
+
+CpuClothSolver::SimdPath CpuClothSolver::BestSimdPath()
+{
+#if CLOTH_SIMD_AVX
+	return SimdPath::Avx;
+#elif CLOTH_SIMD_SSE
+	return SimdPath::Sse;
+#else
+	return SimdPath::Scalar;
+#endif
+}
+
+const char* CpuClothSolver::ToString(SimdPath path)
+{
+	switch (path) {
+	case SimdPath::Avx: return "AVX";
+	case SimdPath::Sse: return "SSE";
+	default:            return "scalar";
+	}
+}
+
+CpuClothSolver::CpuClothSolver(const std::vector<glm::vec4>& positions, const ClothConstraints& constraints, ThreadPool& pool)
+	: constraints_(constraints), pool_(pool), rest_positions_(positions)
+{
+	Reset(positions);
+}
+
+void CpuClothSolver::Reset(const std::vector<glm::vec4>& positions)
+{
+	positions_ = positions;
+	predicted_ = positions;
+	velocities_.assign(positions.size(), glm::vec4(0.0f));
+	deltas_.assign(positions.size(), glm::ivec4(0));
+	lambdas_.assign(constraints_.constraints_.size(), 0.0f);
+}
+
+void CpuClothSolver::SetColliders(const std::vector<Collider>& colliders, const std::vector<float>& sdfValues)
+{
+	colliders_ = &colliders;
+	sdf_values_ = &sdfValues;
+}
+
+void CpuClothSolver::Step(const SimParams& params)
+{
+	const bool collide = ColliderCount(params) > 0;
+	const bool selfCollide = params.selfCollisionDistance > 0.0f;
+	Integrate(params);
+	if (selfCollide) {
+		BuildHashGrid(params);
+	}
+	for (uint32_t iter = 0; iter < params.numIters; ++iter) {
+		if (params.solverMode == SolverMode::GaussSeidel) {
+			SolveGaussSeidel(params, iter);
+		}
+		else {
+			SolveJacobi(params, iter);
+		}
+		if (collide) {
+			SolveCollisions(params);
+		}
+		if (selfCollide) {
+			SolveSelfCollisions(params);
+		}
+	}
+	if (collide) {
+		UpdateVelocitiesWithContacts(params);
+	}
+	else {
+		UpdateVelocities(params);
+	}
+}
+
+void CpuClothSolver::Integrate(const SimParams& params)
+{
+	const uint32_t count = static_cast<uint32_t>(positions_.size());
+	pool_.ParallelFor(count, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+		uint32_t i = begin;
+#if CLOTH_SIMD_AVX
+		if (simd_path_ == SimdPath::Avx) {
+			const __m256 gdt8 = _mm256_set_ps(0.0f, 0.0f, params.gravityY * params.dt, 0.0f, 0.0f, 0.0f, params.gravityY * params.dt, 0.0f);
+			const __m256 dt8 = _mm256_set1_ps(params.dt);
+			for (; i + 2 <= end; i += 2) {
+				IntegrateTwo(&positions_[i], &velocities_[i], &predicted_[i], gdt8, dt8);
+			}
+		}
+#endif
+#if CLOTH_SIMD_SSE
+		if (simd_path_ != SimdPath::Scalar) {
+			const __m128 gdt = _mm_set_ps(0.0f, 0.0f, params.gravityY * params.dt, 0.0f);
+			const __m128 dt = _mm_set1_ps(params.dt);
+			for (; i < end; ++i) {
+				IntegrateOne(positions_[i], velocities_[i], predicted_[i], gdt, dt);
+			}
+		}
+#endif
+		// SIMD 경로와 같게 x / z 에도 0 을 더한다 (-0 + 0 = +0)
+		const glm::vec3 gdt(0.0f, params.gravityY * params.dt, 0.0f);
+		for (; i < end; ++i) {
+			const glm::vec4 x = positions_[i];
+			if (x.w == 0.0f) {
+				predicted_[i] = x;
+				continue;
+			}
+			const glm::vec3 v = glm::vec3(velocities_[i]) + gdt;
+			predicted_[i] = glm::vec4(glm::vec3(x) + v * params.dt, x.w);
+			velocities_[i] = glm::vec4(v, 0.0f);
+		}
+	});
+}
+
+void CpuClothSolver::SolveGaussSeidel(const SimParams& params, uint32_t iteration)
+{
+	// color 순서는 GPU dispatch 순서와 같고, 같은 color 안에서는 particle 을 공유하지 않으므로 나눠서 병렬 처리
+	const auto& constraints = constraints_.constraints_;
+	for (const auto& batch : constraints_.batches_) {
+		pool_.ParallelFor(batch.count, kConstraintGrain, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t c = batch.first + begin; c < batch.first + end; ++c) {
+				const DistanceConstraint& dc = constraints[c];
+				glm::vec4& pa = predicted_[dc.a];
+				glm::vec4& pb = predicted_[dc.b];
+
+				const float lambda = (iteration == 0) ? 0.0f : lambdas_[c];
+				float dLambda;
+				glm::vec4 n;
+				if (!ComputeDistanceCorrection(pa, pb, dc, lambda, params.dt, Compliance(params, dc.type), simd_path_ != SimdPath::Scalar, dLambda, n)) {
+					lambdas_[c] = lambda;
+					continue;
+				}
+
+				// n.w = 0 이므로 w(inverse mass) 는 그대로
+				pa += (pa.w * dLambda) * n;
+				pb -= (pb.w * dLambda) * n;
+				lambdas_[c] = lambda + dLambda;
+			}
+		});
+	}
+}
+
+void CpuClothSolver::SolveJacobi(const SimParams& params, uint32_t iteration)
+{
+	// jacobi_solve.comp : 고정소수점 정수 누적이라 더하는 순서와 무관하게 GPU 와 같은 합이 나온다.
+	// GPU 는 atomicAdd 를 쓰지만 CPU 에서는 color batch 단위로 나누면 같은 batch 안에서 particle 이 겹치지 않으므로
+	// atomic 없이 더해도 된다.
+	const auto& constraints = constraints_.constraints_;
+	for (const auto& batch : constraints_.batches_) {
+		pool_.ParallelFor(batch.count, kConstraintGrain, [&](uint32_t begin, uint32_t end) {
+			auto accumulate = [&](uint32_t particle, const glm::vec3& dx) {
+				const glm::ivec3 fixedPoint(glm::round(dx * static_cast<float>(PARTICLE_DELTA_FIXED_POINT_SCALE)));
+				deltas_[particle] += glm::ivec4(fixedPoint, 1);
+			};
+
+			for (uint32_t c = batch.first + begin; c < batch.first + end; ++c) {
+				const DistanceConstraint& dc = constraints[c];
+				const glm::vec4 pa = predicted_[dc.a];
+				const glm::vec4 pb = predicted_[dc.b];
+
+				const float lambda = (iteration == 0) ? 0.0f : lambdas_[c];
+				float dLambda;
+				glm::vec4 n;
+				if (!ComputeDistanceCorrection(pa, pb, dc, lambda, params.dt, Compliance(params, dc.type), simd_path_ != SimdPath::Scalar, dLambda, n)) {
+					lambdas_[c] = lambda;
+					continue;
+				}
+
+				if (pa.w > 0.0f) accumulate(dc.a, pa.w * dLambda * glm::vec3(n));
+				if (pb.w > 0.0f) accumulate(dc.b, -pb.w * dLambda * glm::vec3(n));
+				lambdas_[c] = lambda + dLambda;
+			}
+		});
+	}
+
+	// jacobi_apply.comp : 평균 * relaxation 적용 후 누적 초기화
+	const uint32_t count = static_cast<uint32_t>(predicted_.size());
+	pool_.ParallelFor(count, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			glm::ivec4& delta = deltas_[i];
+			if (delta.w == 0) continue;
+
+			const glm::vec3 dx = glm::vec3(delta) / static_cast<float>(PARTICLE_DELTA_FIXED_POINT_SCALE);
+			predicted_[i] += glm::vec4(params.relaxation * dx / static_cast<float>(delta.w), 0.0f);
+			delta = glm::ivec4(0);
+		}
+	});
+}
+
+uint32_t CpuClothSolver::ColliderCount(const SimParams& params) const
+{
+	return colliders_ ? std::min(params.numColliders, static_cast<uint32_t>(colliders_->size())) : 0u;
+}
+
+void CpuClothSolver::SolveCollisions(const SimParams& params)
+{
+	// solve_collisions.comp : margin 안쪽이면 collider 순서대로 바깥으로 밀어낸다
+	const uint32_t colliderCount = ColliderCount(params);
+	const uint32_t count = static_cast<uint32_t>(predicted_.size());
+	pool_.ParallelFor(count, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			glm::vec4& p = predicted_[i];
+			if (p.w == 0.0f) continue;
+
+			glm::vec3 pos(p);
+			for (uint32_t c = 0; c < colliderCount; ++c) {
+				glm::vec3 n;
+				const float d = ColliderDistance((*colliders_)[c], sdf_values_->data(), pos, n);
+				if (d < params.collisionMargin) {
+					pos += n * (params.collisionMargin - d);
+				}
+			}
+			p = glm::vec4(pos, p.w);
+		}
+	});
+}
+
+void CpuClothSolver::BuildHashGrid(const SimParams& params)
+{
+	// hash_count / PrefixSum / hash_scatter. bucket 안의 순서는 GPU (atomicAdd 순서) 와 다르지만 보정은 고정소수점 합이라 같다
+	const uint32_t count = static_cast<uint32_t>(predicted_.size());
+	const uint32_t tableMask = SpatialHash::TableSize(count) - 1;
+	const float cellSize = params.selfCollisionDistance;
+
+	std::vector<uint32_t> buckets(count);
+	hash_starts_.assign(tableMask + 2, 0);
+	for (uint32_t i = 0; i < count; ++i) {
+		buckets[i] = SpatialHashBucket(SpatialHashCell(glm::vec3(predicted_[i]), cellSize), tableMask);
+		++hash_starts_[buckets[i] + 1];
+	}
+	for (uint32_t b = 0; b <= tableMask; ++b) hash_starts_[b + 1] += hash_starts_[b];
+
+	hash_sorted_.resize(count);
+	std::vector<uint32_t> cursor(hash_starts_.begin(), hash_starts_.end() - 1);
+	for (uint32_t i = 0; i < count; ++i) {
+		hash_sorted_[cursor[buckets[i]]++] = i;
+	}
+}
+
+void CpuClothSolver::SolveSelfCollisions(const SimParams& params)
+{
+	// self_collide.comp : particle 마다 자기 보정만 deltas_ 에 쓰므로 나눠서 병렬 처리
+	const uint32_t count = static_cast<uint32_t>(predicted_.size());
+	const uint32_t tableMask = static_cast<uint32_t>(hash_starts_.size()) - 2;
+	const float distance = params.selfCollisionDistance;
+	const float dist2 = distance * distance;
+	pool_.ParallelFor(count, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			const glm::vec4 pi = predicted_[i];
+			if (pi.w == 0.0f) continue;
+
+			const glm::vec3 rest(rest_positions_[i]);
+			const glm::ivec3 base = SpatialHashCell(glm::vec3(pi), distance);
+
+			std::array<uint32_t, 27> visited;
+			uint32_t visitedCount = 0;
+			glm::ivec3 sum(0);
+			int32_t pairs = 0;
+			for (int dz = -1; dz <= 1; ++dz)
+			for (int dy = -1; dy <= 1; ++dy)
+			for (int dx = -1; dx <= 1; ++dx) {
+				const uint32_t bucket = SpatialHashBucket(base + glm::ivec3(dx, dy, dz), tableMask);
+				if (std::find(visited.begin(), visited.begin() + visitedCount, bucket) != visited.begin() + visitedCount) continue;
+				visited[visitedCount++] = bucket;
+
+				for (uint32_t s = hash_starts_[bucket]; s < hash_starts_[bucket + 1]; ++s) {
+					const uint32_t j = hash_sorted_[s];
+					if (j == i) continue;
+
+					const glm::vec4 pj = predicted_[j];
+					const glm::vec3 d = glm::vec3(pi) - glm::vec3(pj);
+					const float len2 = glm::dot(d, d);
+					if (len2 >= dist2 || len2 < 1e-12f) continue;
+
+					const glm::vec3 r = rest - glm::vec3(rest_positions_[j]);
+					if (glm::dot(r, r) < dist2) continue;
+
+					const float len = std::sqrt(len2);
+					const glm::vec3 correction = (pi.w / (pi.w + pj.w)) * (distance - len) / len * d;
+					sum += glm::ivec3(glm::round(correction * static_cast<float>(PARTICLE_DELTA_FIXED_POINT_SCALE)));
+					++pairs;
+				}
+			}
+			deltas_[i] = glm::ivec4(sum, pairs);
+		}
+	});
+
+	// jacobi_apply.comp (APPLY_RELAXATION = false) : 평균만 적용
+	pool_.ParallelFor(count, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			glm::ivec4& delta = deltas_[i];
+			if (delta.w == 0) continue;
+
+			const glm::vec3 dx = glm::vec3(delta) / static_cast<float>(PARTICLE_DELTA_FIXED_POINT_SCALE);
+			predicted_[i] += glm::vec4(dx / static_cast<float>(delta.w), 0.0f);
+			delta = glm::ivec4(0);
+		}
+	});
+}
+
+void CpuClothSolver::UpdateVelocitiesWithContacts(const SimParams& params)
+{
+	// update_velocity.comp 의 접촉 처리. 분기가 많아 SIMD 경로 없이 particle 하나씩
+	const uint32_t colliderCount = ColliderCount(params);
+	const uint32_t count = static_cast<uint32_t>(positions_.size());
+	pool_.ParallelFor(count, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t i = begin; i < end; ++i) {
+			const glm::vec4 x = positions_[i];
+			if (x.w == 0.0f) continue;
+
+			const glm::vec3 p(predicted_[i]);
+			glm::vec3 v = (p - glm::vec3(x)) / params.dt;
+
+			float nearest = 2.0f * params.collisionMargin;
+			glm::vec3 n(0.0f);
+			glm::vec3 colliderVelocity(0.0f);
+			for (uint32_t c = 0; c < colliderCount; ++c) {
+				const Collider& collider = (*colliders_)[c];
+				glm::vec3 cn;
+				const float d = ColliderDistance(collider, sdf_values_->data(), p, cn);
+				if (d < nearest) {
+					nearest = d;
+					n = cn;
+					colliderVelocity = glm::vec3(collider.velocity);
+				}
+			}
+			if (glm::dot(n, n) > 0.0f) {
+				const glm::vec3 vRel = v - colliderVelocity;
+				const float vn = glm::dot(vRel, n);
+				const float vnBefore = glm::dot(glm::vec3(velocities_[i]) - colliderVelocity, n);
+				const float vnAfter = std::min(vn, vnBefore < 0.0f ? -params.restitution * vnBefore : vnBefore);
+
+				glm::vec3 vt = vRel - n * vn;
+				const float vtLength = glm::length(vt);
+				const float dvn = std::max(vnAfter - vnBefore, 0.0f);
+				if (vtLength > 1e-6f) {
+					vt *= std::max(1.0f - params.friction * dvn / vtLength, 0.0f);
+				}
+				v = colliderVelocity + vt + n * vnAfter;
+			}
+
+			velocities_[i] = glm::vec4(v, 0.0f);
+			positions_[i] = glm::vec4(p, x.w);
+		}
+	});
+}
+
+void CpuClothSolver::UpdateVelocities(const SimParams& params)
+{
+	const uint32_t count = static_cast<uint32_t>(positions_.size());
+	pool_.ParallelFor(count, kParticleGrain, [&](uint32_t begin, uint32_t end) {
+		uint32_t i = begin;
+#if CLOTH_SIMD_AVX
+		if (simd_path_ == SimdPath::Avx) {
+			const __m256 dt8 = _mm256_set1_ps(params.dt);
+			for (; i + 2 <= end; i += 2) {
+				UpdateVelocityTwo(&positions_[i], &velocities_[i], &predicted_[i], dt8);
+			}
+		}
+#endif
+#if CLOTH_SIMD_SSE
+		if (simd_path_ != SimdPath::Scalar) {
+			const __m128 dt = _mm_set1_ps(params.dt);
+			for (; i < end; ++i) {
+				UpdateVelocityOne(positions_[i], velocities_[i], predicted_[i], dt);
+			}
+		}
+#endif
+		for (; i < end; ++i) {
+			const glm::vec4 x = positions_[i];
+			if (x.w == 0.0f) continue;
+
+			const glm::vec3 p = glm::vec3(predicted_[i]);
+			velocities_[i] = glm::vec4((p - glm::vec3(x)) / params.dt, 0.0f);
+			positions_[i] = glm::vec4(p, x.w);
+		}
+	});
+}
+
+float CpuClothSolver::MaxDifference(const std::vector<glm::vec4>& a, const std::vector<glm::vec4>& b)
+{
+	if (a.size() != b.size()) return std::numeric_limits<float>::infinity();
+
+	float maxDiff = 0.0f;
+	for (size_t i = 0; i < a.size(); ++i) {
+		const glm::vec3 diff = glm::abs(glm::vec3(a[i]) - glm::vec3(b[i]));
+		if (std::isnan(diff.x + diff.y + diff.z)) return std::numeric_limits<float>::infinity();
+		maxDiff = std::max({ maxDiff, diff.x, diff.y, diff.z });
+	}
+	return maxDiff;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "sim_params.h"
+
+class ClothConstraints;
+class ThreadPool;
+struct Collider;
+
+// integrate.comp / solve_distance.comp / jacobi_*.comp / solve_collisions.comp / self_collide.comp / update_velocity.comp #pragma once
+
+#include "sim_params.h"
+
+class ClothConstraints;
+class ThreadPool;
+struct Collider;
+
+// integrate.comp / solve_distance.comp / jacobi_*.comp / solve_collisions.comp / self_collide.comp / update_velocity.comp 의 CPU 구현.
+// GPU 와 같은 SoA vec4 stream (particle_layout.h) 을 쓰고, 같은 color batch 순서로 풀어서
+// compute queue 가 없을 때의 fallback 과 GPU 결과 검증용 reference 로 사용한다.
+class CpuClothSolver
+{
+public:
+	// particle 단위 연산의 명령어 경로. 빌드에 들어간 것 중 가장 넓은 경로가 기본이고,
+	// 모든 경로는 같은 연산을 같은 순서로 해서 bit 단위로 같은 결과가 나와야 한다 (--cpu-reference 가 비교)
+	enum class SimdPath { Scalar, Sse, Avx };
+	static SimdPath BestSimdPath();
+	static const char* ToString(SimdPath path);
+
+	// positions : BuildClothParticles 결과 (w = inverse mass). self-collision 의 rest 위치로도 쓴다
+	CpuClothSolver(const std::vector<glm::vec4>& positions, const ClothConstraints& constraints, ThreadPool& pool);
+	CpuClothSolver(const CpuClothSolver& rhs) = delete;
+	CpuClothSolver(CpuClothSolver&& rhs) = delete;
+	CpuClothSolver& operator=(const CpuClothSolver& rhs) = delete;
+	CpuClothSolver& operator=(CpuClothSolver&& rhs) = delete;
+	~CpuClothSolver() = default;
+
+	void Reset(const std::vector<glm::vec4>& positions);
+	// 이후 Step 이 충돌할 collider 와 SDF 값 (ColliderSet / MeshPool 이 들고 있는 배열을 가리키기만 한다)
+	void SetColliders(const std::vector<Collider>& colliders, const std::vector<float>& sdfValues);
+	void Step(const SimParams& params);
+	// 빌드에 없는 경로는 BestSimdPath 로 내린다
+	void SetSimdPath(SimdPath path) { simd_path_ = std::min(path, BestSimdPath()); }
+	SimdPath GetSimdPath() const { return simd_path_; }
+
+	const std::vector<glm::vec4>& Positions() const { return positions_; }
+	const std::vector<glm::vec4>& Velocities() const { return velocities_; }
+
+	// 두 position stream 의 xyz 최대 오차
+	static float MaxDifference(const std::vector<glm::vec4>& a, const std::vector<glm::vec4>& b);
+
+private:
+	void Integrate(const SimParams& params);
+	void SolveGaussSeidel(const SimParams& params, uint32_t iteration);
+	void SolveJacobi(const SimParams& params, uint32_t iteration);
+	void SolveCollisions(const SimParams& params);
+	void BuildHashGrid(const SimParams& params);
+	void SolveSelfCollisions(const SimParams& params);
+	void UpdateVelocities(const SimParams& params);
+	void UpdateVelocitiesWithContacts(const SimParams& params);
+	uint32_t ColliderCount(const SimParams& params) const;
+
+	const ClothConstraints& constraints_;
+	ThreadPool& pool_;
+	SimdPath simd_path_ = BestSimdPath();
+
+	std::vector<glm::vec4> positions_;
+	std::vector<glm::vec4> velocities_;
+	std::vector<glm::vec4> predicted_;
+	std::vector<glm::ivec4> deltas_;
+	std::vector<float> lambdas_;
+
+	// SpatialHash 와 같은 bucket 의 counting sort 결과
+	std::vector<glm::vec4> rest_positions_;
+	std::vector<uint32_t> hash_starts_; // bucket 수 + 1
+	std::vector<uint32_t> hash_sorted_;
+
+	const std::vector<Collider>* colliders_ = nullptr;
+	const std::vector<float>* sdf_values_ = nullptr;
+};
@@ -0,0 +1,142 @@
+#include "cpu_profiler.h"
+
+namespace {
+	// slot #include "cpu_profiler.h"
+
+namespace {
+	// slot 은 seqlock 처럼 다룬다. 쓰는 쪽은 소유 thread 하나뿐이고, 읽는 쪽은 기록 중인 thread 와 동시에 slot 을 읽으므로
+	// field 마다 relaxed atomic 으로 둔다 (x86 / ARM 에서 일반 load / store 와 같은 명령).
+	// 읽는 쪽은 head 를 앞뒤로 두 번 읽어, 읽는 동안 덮어써졌을 수 있는 slot 은 버린다.
+	struct Slot {
+		std::atomic<const char*> name{ nullptr };
+		std::atomic<int64_t> begin_ns{ 0 };
+		std::atomic<int64_t> end_ns{ 0 };
+	};
+
+	struct ThreadRing {
+		std::array<Slot, CpuProfiler::kRingSize> events{};
+		std::atomic<uint64_t> head{ 0 };
+		std::atomic<const char*> name{ nullptr };
+		uint32_t tid = 0;
+	};
+
+	// ring 은 thread 가 끝나도 export 할 수 있도록 registry 가 소유 (등록은 thread 당 한 번)
+	struct Registry {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadRing>> rings;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	ThreadRing& LocalRing()
+	{
+		thread_local ThreadRing* ring = []() {
+			Registry& registry = GetRegistry();
+			std::lock_guard lock(registry.mutex);
+			auto& created = registry.rings.emplace_back(std::make_unique<ThreadRing>());
+			created->tid = static_cast<uint32_t>(registry.rings.size());
+			return created.get();
+		}();
+		return *ring;
+	}
+
+	void WriteJsonString(std::ostream& out, const char* text)
+	{
+		out << '"';
+		for (const char* c = text; *c; ++c) {
+			if (*c == '"' || *c == '\\') out << '\\';
+			out << *c;
+		}
+		out << '"';
+	}
+}
+
+int64_t CpuProfiler::NowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CpuProfiler::Record(const char* name, int64_t beginNs, int64_t endNs)
+{
+	ThreadRing& ring = LocalRing();
+	const uint64_t head = ring.head.load(std::memory_order_relaxed);
+	// 직전 head store 가 이번 slot 쓰기보다 먼저 보이도록. 읽는 쪽이 새 값을 봤다면 뒤에 읽는 head 도 그만큼 앞서 있다
+	std::atomic_thread_fence(std::memory_order_release);
+	Slot& slot = ring.events[head % kRingSize];
+	slot.name.store(name, std::memory_order_relaxed);
+	slot.begin_ns.store(beginNs, std::memory_order_relaxed);
+	slot.end_ns.store(endNs, std::memory_order_relaxed);
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+	LocalRing().name.store(name, std::memory_order_release);
+}
+
+bool CpuProfiler::WriteChromeTrace(const std::string& path)
+{
+	std::vector<ThreadRing*> rings;
+	{
+		Registry& registry = GetRegistry();
+		std::lock_guard lock(registry.mutex);
+		for (auto& ring : registry.rings) rings.push_back(ring.get());
+	}
+
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "failed to write cpu trace to " << path << std::endl;
+		return false;
+	}
+
+	// ts / dur 는 microsecond
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	size_t eventCount = 0;
+	std::vector<CpuProfiler::Event> events;
+
+	for (ThreadRing* ring : rings) {
+		const char* threadName = ring->name.load(std::memory_order_acquire);
+		if (threadName) {
+			file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->tid << ",\"args\":{\"name\":";
+			WriteJsonString(file, threadName);
+			file << "}}";
+			first = false;
+		}
+
+		const uint64_t head = ring->head.load(std::memory_order_acquire);
+		const uint64_t begin = head > kRingSize ? head - kRingSize : 0;
+		events.clear();
+		for (uint64_t i = begin; i < head; ++i) {
+			const Slot& slot = ring->events[i % kRingSize];
+			events.push_back({ slot.name.load(std::memory_order_relaxed), slot.begin_ns.load(std::memory_order_relaxed), slot.end_ns.load(std::memory_order_relaxed) });
+		}
+
+		// 복사하는 동안 writer 가 덮어쓴 slot 은 버림. writer 는 headAfter 를 publish 하기 전에 index headAfter 의 slot
+		// (= index headAfter - kRingSize) 을 쓰고 있을 수 있으므로 그 slot 도 뺀다
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64_t headAfter = ring->head.load(std::memory_order_relaxed);
+		const uint64_t validBegin = headAfter >= kRingSize ? headAfter - kRingSize + 1 : 0;
+		const size_t skip = static_cast<size_t>(std::min<uint64_t>(validBegin > begin ? validBegin - begin : 0, events.size()));
+
+		for (size_t i = skip; i < events.size(); ++i) {
+			const auto& event = events[i];
+			file << (first ? "" : ",") << "\n{\"name\":";
+			WriteJsonString(file, event.name);
+			file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->tid
+				<< ",\"ts\":" << event.begin_ns / 1000 << "." << std::setw(3) << std::setfill('0') << event.begin_ns % 1000
+				<< ",\"dur\":" << (event.end_ns - event.begin_ns) / 1000 << "." << std::setw(3) << std::setfill('0') << (event.end_ns - event.begin_ns) % 1000
+				<< std::setfill(' ') << "}";
+			first = false;
+			++eventCount;
+		}
+	}
+	file << "\n]}\n";
+
+	std::cout << "cpu trace written to " << path << " (" << eventCount << " events, " << rings.size() << " threads)" << std::endl;
+	return true;
+}
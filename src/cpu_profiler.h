@@ -0,0 +1,55 @@
+#pragma once
+
+// CPU frame phase 痢≪젙.
+// PE_CPU_SCOPE("name") #pragma once
+
+// CPU frame phase 측정.
+// PE_CPU_SCOPE("name") 으로 구간을 표시하면 thread 별 lock-free ring buffer 에 기록되고,
+// CpuProfiler::WriteChromeTrace 로 Chrome trace / Perfetto 에서 열 수 있는 JSON 을 만든다.
+// POWERENGINE_CPU_PROFILER 가 정의되지 않으면 PE_CPU_SCOPE / PE_CPU_THREAD_NAME 은 아무 코드도 만들지 않는다.
+// name 은 string literal 처럼 프로그램 끝까지 살아있는 문자열이어야 한다.
+
+#if defined(POWERENGINE_CPU_PROFILER)
+#define PE_CPU_PROFILER_ENABLED 1
+#define PE_CPU_CONCAT_INNER(a, b) a##b
+#define PE_CPU_CONCAT(a, b) PE_CPU_CONCAT_INNER(a, b)
+#define PE_CPU_SCOPE(name) CpuProfileScope PE_CPU_CONCAT(pe_cpu_scope_, __LINE__)(name)
+#define PE_CPU_THREAD_NAME(name) CpuProfiler::SetThreadName(name)
+#else
+#define PE_CPU_PROFILER_ENABLED 0
+#define PE_CPU_SCOPE(name) ((void)0)
+#define PE_CPU_THREAD_NAME(name) ((void)0)
+#endif
+
+class CpuProfiler
+{
+public:
+	struct Event {
+		const char* name;
+		int64_t begin_ns;
+		int64_t end_ns;
+	};
+
+	// thread 마다 최근 kRingSize 개의 event 만 남는다
+	static constexpr uint32_t kRingSize = 1u << 14;
+
+	static void Record(const char* name, int64_t beginNs, int64_t endNs);
+	static void SetThreadName(const char* name);
+	static int64_t NowNs();
+
+	// 모든 thread 의 ring buffer 를 읽어 Chrome trace JSON 으로 저장. 기록 중인 thread 를 멈추지 않는다
+	static bool WriteChromeTrace(const std::string& path);
+};
+
+class CpuProfileScope
+{
+public:
+	explicit CpuProfileScope(const char* name) : name_(name), begin_ns_(CpuProfiler::NowNs()) {}
+	CpuProfileScope(const CpuProfileScope& rhs) = delete;
+	CpuProfileScope& operator=(const CpuProfileScope& rhs) = delete;
+	~CpuProfileScope() { CpuProfiler::Record(name_, begin_ns_, CpuProfiler::NowNs()); }
+
+private:
+	const char* name_;
+	int64_t begin_ns_;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+// view-projection #pragma once
+
+// view-projection 행렬에서 뽑은 6 개 평면 (Gribb-Hartmann). 법선은 안쪽, GLM_FORCE_DEPTH_ZERO_TO_ONE 기준.
+// 같은 판정을 cull_instances.comp 가 GPU 에서 한다
+struct Frustum
+{
+	std::array<glm::vec4, 6> planes;
+
+	static Frustum FromViewProj(const glm::mat4& viewProj)
+	{
+		const glm::mat4 m = glm::transpose(viewProj); // m[i] = viewProj 의 i 번째 row
+		Frustum frustum;
+		frustum.planes = {
+			m[3] + m[0], // left
+			m[3] - m[0], // right
+			m[3] + m[1], // bottom
+			m[3] - m[1], // top
+			m[2],        // near (z >= 0)
+			m[3] - m[2]  // far
+		};
+		for (auto& plane : frustum.planes) {
+			plane /= glm::length(glm::vec3(plane));
+		}
+		return frustum;
+	}
+
+	bool Intersects(const glm::vec3& center, float radius) const
+	{
+		for (const auto& plane : planes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+		}
+		return true;
+	}
+};
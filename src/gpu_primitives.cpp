@@ -0,0 +1,435 @@
+#include "gpu_primitives.h"
+
+namespace
+{
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+
+	void AddComputeBarrier(const vk::raii::CommandBuffer& cmd)
+	{
+		AddBarrier(cmd,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+	}
+
+	uint32_t DivideRoundUp(uint32_t value, uint32_t divisor)
+	{
+		return (value + divisor - 1) / divisor;
+	}
+
+	bool IsPowerOfTwo(uint32_t value)
+	{
+		return value != 0 && (value & (value - 1)) == 0;
+	}
+
+	// #include "gpu_primitives.h"
+
+namespace
+{
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+
+	void AddComputeBarrier(const vk::raii::CommandBuffer& cmd)
+	{
+		AddBarrier(cmd,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+	}
+
+	uint32_t DivideRoundUp(uint32_t value, uint32_t divisor)
+	{
+		return (value + divisor - 1) / divisor;
+	}
+
+	bool IsPowerOfTwo(uint32_t value)
+	{
+		return value != 0 && (value & (value - 1)) == 0;
+	}
+
+	// 아래는 primitive 들이 같이 쓰는 생성 helper. binding 은 모두 compute 의 storage buffer
+	vk::raii::DescriptorSetLayout CreateStorageSetLayout(vk::raii::Device& device, uint32_t bindingCount)
+	{
+		std::vector<vk::DescriptorSetLayoutBinding> layoutBindings(bindingCount);
+		for (uint32_t binding = 0; binding < bindingCount; ++binding) {
+			layoutBindings[binding] = vk::DescriptorSetLayoutBinding{ binding, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute };
+		}
+		vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = bindingCount, .pBindings = layoutBindings.data() };
+		return vk::raii::DescriptorSetLayout(device, layoutInfo);
+	}
+
+	vk::raii::DescriptorPool CreateStoragePool(vk::raii::Device& device, uint32_t setCount, uint32_t bindingCount)
+	{
+		vk::DescriptorPoolSize poolSize{ vk::DescriptorType::eStorageBuffer, bindingCount * setCount };
+		vk::DescriptorPoolCreateInfo poolInfo{
+			.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+			.maxSets = setCount,
+			.poolSizeCount = 1,
+			.pPoolSizes = &poolSize
+		};
+		return vk::raii::DescriptorPool(device, poolInfo);
+	}
+
+	vk::raii::DescriptorSet AllocateSet(vk::raii::Device& device, const vk::raii::DescriptorPool& pool, const vk::raii::DescriptorSetLayout& layout)
+	{
+		vk::DescriptorSetAllocateInfo allocInfo{ .descriptorPool = *pool, .descriptorSetCount = 1, .pSetLayouts = &*layout };
+		return std::move(vk::raii::DescriptorSets{ device, allocInfo }.front());
+	}
+
+	vk::WriteDescriptorSet StorageWrite(const vk::raii::DescriptorSet& set, uint32_t binding, const vk::DescriptorBufferInfo& info)
+	{
+		return vk::WriteDescriptorSet{
+			.dstSet = *set,
+			.dstBinding = binding,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.pBufferInfo = &info
+		};
+	}
+
+	vk::raii::PipelineLayout CreatePipelineLayout(vk::raii::Device& device, const vk::raii::DescriptorSetLayout& setLayout, uint32_t pushConstantSize)
+	{
+		vk::PushConstantRange pushConstantRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = pushConstantSize };
+		vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 1, .pSetLayouts = &*setLayout, .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange };
+		return vk::raii::PipelineLayout(device, pipelineLayoutInfo);
+	}
+
+	// specialization constant i = constants[i]. constant 0 은 항상 workgroup 크기 (local_size_x_id = 0)
+	vk::raii::Pipeline CreatePipeline(vk::raii::Device& device, const vk::raii::PipelineLayout& layout, const std::string& path, const std::vector<uint32_t>& constants)
+	{
+		std::vector<vk::SpecializationMapEntry> specEntries;
+		for (uint32_t i = 0; i < constants.size(); ++i) {
+			specEntries.push_back(vk::SpecializationMapEntry{ .constantID = i, .offset = i * static_cast<uint32_t>(sizeof(uint32_t)), .size = sizeof(uint32_t) });
+		}
+		vk::SpecializationInfo specInfo{
+			.mapEntryCount = static_cast<uint32_t>(specEntries.size()),
+			.pMapEntries = specEntries.data(),
+			.dataSize = constants.size() * sizeof(uint32_t),
+			.pData = constants.data()
+		};
+		vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device, vku::ReadFile(path));
+		vk::PipelineShaderStageCreateInfo stageInfo{ .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main", .pSpecializationInfo = &specInfo };
+		vk::ComputePipelineCreateInfo pipelineInfo{ .stage = stageInfo, .layout = *layout };
+		return vk::raii::Pipeline(device, nullptr, pipelineInfo);
+	}
+}
+
+namespace vku
+{
+	PrefixSum::PrefixSum(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, uint32_t workgroupSize)
+		: device_(device), allocator_(allocator), max_count_(std::max(maxCount, 1u)), workgroup_size_(workgroupSize)
+	{
+		if (!IsPowerOfTwo(workgroup_size_)) {
+			throw std::runtime_error("prefix sum workgroup size must be a power of two!");
+		}
+
+		// level k 의 원소 수 = level k-1 의 block 수. block 이 하나가 되는 level 까지
+		std::vector<uint32_t> blockCounts;
+		for (uint32_t count = max_count_;;) {
+			const uint32_t blocks = DivideRoundUp(count, workgroup_size_);
+			blockCounts.push_back(blocks);
+			if (blocks == 1) break;
+			count = blocks;
+		}
+		const uint32_t levelCount = static_cast<uint32_t>(blockCounts.size());
+
+		set_layout_ = CreateStorageSetLayout(device_, SCAN_BINDING_COUNT);
+		descriptor_pool_ = CreateStoragePool(device_, levelCount, SCAN_BINDING_COUNT);
+
+		levels_.resize(levelCount);
+		for (uint32_t k = 0; k < levelCount; ++k) {
+			Level& level = levels_[k];
+			level.set = AllocateSet(device_, descriptor_pool_, set_layout_);
+			CreateBuffer(allocator_, sizeof(uint32_t) * blockCounts[k], vk::BufferUsageFlagBits::eStorageBuffer,
+				vk::MemoryPropertyFlagBits::eDeviceLocal, level.sums, level.sums_memory);
+		}
+
+		// 위 level 은 아래 level 의 block 합을 in-place 로 scan 한다. level 0 의 input / output 은 SetBuffers 가
+		for (uint32_t k = 0; k < levelCount; ++k) {
+			vk::DescriptorBufferInfo sums{ *levels_[k].sums, 0, VK_WHOLE_SIZE };
+			std::vector<vk::WriteDescriptorSet> writes{ StorageWrite(levels_[k].set, SCAN_BINDING_SUMS, sums) };
+			vk::DescriptorBufferInfo below{ nullptr, 0, VK_WHOLE_SIZE };
+			if (k > 0) {
+				below.buffer = *levels_[k - 1].sums;
+				writes.push_back(StorageWrite(levels_[k].set, SCAN_BINDING_INPUT, below));
+				writes.push_back(StorageWrite(levels_[k].set, SCAN_BINDING_OUTPUT, below));
+			}
+			device_.updateDescriptorSets(writes, {});
+		}
+
+		pipeline_layout_ = CreatePipelineLayout(device_, set_layout_, sizeof(uint32_t));
+		scan_pipeline_ = CreatePipeline(device_, pipeline_layout_, "shaders/scan.comp.spv", { workgroup_size_ });
+		add_pipeline_ = CreatePipeline(device_, pipeline_layout_, "shaders/scan_add.comp.spv", { workgroup_size_ });
+	}
+
+	void PrefixSum::SetBuffers(const vk::DescriptorBufferInfo& input, const vk::DescriptorBufferInfo& output)
+	{
+		std::array writes{
+			StorageWrite(levels_.front().set, SCAN_BINDING_INPUT, input),
+			StorageWrite(levels_.front().set, SCAN_BINDING_OUTPUT, output)
+		};
+		device_.updateDescriptorSets(writes, {});
+	}
+
+	void PrefixSum::Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const
+	{
+		if (count == 0) return;
+		if (count > max_count_) {
+			throw std::runtime_error("prefix sum count exceeds capacity!");
+		}
+
+		// 이번 count 로 필요한 level 수와 level 마다의 원소 수
+		std::array<uint32_t, 8> counts{};
+		uint32_t levelCount = 0;
+		for (uint32_t n = count;;) {
+			counts[levelCount++] = n;
+			if (n <= workgroup_size_) break;
+			n = DivideRoundUp(n, workgroup_size_);
+		}
+
+		// 올라가면서 block scan
+		cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *scan_pipeline_);
+		for (uint32_t k = 0; k < levelCount; ++k) {
+			cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *levels_[k].set }, {});
+			cmd.pushConstants<uint32_t>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, counts[k]);
+			cmd.dispatch(DivideRoundUp(counts[k], workgroup_size_), 1, 1);
+			AddComputeBarrier(cmd);
+		}
+
+		// 내려오면서 위 level 의 결과 (= 이 level 의 scan 된 block 합) 를 더한다
+		if (levelCount > 1) {
+			cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *add_pipeline_);
+			for (uint32_t k = levelCount - 1; k-- > 0;) {
+				cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *levels_[k].set }, {});
+				cmd.pushConstants<uint32_t>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, counts[k]);
+				cmd.dispatch(DivideRoundUp(counts[k], workgroup_size_), 1, 1);
+				AddComputeBarrier(cmd);
+			}
+		}
+	}
+
+	Reduce::Reduce(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, ReduceOp op, uint32_t workgroupSize)
+		: device_(device), allocator_(allocator), max_count_(std::max(maxCount, 1u)), op_(op), workgroup_size_(workgroupSize)
+	{
+		if (!IsPowerOfTwo(workgroup_size_)) {
+			throw std::runtime_error("reduce workgroup size must be a power of two!");
+		}
+
+		// level k 의 workgroup 수. workgroup 이 하나인 level 이 마지막 (결과 buffer 에 쓴다)
+		const uint32_t itemsPerGroup = workgroup_size_ * REDUCE_ITEMS_PER_THREAD;
+		std::vector<uint32_t> groupCounts;
+		for (uint32_t count = max_count_;;) {
+			const uint32_t groups = DivideRoundUp(count, itemsPerGroup);
+			groupCounts.push_back(groups);
+			if (groups == 1) break;
+			count = groups;
+		}
+		const uint32_t levelCount = static_cast<uint32_t>(groupCounts.size());
+
+		set_layout_ = CreateStorageSetLayout(device_, REDUCE_BINDING_COUNT);
+		descriptor_pool_ = CreateStoragePool(device_, levelCount, REDUCE_BINDING_COUNT);
+
+		levels_.resize(levelCount);
+		for (uint32_t k = 0; k < levelCount; ++k) {
+			Level& level = levels_[k];
+			level.set = AllocateSet(device_, descriptor_pool_, set_layout_);
+			if (k + 1 < levelCount) {
+				CreateBuffer(allocator_, sizeof(uint32_t) * groupCounts[k], vk::BufferUsageFlagBits::eStorageBuffer,
+					vk::MemoryPropertyFlagBits::eDeviceLocal, level.partials, level.partials_memory);
+			}
+		}
+
+		// level k 의 출력 = level k+1 의 입력. level 0 의 입력과 마지막 level 의 출력은 SetBuffers 가
+		for (uint32_t k = 0; k + 1 < levelCount; ++k) {
+			vk::DescriptorBufferInfo partials{ *levels_[k].partials, 0, VK_WHOLE_SIZE };
+			std::array writes{
+				StorageWrite(levels_[k].set, REDUCE_BINDING_OUTPUT, partials),
+				StorageWrite(levels_[k + 1].set, REDUCE_BINDING_INPUT, partials)
+			};
+			device_.updateDescriptorSets(writes, {});
+		}
+
+		pipeline_layout_ = CreatePipelineLayout(device_, set_layout_, sizeof(uint32_t));
+		pipeline_ = CreatePipeline(device_, pipeline_layout_, "shaders/reduce.comp.spv", { workgroup_size_, static_cast<uint32_t>(op_) });
+	}
+
+	void Reduce::SetBuffers(const vk::DescriptorBufferInfo& input, const vk::DescriptorBufferInfo& result)
+	{
+		std::array writes{
+			StorageWrite(levels_.front().set, REDUCE_BINDING_INPUT, input),
+			StorageWrite(levels_.back().set, REDUCE_BINDING_OUTPUT, result)
+		};
+		device_.updateDescriptorSets(writes, {});
+	}
+
+	void Reduce::Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const
+	{
+		if (count > max_count_) {
+			throw std::runtime_error("reduce count exceeds capacity!");
+		}
+
+		// 결과 buffer 는 마지막 level 에 묶여 있으므로 count 가 작아도 모든 level 을 돈다. 위 level 은 workgroup 하나라 거의 공짜
+		const uint32_t itemsPerGroup = workgroup_size_ * REDUCE_ITEMS_PER_THREAD;
+		cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline_);
+		uint32_t n = count;
+		for (const Level& level : levels_) {
+			const uint32_t groups = std::max(DivideRoundUp(n, itemsPerGroup), 1u);
+			cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *level.set }, {});
+			cmd.pushConstants<uint32_t>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, n);
+			cmd.dispatch(groups, 1, 1);
+			AddComputeBarrier(cmd);
+			n = groups;
+		}
+	}
+
+	Compact::Compact(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, uint32_t workgroupSize)
+		: device_(device), allocator_(allocator), max_count_(std::max(maxCount, 1u)), workgroup_size_(workgroupSize)
+	{
+		if (!IsPowerOfTwo(workgroup_size_)) {
+			throw std::runtime_error("compact workgroup size must be a power of two!");
+		}
+
+		CreateBuffer(allocator_, sizeof(uint32_t) * max_count_, vk::BufferUsageFlagBits::eStorageBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, offsets_, offsets_memory_);
+		prefix_sum_ = std::make_unique<PrefixSum>(device_, allocator_, max_count_, workgroup_size_);
+
+		set_layout_ = CreateStorageSetLayout(device_, COMPACT_BINDING_COUNT);
+		descriptor_pool_ = CreateStoragePool(device_, 1, COMPACT_BINDING_COUNT);
+		set_ = AllocateSet(device_, descriptor_pool_, set_layout_);
+
+		vk::DescriptorBufferInfo offsets{ *offsets_, 0, VK_WHOLE_SIZE };
+		std::array writes{ StorageWrite(set_, COMPACT_BINDING_OFFSETS, offsets) };
+		device_.updateDescriptorSets(writes, {});
+
+		pipeline_layout_ = CreatePipelineLayout(device_, set_layout_, sizeof(uint32_t));
+		pipeline_ = CreatePipeline(device_, pipeline_layout_, "shaders/compact.comp.spv", { workgroup_size_ });
+	}
+
+	void Compact::SetBuffers(const vk::DescriptorBufferInfo& values, const vk::DescriptorBufferInfo& flags,
+		const vk::DescriptorBufferInfo& output, const vk::DescriptorBufferInfo& result)
+	{
+		prefix_sum_->SetBuffers(flags, vk::DescriptorBufferInfo{ *offsets_, 0, VK_WHOLE_SIZE });
+
+		std::array writes{
+			StorageWrite(set_, COMPACT_BINDING_VALUES, values),
+			StorageWrite(set_, COMPACT_BINDING_FLAGS, flags),
+			StorageWrite(set_, COMPACT_BINDING_OUTPUT, output),
+			StorageWrite(set_, COMPACT_BINDING_RESULT, result)
+		};
+		device_.updateDescriptorSets(writes, {});
+	}
+
+	void Compact::Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const
+	{
+		if (count == 0) return;
+		if (count > max_count_) {
+			throw std::runtime_error("compact count exceeds capacity!");
+		}
+
+		prefix_sum_->Record(cmd, count);
+
+		cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline_);
+		cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *set_ }, {});
+		cmd.pushConstants<uint32_t>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, count);
+		cmd.dispatch(DivideRoundUp(count, workgroup_size_), 1, 1);
+		AddComputeBarrier(cmd);
+	}
+
+	RadixSort::RadixSort(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, uint32_t workgroupSize)
+		: device_(device), allocator_(allocator), max_count_(std::max(maxCount, 1u)), workgroup_size_(workgroupSize)
+	{
+		if (!IsPowerOfTwo(workgroup_size_) || workgroup_size_ < 4) {
+			throw std::runtime_error("radix sort workgroup size must be a power of two and at least 4!");
+		}
+		static_assert(RADIX_PASSES % 2 == 0, "radix sort result must end in the caller's buffers");
+
+		const vk::DeviceSize bufferSize = sizeof(uint32_t) * max_count_;
+		CreateBuffer(allocator_, bufferSize, vk::BufferUsageFlagBits::eStorageBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, keys_temp_, keys_temp_memory_);
+		CreateBuffer(allocator_, bufferSize, vk::BufferUsageFlagBits::eStorageBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, values_temp_, values_temp_memory_);
+
+		// digit 순서 -> tile 순서. in-place 로 scan 하면 (digit, tile) 의 출력 시작 위치
+		const uint32_t histogramCount = RADIX_BUCKETS * TileCount(max_count_);
+		CreateBuffer(allocator_, sizeof(uint32_t) * histogramCount, vk::BufferUsageFlagBits::eStorageBuffer,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, histogram_, histogram_memory_);
+		prefix_sum_ = std::make_unique<PrefixSum>(device_, allocator_, histogramCount, workgroup_size_);
+		vk::DescriptorBufferInfo histogram{ *histogram_, 0, VK_WHOLE_SIZE };
+		prefix_sum_->SetBuffers(histogram, histogram);
+
+		set_layout_ = CreateStorageSetLayout(device_, RADIX_BINDING_COUNT);
+		descriptor_pool_ = CreateStoragePool(device_, static_cast<uint32_t>(sets_.size()), RADIX_BINDING_COUNT);
+		for (vk::raii::DescriptorSet& set : sets_) {
+			set = AllocateSet(device_, descriptor_pool_, set_layout_);
+		}
+
+		vk::DescriptorBufferInfo keysTemp{ *keys_temp_, 0, VK_WHOLE_SIZE };
+		vk::DescriptorBufferInfo valuesTemp{ *values_temp_, 0, VK_WHOLE_SIZE };
+		std::array writes{
+			StorageWrite(sets_[0], RADIX_BINDING_KEYS_OUT, keysTemp),
+			StorageWrite(sets_[0], RADIX_BINDING_VALUES_OUT, valuesTemp),
+			StorageWrite(sets_[0], RADIX_BINDING_HISTOGRAM, histogram),
+			StorageWrite(sets_[1], RADIX_BINDING_KEYS_IN, keysTemp),
+			StorageWrite(sets_[1], RADIX_BINDING_VALUES_IN, valuesTemp),
+			StorageWrite(sets_[1], RADIX_BINDING_HISTOGRAM, histogram)
+		};
+		device_.updateDescriptorSets(writes, {});
+
+		pipeline_layout_ = CreatePipelineLayout(device_, set_layout_, sizeof(PushConstants));
+		histogram_pipeline_ = CreatePipeline(device_, pipeline_layout_, "shaders/radix_histogram.comp.spv", { workgroup_size_ });
+		scatter_pipeline_ = CreatePipeline(device_, pipeline_layout_, "shaders/radix_scatter.comp.spv", { workgroup_size_ });
+	}
+
+	uint32_t RadixSort::TileCount(uint32_t count) const
+	{
+		return std::max(DivideRoundUp(count, workgroup_size_ * RADIX_TILE_ROUNDS), 1u);
+	}
+
+	void RadixSort::SetBuffers(const vk::DescriptorBufferInfo& keys, const vk::DescriptorBufferInfo& values)
+	{
+		std::array writes{
+			StorageWrite(sets_[0], RADIX_BINDING_KEYS_IN, keys),
+			StorageWrite(sets_[0], RADIX_BINDING_VALUES_IN, values),
+			StorageWrite(sets_[1], RADIX_BINDING_KEYS_OUT, keys),
+			StorageWrite(sets_[1], RADIX_BINDING_VALUES_OUT, values)
+		};
+		device_.updateDescriptorSets(writes, {});
+	}
+
+	void RadixSort::Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const
+	{
+		if (count == 0) return;
+		if (count > max_count_) {
+			throw std::runtime_error("radix sort count exceeds capacity!");
+		}
+
+		const uint32_t tileCount = TileCount(count);
+		for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+			const vk::raii::DescriptorSet& set = sets_[pass % 2];
+			const PushConstants pc{ .count = count, .shift = pass * RADIX_BITS, .tileCount = tileCount };
+
+			cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *histogram_pipeline_);
+			cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *set }, {});
+			cmd.pushConstants<PushConstants>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, pc);
+			cmd.dispatch(tileCount, 1, 1);
+			AddComputeBarrier(cmd);
+
+			// PrefixSum 이 자기 set 을 bind 하므로 scatter 전에 다시 bind
+			prefix_sum_->Record(cmd, RADIX_BUCKETS * tileCount);
+
+			cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *scatter_pipeline_);
+			cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *set }, {});
+			cmd.pushConstants<PushConstants>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, pc);
+			cmd.dispatch(tileCount, 1, 1);
+			AddComputeBarrier(cmd);
+		}
+	}
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "vulkan_utils.h"
+#include "primitives_layout.h"
+
+// compute 濡#pragma once
+
+#include "vulkan_utils.h"
+#include "primitives_layout.h"
+
+// compute 로 도는 병렬 primitive. 모두 uint32 배열을 다루고, workgroup 크기는 specialization constant 로 정한다 (2 의 거듭제곱).
+// 생성할 때 최대 원소 수에 맞춰 중간 buffer / set 을 만들어 두고, SetBuffers 로 입출력을 정한 뒤 Record 를 command buffer 에 기록한다.
+// Record 는 입력을 compute shader 에서 읽을 수 있어야 하고, 끝나면 출력을 compute shader 에서 읽을 수 있다.
+// set 0 을 자기 layout 으로 bind 하므로 호출한 쪽은 이후 자기 set 을 다시 bind 해야 한다.
+// 검증 / 대역폭 측정은 tools/gpu_primitives_bench.cpp
+namespace vku
+{
+	// exclusive prefix sum.
+	// level 0 은 workgroup 마다 block 을 scan 하고 block 합을 남기고, block 합이 workgroup 하나에 들어갈 때까지 위 level 에서 반복한 뒤
+	// 위에서부터 scan 된 block 합을 아래 level 에 더한다 (reduce-then-scan 의 multi-pass 형태)
+	class PrefixSum
+	{
+	public:
+		PrefixSum(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, uint32_t workgroupSize = 256);
+		PrefixSum(const PrefixSum& rhs) = delete;
+		PrefixSum(PrefixSum&& rhs) = delete;
+		PrefixSum& operator=(const PrefixSum& rhs) = delete;
+		PrefixSum& operator=(PrefixSum&& rhs) = delete;
+		~PrefixSum() = default;
+
+		// input / output 은 uint32 가 maxCount 개 이상. 같은 buffer 면 in-place
+		void SetBuffers(const vk::DescriptorBufferInfo& input, const vk::DescriptorBufferInfo& output);
+		void Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const;
+
+		uint32_t MaxCount() const { return max_count_; }
+		uint32_t WorkgroupSize() const { return workgroup_size_; }
+
+	private:
+		struct Level {
+			vk::raii::Buffer sums{ nullptr }; // block 합. 위 level 이 이 buffer 를 in-place 로 scan 한다
+			Allocation sums_memory;
+			vk::raii::DescriptorSet set{ nullptr };
+		};
+
+		vk::raii::Device& device_;
+		Allocator& allocator_;
+		uint32_t max_count_;
+		uint32_t workgroup_size_;
+
+		std::vector<Level> levels_;
+
+		vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+		vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+		vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+		vk::raii::Pipeline scan_pipeline_{ nullptr };
+		vk::raii::Pipeline add_pipeline_{ nullptr };
+	};
+
+	enum class ReduceOp : uint32_t
+	{
+		Sum = REDUCE_OP_SUM, // 2^32 에서 wrap
+		Min = REDUCE_OP_MIN,
+		Max = REDUCE_OP_MAX
+	};
+
+	// uint32 배열을 값 하나로 줄인다. workgroup 하나가 workgroupSize * REDUCE_ITEMS_PER_THREAD 개를 하나로 만들고
+	// 결과가 하나가 될 때까지 level 을 반복한다. 연산은 specialization constant 라 연산마다 instance 하나
+	class Reduce
+	{
+	public:
+		Reduce(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, ReduceOp op, uint32_t workgroupSize = 256);
+		Reduce(const Reduce& rhs) = delete;
+		Reduce(Reduce&& rhs) = delete;
+		Reduce& operator=(const Reduce& rhs) = delete;
+		Reduce& operator=(Reduce&& rhs) = delete;
+		~Reduce() = default;
+
+		// result : uint32 하나
+		void SetBuffers(const vk::DescriptorBufferInfo& input, const vk::DescriptorBufferInfo& result);
+		// count 가 0 이면 결과는 연산의 항등원 (합 0, min 0xffffffff, max 0)
+		void Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const;
+
+		ReduceOp Op() const { return op_; }
+
+	private:
+		struct Level {
+			vk::raii::Buffer partials{ nullptr }; // workgroup 결과. 마지막 level 은 결과 buffer 에 바로 쓰므로 없다
+			Allocation partials_memory;
+			vk::raii::DescriptorSet set{ nullptr };
+		};
+
+		vk::raii::Device& device_;
+		Allocator& allocator_;
+		uint32_t max_count_;
+		ReduceOp op_;
+		uint32_t workgroup_size_;
+
+		std::vector<Level> levels_;
+
+		vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+		vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+		vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+		vk::raii::Pipeline pipeline_{ nullptr };
+	};
+
+	// flags 가 1 인 원소만 입력 순서대로 앞으로 모은다 (flags 는 0 / 1). flags 의 PrefixSum 이 출력 위치
+	class Compact
+	{
+	public:
+		Compact(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, uint32_t workgroupSize = 256);
+		Compact(const Compact& rhs) = delete;
+		Compact(Compact&& rhs) = delete;
+		Compact& operator=(const Compact& rhs) = delete;
+		Compact& operator=(Compact&& rhs) = delete;
+		~Compact() = default;
+
+		// result : 남은 원소 수 (uint32 하나). indirect dispatch / draw 의 count 로 바로 쓸 수 있다
+		void SetBuffers(const vk::DescriptorBufferInfo& values, const vk::DescriptorBufferInfo& flags,
+			const vk::DescriptorBufferInfo& output, const vk::DescriptorBufferInfo& result);
+		// count 가 0 이면 아무것도 하지 않는다 (result 도 그대로)
+		void Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const;
+
+	private:
+		vk::raii::Device& device_;
+		Allocator& allocator_;
+		uint32_t max_count_;
+		uint32_t workgroup_size_;
+
+		vk::raii::Buffer offsets_{ nullptr };
+		Allocation offsets_memory_;
+		std::unique_ptr<PrefixSum> prefix_sum_;
+
+		vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+		vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+		vk::raii::DescriptorSet set_{ nullptr };
+		vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+		vk::raii::Pipeline pipeline_{ nullptr };
+	};
+
+	// 32 bit key / value 안정 정렬 (LSD radix, 8 bit 씩 4 pass).
+	// pass 마다 tile (workgroupSize * RADIX_TILE_ROUNDS 개) 의 digit histogram -> PrefixSum -> tile 안에서 안정 순서로 scatter.
+	// keys / values 와 내부 buffer 를 번갈아 쓰고, pass 수가 짝수라 결과는 원래 buffer 에 남는다
+	class RadixSort
+	{
+	public:
+		// workgroupSize 는 4 의 배수 (scatter 가 digit 을 uint 하나에 4 개씩 모은다)
+		RadixSort(vk::raii::Device& device, Allocator& allocator, uint32_t maxCount, uint32_t workgroupSize = 256);
+		RadixSort(const RadixSort& rhs) = delete;
+		RadixSort(RadixSort&& rhs) = delete;
+		RadixSort& operator=(const RadixSort& rhs) = delete;
+		RadixSort& operator=(RadixSort&& rhs) = delete;
+		~RadixSort() = default;
+
+		// keys / values 는 uint32 가 maxCount 개 이상. key 오름차순, 같은 key 는 입력 순서
+		void SetBuffers(const vk::DescriptorBufferInfo& keys, const vk::DescriptorBufferInfo& values);
+		void Record(const vk::raii::CommandBuffer& cmd, uint32_t count) const;
+
+	private:
+		struct PushConstants {
+			uint32_t count;
+			uint32_t shift;
+			uint32_t tileCount;
+		};
+
+		uint32_t TileCount(uint32_t count) const;
+
+		vk::raii::Device& device_;
+		Allocator& allocator_;
+		uint32_t max_count_;
+		uint32_t workgroup_size_;
+
+		vk::raii::Buffer keys_temp_{ nullptr };
+		Allocation keys_temp_memory_;
+		vk::raii::Buffer values_temp_{ nullptr };
+		Allocation values_temp_memory_;
+		vk::raii::Buffer histogram_{ nullptr };
+		Allocation histogram_memory_;
+		std::unique_ptr<PrefixSum> prefix_sum_;
+
+		vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+		vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+		std::array<vk::raii::DescriptorSet, 2> sets_{ nullptr, nullptr }; // [0] = 원래 -> temp, [1] = temp -> 원래
+		vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+		vk::raii::Pipeline histogram_pipeline_{ nullptr };
+		vk::raii::Pipeline scatter_pipeline_{ nullptr };
+	};
+}
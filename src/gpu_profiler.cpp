@@ -0,0 +1,172 @@
+#include "gpu_profiler.h"
+
+GpuProfiler::GpuProfiler(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t maxScopesPerFrame)
+	: queries_per_slot_(maxScopesPerFrame * 2)
+{
+	const auto properties = physicalDevice.getProperties();
+	const auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+	const uint32_t validBits = queueFamilies[queueFamilyIndex].timestampValidBits;
+
+	// timestampValidBits == 0 #include "gpu_profiler.h"
+
+GpuProfiler::GpuProfiler(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t maxScopesPerFrame)
+	: queries_per_slot_(maxScopesPerFrame * 2)
+{
+	const auto properties = physicalDevice.getProperties();
+	const auto queueFamilies = physicalDevice.getQueueFamilyProperties();
+	const uint32_t validBits = queueFamilies[queueFamilyIndex].timestampValidBits;
+
+	// timestampValidBits == 0 이면 이 queue 에서 timestamp 를 쓸 수 없음
+	if (validBits == 0 || properties.limits.timestampPeriod == 0.0f) {
+		std::cout << "gpu profiler disabled: timestamps are not supported on this queue" << std::endl;
+		return;
+	}
+
+	timestamp_period_ns_ = properties.limits.timestampPeriod;
+	timestamp_mask_ = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+
+	vk::QueryPoolCreateInfo poolInfo{
+		.queryType = vk::QueryType::eTimestamp,
+		.queryCount = queries_per_slot_ * MAX_FRAMES_IN_FLIGHT
+	};
+	query_pool_ = vk::raii::QueryPool(device, poolInfo);
+	enabled_ = true;
+}
+
+void GpuProfiler::BeginFrame(const vk::raii::CommandBuffer& cmd, uint32_t frameSlot)
+{
+	if (!enabled_) return;
+
+	// 같은 slot 의 이전 frame 은 fence / timeline 으로 이미 끝난 상태
+	FrameSlot& slot = slots_[frameSlot];
+	Collect(slot, frameSlot);
+
+	cmd.resetQueryPool(*query_pool_, frameSlot * queries_per_slot_, queries_per_slot_);
+	slot.scopes.clear();
+	slot.query_count = 0;
+	slot.frame_number = frame_number_++;
+	slot.pending = true;
+
+	current_slot_ = frameSlot;
+	recording_ = true;
+}
+
+void GpuProfiler::EndFrame()
+{
+	recording_ = false;
+}
+
+uint32_t GpuProfiler::BeginScope(const vk::raii::CommandBuffer& cmd, const char* name)
+{
+	if (!enabled_ || !recording_) return ~0u;
+
+	FrameSlot& slot = slots_[current_slot_];
+	if (slot.query_count + 2 > queries_per_slot_) return ~0u;
+
+	const uint32_t query = current_slot_ * queries_per_slot_ + slot.query_count;
+	slot.query_count += 2;
+	slot.scopes.emplace_back(FindOrAddScope(name), query);
+
+	cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *query_pool_, query);
+	return query;
+}
+
+void GpuProfiler::EndScope(const vk::raii::CommandBuffer& cmd, uint32_t handle)
+{
+	if (handle == ~0u) return;
+	cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *query_pool_, handle + 1);
+}
+
+void GpuProfiler::Collect(FrameSlot& slot, uint32_t slotIndex)
+{
+	if (!slot.pending || slot.query_count == 0) {
+		slot.pending = false;
+		return;
+	}
+	slot.pending = false;
+
+	// eWait 없이 읽는다. 준비가 안 됐으면 (eNotReady) 이 frame 은 버림
+	const uint32_t first = slotIndex * queries_per_slot_;
+	auto [result, timestamps] = query_pool_.getResults<uint64_t>(first, slot.query_count, slot.query_count * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+	if (result != vk::Result::eSuccess) return;
+
+	for (const auto& [scope, query] : slot.scopes) {
+		const uint64_t begin = timestamps[query - first] & timestamp_mask_;
+		const uint64_t end = timestamps[query - first + 1] & timestamp_mask_;
+		const float ms = static_cast<float>(static_cast<double>((end - begin) & timestamp_mask_) * timestamp_period_ns_ * 1e-6);
+
+		ScopeStats& stats = stats_[scope];
+		stats.samples[stats.next] = ms;
+		stats.next = (stats.next + 1) % kHistorySize;
+		stats.count = std::min(stats.count + 1, kHistorySize);
+
+		if (csv_rows_.size() < kMaxCsvRows) {
+			csv_rows_.push_back({ slot.frame_number, scope, ms });
+		}
+	}
+}
+
+uint32_t GpuProfiler::FindOrAddScope(const char* name)
+{
+	for (uint32_t i = 0; i < stats_.size(); ++i) {
+		if (stats_[i].name == name) return i;
+	}
+	stats_.push_back(ScopeStats{ .name = name });
+	return static_cast<uint32_t>(stats_.size() - 1);
+}
+
+void GpuProfiler::DrawImgui() const
+{
+	if (!enabled_) {
+		ImGui::TextUnformatted("Timestamps are not supported");
+		return;
+	}
+
+	if (ImGui::BeginTable("gpu_scopes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+		ImGui::TableSetupColumn("Scope");
+		ImGui::TableSetupColumn("avg ms");
+		ImGui::TableSetupColumn("min ms");
+		ImGui::TableSetupColumn("p99 ms");
+		ImGui::TableHeadersRow();
+
+		std::vector<float> sorted;
+		for (const auto& stats : stats_) {
+			if (stats.count == 0) continue;
+
+			sorted.assign(stats.samples.begin(), stats.samples.begin() + stats.count);
+			std::sort(sorted.begin(), sorted.end());
+			float sum = 0.0f;
+			for (float ms : sorted) sum += ms;
+			const size_t p99 = std::min(sorted.size() - 1, static_cast<size_t>(sorted.size() * 0.99f));
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.name.c_str());
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", sum / sorted.size());
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", sorted.front());
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", sorted[p99]);
+		}
+		ImGui::EndTable();
+	}
+}
+
+void GpuProfiler::WriteCsv(const std::string& path)
+{
+	if (!enabled_) return;
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT); ++i) {
+		Collect(slots_[i], i);
+	}
+	if (csv_rows_.empty()) return;
+
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "failed to write gpu profile to " << path << std::endl;
+		return;
+	}
+
+	file << "frame,scope,gpu_ms\n";
+	for (const auto& row : csv_rows_) {
+		file << row.frame << "," << stats_[row.scope].name << "," << row.ms << "\n";
+	}
+	std::cout << "gpu profile written to " << path << " (" << csv_rows_.size() << " samples)" << std::endl;
+}
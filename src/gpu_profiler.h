@@ -0,0 +1,90 @@
+#pragma once
+
+// vk::QueryPool timestamp 湲곕컲 GPU profiler.
+// frame slot (MAX_FRAMES_IN_FLIGHT) 留덈떎 query 援ш컙#pragma once
+
+// vk::QueryPool timestamp 기반 GPU profiler.
+// frame slot (MAX_FRAMES_IN_FLIGHT) 마다 query 구간을 따로 쓰고, 같은 slot 을 다시 기록할 때 이전 결과를 가져오므로
+// 결과를 기다리며 멈추지 않는다. 아직 준비되지 않은 결과는 버린다.
+class GpuProfiler
+{
+public:
+	GpuProfiler(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t maxScopesPerFrame = 32);
+	GpuProfiler(const GpuProfiler& rhs) = delete;
+	GpuProfiler(GpuProfiler&& rhs) = delete;
+	GpuProfiler& operator=(const GpuProfiler& rhs) = delete;
+	GpuProfiler& operator=(GpuProfiler&& rhs) = delete;
+	~GpuProfiler() = default;
+
+	// frame 의 첫 command buffer 맨 앞에서 호출 (render pass 밖). 이 slot 의 이전 결과를 모으고 query 를 reset
+	void BeginFrame(const vk::raii::CommandBuffer& cmd, uint32_t frameSlot);
+	// 이 frame 의 기록이 끝났음을 표시. 이후의 scope 는 무시된다 (예: one-time submit)
+	void EndFrame();
+
+	// 반환값은 EndScope 에 넘길 handle. 기록 중이 아니거나 query 가 부족하면 ~0u
+	uint32_t BeginScope(const vk::raii::CommandBuffer& cmd, const char* name);
+	void EndScope(const vk::raii::CommandBuffer& cmd, uint32_t handle);
+
+	void DrawImgui() const;
+	// device idle 상태에서 호출. 남은 결과를 모은 뒤 frame, scope, ms 를 CSV 로 기록
+	void WriteCsv(const std::string& path);
+
+	bool Enabled() const { return enabled_; }
+
+private:
+	static constexpr uint32_t kHistorySize = 240;   // min / avg / p99 를 계산할 최근 sample 수
+	static constexpr size_t kMaxCsvRows = 1u << 20; // CSV 로 남길 최대 sample 수
+
+	struct ScopeStats {
+		std::string name;
+		std::array<float, kHistorySize> samples{};
+		uint32_t count = 0;
+		uint32_t next = 0;
+	};
+
+	struct FrameSlot {
+		std::vector<std::pair<uint32_t, uint32_t>> scopes; // (stats index, 첫 query index)
+		uint32_t query_count = 0;
+		uint64_t frame_number = 0;
+		bool pending = false;
+	};
+
+	struct CsvRow {
+		uint64_t frame;
+		uint32_t scope;
+		float ms;
+	};
+
+	void Collect(FrameSlot& slot, uint32_t slotIndex);
+	uint32_t FindOrAddScope(const char* name);
+
+	vk::raii::QueryPool query_pool_{ nullptr };
+	bool enabled_ = false;
+	bool recording_ = false;
+	float timestamp_period_ns_ = 1.0f;
+	uint64_t timestamp_mask_ = ~0ull;
+	uint32_t queries_per_slot_ = 0;
+
+	std::array<FrameSlot, MAX_FRAMES_IN_FLIGHT> slots_;
+	uint32_t current_slot_ = 0;
+	uint64_t frame_number_ = 0;
+
+	std::vector<ScopeStats> stats_;
+	std::vector<CsvRow> csv_rows_;
+};
+
+// RAII scope. profiler 가 nullptr 이면 아무것도 하지 않는다
+class GpuScope
+{
+public:
+	GpuScope(GpuProfiler* profiler, const vk::raii::CommandBuffer& cmd, const char* name)
+		: profiler_(profiler), cmd_(cmd), handle_(profiler ? profiler->BeginScope(cmd, name) : ~0u) {}
+	GpuScope(const GpuScope& rhs) = delete;
+	GpuScope& operator=(const GpuScope& rhs) = delete;
+	~GpuScope() { if (profiler_) profiler_->EndScope(cmd_, handle_); }
+
+private:
+	GpuProfiler* profiler_;
+	const vk::raii::CommandBuffer& cmd_;
+	uint32_t handle_;
+};
@@ -0,0 +1,173 @@
+#include "gpu_profiler.h"
+
+#include "hiz_pyramid.h"
+
+HiZPyramid::HiZPyramid(vk::raii::Device& device, vku::Allocator& allocator)
+	: device_(device), allocator_(allocator)
+{
+	// texelFetch 留#include "gpu_profiler.h"
+
+#include "hiz_pyramid.h"
+
+HiZPyramid::HiZPyramid(vk::raii::Device& device, vku::Allocator& allocator)
+	: device_(device), allocator_(allocator)
+{
+	// texelFetch 만 쓰므로 filter 는 상관없다
+	vk::SamplerCreateInfo samplerInfo{
+		.magFilter = vk::Filter::eNearest,
+		.minFilter = vk::Filter::eNearest,
+		.mipmapMode = vk::SamplerMipmapMode::eNearest,
+		.addressModeU = vk::SamplerAddressMode::eClampToEdge,
+		.addressModeV = vk::SamplerAddressMode::eClampToEdge,
+		.addressModeW = vk::SamplerAddressMode::eClampToEdge,
+		.maxLod = VK_LOD_CLAMP_NONE
+	};
+	sampler_ = vk::raii::Sampler(device_, samplerInfo);
+
+	std::array layoutBindings{
+		vk::DescriptorSetLayoutBinding{ HIZ_BINDING_SRC, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute },
+		vk::DescriptorSetLayoutBinding{ HIZ_BINDING_DST, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute }
+	};
+	vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = static_cast<uint32_t>(layoutBindings.size()), .pBindings = layoutBindings.data() };
+	set_layout_ = vk::raii::DescriptorSetLayout(device_, layoutInfo);
+
+	// level 수는 해상도에 따라 바뀌므로 set 은 최대 level 만큼 미리 만들어 두고 Resize 에서 다시 쓰기만 한다
+	std::array poolSizes{
+		vk::DescriptorPoolSize{ vk::DescriptorType::eCombinedImageSampler, kMaxLevels * MAX_FRAMES_IN_FLIGHT },
+		vk::DescriptorPoolSize{ vk::DescriptorType::eStorageImage, kMaxLevels * MAX_FRAMES_IN_FLIGHT }
+	};
+	vk::DescriptorPoolCreateInfo poolInfo{
+		.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+		.maxSets = kMaxLevels * MAX_FRAMES_IN_FLIGHT,
+		.poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+		.pPoolSizes = poolSizes.data()
+	};
+	descriptor_pool_ = vk::raii::DescriptorPool(device_, poolInfo);
+	for (Frame& frame : frames_) {
+		std::array<vk::DescriptorSetLayout, kMaxLevels> layouts;
+		layouts.fill(*set_layout_);
+		vk::DescriptorSetAllocateInfo allocInfo{ .descriptorPool = *descriptor_pool_, .descriptorSetCount = kMaxLevels, .pSetLayouts = layouts.data() };
+		frame.sets = vk::raii::DescriptorSets{ device_, allocInfo };
+	}
+
+	vk::PushConstantRange pushConstantRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = sizeof(PushConstants) };
+	vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 1, .pSetLayouts = &*set_layout_, .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange };
+	pipeline_layout_ = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
+
+	vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device_, vku::ReadFile("shaders/hiz_build.comp.spv"));
+	vk::PipelineShaderStageCreateInfo stageInfo{ .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main" };
+	vk::ComputePipelineCreateInfo pipelineInfo{ .stage = stageInfo, .layout = *pipeline_layout_ };
+	pipeline_ = vk::raii::Pipeline(device_, nullptr, pipelineInfo);
+}
+
+void HiZPyramid::Resize(vk::Extent2D depthExtent, const std::array<vk::ImageView, MAX_FRAMES_IN_FLIGHT>& depthViews)
+{
+	depth_extent_ = depthExtent;
+
+	// depth 의 절반에서 시작해 1x1 까지. 크기가 홀수면 내림 (build 가 남는 행 / 열까지 max 에 포함)
+	level_count_ = 0;
+	vk::Extent2D extent{ std::max(depthExtent.width / 2, 1u), std::max(depthExtent.height / 2, 1u) };
+	while (level_count_ < kMaxLevels) {
+		level_extents_[level_count_++] = extent;
+		if (extent.width == 1 && extent.height == 1) break;
+		extent = { std::max(extent.width / 2, 1u), std::max(extent.height / 2, 1u) };
+	}
+
+	const vk::Format format = vk::Format::eR32Sfloat;
+	for (uint32_t slot = 0; slot < MAX_FRAMES_IN_FLIGHT; ++slot) {
+		Frame& frame = frames_[slot];
+		frame.level_views.clear();
+		frame.view = nullptr;
+		frame.image = nullptr;
+		frame.memory.Reset();
+
+		vku::CreateImage(allocator_, level_extents_[0].width, level_extents_[0].height, level_count_, vk::SampleCountFlagBits::e1, format,
+			vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
+			vk::MemoryPropertyFlagBits::eDeviceLocal, frame.image, frame.memory);
+		frame.view = vku::CreateImageView(device_, frame.image, format, vk::ImageAspectFlagBits::eColor, level_count_);
+		for (uint32_t level = 0; level < level_count_; ++level) {
+			vk::ImageViewCreateInfo viewInfo{
+				.image = *frame.image,
+				.viewType = vk::ImageViewType::e2D,
+				.format = format,
+				.subresourceRange = { vk::ImageAspectFlagBits::eColor, level, 1, 0, 1 }
+			};
+			frame.level_views.emplace_back(device_, viewInfo);
+		}
+
+		for (uint32_t level = 0; level < level_count_; ++level) {
+			vk::DescriptorImageInfo srcInfo = level == 0
+				? vk::DescriptorImageInfo{ .sampler = *sampler_, .imageView = depthViews[slot], .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal }
+				: vk::DescriptorImageInfo{ .sampler = *sampler_, .imageView = *frame.level_views[level - 1], .imageLayout = vk::ImageLayout::eGeneral };
+			vk::DescriptorImageInfo dstInfo{ .imageView = *frame.level_views[level], .imageLayout = vk::ImageLayout::eGeneral };
+			std::array writes{
+				vk::WriteDescriptorSet{
+					.dstSet = *frame.sets[level],
+					.dstBinding = HIZ_BINDING_SRC,
+					.dstArrayElement = 0,
+					.descriptorCount = 1,
+					.descriptorType = vk::DescriptorType::eCombinedImageSampler,
+					.pImageInfo = &srcInfo
+				},
+				vk::WriteDescriptorSet{
+					.dstSet = *frame.sets[level],
+					.dstBinding = HIZ_BINDING_DST,
+					.dstArrayElement = 0,
+					.descriptorCount = 1,
+					.descriptorType = vk::DescriptorType::eStorageImage,
+					.pImageInfo = &dstInfo
+				}
+			};
+			device_.updateDescriptorSets(writes, {});
+		}
+	}
+}
+
+void HiZPyramid::Build(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, GpuProfiler* profiler)
+{
+	Frame& frame = frames_[frameIndex];
+	GpuScope scope(profiler, cmd, "Hi-Z build");
+
+	// 모든 level 을 새로 쓰므로 이전 내용은 버린다 (지난 frame 의 occlusion cull 이 읽은 뒤)
+	vk::ImageMemoryBarrier2 toGeneral{
+		.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+		.srcAccessMask = {},
+		.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+		.dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+		.oldLayout = vk::ImageLayout::eUndefined,
+		.newLayout = vk::ImageLayout::eGeneral,
+		.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+		.image = *frame.image,
+		.subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, level_count_, 0, 1 }
+	};
+	cmd.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toGeneral });
+
+	cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *pipeline_);
+	vk::Extent2D src = depth_extent_;
+	for (uint32_t level = 0; level < level_count_; ++level) {
+		const vk::Extent2D dst = level_extents_[level];
+		PushConstants push{
+			.srcSize = glm::ivec2(src.width, src.height),
+			.dstSize = glm::ivec2(dst.width, dst.height)
+		};
+		cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *frame.sets[level] }, {});
+		cmd.pushConstants<PushConstants>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, push);
+		cmd.dispatch((dst.width + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (dst.height + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, 1);
+
+		// 다음 level 의 src 로 (마지막 level 이후에는 occlusion cull 이 읽는다)
+		vk::MemoryBarrier2 barrier{
+			.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+			.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+			.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead
+		};
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+		src = dst;
+	}
+}
+
+vk::DescriptorImageInfo HiZPyramid::SampledInfo(uint32_t frame) const
+{
+	return vk::DescriptorImageInfo{ .sampler = *sampler_, .imageView = *frames_[frame].view, .imageLayout = vk::ImageLayout::eGeneral };
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+class GpuProfiler;
+
+#include "vulkan_utils.h"
+#include "instance_layout.h"
+
+// depth buffer #pragma once
+
+class GpuProfiler;
+
+#include "vulkan_utils.h"
+#include "instance_layout.h"
+
+// depth buffer 의 max mip chain (Hi-Z). depth image 가 frame slot 마다 따로라 pyramid 도 slot 마다 하나.
+// level 0 은 depth 의 절반 해상도 (R32F) 이고, 각 texel 은 아래 level 에서 자기가 덮는 영역의 최대 depth.
+// pyramid 는 항상 eGeneral 이고, Build 가 매 frame 모든 level 을 다시 쓴다
+class HiZPyramid
+{
+public:
+	HiZPyramid(vk::raii::Device& device, vku::Allocator& allocator);
+	HiZPyramid(const HiZPyramid& rhs) = delete;
+	HiZPyramid(HiZPyramid&& rhs) = delete;
+	HiZPyramid& operator=(const HiZPyramid& rhs) = delete;
+	HiZPyramid& operator=(HiZPyramid&& rhs) = delete;
+	~HiZPyramid() = default;
+
+	// depth target 을 (다시) 만든 뒤 호출. depthViews[slot] 은 sampled usage 가 있는 depth aspect view
+	void Resize(vk::Extent2D depthExtent, const std::array<vk::ImageView, MAX_FRAMES_IN_FLIGHT>& depthViews);
+	// depth 는 eShaderReadOnlyOptimal 이어야 한다. 끝나면 pyramid 를 compute shader 에서 읽을 수 있다
+	void Build(const vk::raii::CommandBuffer& cmd, uint32_t frame, GpuProfiler* profiler);
+
+	vk::DescriptorImageInfo SampledInfo(uint32_t frame) const;
+	uint32_t LevelCount() const { return level_count_; }
+
+private:
+	static constexpr uint32_t kMaxLevels = 16;
+
+	struct PushConstants {
+		glm::ivec2 srcSize;
+		glm::ivec2 dstSize;
+	};
+	struct Frame {
+		vk::raii::Image image{ nullptr };
+		vku::Allocation memory;
+		vk::raii::ImageView view{ nullptr };           // 모든 level (culling 에서 sampling)
+		std::vector<vk::raii::ImageView> level_views;  // level 하나씩 (build 의 src / dst)
+		std::vector<vk::raii::DescriptorSet> sets;     // level 마다 (src = depth 또는 이전 level, dst = 이 level)
+	};
+
+	vk::raii::Device& device_;
+	vku::Allocator& allocator_;
+
+	std::array<Frame, MAX_FRAMES_IN_FLIGHT> frames_;
+	vk::Extent2D depth_extent_{};
+	std::array<vk::Extent2D, kMaxLevels> level_extents_{};
+	uint32_t level_count_ = 0;
+
+	vk::raii::Sampler sampler_{ nullptr };
+	vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+	vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+	vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+	vk::raii::Pipeline pipeline_{ nullptr };
+};
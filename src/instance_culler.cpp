@@ -0,0 +1,424 @@
+#include "cpu_profiler.h"
+#include "mesh_asset.h"
+#include "mesh_instance.h"
+#include "thread_pool.h"
+#include "gpu_profiler.h"
+#include "frustum.h"
+#include "mesh_cache.h"
+
+#include "instance_culler.h"
+
+namespace
+{
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+
+	// #include "cpu_profiler.h"
+#include "mesh_asset.h"
+#include "mesh_instance.h"
+#include "thread_pool.h"
+#include "gpu_profiler.h"
+#include "frustum.h"
+#include "mesh_cache.h"
+
+#include "instance_culler.h"
+
+namespace
+{
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+
+	// 화면에서의 오차 (허용 pixel 단위) = world 오차 / 거리 * lodScale 가 1 이하인 가장 거친 LOD.
+	// 거리는 sphere 표면까지라 가까운 쪽으로 (더 자세한 LOD 로) 치우친다. cull shader 의 SelectLod 와 같은 식
+	uint32_t SelectLod(const glm::vec4& sphere, const glm::vec4& camera, const std::vector<MeshAsset::Lod>& lods)
+	{
+		if (camera.w <= 0.0f) return 0;
+
+		const float distance = std::max(glm::length(glm::vec3(sphere) - glm::vec3(camera)) - sphere.w, 1e-3f);
+		const float pixelsPerUnit = camera.w / distance;
+		uint32_t lod = 0;
+		for (uint32_t i = 1; i < lods.size(); ++i) {
+			if (lods[i].error * sphere.w * pixelsPerUnit > 1.0f) break;
+			lod = i;
+		}
+		return lod;
+	}
+
+	// batch 의 draw slot 수. cluster 단위로 그리는 mesh 는 0
+	uint32_t DrawLodCount(const MeshAsset& mesh)
+	{
+		return mesh.clustered_ ? 0u : static_cast<uint32_t>(mesh.lods_.size());
+	}
+}
+
+InstanceCuller::InstanceCuller(vk::raii::Device& device, vku::Allocator& allocator, ThreadPool& pool, bool gpuCulling)
+	: device_(device), allocator_(allocator), pool_(pool), gpu_culling_(gpuCulling)
+{
+	if (!gpu_culling_) return;
+
+	std::array<vk::DescriptorSetLayoutBinding, CULL_BINDING_COUNT> layoutBindings;
+	for (uint32_t binding = 0; binding < CULL_BINDING_COUNT; ++binding) {
+		layoutBindings[binding] = vk::DescriptorSetLayoutBinding{ binding, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute };
+	}
+	vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = static_cast<uint32_t>(layoutBindings.size()), .pBindings = layoutBindings.data() };
+	set_layout_ = vk::raii::DescriptorSetLayout(device_, layoutInfo);
+
+	// occlusion pass 만 쓰는 set 1 : Hi-Z + view-projection
+	std::array occlusionBindings{
+		vk::DescriptorSetLayoutBinding{ OCCLUSION_BINDING_HIZ, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute },
+		vk::DescriptorSetLayoutBinding{ OCCLUSION_BINDING_PARAMS, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eCompute }
+	};
+	vk::DescriptorSetLayoutCreateInfo occlusionLayoutInfo{ .bindingCount = static_cast<uint32_t>(occlusionBindings.size()), .pBindings = occlusionBindings.data() };
+	occlusion_set_layout_ = vk::raii::DescriptorSetLayout(device_, occlusionLayoutInfo);
+
+	std::array poolSizes{
+		vk::DescriptorPoolSize{ vk::DescriptorType::eStorageBuffer, CULL_BINDING_COUNT * MAX_FRAMES_IN_FLIGHT },
+		vk::DescriptorPoolSize{ vk::DescriptorType::eCombinedImageSampler, MAX_FRAMES_IN_FLIGHT },
+		vk::DescriptorPoolSize{ vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT }
+	};
+	vk::DescriptorPoolCreateInfo poolInfo{
+		.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+		.maxSets = 2 * MAX_FRAMES_IN_FLIGHT,
+		.poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+		.pPoolSizes = poolSizes.data()
+	};
+	descriptor_pool_ = vk::raii::DescriptorPool(device_, poolInfo);
+	for (Frame& frame : frames_) {
+		vk::DescriptorSetAllocateInfo allocInfo{ .descriptorPool = *descriptor_pool_, .descriptorSetCount = 1, .pSetLayouts = &*set_layout_ };
+		frame.set = std::move(vk::raii::DescriptorSets{ device_, allocInfo }.front());
+
+		vk::DescriptorSetAllocateInfo occlusionAllocInfo{ .descriptorPool = *descriptor_pool_, .descriptorSetCount = 1, .pSetLayouts = &*occlusion_set_layout_ };
+		frame.occlusion_set = std::move(vk::raii::DescriptorSets{ device_, occlusionAllocInfo }.front());
+
+		// view-projection 은 크기가 고정이라 여기서 한 번 만들고 set 에 써 둔다
+		Reserve(frame.occlusion_params, 1, sizeof(glm::mat4), vk::BufferUsageFlagBits::eUniformBuffer, true);
+		vk::DescriptorBufferInfo paramsInfo{ *frame.occlusion_params.buffer, 0, sizeof(glm::mat4) };
+		vk::WriteDescriptorSet paramsWrite{
+			.dstSet = *frame.occlusion_set,
+			.dstBinding = OCCLUSION_BINDING_PARAMS,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eUniformBuffer,
+			.pBufferInfo = &paramsInfo
+		};
+		device_.updateDescriptorSets(paramsWrite, {});
+	}
+
+	vk::PushConstantRange pushConstantRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = sizeof(PushConstants) };
+	vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 1, .pSetLayouts = &*set_layout_, .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange };
+	pipeline_layout_ = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
+
+	std::array<vk::DescriptorSetLayout, 2> occlusionSetLayouts{ *set_layout_, *occlusion_set_layout_ };
+	vk::PipelineLayoutCreateInfo occlusionPipelineLayoutInfo{ .setLayoutCount = 2, .pSetLayouts = occlusionSetLayouts.data(), .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange };
+	occlusion_pipeline_layout_ = vk::raii::PipelineLayout(device_, occlusionPipelineLayoutInfo);
+
+	auto createPipeline = [&](const std::string& path, const vk::raii::PipelineLayout& layout) {
+		vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device_, vku::ReadFile(path));
+		vk::PipelineShaderStageCreateInfo stageInfo{ .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main" };
+		vk::ComputePipelineCreateInfo pipelineInfo{ .stage = stageInfo, .layout = *layout };
+		return vk::raii::Pipeline(device_, nullptr, pipelineInfo);
+	};
+	cull_pipeline_ = createPipeline("shaders/cull_instances.comp.spv", pipeline_layout_);
+	compact_pipeline_ = createPipeline("shaders/compact_draws.comp.spv", pipeline_layout_);
+	occlusion_pipeline_ = createPipeline("shaders/cull_occlusion.comp.spv", occlusion_pipeline_layout_);
+}
+
+void InstanceCuller::SetHiZ(uint32_t frameIndex, const vk::DescriptorImageInfo& hiz)
+{
+	if (!gpu_culling_) return;
+
+	vk::WriteDescriptorSet write{
+		.dstSet = *frames_[frameIndex].occlusion_set,
+		.dstBinding = OCCLUSION_BINDING_HIZ,
+		.dstArrayElement = 0,
+		.descriptorCount = 1,
+		.descriptorType = vk::DescriptorType::eCombinedImageSampler,
+		.pImageInfo = &hiz
+	};
+	device_.updateDescriptorSets(write, {});
+}
+
+bool InstanceCuller::Reserve(MappedBuffer& target, size_t required, vk::DeviceSize elementSize, vk::BufferUsageFlags usage, bool hostVisible)
+{
+	if (*target.buffer && target.capacity >= required) return false;
+
+	// 두 배씩 키워서 object 가 계속 늘어도 재할당은 드물게
+	uint32_t capacity = std::max(target.capacity, 64u);
+	while (capacity < required) capacity *= 2;
+
+	const vk::MemoryPropertyFlags properties = hostVisible
+		? vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+		: vk::MemoryPropertyFlagBits::eDeviceLocal;
+	vku::CreateBuffer(allocator_, elementSize * capacity, usage, properties, target.buffer, target.memory);
+	target.capacity = capacity;
+	return true;
+}
+
+float InstanceCuller::LodScale(float fovY, uint32_t viewportHeight, float pixelError)
+{
+	if (pixelError <= 0.0f) return 0.0f;
+	// 거리 d 에서 화면 높이는 2 d tan(fov / 2) 이므로 world 1 은 height / (2 tan(fov / 2)) / d pixel
+	return static_cast<float>(viewportHeight) / (2.0f * std::tan(glm::radians(fovY) * 0.5f)) / pixelError;
+}
+
+bool InstanceCuller::Prepare(uint32_t frameIndex, const std::vector<MeshInstance>& instances, const std::vector<DrawBatch>& batches, const glm::mat4& viewProj,
+	const glm::vec3& cameraPosition, float lodScale)
+{
+	PE_CPU_SCOPE("InstanceCuller::Prepare");
+
+	Frame& frame = frames_[frameIndex];
+
+	// 이 slot 이 지난번에 낸 결과 (GPU 경로는 readback 으로 copy 해 둔 것)
+	if (gpu_culling_ && frame.has_result) {
+		const auto* counts = static_cast<const uint32_t*>(frame.readback.memory.Mapped());
+		visible_draws_ = counts[2];
+		visible_instances_ = counts[1];
+		occluded_instances_ = counts[3];
+		visible_triangles_ = counts[4];
+	}
+
+	batch_slots_.resize(batches.size() + 1);
+	uint32_t slotCount = 0;
+	uint32_t visibleCount = 0;
+	for (size_t b = 0; b < batches.size(); ++b) {
+		const uint32_t lodCount = DrawLodCount(*batches[b].mesh);
+		batch_slots_[b] = BatchSlots{ .first_slot = slotCount, .first_visible = visibleCount };
+		slotCount += lodCount;
+		visibleCount += lodCount * batches[b].instance_count;
+	}
+	batch_slots_.back() = BatchSlots{ .first_slot = slotCount, .first_visible = visibleCount };
+
+	// GPU 경로의 결과 buffer 는 device local, CPU 경로는 host 가 쓴다
+	const bool hostResults = !gpu_culling_;
+	const vk::BufferUsageFlags indirect = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer;
+	bool recreated = false;
+	recreated |= Reserve(frame.instances, instances.size(), sizeof(InstanceData), vk::BufferUsageFlagBits::eStorageBuffer, true);
+	recreated |= Reserve(frame.visible, visibleCount, sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer, hostResults);
+	bool cullRecreated = recreated;
+	cullRecreated |= Reserve(frame.draws, slotCount, sizeof(vk::DrawIndexedIndirectCommand), indirect, hostResults);
+	cullRecreated |= Reserve(frame.counts, 5, sizeof(uint32_t), indirect | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc, hostResults);
+	if (gpu_culling_) {
+		Reserve(frame.templates, slotCount, sizeof(vk::DrawIndexedIndirectCommand), vk::BufferUsageFlagBits::eTransferSrc, true);
+		cullRecreated |= Reserve(frame.batches, slotCount, sizeof(vk::DrawIndexedIndirectCommand), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst, false);
+		cullRecreated |= Reserve(frame.lod_errors, slotCount, sizeof(float), vk::BufferUsageFlagBits::eStorageBuffer, true);
+		Reserve(frame.readback, 5, sizeof(uint32_t), vk::BufferUsageFlagBits::eTransferDst, true);
+		if (Reserve(frame.visibility, instances.size(), sizeof(uint32_t), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst, false)) {
+			frame.reset_visibility = true;
+			cullRecreated = true;
+		}
+		if (cullRecreated) {
+			WriteDescriptors(frame);
+		}
+	}
+
+	// instance : world matrix + world space bounds + batch 의 첫 draw slot. batch 는 instance 가 연속이라 chunk 시작에서 한 번만 찾는다
+	auto* dst = static_cast<InstanceData*>(frame.instances.memory.Mapped());
+	pool_.ParallelFor(static_cast<uint32_t>(instances.size()), 16384, [&](uint32_t begin, uint32_t end) {
+		auto batch = std::upper_bound(batches.begin(), batches.end(), begin,
+			[](uint32_t i, const DrawBatch& b) { return i < b.first_instance; }) - 1;
+		for (uint32_t i = begin; i < end; ++i) {
+			while (i >= batch->first_instance + batch->instance_count) ++batch;
+			const MeshInstance& instance = instances[i];
+			dst[i].world = instance.world_;
+			dst[i].sphere = glm::vec4(instance.BoundsCenter(), instance.BoundsRadius());
+			dst[i].slot = batch_slots_[batch - batches.begin()].first_slot;
+			dst[i].lod_count = DrawLodCount(*batch->mesh);
+		}
+	});
+
+	const Frustum frustum = Frustum::FromViewProj(viewProj);
+	std::copy(frustum.planes.begin(), frustum.planes.end(), frame.push.planes);
+	frame.push.camera = glm::vec4(cameraPosition, lodScale);
+	frame.push.instanceCount = static_cast<uint32_t>(instances.size());
+	frame.push.slotCount = slotCount;
+
+	if (gpu_culling_) {
+		std::memcpy(frame.occlusion_params.memory.Mapped(), &viewProj, sizeof(glm::mat4));
+
+		// cull 이 instanceCount 를 0 부터 센다. LOD l 의 visible 구간은 batch 구간의 l 번째 instance_count 칸
+		auto* templates = static_cast<vk::DrawIndexedIndirectCommand*>(frame.templates.memory.Mapped());
+		auto* lodErrors = static_cast<float*>(frame.lod_errors.memory.Mapped());
+		for (size_t b = 0; b < batches.size(); ++b) {
+			const MeshAsset& mesh = *batches[b].mesh;
+			for (uint32_t l = 0; l < DrawLodCount(mesh); ++l) {
+				const uint32_t slot = batch_slots_[b].first_slot + l;
+				templates[slot] = vk::DrawIndexedIndirectCommand{
+					.indexCount = mesh.lods_[l].index_count,
+					.instanceCount = 0,
+					.firstIndex = mesh.lods_[l].first_index,
+					.vertexOffset = mesh.vertex_offset_,
+					.firstInstance = batch_slots_[b].first_visible + l * batches[b].instance_count
+				};
+				lodErrors[slot] = mesh.lods_[l].error;
+			}
+		}
+	}
+	else {
+		CullOnCpu(frame, batches, frustum);
+	}
+
+	return recreated;
+}
+
+void InstanceCuller::CullOnCpu(Frame& frame, const std::vector<DrawBatch>& batches, const Frustum& frustum)
+{
+	PE_CPU_SCOPE("InstanceCuller::CullOnCpu");
+
+	// cull_instances.comp + compact_draws.comp 와 같은 결과. slot 안의 순서만 (atomic 이 없어서) 원래 순서 그대로
+	const auto* instances = static_cast<const InstanceData*>(frame.instances.memory.Mapped());
+	auto* visible = static_cast<uint32_t*>(frame.visible.memory.Mapped());
+	auto* draws = static_cast<vk::DrawIndexedIndirectCommand*>(frame.draws.memory.Mapped());
+
+	uint32_t drawCount = 0;
+	uint32_t visibleCount = 0;
+	uint64_t triangleCount = 0;
+	for (size_t b = 0; b < batches.size(); ++b) {
+		const DrawBatch& batch = batches[b];
+		if (batch.mesh->clustered_) continue;
+		const std::vector<MeshAsset::Lod>& lods = batch.mesh->lods_;
+		const uint32_t firstVisible = batch_slots_[b].first_visible;
+
+		std::array<uint32_t, pmesh::kMaxLods> survivors{};
+		for (uint32_t i = batch.first_instance; i < batch.first_instance + batch.instance_count; ++i) {
+			if (!frustum.Intersects(glm::vec3(instances[i].sphere), instances[i].sphere.w)) continue;
+			const uint32_t lod = SelectLod(instances[i].sphere, frame.push.camera, lods);
+			visible[firstVisible + lod * batch.instance_count + survivors[lod]++] = i;
+		}
+
+		for (uint32_t l = 0; l < lods.size(); ++l) {
+			if (survivors[l] == 0) continue;
+			draws[drawCount++] = vk::DrawIndexedIndirectCommand{
+				.indexCount = lods[l].index_count,
+				.instanceCount = survivors[l],
+				.firstIndex = lods[l].first_index,
+				.vertexOffset = batch.mesh->vertex_offset_,
+				.firstInstance = firstVisible + l * batch.instance_count
+			};
+			visibleCount += survivors[l];
+			triangleCount += static_cast<uint64_t>(lods[l].index_count / 3) * survivors[l];
+		}
+	}
+
+	auto* counts = static_cast<uint32_t*>(frame.counts.memory.Mapped());
+	counts[0] = drawCount;
+	counts[1] = visibleCount;
+	counts[2] = drawCount;
+	counts[3] = 0;
+	counts[4] = static_cast<uint32_t>(std::min<uint64_t>(triangleCount, UINT32_MAX));
+	frame.draw_count = drawCount;
+	visible_draws_ = drawCount;
+	visible_instances_ = visibleCount;
+	occluded_instances_ = 0;
+	visible_triangles_ = triangleCount;
+}
+
+void InstanceCuller::WriteDescriptors(Frame& frame)
+{
+	std::array<vk::DescriptorBufferInfo, CULL_BINDING_COUNT> infos;
+	infos[CULL_BINDING_INSTANCES] = { *frame.instances.buffer, 0, VK_WHOLE_SIZE };
+	infos[CULL_BINDING_BATCHES] = { *frame.batches.buffer, 0, VK_WHOLE_SIZE };
+	infos[CULL_BINDING_VISIBLE] = { *frame.visible.buffer, 0, VK_WHOLE_SIZE };
+	infos[CULL_BINDING_DRAWS] = { *frame.draws.buffer, 0, VK_WHOLE_SIZE };
+	infos[CULL_BINDING_COUNTS] = { *frame.counts.buffer, 0, VK_WHOLE_SIZE };
+	infos[CULL_BINDING_VISIBILITY] = { *frame.visibility.buffer, 0, VK_WHOLE_SIZE };
+	infos[CULL_BINDING_LOD_ERRORS] = { *frame.lod_errors.buffer, 0, VK_WHOLE_SIZE };
+
+	std::array<vk::WriteDescriptorSet, CULL_BINDING_COUNT> writes;
+	for (uint32_t binding = 0; binding < CULL_BINDING_COUNT; ++binding) {
+		writes[binding] = vk::WriteDescriptorSet{
+			.dstSet = *frame.set,
+			.dstBinding = binding,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.pBufferInfo = &infos[binding]
+		};
+	}
+	device_.updateDescriptorSets(writes, {});
+}
+
+void InstanceCuller::RecordCull(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex, GpuProfiler* profiler, Pass pass)
+{
+	if (!gpu_culling_) return;
+
+	Frame& frame = frames_[frameIndex];
+	GpuScope scope(profiler, cmd, pass == Pass::Occlusion ? "Instance cull (occlusion)" : "Instance cull");
+
+	if (pass == Pass::Occlusion) {
+		// 첫 pass 의 compact / draw 가 batches, visible, draws, counts 를 다 읽은 뒤에 다시 쓴다
+		AddBarrier(cmd,
+			vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eVertexShader,
+			vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eIndirectCommandRead,
+			vk::PipelineStageFlagBits2::eTransfer | vk::PipelineStageFlagBits2::eComputeShader,
+			vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eShaderWrite);
+	}
+
+	// draw slot command 초기화 (instanceCount = 0), 이번 pass 의 draw 수 = 0. frame 합계는 첫 pass 에서만 0 으로
+	const vk::DeviceSize slotBytes = std::max<vk::DeviceSize>(frame.push.slotCount * sizeof(vk::DrawIndexedIndirectCommand), 4);
+	cmd.copyBuffer(*frame.templates.buffer, *frame.batches.buffer, vk::BufferCopy(0, 0, slotBytes));
+	cmd.fillBuffer(*frame.counts.buffer, 0, (pass == Pass::Occlusion ? 1 : 5) * sizeof(uint32_t), 0);
+	if (frame.reset_visibility && pass != Pass::Occlusion) {
+		cmd.fillBuffer(*frame.visibility.buffer, 0, VK_WHOLE_SIZE, 1);
+		frame.reset_visibility = false;
+	}
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+		vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+
+	PushConstants push = frame.push;
+	push.visibleOnly = pass == Pass::PreviouslyVisible ? 1u : 0u;
+
+	if (pass == Pass::Occlusion) {
+		cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *occlusion_pipeline_layout_, 0, { *frame.set, *frame.occlusion_set }, {});
+		cmd.pushConstants<PushConstants>(*occlusion_pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, push);
+		cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *occlusion_pipeline_);
+	}
+	else {
+		cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *frame.set }, {});
+		cmd.pushConstants<PushConstants>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, push);
+		cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *cull_pipeline_);
+	}
+	cmd.dispatch((frame.push.instanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+		vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+
+	// set 0 과 push constant 범위가 같아서 occlusion layout 으로 bind 한 것도 그대로 쓸 수 있다
+	cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *compact_pipeline_);
+	cmd.dispatch((frame.push.slotCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+	// draws / counts 는 indirect 로, visible 은 vertex shader 가, counts 는 readback copy 가 읽는다
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+		vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eTransfer,
+		vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eTransferRead);
+
+	// frame 합계는 마지막 pass 뒤에 읽는다
+	if (pass == Pass::PreviouslyVisible) return;
+	cmd.copyBuffer(*frame.counts.buffer, *frame.readback.buffer, vk::BufferCopy(0, 0, 5 * sizeof(uint32_t)));
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+		vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead);
+	frame.has_result = true;
+}
+
+void InstanceCuller::RecordDraw(const vk::raii::CommandBuffer& cmd, uint32_t frameIndex) const
+{
+	const Frame& frame = frames_[frameIndex];
+	constexpr uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+
+	if (gpu_culling_) {
+		cmd.drawIndexedIndirectCount(*frame.draws.buffer, 0, *frame.counts.buffer, 0, frame.push.slotCount, stride);
+	}
+	else if (frame.draw_count > 0) {
+		cmd.drawIndexedIndirect(*frame.draws.buffer, 0, frame.draw_count, stride);
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+class MeshInstance;
+class ThreadPool;
+class GpuProfiler;
+struct DrawBatch;
+struct Frustum;
+
+#include "vulkan_utils.h"
+#include "instance_layout.h"
+
+// instance frustum / occlusion culling + LOD #pragma once
+
+class MeshInstance;
+class ThreadPool;
+class GpuProfiler;
+struct DrawBatch;
+struct Frustum;
+
+#include "vulkan_utils.h"
+#include "instance_layout.h"
+
+// instance frustum / occlusion culling + LOD 선택 + draw compaction.
+// draw slot : batch (mesh) 의 LOD 마다 하나. 살아남은 instance 는 화면에서의 크기로 LOD 를 골라 그 slot 에 들어간다.
+// GPU 경로 : cull_instances.comp 가 살아남은 instance 를 draw slot 별 구간에 모으고,
+//           compact_draws.comp 가 instance 가 남은 slot 의 command 만 앞으로 당긴다. 그리기는 drawIndexedIndirectCount 한 번.
+//           Hi-Z 가 있으면 두 pass : 지난번에 보였던 instance 를 먼저 그리고, 그 depth 로 만든 Hi-Z 에 나머지를 판정해 추가로 그린다.
+// CPU 경로 : 같은 판정을 Prepare 에서 하고 같은 buffer 에 결과를 쓴다 (drawIndirectCount 가 없는 장치 / software Vulkan 비교용).
+// 어느 쪽이든 vertex shader 는 instances[visible[gl_InstanceIndex]] 를 읽는다.
+// clustered_ mesh 의 instance 는 instance buffer 에만 쓰고 (ClusterCuller 가 읽는다) draw slot 은 만들지 않는다.
+class InstanceCuller
+{
+public:
+	struct InstanceData {
+		glm::mat4 world;
+		glm::vec4 sphere; // xyz = world space 중심, w = 반지름
+		uint32_t slot;      // batch 의 첫 draw slot (LOD 0)
+		uint32_t lod_count; // 0 이면 draw slot 이 없다 (MeshAsset::clustered_, ClusterCuller 가 그림)
+		uint32_t pad[2];
+	};
+	static_assert(sizeof(InstanceData) == INSTANCE_STRIDE);
+
+	enum class Pass {
+		Frustum,           // frustum 만 (occlusion culling 을 쓰지 않을 때)
+		PreviouslyVisible, // frustum + 지난 occlusion pass 에서 보였던 instance
+		Occlusion          // Hi-Z 로 전부 다시 판정. visibility 를 갱신하고 PreviouslyVisible 에서 빠진 것만 그린다
+	};
+
+	InstanceCuller(vk::raii::Device& device, vku::Allocator& allocator, ThreadPool& pool, bool gpuCulling);
+	InstanceCuller(const InstanceCuller& rhs) = delete;
+	InstanceCuller(InstanceCuller&& rhs) = delete;
+	InstanceCuller& operator=(const InstanceCuller& rhs) = delete;
+	InstanceCuller& operator=(InstanceCuller&& rhs) = delete;
+	~InstanceCuller() = default;
+
+	// frame slot 의 buffer 를 필요하면 키우고 instance / batch 를 쓴다. CPU 경로면 culling 까지 끝낸다.
+	// frame slot 의 이전 GPU 작업이 끝난 뒤에 불러야 한다. buffer 를 다시 만들었으면 true (vertex shader 쪽 descriptor 를 다시 써야 함)
+	// lodScale : 거리 1 에서 world 1 이 차지하는 pixel 수 / 허용 pixel 오차 (LodScale). 0 이면 항상 LOD 0
+	bool Prepare(uint32_t frame, const std::vector<MeshInstance>& instances, const std::vector<DrawBatch>& batches, const glm::mat4& viewProj,
+		const glm::vec3& cameraPosition = glm::vec3(0.0f), float lodScale = 0.0f);
+	// GPU 경로면 cull / compact dispatch 와 indirect 읽기 barrier 를 기록한다. rendering 밖에서 불러야 한다.
+	// Occlusion 은 같은 frame 의 PreviouslyVisible draw 와 Hi-Z build 뒤에
+	void RecordCull(const vk::raii::CommandBuffer& cmd, uint32_t frame, GpuProfiler* profiler, Pass pass = Pass::Frustum);
+	// 살아남은 draw 를 그린다. pipeline / descriptor / vertex, index buffer 는 호출하는 쪽이 bind
+	void RecordDraw(const vk::raii::CommandBuffer& cmd, uint32_t frame) const;
+
+	vk::DescriptorBufferInfo InstanceBufferInfo(uint32_t frame) const { return { *frames_[frame].instances.buffer, 0, VK_WHOLE_SIZE }; }
+	vk::DescriptorBufferInfo VisibleBufferInfo(uint32_t frame) const { return { *frames_[frame].visible.buffer, 0, VK_WHOLE_SIZE }; }
+	// occlusion pass 가 읽을 Hi-Z (hiz_pyramid.h). pyramid 를 다시 만들 때마다
+	void SetHiZ(uint32_t frame, const vk::DescriptorImageInfo& hiz);
+
+	// 세로 fov (degree), 화면 높이 (pixel), 허용 오차 (pixel) -> Prepare 의 lodScale. pixelError 가 0 이하면 0 (LOD 끔)
+	static float LodScale(float fovY, uint32_t viewportHeight, float pixelError);
+
+	bool GpuCulling() const { return gpu_culling_; }
+	// 마지막으로 결과를 읽은 frame 의 visible / occluded instance, draw 수 (GPU 경로는 MAX_FRAMES_IN_FLIGHT frame 늦음)
+	uint32_t VisibleInstances() const { return visible_instances_; }
+	uint32_t VisibleDraws() const { return visible_draws_; }
+	uint32_t OccludedInstances() const { return occluded_instances_; }
+	uint64_t VisibleTriangles() const { return visible_triangles_; }
+
+private:
+	struct PushConstants {
+		glm::vec4 planes[6];
+		glm::vec4 camera; // xyz = camera 위치, w = lodScale
+		uint32_t instanceCount;
+		uint32_t slotCount;
+		uint32_t visibleOnly;
+		uint32_t pad;
+	};
+	static_assert(sizeof(PushConstants) <= 128);
+	// batch 의 draw slot / visible 구간 시작. slot 은 LOD 수만큼, visible 구간은 LOD 마다 batch 의 instance 수만큼 (모두 같은 LOD 를 고를 수 있으므로)
+	struct BatchSlots {
+		uint32_t first_slot;
+		uint32_t first_visible;
+	};
+	struct MappedBuffer {
+		vk::raii::Buffer buffer{ nullptr };
+		vku::Allocation memory;
+		uint32_t capacity = 0; // 원소 수
+	};
+	struct Frame {
+		MappedBuffer instances; // host visible
+		MappedBuffer templates; // host visible. draw slot 마다 instanceCount = 0 인 command
+		MappedBuffer batches;   // GPU 경로에서 cull 이 세는 command (templates 에서 copy)
+		MappedBuffer visible;
+		MappedBuffer draws;
+		MappedBuffer counts;    // [0] = 이번 pass 의 draw 수, [1] = visible instance 수, [2] = frame 전체 draw 수, [3] = occluded instance 수, [4] = triangle 수
+		MappedBuffer readback;  // GPU 경로에서 counts 를 읽어오는 곳
+		MappedBuffer visibility; // instance 별 0 / 1. 같은 slot 의 이전 frame (MAX_FRAMES_IN_FLIGHT 전) 결과라 조금 늦지만, 늦은 만큼은 occlusion pass 가 채운다
+		MappedBuffer occlusion_params; // host visible. view-projection
+		MappedBuffer lod_errors; // host visible. draw slot 마다 MeshAsset::Lod::error
+		vk::raii::DescriptorSet set{ nullptr };
+		vk::raii::DescriptorSet occlusion_set{ nullptr };
+		PushConstants push{};
+		uint32_t draw_count = 0; // CPU 경로
+		bool has_result = false;
+		bool reset_visibility = false; // visibility 를 새로 만들었으면 전부 1 (다음 PreviouslyVisible 가 frustum 만으로 그림)
+	};
+
+	// 원소 required 개 이상으로 (두 배씩) 키운다. 다시 만들었으면 true
+	bool Reserve(MappedBuffer& target, size_t required, vk::DeviceSize elementSize, vk::BufferUsageFlags usage, bool hostVisible);
+	void WriteDescriptors(Frame& frame);
+	void CullOnCpu(Frame& frame, const std::vector<DrawBatch>& batches, const Frustum& frustum);
+
+	vk::raii::Device& device_;
+	vku::Allocator& allocator_;
+	ThreadPool& pool_;
+	bool gpu_culling_;
+
+	std::array<Frame, MAX_FRAMES_IN_FLIGHT> frames_;
+
+	vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+	vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+	vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+	vk::raii::Pipeline cull_pipeline_{ nullptr };
+	vk::raii::Pipeline compact_pipeline_{ nullptr };
+	vk::raii::DescriptorSetLayout occlusion_set_layout_{ nullptr };
+	vk::raii::PipelineLayout occlusion_pipeline_layout_{ nullptr };
+	vk::raii::Pipeline occlusion_pipeline_{ nullptr };
+
+	uint32_t visible_instances_ = 0;
+	uint32_t visible_draws_ = 0;
+	uint32_t occluded_instances_ = 0;
+	uint64_t visible_triangles_ = 0;
+
+	std::vector<BatchSlots> batch_slots_; // 마지막 Prepare 의 batch 별. 끝에 하나 더 (slot / visible 합계)
+};
@@ -0,0 +1,31 @@
+// Instance culling layout.
+// C++ (instance_culler.h) // Instance culling layout.
+// C++ (instance_culler.h) 와 GLSL (#include "instance_layout.h") 이 같은 정의를 사용한다.
+#ifndef INSTANCE_LAYOUT_H
+#define INSTANCE_LAYOUT_H
+
+// cull / compact compute set 의 binding
+#define CULL_BINDING_INSTANCES 0 // Instance[]    : world matrix + world space bounding sphere + 첫 draw slot, LOD 수
+#define CULL_BINDING_BATCHES   1 // DrawCommand[] : draw slot ((batch, LOD) 쌍) 마다 하나. instanceCount 를 cull 이 atomic 으로 센다
+#define CULL_BINDING_VISIBLE   2 // uint[]        : draw slot 별 구간에 살아남은 instance 번호
+#define CULL_BINDING_DRAWS     3 // DrawCommand[] : instance 가 하나라도 남은 draw slot 만 앞으로 모은 것
+#define CULL_BINDING_COUNTS    4 // uint[5]       : 이번 pass 의 draw 수, visible instance 수, frame 전체 draw 수, occluded instance 수, 그린 triangle 수
+#define CULL_BINDING_VISIBILITY 5 // uint[]       : instance 가 지난 occlusion pass 에서 보였으면 1
+#define CULL_BINDING_LOD_ERRORS 6 // float[]      : draw slot 의 LOD 오차 (mesh bounds 반지름에 대한 비율)
+#define CULL_BINDING_COUNT     7
+
+// occlusion pass (cull_occlusion.comp) 만 쓰는 set 1
+#define OCCLUSION_BINDING_HIZ    0 // sampler2D : depth 의 max mip chain (hiz_pyramid.h)
+#define OCCLUSION_BINDING_PARAMS 1 // uniform   : view-projection
+
+#define CULL_GROUP_SIZE 64
+
+// Hi-Z build (hiz_build.comp) : 아래 level (또는 depth) -> 다음 level
+#define HIZ_BINDING_SRC 0
+#define HIZ_BINDING_DST 1
+#define HIZ_GROUP_SIZE  8
+
+// Instance 는 std430 으로 96 bytes (mat4 + vec4 + uint 2 + padding)
+#define INSTANCE_STRIDE 96
+
+#endif
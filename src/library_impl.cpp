@@ -1,4 +1,4 @@
-// library_impl.cpp 파일 내용
+// library_impl.cpp // library_impl.cpp 파일 내용
 
 // TinyGLTF의 구현을 생성합니다.
 #define TINYGLTF_IMPLEMENTATION
@@ -1,8 +1,325 @@
+#include "app_options.h"
+#include "sim_params.h"
+#include "cloth_constraints.h"
+#include "thread_pool.h"
+#include "cpu_cloth_solver.h"
+#include "context.h"
+#include "camera.h"
+#include "mouse_interactor.h"
+#include "cpu_profiler.h"
+
+#include "window.h"
+
+namespace {
+    AppOptions ParseArgs(int argc, char** argv)
+    {
+        AppOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--cpu-sim") {
+                options.cpu_simulation = true;
+            }
+            else if (arg == "--cpu-reference" && i + 1 < argc) {
+                options.cpu_reference_steps = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--validate-gpu" && i + 1 < argc) {
+                options.validate_steps = std::max(static_cast<uint32_t>(std::stoul(argv[++i])), 1u);
+            }
+            else if (arg == "--tolerance" && i + 1 < argc) {
+                options.validate_tolerance = std::stof(argv[++i]);
+            }
+            else if (arg == "--headless" && i + 1 < argc) {
+                options.headless = true;
+                options.headless_frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--no-render") {
+                options.headless_render = false;
+            }
+            else if (arg == "--output" && i + 1 < argc) {
+                options.headless_output = argv[++i];
+            }
+            else if (arg == "--gpu-profile" && i + 1 < argc) {
+                options.gpu_profile_csv = argv[++i];
+            }
+            else if (arg == "--cpu-trace" && i + 1 < argc) {
+                options.cpu_trace_output = argv[++i];
+            }
+            else if (arg == "--cpu-cull") {
+                options.cpu_culling = true;
+            }
+            else if (arg == "--no-occlusion") {
+                options.occlusion_culling = false;
+            }
+            else if (arg == "--lod-error" && i + 1 < argc) {
+                options.lod_pixel_error = std::stof(argv[++i]);
+            }
+            else if (arg == "--cluster-tris" && i + 1 < argc) {
+                options.cluster_triangles = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--no-mesh-shader") {
+                options.mesh_shader = false;
+            }
+            else if (arg == "--cloth" && i + 1 < argc) {
+                options.cloth_resolution = static_cast<uint32_t>(std::stoul(argv[++i]));
+                if (options.cloth_resolution < 2) {
+                    throw std::runtime_error("--cloth expects at least 2 particles per side");
+                }
+            }
+            else if (arg == "--sim-rate" && i + 1 < argc) {
+                options.sim_rate = std::stof(argv[++i]);
+                if (!(options.sim_rate > 0.0f)) {
+                    throw std::runtime_error("--sim-rate expects a positive rate");
+                }
+            }
+            else if (arg == "--substeps" && i + 1 < argc) {
+                options.sim_substeps = std::max(static_cast<uint32_t>(std::stoul(argv[++i])), 1u);
+            }
+            else if (arg == "--max-sim-steps" && i + 1 < argc) {
+                options.sim_max_steps = std::max(static_cast<uint32_t>(std::stoul(argv[++i])), 1u);
+            }
+            else if (arg == "--objects" && i + 1 < argc) {
+                options.scene_objects = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--size" && i + 1 < argc) {
+                const std::string size = argv[++i];
+                const size_t x = size.find('x');
+                if (x == std::string::npos) {
+                    throw std::runtime_error("--size expects <width>x<height>");
+                }
+                options.width = static_cast<uint32_t>(std::stoul(size.substr(0, x)));
+                options.height = static_cast<uint32_t>(std::stoul(size.substr(x + 1)));
+            }
+            else {
+                throw std::runtime_error("unknown argument: " + arg);
+            }
+        }
+        return options;
+    }
+
+    // FNV-1a
+    uint64_t HashPositions(const std::vector<glm::vec4>& positions)
+    {
+        uint64_t hash = 1469598103934665603ull;
+        const auto* bytes = reinterpret_cast<const unsigned char*>(positions.data());
+        for (size_t i = 0; i < positions.size() * sizeof(glm::vec4); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // GPU 媛#include "app_options.h"
+#include "sim_params.h"
+#include "cloth_constraints.h"
+#include "thread_pool.h"
+#include "cpu_cloth_solver.h"
+#include "context.h"
+#include "camera.h"
+#include "mouse_interactor.h"
+#include "cpu_profiler.h"
+
 #include "window.h"
 
-int main() {
+namespace {
+    AppOptions ParseArgs(int argc, char** argv)
+    {
+        AppOptions options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--cpu-sim") {
+                options.cpu_simulation = true;
+            }
+            else if (arg == "--cpu-reference" && i + 1 < argc) {
+                options.cpu_reference_steps = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--validate-gpu" && i + 1 < argc) {
+                options.validate_steps = std::max(static_cast<uint32_t>(std::stoul(argv[++i])), 1u);
+            }
+            else if (arg == "--tolerance" && i + 1 < argc) {
+                options.validate_tolerance = std::stof(argv[++i]);
+            }
+            else if (arg == "--headless" && i + 1 < argc) {
+                options.headless = true;
+                options.headless_frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--no-render") {
+                options.headless_render = false;
+            }
+            else if (arg == "--output" && i + 1 < argc) {
+                options.headless_output = argv[++i];
+            }
+            else if (arg == "--gpu-profile" && i + 1 < argc) {
+                options.gpu_profile_csv = argv[++i];
+            }
+            else if (arg == "--cpu-trace" && i + 1 < argc) {
+                options.cpu_trace_output = argv[++i];
+            }
+            else if (arg == "--cpu-cull") {
+                options.cpu_culling = true;
+            }
+            else if (arg == "--no-occlusion") {
+                options.occlusion_culling = false;
+            }
+            else if (arg == "--lod-error" && i + 1 < argc) {
+                options.lod_pixel_error = std::stof(argv[++i]);
+            }
+            else if (arg == "--cluster-tris" && i + 1 < argc) {
+                options.cluster_triangles = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--no-mesh-shader") {
+                options.mesh_shader = false;
+            }
+            else if (arg == "--cloth" && i + 1 < argc) {
+                options.cloth_resolution = static_cast<uint32_t>(std::stoul(argv[++i]));
+                if (options.cloth_resolution < 2) {
+                    throw std::runtime_error("--cloth expects at least 2 particles per side");
+                }
+            }
+            else if (arg == "--sim-rate" && i + 1 < argc) {
+                options.sim_rate = std::stof(argv[++i]);
+                if (!(options.sim_rate > 0.0f)) {
+                    throw std::runtime_error("--sim-rate expects a positive rate");
+                }
+            }
+            else if (arg == "--substeps" && i + 1 < argc) {
+                options.sim_substeps = std::max(static_cast<uint32_t>(std::stoul(argv[++i])), 1u);
+            }
+            else if (arg == "--max-sim-steps" && i + 1 < argc) {
+                options.sim_max_steps = std::max(static_cast<uint32_t>(std::stoul(argv[++i])), 1u);
+            }
+            else if (arg == "--objects" && i + 1 < argc) {
+                options.scene_objects = static_cast<uint32_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--size" && i + 1 < argc) {
+                const std::string size = argv[++i];
+                const size_t x = size.find('x');
+                if (x == std::string::npos) {
+                    throw std::runtime_error("--size expects <width>x<height>");
+                }
+                options.width = static_cast<uint32_t>(std::stoul(size.substr(0, x)));
+                options.height = static_cast<uint32_t>(std::stoul(size.substr(x + 1)));
+            }
+            else {
+                throw std::runtime_error("unknown argument: " + arg);
+            }
+        }
+        return options;
+    }
+
+    // FNV-1a
+    uint64_t HashPositions(const std::vector<glm::vec4>& positions)
+    {
+        uint64_t hash = 1469598103934665603ull;
+        const auto* bytes = reinterpret_cast<const unsigned char*>(positions.data());
+        for (size_t i = 0; i < positions.size() * sizeof(glm::vec4); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // GPU 가 없는 환경(CI)용 : CPU solver 를 빌드에 들어간 SIMD 경로마다 고정 dt 로 돌리고 결과 hash 를 출력.
+    // 경로끼리 hash 가 다르면 (= bit 단위로 같지 않으면) 실패
+    int RunCpuReference(uint32_t steps)
+    {
+        ClothConstraints constraints;
+        constraints.Build(kClothNx, kClothNy, kClothSpacing);
+        const uint32_t particleCount = static_cast<uint32_t>(kClothNx * kClothNy);
+        if (!ClothConstraints::Validate(constraints.constraints_, constraints.batches_, particleCount)) {
+            return EXIT_FAILURE;
+        }
+
+        ThreadPool pool;
+        const std::vector<glm::vec4> initial = BuildClothParticles(kClothNx, kClothNy, kClothSpacing);
+        CpuClothSolver solver(initial, constraints, pool);
+
+        SimParams params;
+        params.numParticles = particleCount;
+
+        std::cout << "cpu reference: " << steps << " steps, " << pool.ThreadCount() << " worker threads" << std::endl;
+        bool same = true;
+        uint64_t expected = 0;
+        for (int path = static_cast<int>(CpuClothSolver::BestSimdPath()); path >= 0; --path) {
+            solver.SetSimdPath(static_cast<CpuClothSolver::SimdPath>(path));
+            solver.Reset(initial);
+
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < steps; ++i) {
+                solver.Step(params);
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            const uint64_t hash = HashPositions(solver.Positions());
+            if (path == static_cast<int>(CpuClothSolver::BestSimdPath())) {
+                expected = hash;
+                const glm::vec4& bottom = solver.Positions()[kClothNx / 2];
+                std::cout << "bottom center (" << bottom.x << ", " << bottom.y << ", " << bottom.z << ")" << std::endl;
+            }
+            same &= hash == expected;
+            std::cout << std::setw(6) << CpuClothSolver::ToString(solver.GetSimdPath()) << " : " << ms / std::max(steps, 1u)
+                << " ms/step, positions hash " << std::hex << hash << std::dec << (hash == expected ? "" : "  ** differs **") << std::endl;
+        }
+        return same ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // --validate-gpu : 창 없이 GPU solver 를 CPU reference 와 비교 (compute queue 가 없으면 실패)
+    int RunGpuValidation(const AppOptions& options)
+    {
+        AppOptions headless = options;
+        headless.headless_render = false;
+        Context ctx(nullptr, options.width, options.height, headless);
+        const bool pass = ctx.ValidateAgainstCpu(options.validate_steps, options.validate_tolerance);
+        ctx.WaitIdle();
+        return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // 창 없이 고정 dt 로 headless_frames 만큼 진행 (batch 시뮬레이션 / 성능 회귀 측정용)
+    int RunHeadless(const AppOptions& options)
+    {
+        Context ctx(nullptr, options.width, options.height, options);
+        Camera camera;
+        MouseInteractor mouseInteractor;
+
+        const float dt = 1.0f / 60.0f;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < options.headless_frames; ++frame) {
+            PE_CPU_SCOPE("Frame");
+            ctx.Update(camera, mouseInteractor, dt);
+            ctx.Draw();
+        }
+        ctx.WaitIdle();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "headless: " << options.headless_frames << " frames" << (options.headless_render ? "" : " (no render)")
+            << ", " << ms / std::max(options.headless_frames, 1u) << " ms/frame" << std::endl;
+
+        if (!options.headless_output.empty()) {
+            ctx.SaveOffscreenImage(options.headless_output);
+            std::cout << "saved " << options.headless_output << std::endl;
+        }
+
+#if PE_CPU_PROFILER_ENABLED
+        if (!options.cpu_trace_output.empty()) {
+            CpuProfiler::WriteChromeTrace(options.cpu_trace_output);
+        }
+#endif
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char** argv) {
     try {
-        Window win;
+        PE_CPU_THREAD_NAME("Main");
+        const AppOptions options = ParseArgs(argc, argv);
+        if (options.cpu_reference_steps > 0) {
+            return RunCpuReference(options.cpu_reference_steps);
+        }
+        if (options.validate_steps > 0) {
+            return RunGpuValidation(options);
+        }
+        if (options.headless) {
+            return RunHeadless(options);
+        }
+
+        Window win(options);
         win.run();
     }
     catch (const std::exception& e) {
@@ -11,4 +328,4 @@ int main() {
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
@@ -0,0 +1,51 @@
+#include "vertex.h"
+#include "asset_loader.h"
+
+#include "mesh_asset.h"
+
+MeshAsset::MeshAsset(const MeshData& mesh, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstMeshlet, uint32_t firstSdfValue)
+	: first_index_(firstIndex + mesh.LodData()[0].first_index), index_count_(mesh.LodData()[0].index_count), vertex_offset_(vertexOffset),
+	first_meshlet_(firstMeshlet), meshlet_count_(mesh.MeshletCount()), first_sdf_value_(firstSdfValue), sdf_(mesh.GetSdfVolume())
+{
+	const pmesh::Lod* lods = mesh.LodData();
+	for (uint32_t i = 0; i < mesh.LodCount(); ++i) {
+		lods_.push_back(Lod{ .first_index = firstIndex + lods[i].first_index, .index_count = lods[i].index_count, .error = lods[i].error });
+	}
+
+	// AABB 以묒떖 湲곗#include "vertex.h"
+#include "asset_loader.h"
+
+#include "mesh_asset.h"
+
+MeshAsset::MeshAsset(const MeshData& mesh, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstMeshlet, uint32_t firstSdfValue)
+	: first_index_(firstIndex + mesh.LodData()[0].first_index), index_count_(mesh.LodData()[0].index_count), vertex_offset_(vertexOffset),
+	first_meshlet_(firstMeshlet), meshlet_count_(mesh.MeshletCount()), first_sdf_value_(firstSdfValue), sdf_(mesh.GetSdfVolume())
+{
+	const pmesh::Lod* lods = mesh.LodData();
+	for (uint32_t i = 0; i < mesh.LodCount(); ++i) {
+		lods_.push_back(Lod{ .first_index = firstIndex + lods[i].first_index, .index_count = lods[i].index_count, .error = lods[i].error });
+	}
+
+	// AABB 중심 기준 bounding sphere. 최적은 아니지만 한 번만 계산하고 충분히 타이트하다
+	const auto* vertices = static_cast<const Vertex*>(mesh.VertexData());
+	const size_t vertexCount = mesh.VertexBytes() / sizeof(Vertex);
+	if (vertexCount == 0) return;
+
+	glm::vec3 lo = vertices[0].pos;
+	glm::vec3 hi = vertices[0].pos;
+	for (size_t i = 1; i < vertexCount; ++i) {
+		lo = glm::min(lo, vertices[i].pos);
+		hi = glm::max(hi, vertices[i].pos);
+	}
+	bounds_center_ = (lo + hi) * 0.5f;
+
+	float radius2 = 0.0f;
+	for (size_t i = 0; i < vertexCount; ++i) {
+		const glm::vec3 d = vertices[i].pos - bounds_center_;
+		radius2 = std::max(radius2, glm::dot(d, d));
+	}
+	bounds_radius_ = std::sqrt(radius2);
+	if (bounds_radius_ > 0.0f) {
+		for (Lod& lod : lods_) lod.error /= bounds_radius_;
+	}
+}
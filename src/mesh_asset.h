@@ -0,0 +1,49 @@
+#pragma once
+
+struct MeshData;
+
+#include "mesh_cache.h"
+
+// MeshPool #pragma once
+
+struct MeshData;
+
+#include "mesh_cache.h"
+
+// MeshPool 안에 올라간 mesh 하나의 위치 (index range + vertex offset) 와 bounds.
+// 같은 mesh 를 쓰는 MeshInstance 들이 shared_ptr 로 같이 들고 있는다.
+// bounds 는 mesh local space 의 bounding sphere (picking / culling 용)
+class MeshAsset
+{
+public:
+	// pool index buffer 안의 LOD 구간. error 는 bounds_radius_ 에 대한 비율 (instance 크기를 곱하면 world space 오차)
+	struct Lod {
+		uint32_t first_index = 0;
+		uint32_t index_count = 0;
+		float error = 0.0f;
+	};
+
+	MeshAsset(const MeshData& mesh, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstMeshlet, uint32_t firstSdfValue);
+	MeshAsset(const MeshAsset& rhs) = delete;
+	MeshAsset(MeshAsset&& rhs) = delete;
+	MeshAsset& operator=(const MeshAsset& rhs) = delete;
+	MeshAsset& operator=(MeshAsset&& rhs) = delete;
+	~MeshAsset() = default;
+
+	uint32_t first_index_ = 0; // LOD 0
+	uint32_t index_count_ = 0;
+	int32_t vertex_offset_ = 0;
+	std::vector<Lod> lods_;    // [0] = 원본, 뒤로 갈수록 거칠다
+
+	// pool meshlet buffer 안의 LOD 0 meshlet 구간. clustered_ 면 instance 단위 draw 대신 ClusterCuller 가 meshlet 단위로 cull / draw
+	uint32_t first_meshlet_ = 0;
+	uint32_t meshlet_count_ = 0;
+	bool clustered_ = false;
+
+	// pool SDF buffer 안의 격자 시작 위치와 격자 정보 (resolution 0 이면 bounding sphere 로 충돌)
+	uint32_t first_sdf_value_ = 0;
+	pmesh::SdfVolume sdf_;
+
+	glm::vec3 bounds_center_{ 0.0f };
+	float bounds_radius_ = 0.0f;
+};
@@ -0,0 +1,328 @@
+#include "vertex.h"
+
+#include "mesh_cache.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pmesh
+{
+	namespace {
+		constexpr char kMagic[4] = { 'P', 'M', 'S', 'H' };
+
+		uint64_t Fnv1a(uint64_t hash, const void* data, size_t size)
+		{
+			const auto* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; ++i) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return hash;
+		}
+
+		bool ReadWholeFile(const std::filesystem::path& path, std::string& out)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open()) return false;
+			out.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(out.data(), static_cast<std::streamsize>(out.size()));
+			return static_cast<bool>(file);
+		}
+
+		uint64_t AlignUp(uint64_t value)
+		{
+			return (value + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+		}
+
+		// "uri" : "xxx.bin" 泥섎읆 李몄“#include "vertex.h"
+
+#include "mesh_cache.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pmesh
+{
+	namespace {
+		constexpr char kMagic[4] = { 'P', 'M', 'S', 'H' };
+
+		uint64_t Fnv1a(uint64_t hash, const void* data, size_t size)
+		{
+			const auto* bytes = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < size; ++i) {
+				hash = (hash ^ bytes[i]) * 1099511628211ull;
+			}
+			return hash;
+		}
+
+		bool ReadWholeFile(const std::filesystem::path& path, std::string& out)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			if (!file.is_open()) return false;
+			out.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(out.data(), static_cast<std::streamsize>(out.size()));
+			return static_cast<bool>(file);
+		}
+
+		uint64_t AlignUp(uint64_t value)
+		{
+			return (value + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+		}
+
+		// "uri" : "xxx.bin" 처럼 참조하는 외부 파일 (data: URI 는 이미 text 에 포함)
+		std::vector<std::filesystem::path> ReferencedFiles(const std::string& sourcePath, const std::string& text)
+		{
+			std::vector<std::filesystem::path> files;
+			const std::filesystem::path baseDir = std::filesystem::path(sourcePath).parent_path();
+			for (size_t pos = text.find("\"uri\""); pos != std::string::npos; pos = text.find("\"uri\"", pos + 5)) {
+				const size_t open = text.find('"', text.find(':', pos + 5));
+				const size_t close = open == std::string::npos ? std::string::npos : text.find('"', open + 1);
+				if (close == std::string::npos) break;
+
+				const std::string uri = text.substr(open + 1, close - open - 1);
+				if (uri.rfind("data:", 0) == 0) continue;
+				files.push_back(baseDir / uri);
+			}
+			return files;
+		}
+
+		void AddToStamp(SourceStamp& stamp, const std::filesystem::path& path)
+		{
+			std::error_code error;
+			const uint64_t size = std::filesystem::file_size(path, error);
+			if (error) return;
+			const auto mtime = std::filesystem::last_write_time(path, error);
+			if (error) return;
+			stamp.size += size;
+			stamp.mtime = std::max<int64_t>(stamp.mtime, mtime.time_since_epoch().count());
+		}
+	}
+
+	uint64_t HashSource(const std::string& sourcePath)
+	{
+		std::string text;
+		if (!ReadWholeFile(sourcePath, text)) {
+			throw std::runtime_error("failed to read mesh source " + sourcePath);
+		}
+		uint64_t hash = Fnv1a(1469598103934665603ull, text.data(), text.size());
+
+		for (const std::filesystem::path& file : ReferencedFiles(sourcePath, text)) {
+			std::string referenced;
+			if (ReadWholeFile(file, referenced)) {
+				hash = Fnv1a(hash, referenced.data(), referenced.size());
+			}
+		}
+		return hash;
+	}
+
+	SourceStamp StampSource(const std::string& sourcePath)
+	{
+		std::string text;
+		if (!ReadWholeFile(sourcePath, text)) {
+			throw std::runtime_error("failed to read mesh source " + sourcePath);
+		}
+
+		SourceStamp stamp;
+		AddToStamp(stamp, sourcePath);
+		for (const std::filesystem::path& file : ReferencedFiles(sourcePath, text)) {
+			AddToStamp(stamp, file);
+		}
+		return stamp;
+	}
+
+	std::string CachePathFor(const std::string& sourcePath)
+	{
+		return std::filesystem::path(sourcePath).replace_extension(".pmesh").string();
+	}
+
+	void Write(const std::string& path, uint64_t sourceHash, const SourceStamp& sourceStamp, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<Lod>& lods,
+		const Meshlets& meshlets, const Sdf& sdf)
+	{
+		Header header{};
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = kVersion;
+		header.source_hash = sourceHash;
+		header.source_stamp = sourceStamp;
+		header.vertex_stride = sizeof(Vertex);
+		header.index_stride = sizeof(uint32_t);
+		header.vertex_count = vertices.size();
+		header.index_count = indices.size();
+		header.vertex_offset = AlignUp(sizeof(Header));
+		header.index_offset = AlignUp(header.vertex_offset + vertices.size() * sizeof(Vertex));
+		header.lod_offset = AlignUp(header.index_offset + indices.size() * sizeof(uint32_t));
+		header.lod_count = static_cast<uint32_t>(lods.size());
+		header.meshlet_offset = AlignUp(header.lod_offset + lods.size() * sizeof(Lod));
+		header.meshlet_count = static_cast<uint32_t>(meshlets.meshlets.size());
+		header.meshlet_vertex_offset = AlignUp(header.meshlet_offset + meshlets.meshlets.size() * sizeof(Meshlet));
+		header.meshlet_vertex_count = static_cast<uint32_t>(meshlets.vertices.size());
+		header.meshlet_triangle_offset = AlignUp(header.meshlet_vertex_offset + meshlets.vertices.size() * sizeof(uint32_t));
+		header.meshlet_triangle_count = static_cast<uint32_t>(meshlets.triangles.size());
+		header.sdf = sdf.volume;
+		header.sdf_offset = AlignUp(header.meshlet_triangle_offset + meshlets.triangles.size() * sizeof(uint32_t));
+		header.file_size = header.sdf_offset + sdf.distances.size() * sizeof(float);
+
+		const std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				throw std::runtime_error("failed to open " + tempPath + " for writing");
+			}
+
+			const std::vector<char> padding(kSectionAlignment, 0);
+			auto writeAt = [&](uint64_t offset, const void* data, size_t size) {
+				const uint64_t current = static_cast<uint64_t>(file.tellp());
+				file.write(padding.data(), static_cast<std::streamsize>(offset - current));
+				file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+			};
+			writeAt(0, &header, sizeof(Header));
+			writeAt(header.vertex_offset, vertices.data(), vertices.size() * sizeof(Vertex));
+			writeAt(header.index_offset, indices.data(), indices.size() * sizeof(uint32_t));
+			writeAt(header.lod_offset, lods.data(), lods.size() * sizeof(Lod));
+			writeAt(header.meshlet_offset, meshlets.meshlets.data(), meshlets.meshlets.size() * sizeof(Meshlet));
+			writeAt(header.meshlet_vertex_offset, meshlets.vertices.data(), meshlets.vertices.size() * sizeof(uint32_t));
+			writeAt(header.meshlet_triangle_offset, meshlets.triangles.data(), meshlets.triangles.size() * sizeof(uint32_t));
+			writeAt(header.sdf_offset, sdf.distances.data(), sdf.distances.size() * sizeof(float));
+
+			if (!file) {
+				throw std::runtime_error("failed to write " + tempPath);
+			}
+		}
+		std::filesystem::rename(tempPath, path);
+	}
+
+	// ===== MappedFile =====
+
+	std::unique_ptr<MappedFile> MappedFile::Open(const std::string& path)
+	{
+		std::unique_ptr<MappedFile> mapped(new MappedFile());
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return nullptr;
+		mapped->file_ = file;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) return nullptr;
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) return nullptr;
+		mapped->mapping_ = mapping;
+
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view) return nullptr;
+		mapped->data_ = static_cast<const std::byte*>(view);
+		mapped->size_ = static_cast<size_t>(size.QuadPart);
+#else
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) return nullptr;
+
+		struct stat st {};
+		if (fstat(fd, &st) != 0 || st.st_size == 0) {
+			close(fd);
+			return nullptr;
+		}
+
+		// mapping 은 fd 를 닫아도 유지된다
+		void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (view == MAP_FAILED) return nullptr;
+		mapped->data_ = static_cast<const std::byte*>(view);
+		mapped->size_ = static_cast<size_t>(st.st_size);
+#endif
+		return mapped;
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifdef _WIN32
+		if (data_) UnmapViewOfFile(data_);
+		if (mapping_) CloseHandle(mapping_);
+		if (file_) CloseHandle(file_);
+#else
+		if (data_) munmap(const_cast<std::byte*>(data_), size_);
+#endif
+	}
+
+	// ===== MappedMesh =====
+
+	std::unique_ptr<MappedMesh> MappedMesh::Open(const std::string& path, const SourceStamp& stamp, const std::function<uint64_t()>& hashSource)
+	{
+		std::unique_ptr<MappedFile> file = MappedFile::Open(path);
+		if (!file || file->Size() < sizeof(Header)) return nullptr;
+
+		Header header;
+		std::memcpy(&header, file->Data(), sizeof(Header));
+		const bool valid =
+			std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+			header.version == kVersion &&
+			header.vertex_stride == sizeof(Vertex) &&
+			header.index_stride == sizeof(uint32_t) &&
+			header.file_size == file->Size() &&
+			header.vertex_offset % kSectionAlignment == 0 &&
+			header.index_offset % kSectionAlignment == 0 &&
+			header.vertex_offset + header.vertex_count * header.vertex_stride <= header.index_offset &&
+			header.index_offset + header.index_count * header.index_stride <= header.lod_offset &&
+			header.lod_offset % kSectionAlignment == 0 &&
+			header.lod_count >= 1 && header.lod_count <= kMaxLods &&
+			header.lod_offset + header.lod_count * sizeof(Lod) <= header.meshlet_offset &&
+			header.meshlet_offset % kSectionAlignment == 0 &&
+			header.meshlet_vertex_offset % kSectionAlignment == 0 &&
+			header.meshlet_triangle_offset % kSectionAlignment == 0 &&
+			header.meshlet_offset + header.meshlet_count * sizeof(Meshlet) <= header.meshlet_vertex_offset &&
+			header.meshlet_vertex_offset + header.meshlet_vertex_count * sizeof(uint32_t) <= header.meshlet_triangle_offset &&
+			header.meshlet_triangle_offset + header.meshlet_triangle_count * sizeof(uint32_t) <= header.sdf_offset &&
+			header.sdf_offset % kSectionAlignment == 0 &&
+			header.sdf_offset + static_cast<uint64_t>(header.sdf.Count()) * sizeof(float) <= header.file_size;
+		if (!valid) return nullptr;
+
+		// LOD / meshlet 구간이 배열 밖을 가리키면 손상된 것
+		const auto* lods = reinterpret_cast<const Lod*>(file->Data() + header.lod_offset);
+		for (uint32_t i = 0; i < header.lod_count; ++i) {
+			if (static_cast<uint64_t>(lods[i].first_index) + lods[i].index_count > header.index_count) return nullptr;
+		}
+		const auto* meshlets = reinterpret_cast<const Meshlet*>(file->Data() + header.meshlet_offset);
+		for (uint32_t i = 0; i < header.meshlet_count; ++i) {
+			const Meshlet& m = meshlets[i];
+			if (m.vertex_count > MESHLET_MAX_VERTICES || m.triangle_count > MESHLET_MAX_TRIANGLES ||
+				static_cast<uint64_t>(m.vertex_offset) + m.vertex_count > header.meshlet_vertex_count ||
+				static_cast<uint64_t>(m.triangle_offset) + m.triangle_count > header.meshlet_triangle_count) return nullptr;
+		}
+
+		// layout 검사를 통과한 뒤에야 원본을 비교한다. 크기 / 수정 시각이 같으면 hash 생략
+		if (!(header.source_stamp == stamp)) {
+			if (header.source_hash != hashSource()) return nullptr;
+
+			// 내용은 같으므로 stamp 만 고쳐 쓴다. 실패해도 (읽기 전용 등) 다음에 다시 hash 할 뿐.
+			// Windows 는 map 중인 파일에 쓸 수 없으므로 mapping 을 풀고 쓴 뒤 다시 연다
+			file.reset();
+			{
+				std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+				if (out.is_open()) {
+					out.seekp(offsetof(Header, source_stamp));
+					out.write(reinterpret_cast<const char*>(&stamp), sizeof(SourceStamp));
+				}
+			}
+			file = MappedFile::Open(path);
+			if (!file || file->Size() != header.file_size) return nullptr;
+		}
+
+		return std::unique_ptr<MappedMesh>(new MappedMesh(std::move(file)));
+	}
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+struct Vertex;
+
+#include "meshlet_layout.h"
+
+// #pragma once
+
+struct Vertex;
+
+#include "meshlet_layout.h"
+
+// 한 번 import 한 mesh 를 그대로 buffer 에 올릴 수 있는 형태로 저장한 binary cache (.pmesh).
+// [Header 176 bytes][vertex 배열][index 배열][LOD table][meshlet][meshlet vertex][meshlet triangle][SDF],
+// 각 section 은 kSectionAlignment 로 정렬. little endian.
+// index 배열에는 LOD 0 (원본) 부터 모든 LOD 의 index 가 이어져 있고 vertex 배열은 모든 LOD 가 공유한다.
+// meshlet 은 LOD 0 만 나눈 것 (meshlet.h). SDF 는 천 충돌용 signed distance 격자 (mesh_sdf.h).
+// source_hash 가 원본 asset 과 다르거나 version / vertex layout 이 다르면 stale 로 보고 다시 import 한다.
+// 원본의 크기 / 수정 시각 (source_stamp) 이 header 와 같으면 내용 hash 는 계산하지 않는다.
+namespace pmesh
+{
+	constexpr uint32_t kVersion = 7; // 2 : primitive 가 여러 개인 mesh 의 index remap 수정, 3 : normal 추가, 4 : LOD chain, 5 : meshlet, 6 : SDF, 7 : source stamp
+	constexpr uint64_t kSectionAlignment = 256;
+	constexpr uint32_t kMaxLods = 8;
+
+	// LOD 하나의 index 구간 (index 배열 안에서의 위치)
+	struct Lod {
+		uint32_t first_index;
+		uint32_t index_count;
+		float error;            // 원본 대비 object space 오차 (mesh_lod.h)
+		uint32_t pad = 0;
+	};
+	static_assert(sizeof(Lod) == 16);
+
+	// meshlet 하나. bounds / cone 은 mesh local space, offset 은 Meshlets::vertices / triangles 안의 위치
+	struct Meshlet {
+		glm::vec3 center;
+		float radius;
+		glm::vec3 cone_axis;    // triangle 법선의 평균 방향
+		float cone_cutoff;      // sin(법선과 axis 사이의 최대 각). 1 이면 backface cone 판정을 하지 않는다
+		uint32_t vertex_offset;
+		uint32_t triangle_offset;
+		uint32_t vertex_count;
+		uint32_t triangle_count;
+	};
+	static_assert(sizeof(Meshlet) == MESHLET_STRIDE);
+
+	struct Meshlets {
+		std::vector<Meshlet> meshlets;
+		std::vector<uint32_t> vertices;  // meshlet local vertex -> mesh vertex 번호
+		std::vector<uint32_t> triangles; // local vertex 3 개를 8 bit 씩 (a | b << 8 | c << 16)
+	};
+
+	// mesh local space 의 균일 격자. 값 (x 가 가장 빠름) 은 격자점에서 표면까지의 거리, 안쪽이 음수
+	struct SdfVolume {
+		glm::vec3 origin;       // 격자점 (0, 0, 0) 의 위치
+		float cell = 0.0f;      // 격자 간격
+		glm::uvec3 resolution{ 0 }; // 축마다 격자점 수. 0 이면 SDF 없음 (bounding sphere 로 충돌)
+		uint32_t pad = 0;
+
+		uint32_t Count() const { return resolution.x * resolution.y * resolution.z; }
+	};
+	static_assert(sizeof(SdfVolume) == 32);
+
+	struct Sdf {
+		SdfVolume volume;
+		std::vector<float> distances;
+	};
+
+	// 원본 asset (.gltf 와 거기서 참조하는 외부 파일) 의 크기 합과 가장 늦은 수정 시각
+	struct SourceStamp {
+		uint64_t size = 0;
+		int64_t mtime = 0;      // std::filesystem::file_time_type 의 tick
+		bool operator==(const SourceStamp& rhs) const = default;
+	};
+	static_assert(sizeof(SourceStamp) == 16);
+
+	struct Header {
+		char magic[4];          // "PMSH"
+		uint32_t version;
+		uint64_t source_hash;
+		uint32_t vertex_stride; // sizeof(Vertex)
+		uint32_t index_stride;  // sizeof(uint32_t)
+		uint64_t vertex_count;
+		uint64_t index_count;   // 모든 LOD 의 합
+		uint64_t vertex_offset;
+		uint64_t index_offset;
+		uint64_t file_size;
+		uint64_t lod_offset;
+		uint32_t lod_count;     // 1 이상 (LOD 0 = 원본)
+		uint32_t reserved;
+		uint64_t meshlet_offset;
+		uint64_t meshlet_vertex_offset;
+		uint64_t meshlet_triangle_offset;
+		uint32_t meshlet_count;
+		uint32_t meshlet_vertex_count;
+		uint32_t meshlet_triangle_count;
+		uint32_t reserved2;
+		SdfVolume sdf;
+		uint64_t sdf_offset;
+		uint64_t reserved3;
+		SourceStamp source_stamp;
+	};
+	static_assert(sizeof(Header) == 176);
+
+	// 원본 asset 의 내용 hash (FNV-1a 64). .gltf 와 거기서 참조하는 외부 파일 (.bin 등) 을 모두 포함
+	uint64_t HashSource(const std::string& sourcePath);
+	// 원본 asset 의 크기 / 수정 시각. 외부 파일 이름을 찾으려고 .gltf 는 읽지만 buffer 는 stat 만 한다
+	SourceStamp StampSource(const std::string& sourcePath);
+	// assets/models/sphere.gltf -> assets/models/sphere.pmesh
+	std::string CachePathFor(const std::string& sourcePath);
+
+	// 임시 파일에 쓴 뒤 rename 하므로 중간에 죽어도 반쯤 쓴 cache 가 남지 않는다
+	void Write(const std::string& path, uint64_t sourceHash, const SourceStamp& sourceStamp, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<Lod>& lods,
+		const Meshlets& meshlets, const Sdf& sdf);
+
+	// 읽기 전용 memory mapped file
+	class MappedFile
+	{
+	public:
+		// 파일이 없거나 열 수 없으면 nullptr
+		static std::unique_ptr<MappedFile> Open(const std::string& path);
+		MappedFile(const MappedFile& rhs) = delete;
+		MappedFile(MappedFile&& rhs) = delete;
+		MappedFile& operator=(const MappedFile& rhs) = delete;
+		MappedFile& operator=(MappedFile&& rhs) = delete;
+		~MappedFile();
+
+		const std::byte* Data() const { return data_; }
+		size_t Size() const { return size_; }
+
+	private:
+		MappedFile() = default;
+
+#ifdef _WIN32
+		void* file_ = nullptr;
+		void* mapping_ = nullptr;
+#endif
+		const std::byte* data_ = nullptr;
+		size_t size_ = 0;
+	};
+
+	// mmap 한 .pmesh. VertexData() / IndexData() / LodData() 는 mapping 을 직접 가리키므로 복사 없이 staging 으로 memcpy 할 수 있다
+	class MappedMesh
+	{
+	public:
+		// 없거나 stale / 손상된 cache 면 nullptr. stamp 가 header 와 다를 때만 hashSource 를 불러 내용을 비교하고,
+		// 내용이 같으면 (checkout 등으로 수정 시각만 바뀐 경우) 다음 실행을 위해 header 의 stamp 를 갱신한다
+		static std::unique_ptr<MappedMesh> Open(const std::string& path, const SourceStamp& stamp, const std::function<uint64_t()>& hashSource);
+		MappedMesh(const MappedMesh& rhs) = delete;
+		MappedMesh(MappedMesh&& rhs) = delete;
+		MappedMesh& operator=(const MappedMesh& rhs) = delete;
+		MappedMesh& operator=(MappedMesh&& rhs) = delete;
+		~MappedMesh() = default;
+
+		const Header& GetHeader() const { return *reinterpret_cast<const Header*>(file_->Data()); }
+		const std::byte* VertexData() const { return file_->Data() + GetHeader().vertex_offset; }
+		const std::byte* IndexData() const { return file_->Data() + GetHeader().index_offset; }
+		uint64_t VertexBytes() const { return GetHeader().vertex_count * GetHeader().vertex_stride; }
+		uint64_t IndexBytes() const { return GetHeader().index_count * GetHeader().index_stride; }
+		uint32_t IndexCount() const { return static_cast<uint32_t>(GetHeader().index_count); }
+		const Lod* LodData() const { return reinterpret_cast<const Lod*>(file_->Data() + GetHeader().lod_offset); }
+		uint32_t LodCount() const { return GetHeader().lod_count; }
+		const Meshlet* MeshletData() const { return reinterpret_cast<const Meshlet*>(file_->Data() + GetHeader().meshlet_offset); }
+		uint32_t MeshletCount() const { return GetHeader().meshlet_count; }
+		const uint32_t* MeshletVertexData() const { return reinterpret_cast<const uint32_t*>(file_->Data() + GetHeader().meshlet_vertex_offset); }
+		uint32_t MeshletVertexCount() const { return GetHeader().meshlet_vertex_count; }
+		const uint32_t* MeshletTriangleData() const { return reinterpret_cast<const uint32_t*>(file_->Data() + GetHeader().meshlet_triangle_offset); }
+		uint32_t MeshletTriangleCount() const { return GetHeader().meshlet_triangle_count; }
+		const SdfVolume& GetSdfVolume() const { return GetHeader().sdf; }
+		const float* SdfData() const { return reinterpret_cast<const float*>(file_->Data() + GetHeader().sdf_offset); }
+
+	private:
+		explicit MappedMesh(std::unique_ptr<MappedFile> file) : file_(std::move(file)) {}
+
+		std::unique_ptr<MappedFile> file_;
+	};
+}
@@ -0,0 +1,317 @@
+#include "vertex.h"
+
+#include "mesh_import.h"
+
+namespace {
+    // accessor 媛#include "vertex.h"
+
+#include "mesh_import.h"
+
+namespace {
+    // accessor 가 가리키는 첫 element 와 element 간격. bufferView 가 없으면 (sparse 만 있는 accessor) nullptr
+    const unsigned char* AccessorData(const tinygltf::Model& model, const tinygltf::Accessor& accessor, size_t& stride)
+    {
+        if (accessor.bufferView < 0) return nullptr;
+
+        const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+        const tinygltf::Buffer& buffer = model.buffers[view.buffer];
+        const int byteStride = accessor.ByteStride(view);
+        if (byteStride <= 0) {
+            throw std::runtime_error("invalid glTF accessor stride");
+        }
+        stride = static_cast<size_t>(byteStride);
+
+        const size_t elementSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(accessor.componentType)) * tinygltf::GetNumComponentsInType(accessor.type);
+        const size_t begin = view.byteOffset + accessor.byteOffset;
+        if (accessor.count > 0 && begin + stride * (accessor.count - 1) + elementSize > buffer.data.size()) {
+            throw std::runtime_error("glTF accessor reads past the end of its buffer");
+        }
+        return buffer.data.data() + begin;
+    }
+
+    // component 하나를 float 로. normalized 정수는 [0,1] / [-1,1], 아니면 값 그대로 (KHR_mesh_quantization)
+    float ReadComponent(const unsigned char* src, int componentType, bool normalized)
+    {
+        switch (componentType) {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT: { float v; std::memcpy(&v, src, 4); return v; }
+        case TINYGLTF_COMPONENT_TYPE_BYTE: { int8_t v; std::memcpy(&v, src, 1); return normalized ? std::max(v / 127.0f, -1.0f) : v; }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: { uint8_t v = *src; return normalized ? v / 255.0f : v; }
+        case TINYGLTF_COMPONENT_TYPE_SHORT: { int16_t v; std::memcpy(&v, src, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : v; }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; std::memcpy(&v, src, 2); return normalized ? v / 65535.0f : v; }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: { uint32_t v; std::memcpy(&v, src, 4); return static_cast<float>(v); }
+        default: throw std::runtime_error("unsupported glTF component type " + std::to_string(componentType));
+        }
+    }
+
+    uint32_t ReadIndex(const unsigned char* src, int componentType)
+    {
+        switch (componentType) {
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: return *src;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; std::memcpy(&v, src, 2); return v; }
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: { uint32_t v; std::memcpy(&v, src, 4); return v; }
+        default: throw std::runtime_error("unsupported glTF index type " + std::to_string(componentType));
+        }
+    }
+
+    // 흔한 경우 (float, N 성분) : 꽉 차 있으면 memcpy 한 번, interleaved 면 N 이 상수인 고정 크기 copy 로 풀린다
+    template <size_t N>
+    void CopyFloats(const unsigned char* src, size_t stride, size_t count, float* dst)
+    {
+        if (stride == N * sizeof(float)) {
+            std::memcpy(dst, src, count * N * sizeof(float));
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            std::memcpy(dst + i * N, src + i * stride, N * sizeof(float));
+        }
+    }
+
+    // accessor 를 element 당 components 개의 float 로 읽는다. 모자란 성분은 0, 남는 성분은 버림.
+    // byteStride (interleaved), normalized / quantized 정수, sparse 를 모두 처리한다
+    void ReadFloats(const tinygltf::Model& model, const tinygltf::Accessor& accessor, size_t components, std::vector<float>& out)
+    {
+        const size_t sourceComponents = static_cast<size_t>(tinygltf::GetNumComponentsInType(accessor.type));
+        const size_t count = accessor.count;
+        out.assign(count * components, 0.0f);
+
+        size_t stride = 0;
+        if (const unsigned char* src = AccessorData(model, accessor, stride)) {
+            if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && sourceComponents == components) {
+                switch (components) {
+                case 1: CopyFloats<1>(src, stride, count, out.data()); break;
+                case 2: CopyFloats<2>(src, stride, count, out.data()); break;
+                case 3: CopyFloats<3>(src, stride, count, out.data()); break;
+                case 4: CopyFloats<4>(src, stride, count, out.data()); break;
+                default: break;
+                }
+            }
+            else {
+                const size_t componentSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(accessor.componentType));
+                const size_t n = std::min(components, sourceComponents);
+                for (size_t i = 0; i < count; ++i) {
+                    for (size_t c = 0; c < n; ++c) {
+                        out[i * components + c] = ReadComponent(src + i * stride + c * componentSize, accessor.componentType, accessor.normalized);
+                    }
+                }
+            }
+        }
+
+        // sparse : 일부 element 만 다른 값으로 덮어쓴다 (values 는 꽉 찬 배열, accessor 와 같은 component type)
+        if (accessor.sparse.isSparse) {
+            const auto& sparse = accessor.sparse;
+            const tinygltf::BufferView& indexView = model.bufferViews[sparse.indices.bufferView];
+            const tinygltf::BufferView& valueView = model.bufferViews[sparse.values.bufferView];
+            const unsigned char* sparseIndices = model.buffers[indexView.buffer].data.data() + indexView.byteOffset + sparse.indices.byteOffset;
+            const unsigned char* sparseValues = model.buffers[valueView.buffer].data.data() + valueView.byteOffset + sparse.values.byteOffset;
+            const size_t indexSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(sparse.indices.componentType));
+            const size_t componentSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(accessor.componentType));
+            const size_t n = std::min(components, sourceComponents);
+
+            for (int s = 0; s < sparse.count; ++s) {
+                const uint32_t target = ReadIndex(sparseIndices + s * indexSize, sparse.indices.componentType);
+                if (target >= count) {
+                    throw std::runtime_error("glTF sparse accessor index out of range");
+                }
+                for (size_t c = 0; c < n; ++c) {
+                    out[target * components + c] = ReadComponent(sparseValues + (s * sourceComponents + c) * componentSize, accessor.componentType, accessor.normalized);
+                }
+            }
+        }
+    }
+
+    void ReadIndices(const tinygltf::Model& model, const tinygltf::Accessor& accessor, std::vector<uint32_t>& out)
+    {
+        out.resize(accessor.count);
+        size_t stride = 0;
+        const unsigned char* src = AccessorData(model, accessor, stride);
+        if (!src) {
+            throw std::runtime_error("glTF index accessor has no buffer view");
+        }
+        if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT && stride == sizeof(uint32_t)) {
+            std::memcpy(out.data(), src, accessor.count * sizeof(uint32_t));
+            return;
+        }
+        for (size_t i = 0; i < accessor.count; ++i) {
+            out[i] = ReadIndex(src + i * stride, accessor.componentType);
+        }
+    }
+
+    // NORMAL 이 없는 primitive 용. 면적 가중 평균 (smooth)
+    void GenerateNormals(const std::vector<float>& positions, const std::vector<uint32_t>& indices, std::vector<float>& normals)
+    {
+        normals.assign(positions.size(), 0.0f);
+        auto position = [&](uint32_t i) { return glm::vec3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]); };
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            const uint32_t i0 = indices[t], i1 = indices[t + 1], i2 = indices[t + 2];
+            const glm::vec3 faceNormal = glm::cross(position(i1) - position(i0), position(i2) - position(i0));
+            for (uint32_t i : { i0, i1, i2 }) {
+                normals[i * 3] += faceNormal.x;
+                normals[i * 3 + 1] += faceNormal.y;
+                normals[i * 3 + 2] += faceNormal.z;
+            }
+        }
+        for (size_t i = 0; i < normals.size(); i += 3) {
+            glm::vec3 n(normals[i], normals[i + 1], normals[i + 2]);
+            const float length = glm::length(n);
+            n = length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            normals[i] = n.x; normals[i + 1] = n.y; normals[i + 2] = n.z;
+        }
+    }
+}
+
+void ImportGltfMesh(const std::string& modelPath, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    tinygltf::Model model;
+    tinygltf::TinyGLTF loader;
+    std::string err;
+    std::string warn;
+
+    bool ret = loader.LoadASCIIFromFile(&model, &err, &warn, modelPath);
+
+    if (!warn.empty()) {
+        std::cout << "glTF warning: " << warn << std::endl;
+    }
+
+    if (!err.empty()) {
+        std::cout << "glTF error: " << err << std::endl;
+    }
+
+    if (!ret) {
+        throw std::runtime_error("Failed to load glTF model");
+    }
+
+    // accessor count 로 최종 크기를 미리 잡는다 (dedup 전 기준이므로 vertices 는 상한)
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const auto& mesh : model.meshes) {
+        for (const auto& primitive : mesh.primitives) {
+            const size_t count = model.accessors[primitive.attributes.at("POSITION")].count;
+            vertexCount += count;
+            indexCount += primitive.indices >= 0 ? model.accessors[primitive.indices].count : count;
+        }
+    }
+    vertices.reserve(vertices.size() + vertexCount);
+    indices.reserve(indices.size() + indexCount);
+
+    VertexDeduplicator dedup(vertices, vertexCount);
+    // primitive 단위 작업 버퍼 (primitive 마다 다시 할당하지 않도록 밖에 둔다)
+    std::vector<float> positions, texcoords, normals;
+    std::vector<uint32_t> localIndices;
+    // primitive 안의 local index -> 합쳐진 vertices 의 index
+    std::vector<uint32_t> remap;
+
+    for (const auto& mesh : model.meshes) {
+        for (const auto& primitive : mesh.primitives) {
+            if (primitive.mode != TINYGLTF_MODE_TRIANGLES && primitive.mode != -1) {
+                std::cout << "glTF warning: skipping non-triangle primitive in " << mesh.name << std::endl;
+                continue;
+            }
+
+            const tinygltf::Accessor& posAccessor = model.accessors[primitive.attributes.at("POSITION")];
+            const size_t count = posAccessor.count;
+            ReadFloats(model, posAccessor, 3, positions);
+
+            if (primitive.indices >= 0) {
+                ReadIndices(model, model.accessors[primitive.indices], localIndices);
+            }
+            else {
+                // index 가 없는 primitive 는 vertex 순서 그대로 (0, 1, 2, ...)
+                localIndices.resize(count);
+                std::iota(localIndices.begin(), localIndices.end(), 0u);
+            }
+            for (uint32_t index : localIndices) {
+                if (index >= count) {
+                    throw std::runtime_error("glTF index out of range in " + modelPath);
+                }
+            }
+
+            const auto texcoordIt = primitive.attributes.find("TEXCOORD_0");
+            if (texcoordIt != primitive.attributes.end()) {
+                ReadFloats(model, model.accessors[texcoordIt->second], 2, texcoords);
+            }
+            else {
+                texcoords.assign(count * 2, 0.0f);
+            }
+
+            const auto normalIt = primitive.attributes.find("NORMAL");
+            if (normalIt != primitive.attributes.end()) {
+                ReadFloats(model, model.accessors[normalIt->second], 3, normals);
+            }
+            else {
+                GenerateNormals(positions, localIndices, normals);
+            }
+
+            // vertex 마다 한 번만 hash 하고 결과 index 를 remap 에 기록
+            remap.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                Vertex vertex{};
+                vertex.pos = { positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2] };
+                vertex.texcoord = { texcoords[i * 2], 1.0f - texcoords[i * 2 + 1] };
+                vertex.normal = { normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2] };
+                remap[i] = dedup.Insert(vertex);
+            }
+
+            for (uint32_t index : localIndices) {
+                indices.push_back(remap[index]);
+            }
+        }
+    }
+}
+
+VertexDeduplicator::VertexDeduplicator(std::vector<Vertex>& vertices, size_t expectedVertices)
+    : vertices_(vertices)
+{
+    size_t slotCount = 16;
+    while (slotCount < expectedVertices * 2) slotCount <<= 1;
+    Rehash(slotCount);
+}
+
+uint64_t VertexDeduplicator::Hash(const Vertex& vertex)
+{
+    // float 의 bit pattern 을 32bit 단위로 섞고 murmur3 finalizer 로 마무리
+    static_assert(sizeof(Vertex) % sizeof(uint32_t) == 0);
+    std::array<uint32_t, sizeof(Vertex) / sizeof(uint32_t)> words;
+    std::memcpy(words.data(), &vertex, sizeof(Vertex));
+
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    for (uint32_t word : words) {
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint32_t VertexDeduplicator::Insert(const Vertex& vertex)
+{
+    size_t slot = Hash(vertex) & mask_;
+    for (;;) {
+        const uint32_t index = slots_[slot];
+        if (index == kEmpty) break;
+        if (std::memcmp(&vertices_[index], &vertex, sizeof(Vertex)) == 0) return index;
+        slot = (slot + 1) & mask_;
+    }
+
+    const uint32_t index = static_cast<uint32_t>(vertices_.size());
+    vertices_.push_back(vertex);
+    slots_[slot] = index;
+
+    if (vertices_.size() * 2 > slots_.size()) {
+        Rehash(slots_.size() * 2);
+    }
+    return index;
+}
+
+void VertexDeduplicator::Rehash(size_t slotCount)
+{
+    slots_.assign(slotCount, kEmpty);
+    mask_ = slotCount - 1;
+    for (uint32_t index = 0; index < vertices_.size(); ++index) {
+        size_t slot = Hash(vertices_[index]) & mask_;
+        while (slots_[slot] != kEmpty) slot = (slot + 1) & mask_;
+        slots_[slot] = index;
+    }
+}
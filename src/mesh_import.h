@@ -0,0 +1,39 @@
+#pragma once
+
+struct Vertex;
+
+// glTF (ASCII) #pragma once
+
+struct Vertex;
+
+// glTF (ASCII) 의 모든 mesh / primitive 를 하나의 vertex / index 배열로 합친다. 같은 vertex 는 dedup
+void ImportGltfMesh(const std::string& modelPath, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+// 같은 vertex (bit 단위 비교) 를 하나로 합치는 open addressing hash table.
+// linear probing, 크기는 2의 거듭제곱이고 load factor 가 1/2 를 넘으면 두 배로 키운다.
+// slot 에는 vertices 의 index 만 저장하므로 vertex 를 따로 복사해두지 않는다.
+class VertexDeduplicator
+{
+public:
+	// expectedVertices : 넣을 vertex 수 (accessor count 합). rehash 가 일어나지 않도록 미리 잡는다
+	VertexDeduplicator(std::vector<Vertex>& vertices, size_t expectedVertices);
+	VertexDeduplicator(const VertexDeduplicator& rhs) = delete;
+	VertexDeduplicator(VertexDeduplicator&& rhs) = delete;
+	VertexDeduplicator& operator=(const VertexDeduplicator& rhs) = delete;
+	VertexDeduplicator& operator=(VertexDeduplicator&& rhs) = delete;
+	~VertexDeduplicator() = default;
+
+	// vertex 의 index. 처음 보는 vertex 면 vertices 뒤에 추가
+	uint32_t Insert(const Vertex& vertex);
+
+	static uint64_t Hash(const Vertex& vertex);
+
+private:
+	void Rehash(size_t slotCount);
+
+	static constexpr uint32_t kEmpty = ~0u;
+
+	std::vector<Vertex>& vertices_;
+	std::vector<uint32_t> slots_;
+	size_t mask_ = 0;
+};
@@ -0,0 +1,66 @@
+#include "mesh_asset.h"
+
+#include "mesh_instance.h"
+
+MeshInstance::MeshInstance(std::shared_ptr<MeshAsset> mesh, glm::vec3 initPos)
+    : mesh_(std::move(mesh))
+{
+    position_ = initPos;
+    glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position_);
+    world_ = translationMatrix;
+}
+
+glm::vec3 MeshInstance::BoundsCenter() const
+{
+    return glm::vec3(world_ * glm::vec4(mesh_->bounds_center_, 1.0f));
+}
+
+float MeshInstance::BoundsRadius() const
+{
+    return mesh_->bounds_radius_ * std::max({ scale_.x, scale_.y, scale_.z });
+}
+
+void MeshInstance::ApplyTransform(const glm::quat& rotationDelta, const glm::vec3& translationDelta)
+{   // 1. 而댄룷#include "mesh_asset.h"
+
+#include "mesh_instance.h"
+
+MeshInstance::MeshInstance(std::shared_ptr<MeshAsset> mesh, glm::vec3 initPos)
+    : mesh_(std::move(mesh))
+{
+    position_ = initPos;
+    glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position_);
+    world_ = translationMatrix;
+}
+
+glm::vec3 MeshInstance::BoundsCenter() const
+{
+    return glm::vec3(world_ * glm::vec4(mesh_->bounds_center_, 1.0f));
+}
+
+float MeshInstance::BoundsRadius() const
+{
+    return mesh_->bounds_radius_ * std::max({ scale_.x, scale_.y, scale_.z });
+}
+
+void MeshInstance::ApplyTransform(const glm::quat& rotationDelta, const glm::vec3& translationDelta)
+{   // 1. 컴포넌트를 직접 업데이트한다.
+
+    // 기존 위치에 이동량을 더한다.
+    position_ += translationDelta;
+
+    // 기존 회전에 새로운 회전을 '앞에' 곱해준다.
+    // (q_new * q_old 는 old 회전 후 new 회전을 적용하는 것과 같음)
+    rotation_ = rotationDelta * rotation_;
+
+    // 쿼터니언은 부동소수점 오차로 길이가 1이 아니게 될 수 있으므로,
+    // 주기적으로 정규화해주는 것이 좋다.
+    rotation_ = glm::normalize(rotation_);
+
+    glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale_);
+    glm::mat4 rotationMatrix = glm::mat4_cast(rotation_); // 쿼터니언 -> 회전 행렬
+    glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position_);
+
+    // 2. SRT (Scale -> Rotate -> Translate) 순서로 조합하여 최종 월드 행렬을 계산한다.
+    world_ = translationMatrix * rotationMatrix * scaleMatrix;
+}
\ No newline at end of file
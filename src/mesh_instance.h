@@ -0,0 +1,37 @@
+#pragma once
+
+class MeshAsset;
+
+// scene #pragma once
+
+class MeshAsset;
+
+// scene 에 놓인 object 하나. GPU 자원은 MeshAsset 이 들고 있고 여기는 transform 만 가진다.
+// 같은 mesh 의 instance 들은 한 번의 instanced draw 로 그려진다
+class MeshInstance
+{
+public:
+	MeshInstance(std::shared_ptr<MeshAsset> mesh, glm::vec3 initPos);
+
+	std::shared_ptr<MeshAsset> mesh_;
+
+	glm::mat4 world_{ 1.0f };
+	glm::vec3 position_{ 0.0f, 0.0f, 0.0f };
+	glm::quat rotation_{ 1.0f, 0.0f, 0.0f, 0.0f };
+	glm::vec3 scale_{ 1.0f, 1.0f, 1.0f };
+
+	// world space bounding sphere
+	glm::vec3 BoundsCenter() const;
+	float BoundsRadius() const;
+
+	void ApplyTransform(const glm::quat& rotationDelta, const glm::vec3& translationDelta);
+
+};
+
+// 같은 mesh 의 instance 들은 instance 배열 안에서 연속. batch 하나가 draw command 하나
+struct DrawBatch
+{
+	const MeshAsset* mesh;
+	uint32_t first_instance;
+	uint32_t instance_count;
+};
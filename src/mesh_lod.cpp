@@ -0,0 +1,243 @@
+#include "vertex.h"
+#include "mesh_cache.h"
+
+#include "mesh_lod.h"
+
+namespace {
+	// #include "vertex.h"
+#include "mesh_cache.h"
+
+#include "mesh_lod.h"
+
+namespace {
+	// 이보다 작은 LOD 는 만들지 않는다 (draw 하나의 고정 비용이 더 크다)
+	constexpr size_t kMinLodTriangles = 32;
+	constexpr uint32_t kMaxPasses = 64;
+
+	// 대칭 4x4 행렬 Q. 평면 (n, d) 에 대해 Q += [n d]^T [n d], 점 p 의 오차는 [p 1] Q [p 1]^T = 평면까지 거리 제곱의 합
+	struct Quadric {
+		double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+		double a11 = 0, a12 = 0, a13 = 0;
+		double a22 = 0, a23 = 0;
+		double a33 = 0;
+
+		void AddPlane(const glm::dvec3& n, double d)
+		{
+			a00 += n.x * n.x; a01 += n.x * n.y; a02 += n.x * n.z; a03 += n.x * d;
+			a11 += n.y * n.y; a12 += n.y * n.z; a13 += n.y * d;
+			a22 += n.z * n.z; a23 += n.z * d;
+			a33 += d * d;
+		}
+
+		void Add(const Quadric& q)
+		{
+			a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+			a11 += q.a11; a12 += q.a12; a13 += q.a13;
+			a22 += q.a22; a23 += q.a23;
+			a33 += q.a33;
+		}
+
+		double Evaluate(const glm::dvec3& p) const
+		{
+			return a00 * p.x * p.x + 2.0 * a01 * p.x * p.y + 2.0 * a02 * p.x * p.z + 2.0 * a03 * p.x
+				+ a11 * p.y * p.y + 2.0 * a12 * p.y * p.z + 2.0 * a13 * p.y
+				+ a22 * p.z * p.z + 2.0 * a23 * p.z
+				+ a33;
+		}
+	};
+
+	struct Collapse {
+		uint32_t u; // 없어지는 vertex
+		uint32_t v; // u 가 옮겨가는 vertex
+		double cost;
+	};
+
+	uint64_t EdgeKey(uint32_t a, uint32_t b)
+	{
+		return (static_cast<uint64_t>(a) << 32) | b;
+	}
+}
+
+std::vector<uint32_t> SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& source, size_t targetIndexCount, float& resultError)
+{
+	std::vector<uint32_t> indices = source;
+	resultError = 0.0f;
+
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	if (indices.size() <= targetIndexCount || vertexCount == 0) return indices;
+
+	// 같은 위치의 vertex 는 처음 나온 것을 대표로 묶는다. quadric / 잠금은 대표 기준
+	std::vector<uint32_t> canonical(vertexCount);
+	{
+		std::unordered_map<glm::vec3, uint32_t> first;
+		first.reserve(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; ++v) {
+			canonical[v] = first.try_emplace(vertices[v].pos, v).first->second;
+		}
+	}
+
+	// seam : 대표가 같은 vertex 가 둘 이상. 움직이면 반대쪽 copy 와 벌어진다
+	std::vector<uint8_t> locked(vertexCount, 0);
+	{
+		std::vector<uint32_t> groupSize(vertexCount, 0);
+		for (uint32_t v = 0; v < vertexCount; ++v) ++groupSize[canonical[v]];
+		for (uint32_t v = 0; v < vertexCount; ++v) {
+			if (groupSize[canonical[v]] > 1) locked[canonical[v]] = 1;
+		}
+	}
+	// 열린 경계 : 위치 기준 edge (a, b) 의 반대 방향 (b, a) 가 없다
+	{
+		std::vector<uint64_t> edges;
+		edges.reserve(indices.size());
+		for (size_t t = 0; t < indices.size(); t += 3) {
+			for (int e = 0; e < 3; ++e) {
+				edges.push_back(EdgeKey(canonical[indices[t + e]], canonical[indices[t + (e + 1) % 3]]));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		for (uint64_t edge : edges) {
+			const uint32_t a = static_cast<uint32_t>(edge >> 32);
+			const uint32_t b = static_cast<uint32_t>(edge);
+			if (!std::binary_search(edges.begin(), edges.end(), EdgeKey(b, a))) {
+				locked[a] = 1;
+				locked[b] = 1;
+			}
+		}
+	}
+	auto isLocked = [&](uint32_t v) { return locked[canonical[v]] != 0; };
+
+	// vertex 마다 인접 triangle 평면의 quadric (면적 가중치 없이 : 오차를 거리로 읽을 수 있게)
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t t = 0; t < indices.size(); t += 3) {
+		const glm::dvec3 p0 = vertices[indices[t + 0]].pos;
+		const glm::dvec3 p1 = vertices[indices[t + 1]].pos;
+		const glm::dvec3 p2 = vertices[indices[t + 2]].pos;
+		glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+		const double length = glm::length(n);
+		if (length == 0.0) continue;
+		n /= length;
+		const double d = -glm::dot(n, p0);
+		for (int c = 0; c < 3; ++c) {
+			quadrics[canonical[indices[t + c]]].AddPlane(n, d);
+		}
+	}
+
+	std::vector<uint32_t> triOffsets(vertexCount + 1);
+	std::vector<uint32_t> triList;
+	std::vector<Collapse> candidates;
+	std::vector<uint8_t> touched(vertexCount);
+	std::vector<uint32_t> remap(vertexCount);
+
+	for (uint32_t pass = 0; pass < kMaxPasses && indices.size() > targetIndexCount; ++pass) {
+		const size_t triangleCount = indices.size() / 3;
+		const size_t targetTriangles = targetIndexCount / 3;
+
+		// vertex -> 인접 triangle (CSR). pass 마다 index 가 바뀌므로 다시 만든다
+		std::fill(triOffsets.begin(), triOffsets.end(), 0);
+		for (uint32_t index : indices) ++triOffsets[index + 1];
+		for (uint32_t v = 0; v < vertexCount; ++v) triOffsets[v + 1] += triOffsets[v];
+		triList.resize(indices.size());
+		{
+			std::vector<uint32_t> cursor(triOffsets.begin(), triOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				triList[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		// edge 마다 양 방향 후보. 닫힌 면의 edge 는 두 triangle 에 반대 방향으로 나오므로 a < b 쪽에서만 넣는다
+		candidates.clear();
+		for (size_t t = 0; t < indices.size(); t += 3) {
+			for (int e = 0; e < 3; ++e) {
+				const uint32_t a = indices[t + e];
+				const uint32_t b = indices[t + (e + 1) % 3];
+				if (a > b) continue;
+				Quadric q = quadrics[canonical[a]];
+				q.Add(quadrics[canonical[b]]);
+				if (!isLocked(a)) candidates.push_back({ a, b, q.Evaluate(glm::dvec3(vertices[b].pos)) });
+				if (!isLocked(b)) candidates.push_back({ b, a, q.Evaluate(glm::dvec3(vertices[a].pos)) });
+			}
+		}
+		if (candidates.empty()) break;
+		std::sort(candidates.begin(), candidates.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+		// collapse 하나가 triangle 을 보통 2 개 없앤다. 필요한 만큼의 싼 후보까지만 본다 (남은 건 다음 pass 에서 새 quadric 으로)
+		const size_t needed = (triangleCount - targetTriangles + 1) / 2;
+		const double costLimit = candidates[std::min(candidates.size() - 1, needed)].cost;
+
+		// 한 pass 의 collapse 들은 서로 triangle 을 공유하지 않는다 (adjacency 를 다시 만들지 않아도 되도록)
+		std::fill(touched.begin(), touched.end(), 0);
+		std::iota(remap.begin(), remap.end(), 0u);
+		size_t removed = 0;
+		for (const Collapse& c : candidates) {
+			if (triangleCount - removed <= targetTriangles || c.cost > costLimit) break;
+			if (touched[c.u] || touched[c.v]) continue;
+
+			// u 를 v 로 옮겼을 때 남는 triangle 이 뒤집히거나 납작해지면 건너뛴다 (seam 의 다른 copy 로 붙는 경우 포함)
+			bool flips = false;
+			size_t collapsed = 0;
+			const glm::vec3 target = vertices[c.v].pos;
+			for (uint32_t k = triOffsets[c.u]; k < triOffsets[c.u + 1] && !flips; ++k) {
+				const uint32_t* tri = &indices[triList[k] * 3];
+				if (tri[0] == c.v || tri[1] == c.v || tri[2] == c.v) {
+					++collapsed;
+					continue;
+				}
+				glm::vec3 before[3];
+				glm::vec3 after[3];
+				for (int i = 0; i < 3; ++i) {
+					before[i] = vertices[tri[i]].pos;
+					after[i] = tri[i] == c.u ? target : before[i];
+				}
+				const glm::vec3 nBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+				const glm::vec3 nAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+				flips = glm::dot(nBefore, nAfter) <= 0.0f;
+			}
+			if (flips || collapsed == 0) continue;
+
+			remap[c.u] = c.v;
+			removed += collapsed;
+			for (uint32_t k = triOffsets[c.u]; k < triOffsets[c.u + 1]; ++k) {
+				const uint32_t* tri = &indices[triList[k] * 3];
+				touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+			}
+			quadrics[canonical[c.v]].Add(quadrics[canonical[c.u]]);
+			resultError = std::max(resultError, static_cast<float>(std::sqrt(std::max(c.cost, 0.0))));
+		}
+		if (removed == 0) break;
+
+		// remap 적용, 퇴화한 triangle 제거
+		size_t write = 0;
+		for (size_t t = 0; t < indices.size(); t += 3) {
+			const uint32_t a = remap[indices[t + 0]];
+			const uint32_t b = remap[indices[t + 1]];
+			const uint32_t c = remap[indices[t + 2]];
+			if (a == b || b == c || c == a) continue;
+			indices[write++] = a;
+			indices[write++] = b;
+			indices[write++] = c;
+		}
+		indices.resize(write);
+	}
+	return indices;
+}
+
+void BuildLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::vector<pmesh::Lod>& lods)
+{
+	lods.clear();
+	lods.push_back(pmesh::Lod{ .first_index = 0, .index_count = static_cast<uint32_t>(indices.size()), .error = 0.0f });
+
+	// 이전 LOD 에서 다시 줄인다 (원본에서 매번 줄이는 것보다 빠르고, 오차는 더해서 상한으로 쓴다)
+	std::vector<uint32_t> current = indices;
+	float error = 0.0f;
+	while (lods.size() < pmesh::kMaxLods && current.size() / 3 >= 2 * kMinLodTriangles) {
+		float stepError = 0.0f;
+		std::vector<uint32_t> next = SimplifyMesh(vertices, current, current.size() / 6 * 3, stepError);
+		// 10% 도 못 줄였으면 (대부분 seam / 경계) 더 만들어도 의미가 없다
+		if (next.size() * 10 > current.size() * 9) break;
+
+		error += stepError;
+		lods.push_back(pmesh::Lod{ .first_index = static_cast<uint32_t>(indices.size()), .index_count = static_cast<uint32_t>(next.size()), .error = error });
+		indices.insert(indices.end(), next.begin(), next.end());
+		current = std::move(next);
+	}
+}
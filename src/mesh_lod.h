@@ -0,0 +1,21 @@
+#pragma once
+
+struct Vertex;
+namespace pmesh { struct Lod; }
+
+// quadric error metric (Garland & Heckbert) 湲곕컲 edge collapse 濡#pragma once
+
+struct Vertex;
+namespace pmesh { struct Lod; }
+
+// quadric error metric (Garland & Heckbert) 기반 edge collapse 로 index 만 줄인다. vertex 배열은 그대로 공유.
+// collapse 는 u -> v (v 의 위치를 그대로 쓴다) 라 새 vertex 를 만들지 않는다.
+// 같은 위치에 vertex 가 여럿 (uv / normal seam) 이거나 열린 경계 위의 vertex 는 움직이지 않으므로
+// flat shading 처럼 모든 vertex 가 갈라진 mesh 는 거의 줄지 않는다.
+// targetIndexCount 에 도달하거나 더 줄일 collapse 가 없으면 멈춘다.
+// resultError : 적용한 collapse 중 가장 큰 오차 (object space 거리, quadric 의 제곱근이라 대략적인 상한)
+std::vector<uint32_t> SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount, float& resultError);
+
+// LOD 0 = 원본, 이후 triangle 을 절반씩 줄인 LOD 를 indices 뒤에 이어 붙인다 (최대 pmesh::kMaxLods 개).
+// 더 줄지 않거나 너무 작아지면 멈춘다. lods[i].error 는 원본 대비 누적 오차
+void BuildLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::vector<pmesh::Lod>& lods);
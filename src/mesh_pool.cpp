@@ -0,0 +1,114 @@
+#include "vertex.h"
+#include "asset_loader.h"
+#include "mesh_asset.h"
+
+#include "mesh_pool.h"
+
+MeshPool::MeshPool(vku::Allocator& allocator, const Sizes& capacity)
+	: direct_(allocator.SupportsDirectUpload()), capacity_(capacity)
+{
+	// UMA / ReBAR 硫#include "vertex.h"
+#include "asset_loader.h"
+#include "mesh_asset.h"
+
+#include "mesh_pool.h"
+
+MeshPool::MeshPool(vku::Allocator& allocator, const Sizes& capacity)
+	: direct_(allocator.SupportsDirectUpload()), capacity_(capacity)
+{
+	// UMA / ReBAR 면 mapped memory 에 바로 쓰고, 아니면 device local + staging
+	const vk::MemoryPropertyFlags properties = direct_
+		? vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent
+		: vk::MemoryPropertyFlagBits::eDeviceLocal;
+	const vk::BufferUsageFlags storage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst;
+
+	// vertex 는 mesh shader 가 storage buffer 로도 읽는다
+	vku::CreateBuffer(allocator, std::max<vk::DeviceSize>(capacity.vertices * sizeof(Vertex), 4),
+		vk::BufferUsageFlagBits::eVertexBuffer | storage, properties,
+		vertex_buffer_, vertex_buffer_memory_);
+	vku::CreateBuffer(allocator, std::max<vk::DeviceSize>(capacity.indices * sizeof(uint32_t), 4),
+		vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst, properties,
+		index_buffer_, index_buffer_memory_);
+	vku::CreateBuffer(allocator, std::max<vk::DeviceSize>(capacity.meshlets * sizeof(pmesh::Meshlet), 4), storage, properties,
+		meshlet_buffer_, meshlet_buffer_memory_);
+	vku::CreateBuffer(allocator, std::max<vk::DeviceSize>(capacity.meshlet_vertices * sizeof(uint32_t), 4), storage, properties,
+		meshlet_vertex_buffer_, meshlet_vertex_buffer_memory_);
+	vku::CreateBuffer(allocator, std::max<vk::DeviceSize>(capacity.meshlet_triangles * sizeof(uint32_t), 4), storage, properties,
+		meshlet_triangle_buffer_, meshlet_triangle_buffer_memory_);
+	vku::CreateBuffer(allocator, std::max<vk::DeviceSize>(capacity.sdf_values * sizeof(float), 4), storage, properties,
+		sdf_buffer_, sdf_buffer_memory_);
+	sdf_values_.reserve(capacity.sdf_values);
+}
+
+std::shared_ptr<MeshAsset> MeshPool::Add(const MeshData& mesh, UploadService& uploads)
+{
+	const Sizes count{
+		.vertices = mesh.VertexBytes() / sizeof(Vertex),
+		.indices = mesh.IndexCount(),
+		.meshlets = mesh.MeshletCount(),
+		.meshlet_vertices = mesh.MeshletVertexCount(),
+		.meshlet_triangles = mesh.MeshletTriangleCount(),
+		.sdf_values = mesh.GetSdfVolume().Count()
+	};
+	if (size_.vertices + count.vertices > capacity_.vertices || size_.indices + count.indices > capacity_.indices ||
+		size_.meshlets + count.meshlets > capacity_.meshlets || size_.meshlet_vertices + count.meshlet_vertices > capacity_.meshlet_vertices ||
+		size_.meshlet_triangles + count.meshlet_triangles > capacity_.meshlet_triangles || size_.sdf_values + count.sdf_values > capacity_.sdf_values) {
+		throw std::runtime_error("mesh pool is full!");
+	}
+
+	// meshlet 의 vertex / triangle 구간은 pool 배열 기준으로 옮긴다. local vertex 가 가리키는 번호는 mesh 안의 번호 그대로
+	std::vector<pmesh::Meshlet> meshlets(mesh.MeshletData(), mesh.MeshletData() + count.meshlets);
+	for (pmesh::Meshlet& meshlet : meshlets) {
+		meshlet.vertex_offset += static_cast<uint32_t>(size_.meshlet_vertices);
+		meshlet.triangle_offset += static_cast<uint32_t>(size_.meshlet_triangles);
+	}
+
+	struct Copy {
+		vk::Buffer buffer;
+		void* mapped;
+		vk::DeviceSize offset;
+		const void* data;
+		vk::DeviceSize bytes;
+	};
+	const std::array copies{
+		Copy{ *vertex_buffer_, vertex_buffer_memory_.Mapped(), size_.vertices * sizeof(Vertex), mesh.VertexData(), mesh.VertexBytes() },
+		Copy{ *index_buffer_, index_buffer_memory_.Mapped(), size_.indices * sizeof(uint32_t), mesh.IndexData(), mesh.IndexBytes() },
+		Copy{ *meshlet_buffer_, meshlet_buffer_memory_.Mapped(), size_.meshlets * sizeof(pmesh::Meshlet), meshlets.data(), meshlets.size() * sizeof(pmesh::Meshlet) },
+		Copy{ *meshlet_vertex_buffer_, meshlet_vertex_buffer_memory_.Mapped(), size_.meshlet_vertices * sizeof(uint32_t), mesh.MeshletVertexData(), count.meshlet_vertices * sizeof(uint32_t) },
+		Copy{ *meshlet_triangle_buffer_, meshlet_triangle_buffer_memory_.Mapped(), size_.meshlet_triangles * sizeof(uint32_t), mesh.MeshletTriangleData(), count.meshlet_triangles * sizeof(uint32_t) },
+		Copy{ *sdf_buffer_, sdf_buffer_memory_.Mapped(), size_.sdf_values * sizeof(float), mesh.SdfData(), count.sdf_values * sizeof(float) }
+	};
+	for (const Copy& copy : copies) {
+		if (copy.bytes == 0) continue;
+		if (direct_) {
+			std::memcpy(static_cast<std::byte*>(copy.mapped) + copy.offset, copy.data, copy.bytes);
+		}
+		else {
+			uploads.UploadBuffer(copy.buffer, copy.offset, copy.data, copy.bytes);
+		}
+	}
+
+	// index 는 mesh 안에서의 번호 그대로 두고 draw 의 vertexOffset 으로 옮긴다
+	sdf_values_.insert(sdf_values_.end(), mesh.SdfData(), mesh.SdfData() + count.sdf_values);
+
+	auto asset = std::make_shared<MeshAsset>(mesh, static_cast<uint32_t>(size_.indices), static_cast<int32_t>(size_.vertices), static_cast<uint32_t>(size_.meshlets),
+		static_cast<uint32_t>(size_.sdf_values));
+	size_.vertices += count.vertices;
+	size_.indices += count.indices;
+	size_.meshlets += count.meshlets;
+	size_.meshlet_vertices += count.meshlet_vertices;
+	size_.meshlet_triangles += count.meshlet_triangles;
+	size_.sdf_values += count.sdf_values;
+	return asset;
+}
+
+void MeshPool::Bind(const vk::raii::CommandBuffer& cmd) const
+{
+	cmd.bindVertexBuffers(0, { *vertex_buffer_ }, { 0 });
+	cmd.bindIndexBuffer(*index_buffer_, 0, vk::IndexType::eUint32);
+}
+
+void MeshPool::BindVertices(const vk::raii::CommandBuffer& cmd) const
+{
+	cmd.bindVertexBuffers(0, { *vertex_buffer_ }, { 0 });
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+struct MeshData;
+class MeshAsset;
+
+#include "vulkan_utils.h"
+
+// 紐⑤뱺 mesh #pragma once
+
+struct MeshData;
+class MeshAsset;
+
+#include "vulkan_utils.h"
+
+// 모든 mesh 의 vertex / index 를 buffer 하나씩에 이어 붙여 둔다.
+// 모든 draw 가 같은 buffer 를 쓰므로 GPU 가 만든 indirect command 들을 drawIndexedIndirectCount 한 번으로 그릴 수 있다.
+// meshlet (bounds / cone, local vertex, triangle) 도 같은 식으로 이어 붙여 cluster culling / mesh shader 가 storage buffer 로 읽는다.
+// SDF 격자 값도 이어 붙여 천 충돌 pass 가 읽는다. CPU solver 도 같은 값을 쓰므로 host 쪽 사본을 같이 둔다.
+// 크기는 만들 때 정한다 (scene 의 mesh 가 모두 decode 된 뒤 합계로)
+class MeshPool
+{
+public:
+	// 원소 수
+	struct Sizes {
+		uint64_t vertices = 0;
+		uint64_t indices = 0;
+		uint64_t meshlets = 0;
+		uint64_t meshlet_vertices = 0;
+		uint64_t meshlet_triangles = 0;
+		uint64_t sdf_values = 0;
+	};
+
+	MeshPool(vku::Allocator& allocator, const Sizes& capacity);
+	MeshPool(const MeshPool& rhs) = delete;
+	MeshPool(MeshPool&& rhs) = delete;
+	MeshPool& operator=(const MeshPool& rhs) = delete;
+	MeshPool& operator=(MeshPool&& rhs) = delete;
+	~MeshPool() = default;
+
+	// 남은 공간 뒤에 붙인다. copy 는 uploads 의 다음 Flush 에 포함 (UMA / ReBAR 면 바로 기록)
+	std::shared_ptr<MeshAsset> Add(const MeshData& mesh, UploadService& uploads);
+
+	void Bind(const vk::raii::CommandBuffer& cmd) const;
+	// index buffer 없이 vertex buffer 만 (cluster culling 이 만든 index buffer 와 같이 쓸 때)
+	void BindVertices(const vk::raii::CommandBuffer& cmd) const;
+
+	vk::DescriptorBufferInfo VertexBufferInfo() const { return { *vertex_buffer_, 0, VK_WHOLE_SIZE }; }
+	vk::DescriptorBufferInfo MeshletBufferInfo() const { return { *meshlet_buffer_, 0, VK_WHOLE_SIZE }; }
+	vk::DescriptorBufferInfo MeshletVertexBufferInfo() const { return { *meshlet_vertex_buffer_, 0, VK_WHOLE_SIZE }; }
+	vk::DescriptorBufferInfo MeshletTriangleBufferInfo() const { return { *meshlet_triangle_buffer_, 0, VK_WHOLE_SIZE }; }
+	vk::DescriptorBufferInfo SdfBufferInfo() const { return { *sdf_buffer_, 0, VK_WHOLE_SIZE }; }
+	const std::vector<float>& SdfValues() const { return sdf_values_; }
+
+	uint64_t VertexCount() const { return size_.vertices; }
+	uint64_t IndexCount() const { return size_.indices; }
+	uint64_t MeshletCount() const { return size_.meshlets; }
+
+private:
+	vk::raii::Buffer vertex_buffer_{ nullptr };
+	vku::Allocation vertex_buffer_memory_;
+	vk::raii::Buffer index_buffer_{ nullptr };
+	vku::Allocation index_buffer_memory_;
+	vk::raii::Buffer meshlet_buffer_{ nullptr };
+	vku::Allocation meshlet_buffer_memory_;
+	vk::raii::Buffer meshlet_vertex_buffer_{ nullptr };
+	vku::Allocation meshlet_vertex_buffer_memory_;
+	vk::raii::Buffer meshlet_triangle_buffer_{ nullptr };
+	vku::Allocation meshlet_triangle_buffer_memory_;
+	vk::raii::Buffer sdf_buffer_{ nullptr };
+	vku::Allocation sdf_buffer_memory_;
+	std::vector<float> sdf_values_;
+	bool direct_ = false;
+
+	Sizes capacity_;
+	Sizes size_;
+};
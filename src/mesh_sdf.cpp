@@ -0,0 +1,130 @@
+#include "vertex.h"
+#include "mesh_cache.h"
+
+#include "mesh_sdf.h"
+
+namespace {
+	constexpr uint32_t kSdfResolution = 24;
+	constexpr uint32_t kSdfPadding = 2;
+
+	// #include "vertex.h"
+#include "mesh_cache.h"
+
+#include "mesh_sdf.h"
+
+namespace {
+	constexpr uint32_t kSdfResolution = 24;
+	constexpr uint32_t kSdfPadding = 2;
+
+	// 점 p 에서 triangle (a, b, c) 까지 최단 거리의 제곱 (Ericson, Real-Time Collision Detection 5.1.5)
+	float DistanceSquared(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+	{
+		const glm::vec3 ab = b - a;
+		const glm::vec3 ac = c - a;
+		const glm::vec3 ap = p - a;
+		const float d1 = glm::dot(ab, ap);
+		const float d2 = glm::dot(ac, ap);
+		if (d1 <= 0.0f && d2 <= 0.0f) return glm::dot(ap, ap);
+
+		const glm::vec3 bp = p - b;
+		const float d3 = glm::dot(ab, bp);
+		const float d4 = glm::dot(ac, bp);
+		if (d3 >= 0.0f && d4 <= d3) return glm::dot(bp, bp);
+
+		const float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+			const glm::vec3 q = a + ab * (d1 / (d1 - d3));
+			return glm::dot(p - q, p - q);
+		}
+
+		const glm::vec3 cp = p - c;
+		const float d5 = glm::dot(ab, cp);
+		const float d6 = glm::dot(ac, cp);
+		if (d6 >= 0.0f && d5 <= d6) return glm::dot(cp, cp);
+
+		const float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+			const glm::vec3 q = a + ac * (d2 / (d2 - d6));
+			return glm::dot(p - q, p - q);
+		}
+
+		const float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+			const glm::vec3 q = b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+			return glm::dot(p - q, p - q);
+		}
+
+		const float denom = 1.0f / (va + vb + vc);
+		const glm::vec3 q = a + ab * (vb * denom) + ac * (vc * denom);
+		return glm::dot(p - q, p - q);
+	}
+
+	// p 에서 본 triangle 의 solid angle (Van Oosterom & Strackee). 모두 더해 4π 로 나누면 winding number
+	float SolidAngle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+	{
+		const glm::vec3 pa = a - p;
+		const glm::vec3 pb = b - p;
+		const glm::vec3 pc = c - p;
+		const float la = glm::length(pa);
+		const float lb = glm::length(pb);
+		const float lc = glm::length(pc);
+		const float numerator = glm::dot(pa, glm::cross(pb, pc));
+		const float denominator = la * lb * lc + glm::dot(pa, pb) * lc + glm::dot(pb, pc) * la + glm::dot(pc, pa) * lb;
+		return 2.0f * std::atan2(numerator, denominator);
+	}
+}
+
+void BakeSdf(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<pmesh::Lod>& lods, pmesh::Sdf& out)
+{
+	out = pmesh::Sdf{};
+	if (lods.empty() || lods[0].index_count < 3 || vertices.empty()) return;
+
+	// bounds 는 LOD 0 이 쓰는 vertex 기준
+	glm::vec3 lo(std::numeric_limits<float>::max());
+	glm::vec3 hi(std::numeric_limits<float>::lowest());
+	for (uint32_t i = 0; i < lods[0].index_count; ++i) {
+		const glm::vec3& p = vertices[indices[lods[0].first_index + i]].pos;
+		lo = glm::min(lo, p);
+		hi = glm::max(hi, p);
+	}
+	const glm::vec3 extent = hi - lo;
+	const float longest = std::max({ extent.x, extent.y, extent.z });
+	if (longest <= 0.0f) return;
+
+	pmesh::SdfVolume& volume = out.volume;
+	volume.cell = longest / static_cast<float>(kSdfResolution - 1 - 2 * kSdfPadding);
+	volume.origin = lo - glm::vec3(static_cast<float>(kSdfPadding) * volume.cell);
+	for (int axis = 0; axis < 3; ++axis) {
+		volume.resolution[axis] = static_cast<uint32_t>(std::ceil(extent[axis] / volume.cell)) + 1 + 2 * kSdfPadding;
+	}
+
+	// 격자보다 잘게 맞출 필요는 없다. 오차가 반 칸 이하인 가장 거친 LOD (LOD 의 error 는 누적 상한)
+	const pmesh::Lod* lod = &lods[0];
+	for (const pmesh::Lod& candidate : lods) {
+		if (candidate.error <= volume.cell * 0.5f) lod = &candidate;
+	}
+	std::vector<glm::vec3> triangles;
+	triangles.reserve(lod->index_count);
+	for (uint32_t i = 0; i < lod->index_count; ++i) {
+		triangles.push_back(vertices[indices[lod->first_index + i]].pos);
+	}
+
+	constexpr float kFourPi = 12.566370614359172f;
+	out.distances.resize(volume.Count());
+	size_t write = 0;
+	for (uint32_t z = 0; z < volume.resolution.z; ++z) {
+		for (uint32_t y = 0; y < volume.resolution.y; ++y) {
+			for (uint32_t x = 0; x < volume.resolution.x; ++x) {
+				const glm::vec3 p = volume.origin + glm::vec3(x, y, z) * volume.cell;
+				float nearest = std::numeric_limits<float>::max();
+				float winding = 0.0f;
+				for (size_t t = 0; t < triangles.size(); t += 3) {
+					nearest = std::min(nearest, DistanceSquared(p, triangles[t], triangles[t + 1], triangles[t + 2]));
+					winding += SolidAngle(p, triangles[t], triangles[t + 1], triangles[t + 2]);
+				}
+				const bool inside = std::abs(winding / kFourPi) > 0.5f;
+				out.distances[write++] = inside ? -std::sqrt(nearest) : std::sqrt(nearest);
+			}
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+struct Vertex;
+namespace pmesh { struct Lod; struct Sdf; }
+
+// 泥#pragma once
+
+struct Vertex;
+namespace pmesh { struct Lod; struct Sdf; }
+
+// 천 충돌용 signed distance field 를 mesh local space 격자에 굽는다.
+// 가장 긴 축이 kSdfResolution 개의 격자점이 되도록 간격을 정하고, bounds 밖으로 kSdfPadding 칸씩 여유를 둔다.
+// 거리는 격자 간격의 절반보다 오차가 작은 가장 거친 LOD 의 triangle 까지, 부호는 generalized winding number 로
+// (열린 mesh 나 뒤집힌 triangle 이 섞여 있어도 안 / 밖이 크게 틀리지 않는다).
+// triangle 이 없으면 out.volume.resolution 은 0.
+void BakeSdf(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<pmesh::Lod>& lods, pmesh::Sdf& out);
@@ -0,0 +1,155 @@
+#include "vertex.h"
+#include "mesh_cache.h"
+
+#include "meshlet.h"
+
+namespace {
+	constexpr uint8_t kNoLocal = 0xff;
+	static_assert(MESHLET_MAX_VERTICES < kNoLocal);
+
+	// bounds #include "vertex.h"
+#include "mesh_cache.h"
+
+#include "meshlet.h"
+
+namespace {
+	constexpr uint8_t kNoLocal = 0xff;
+	static_assert(MESHLET_MAX_VERTICES < kNoLocal);
+
+	// bounds 는 AABB 중심 기준 sphere, cone 은 triangle 법선 평균 (meshoptimizer 와 같은 정의)
+	void ComputeBounds(const std::vector<Vertex>& vertices, const pmesh::Meshlets& out, pmesh::Meshlet& meshlet)
+	{
+		const uint32_t* local = &out.vertices[meshlet.vertex_offset];
+		glm::vec3 lo(std::numeric_limits<float>::max());
+		glm::vec3 hi(std::numeric_limits<float>::lowest());
+		for (uint32_t i = 0; i < meshlet.vertex_count; ++i) {
+			lo = glm::min(lo, vertices[local[i]].pos);
+			hi = glm::max(hi, vertices[local[i]].pos);
+		}
+		meshlet.center = (lo + hi) * 0.5f;
+		float radius = 0.0f;
+		for (uint32_t i = 0; i < meshlet.vertex_count; ++i) {
+			radius = std::max(radius, glm::length(vertices[local[i]].pos - meshlet.center));
+		}
+		meshlet.radius = radius;
+
+		glm::vec3 normals[MESHLET_MAX_TRIANGLES];
+		uint32_t normalCount = 0;
+		glm::vec3 sum(0.0f);
+		for (uint32_t t = 0; t < meshlet.triangle_count; ++t) {
+			const uint32_t packed = out.triangles[meshlet.triangle_offset + t];
+			const glm::vec3 p0 = vertices[local[packed & 0xff]].pos;
+			const glm::vec3 p1 = vertices[local[(packed >> 8) & 0xff]].pos;
+			const glm::vec3 p2 = vertices[local[(packed >> 16) & 0xff]].pos;
+			const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+			const float length = glm::length(n);
+			if (length == 0.0f) continue;
+			normals[normalCount++] = n / length;
+			sum += n / length;
+		}
+
+		// 법선이 서로 상쇄되거나 반구를 넘게 퍼져 있으면 cone 으로 버릴 수 있는 방향이 없다
+		meshlet.cone_axis = glm::vec3(0.0f, 0.0f, 1.0f);
+		meshlet.cone_cutoff = 1.0f;
+		const float sumLength = glm::length(sum);
+		if (normalCount == 0 || sumLength < 1e-6f) return;
+		const glm::vec3 axis = sum / sumLength;
+		float minDot = 1.0f;
+		for (uint32_t i = 0; i < normalCount; ++i) {
+			minDot = std::min(minDot, glm::dot(axis, normals[i]));
+		}
+		meshlet.cone_axis = axis;
+		if (minDot > 0.0f) {
+			meshlet.cone_cutoff = std::sqrt(1.0f - minDot * minDot);
+		}
+	}
+}
+
+void BuildMeshlets(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount, pmesh::Meshlets& out)
+{
+	out.meshlets.clear();
+	out.vertices.clear();
+	out.triangles.clear();
+
+	const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+	const uint32_t triangleCount = static_cast<uint32_t>(indexCount / 3);
+	if (triangleCount == 0) return;
+
+	// vertex -> 인접 triangle (CSR)
+	std::vector<uint32_t> triOffsets(vertexCount + 1, 0);
+	for (size_t i = 0; i < triangleCount * 3; ++i) ++triOffsets[indices[i] + 1];
+	for (uint32_t v = 0; v < vertexCount; ++v) triOffsets[v + 1] += triOffsets[v];
+	std::vector<uint32_t> triList(triangleCount * 3);
+	{
+		std::vector<uint32_t> cursor(triOffsets.begin(), triOffsets.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; ++i) {
+			triList[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	std::vector<uint8_t> emitted(triangleCount, 0);
+	std::vector<uint8_t> localIndex(vertexCount, kNoLocal);
+	pmesh::Meshlet current{};
+	uint32_t seedCursor = 0;
+
+	auto newVertices = [&](uint32_t t) {
+		uint32_t count = 0;
+		for (int c = 0; c < 3; ++c) count += localIndex[indices[t * 3 + c]] == kNoLocal;
+		return count;
+	};
+	auto closeMeshlet = [&]() {
+		if (current.triangle_count == 0) return;
+		ComputeBounds(vertices, out, current);
+		for (uint32_t i = 0; i < current.vertex_count; ++i) {
+			localIndex[out.vertices[current.vertex_offset + i]] = kNoLocal;
+		}
+		out.meshlets.push_back(current);
+		current = pmesh::Meshlet{};
+		current.vertex_offset = static_cast<uint32_t>(out.vertices.size());
+		current.triangle_offset = static_cast<uint32_t>(out.triangles.size());
+	};
+
+	for (uint32_t added = 0; added < triangleCount; ++added) {
+		// 현재 meshlet 의 vertex 에 붙은 triangle 중 새 vertex 가 가장 적은 것
+		uint32_t best = UINT32_MAX;
+		uint32_t bestCost = 4;
+		for (uint32_t i = 0; i < current.vertex_count && bestCost > 0; ++i) {
+			const uint32_t v = out.vertices[current.vertex_offset + i];
+			for (uint32_t k = triOffsets[v]; k < triOffsets[v + 1]; ++k) {
+				const uint32_t t = triList[k];
+				if (emitted[t]) continue;
+				const uint32_t cost = newVertices(t);
+				if (cost < bestCost) {
+					best = t;
+					bestCost = cost;
+					if (cost == 0) break;
+				}
+			}
+		}
+		// 붙일 이웃이 없으면 (떨어진 조각) 닫고 아직 안 쓴 triangle 중 index 순서로 처음 것에서 다시 시작
+		if (best == UINT32_MAX) {
+			closeMeshlet();
+			while (emitted[seedCursor]) ++seedCursor;
+			best = seedCursor;
+			bestCost = newVertices(best);
+		}
+		if (current.vertex_count + bestCost > MESHLET_MAX_VERTICES || current.triangle_count + 1 > MESHLET_MAX_TRIANGLES) {
+			closeMeshlet();
+			bestCost = 3;
+		}
+
+		uint32_t packed = 0;
+		for (int c = 0; c < 3; ++c) {
+			const uint32_t v = indices[best * 3 + c];
+			if (localIndex[v] == kNoLocal) {
+				localIndex[v] = static_cast<uint8_t>(current.vertex_count++);
+				out.vertices.push_back(v);
+			}
+			packed |= static_cast<uint32_t>(localIndex[v]) << (8 * c);
+		}
+		out.triangles.push_back(packed);
+		++current.triangle_count;
+		emitted[best] = 1;
+	}
+	closeMeshlet();
+}
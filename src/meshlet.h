@@ -0,0 +1,15 @@
+#pragma once
+
+struct Vertex;
+namespace pmesh { struct Meshlets; }
+
+// index 援ш컙 (蹂댄넻 LOD 0) #pragma once
+
+struct Vertex;
+namespace pmesh { struct Meshlets; }
+
+// index 구간 (보통 LOD 0) 을 MESHLET_MAX_VERTICES / MESHLET_MAX_TRIANGLES 이하의 meshlet 으로 나눈다.
+// 이미 넣은 vertex 를 공유하는 인접 triangle 부터 (새 vertex 가 적은 순) 붙여 가며, 한도를 넘거나
+// 붙일 이웃이 없으면 meshlet 을 닫는다. 각 meshlet 의 bounding sphere 와 normal cone 도 같이 계산한다.
+// 결과는 out 에 덧붙이지 않고 새로 채운다.
+void BuildMeshlets(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount, pmesh::Meshlets& out);
@@ -0,0 +1,33 @@
+// Meshlet / cluster culling layout.
+// C++ (meshlet.h, cluster_culler.h) // Meshlet / cluster culling layout.
+// C++ (meshlet.h, cluster_culler.h) 와 GLSL (#include "meshlet_layout.h") 이 같은 정의를 사용한다.
+#ifndef MESHLET_LAYOUT_H
+#define MESHLET_LAYOUT_H
+
+// meshlet 하나의 최대 크기. 124 = mesh shader 출력 (primitive index 3 byte) 이 128 byte 단위에 맞는 값
+#define MESHLET_MAX_VERTICES  64
+#define MESHLET_MAX_TRIANGLES 124
+
+// cluster set (compute cull, task / mesh shader 공용)
+#define CLUSTER_BINDING_PARAMS    0 // uniform       : view-projection, frustum, camera, work 수
+#define CLUSTER_BINDING_MESHLETS  1 // Meshlet[]     : pool 전체 (bounds + normal cone + vertex / triangle 구간)
+#define CLUSTER_BINDING_MESHLET_VERTICES  2 // uint[] : meshlet local vertex -> mesh vertex 번호
+#define CLUSTER_BINDING_MESHLET_TRIANGLES 3 // uint[] : triangle 하나 = local vertex 3 개 (8 bit 씩)
+#define CLUSTER_BINDING_VERTICES  4 // float[]       : pool vertex buffer (Vertex, mesh shader 가 직접 읽는다)
+#define CLUSTER_BINDING_INSTANCES 5 // Instance[]    : InstanceCuller 의 같은 frame slot buffer
+#define CLUSTER_BINDING_WORK      6 // ClusterWork[] : (instance, meshlet 최대 CLUSTER_GROUP_SIZE 개) 하나당 workgroup 하나
+#define CLUSTER_BINDING_DRAWS     7 // DrawCommand[] : compute 경로. 살아남은 meshlet 마다 하나
+#define CLUSTER_BINDING_INDICES   8 // uint[]        : compute 경로. 살아남은 meshlet 의 index 를 이어 붙인 것
+#define CLUSTER_BINDING_COUNTS    9 // uint[6]       : draw 수, index 수, 살아남은 meshlet 수, frustum 으로 버린 수, backface cone 으로 버린 수,
+                                    //                 buffer 가 모자라 그리지 못한 meshlet 수
+#define CLUSTER_BINDING_COUNT     10
+#define CLUSTER_COUNTER_COUNT     6
+
+#define CLUSTER_GROUP_SIZE 32
+
+// Meshlet 은 std430 으로 48 bytes (vec4 sphere + vec4 cone + uint 4)
+#define MESHLET_STRIDE 48
+// Vertex (vertex.h) 는 float 8 개 : pos 3, texcoord 2, normal 3
+#define VERTEX_FLOATS 8
+
+#endif
@@ -1,5 +1,5 @@
 #include "camera.h"
-#include "model.h"
+#include "mesh_instance.h"
 #include "ray.h"
 
 #include "mouse_interactor.h"
@@ -10,14 +10,14 @@ MouseInteractor::MouseInteractor()
 }
 
 std::pair<int, float> MouseInteractor::PickClosestModel(
-    const Ray& ray, const std::vector<std::unique_ptr<Model>>& models) const
+    const Ray& ray, const std::vector<MeshInstance>& models) const
 {
     int picked = -1;
     float minDist = std::numeric_limits<float>::max();
 
     for (int i = 0; i < static_cast<int>(models.size()); ++i) {
         float dist = 0.0f;
-        if (ray.Intersects(*models[i], dist)) {
+        if (ray.Intersects(models[i], dist)) {
             if (dist < minDist) {
                 minDist = dist;
                 picked = i;
@@ -29,7 +29,42 @@ std::pair<int, float> MouseInteractor::PickClosestModel(
 
 void MouseInteractor::Update(const Camera& camera,
     const glm::vec2& viewportSize,
-    std::vector<std::unique_ptr<Model>>& models)
+    std::vector<MeshInstance>& models)
+{
+    const float EPS = 1e-6f;
+
+    // (#include "camera.h"
+#include "mesh_instance.h"
+#include "ray.h"
+
+#include "mouse_interactor.h"
+
+MouseInteractor::MouseInteractor()
+{
+
+}
+
+std::pair<int, float> MouseInteractor::PickClosestModel(
+    const Ray& ray, const std::vector<MeshInstance>& models) const
+{
+    int picked = -1;
+    float minDist = std::numeric_limits<float>::max();
+
+    for (int i = 0; i < static_cast<int>(models.size()); ++i) {
+        float dist = 0.0f;
+        if (ray.Intersects(models[i], dist)) {
+            if (dist < minDist) {
+                minDist = dist;
+                picked = i;
+            }
+        }
+    }
+    return { picked, minDist };
+}
+
+void MouseInteractor::Update(const Camera& camera,
+    const glm::vec2& viewportSize,
+    std::vector<MeshInstance>& models)
 {
     const float EPS = 1e-6f;
 
@@ -47,7 +82,7 @@ void MouseInteractor::Update(const Camera& camera,
             is_dragging_ = true;
             has_prev_ = true;
 
-            const Model& m = *models[selected_];
+            const MeshInstance& m = models[selected_];
             glm::vec3 center = m.position_;
             glm::vec3 pickPoint = ray.origin + ray.direction * dist;
             glm::vec3 v = pickPoint - center;
@@ -95,7 +130,7 @@ void MouseInteractor::Update(const Camera& camera,
     if (is_dragging_ && has_prev_ && selected_ >= 0) {
         Ray ray = CalculateMouseRay(camera, viewportSize);
         float dist = 0.0f;
-        Model& model = *models[selected_];
+        MeshInstance& model = models[selected_];
 
         if (ray.Intersects(model, dist)) {
             glm::vec3 center = model.position_;
@@ -142,7 +177,7 @@ void MouseInteractor::Update(const Camera& camera,
             glm::vec3 delta = newPos - prevPos_;
 
             if (glm::length(delta) > 1e-8f) {
-                models[selected_]->ApplyTransform(glm::quat(1, 0, 0, 0), delta); // 이동
+                models[selected_].ApplyTransform(glm::quat(1, 0, 0, 0), delta); // 이동
                 prevPos_ = newPos;
             }
         }
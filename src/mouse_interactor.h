@@ -2,6 +2,7 @@
 
 struct Camera;
 struct Ray;
+class MeshInstance;
 
 class MouseInteractor
 {
@@ -13,7 +14,7 @@ public:
 	MouseInteractor& operator=(MouseInteractor&& rhs) = delete;
 	~MouseInteractor() = default;
 
-	void Update(const Camera& camera, const glm::vec2& viewportSize, std::vector<std::unique_ptr<Model>>& models);
+	void Update(const Camera& camera, const glm::vec2& viewportSize, std::vector<MeshInstance>& models);
 
 	bool is_left_button_down_event = false;
 	bool is_left_button_up_event = false;
@@ -39,5 +40,5 @@ private:
 	int selected_ = -1;
 
 	std::pair<int, float> PickClosestModel(const Ray& ray,
-		const std::vector<std::unique_ptr<Model>>& models) const;
+		const std::vector<MeshInstance>& models) const;
 };
@@ -0,0 +1,30 @@
+// Particle SoA layout.
+// C++ (particle_store.h) // Particle SoA layout.
+// C++ (particle_store.h) 와 GLSL (#include "particle_layout.h") 이 같은 정의를 사용한다.
+#ifndef PARTICLE_LAYOUT_H
+#define PARTICLE_LAYOUT_H
+
+// stream 번호 = ParticleStore 안의 sub-range 순서 = cloth compute set 의 binding 번호
+#define PARTICLE_STREAM_POSITIONS  0 // vec4  : xyz = position, w = inverse mass (0 이면 고정)
+#define PARTICLE_STREAM_VELOCITIES 1 // vec4  : xyz = velocity
+#define PARTICLE_STREAM_PREDICTED  2 // vec4  : xyz = predicted position, w = inverse mass
+#define PARTICLE_STREAM_DELTAS     3 // ivec4 : Jacobi 위치 보정 누적 (xyz 고정소수점, w = 누적 수)
+#define PARTICLE_STREAM_PREVIOUS   4 // vec4  : frame 의 마지막 step 직전 position. 그릴 때 position 과 보간 (SimScheduler)
+#define PARTICLE_STREAM_COUNT      5
+
+// 모든 stream 의 원소는 16 bytes (vec4 / ivec4)
+#define PARTICLE_STREAM_STRIDE     16
+
+// cloth compute set 에서 particle stream 다음 binding
+#define CLOTH_BINDING_CONSTRAINTS  (PARTICLE_STREAM_COUNT + 0)
+#define CLOTH_BINDING_LAMBDAS      (PARTICLE_STREAM_COUNT + 1)
+#define CLOTH_BINDING_COLLIDERS    (PARTICLE_STREAM_COUNT + 2) // Collider[] : frame slot 마다 구간 하나 (ColliderSet)
+#define CLOTH_BINDING_SDF          (PARTICLE_STREAM_COUNT + 3) // float[]    : MeshPool 의 SDF 격자 값
+#define CLOTH_BINDING_COUNT        (PARTICLE_STREAM_COUNT + 4)
+
+// Collider 는 std430 으로 128 bytes (vec4 sphere + vec4 velocity + mat4 + vec4 + uvec4)
+#define COLLIDER_STRIDE            128
+
+#define PARTICLE_DELTA_FIXED_POINT_SCALE 1048576.0 // 2^20
+
+#endif
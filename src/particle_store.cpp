@@ -0,0 +1,59 @@
+#include "particle_store.h"
+
+ParticleStore::ParticleStore(vku::Allocator& allocator, UploadService& uploads, const std::vector<glm::vec4>& positions)
+	: particle_count_(static_cast<uint32_t>(positions.size()))
+{
+	// stream 留덈떎 minStorageBufferOffsetAlignment 濡#include "particle_store.h"
+
+ParticleStore::ParticleStore(vku::Allocator& allocator, UploadService& uploads, const std::vector<glm::vec4>& positions)
+	: particle_count_(static_cast<uint32_t>(positions.size()))
+{
+	// stream 마다 minStorageBufferOffsetAlignment 로 정렬된 sub-range
+	auto limits = allocator.PhysicalDevice().getProperties().limits;
+	const vk::DeviceSize alignment = limits.minStorageBufferOffsetAlignment;
+	range_ = static_cast<vk::DeviceSize>(particle_count_) * PARTICLE_STREAM_STRIDE;
+	const vk::DeviceSize stride = (range_ + alignment - 1) & ~(alignment - 1);
+
+	for (uint32_t i = 0; i < PARTICLE_STREAM_COUNT; ++i) {
+		offsets_[i] = stride * i;
+	}
+	size_ = stride * PARTICLE_STREAM_COUNT;
+
+	vku::CreateBuffer(allocator, size_,
+		vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc,
+		vk::MemoryPropertyFlagBits::eDeviceLocal,
+		buffer_, buffer_memory_);
+
+	Upload(uploads, positions);
+}
+
+void ParticleStore::Upload(UploadService& uploads, const std::vector<glm::vec4>& positions)
+{
+	if (positions.size() != particle_count_) {
+		throw std::runtime_error("particle store upload size mismatch!");
+	}
+
+	// 초기값 : predicted = previous = positions, velocity / delta = 0
+	std::vector<std::byte> data(size_);
+	std::memcpy(data.data() + Offset(Stream::Positions), positions.data(), range_);
+	std::memcpy(data.data() + Offset(Stream::Predicted), positions.data(), range_);
+	std::memcpy(data.data() + Offset(Stream::Previous), positions.data(), range_);
+
+	uploads.UploadBuffer(*buffer_, 0, data.data(), size_);
+}
+
+std::vector<glm::vec4> ParticleStore::Download(vku::Allocator& allocator, vk::raii::Queue& queue, vk::raii::CommandPool& commandPool, Stream stream)
+{
+	vk::raii::Buffer stagingBuffer(nullptr);
+	vku::Allocation stagingMemory;
+	vku::CreateBuffer(allocator, range_,
+		vk::BufferUsageFlagBits::eTransferDst,
+		vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+		stagingBuffer, stagingMemory);
+
+	vku::CopyBuffer(allocator.Device(), queue, commandPool, buffer_, stagingBuffer, range_, Offset(stream), 0);
+
+	std::vector<glm::vec4> result(particle_count_);
+	std::memcpy(result.data(), stagingMemory.Mapped(), range_);
+	return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "vulkan_utils.h"
+#include "particle_layout.h"
+
+static_assert(sizeof(glm::vec4) == PARTICLE_STREAM_STRIDE);
+static_assert(sizeof(glm::ivec4) == PARTICLE_STREAM_STRIDE);
+
+// particle #pragma once
+
+#include "vulkan_utils.h"
+#include "particle_layout.h"
+
+static_assert(sizeof(glm::vec4) == PARTICLE_STREAM_STRIDE);
+static_assert(sizeof(glm::ivec4) == PARTICLE_STREAM_STRIDE);
+
+// particle 의 모든 stream 을 한 번의 allocation 에 SoA sub-range 로 담는다.
+// 각 stream 은 descriptor offset 으로 따로 bind 되므로 position 만 읽는 pass 는 position 만 읽는다.
+class ParticleStore
+{
+public:
+	enum class Stream : uint32_t
+	{
+		Positions = PARTICLE_STREAM_POSITIONS,
+		Velocities = PARTICLE_STREAM_VELOCITIES,
+		Predicted = PARTICLE_STREAM_PREDICTED,
+		Deltas = PARTICLE_STREAM_DELTAS,
+		Previous = PARTICLE_STREAM_PREVIOUS,
+		Count = PARTICLE_STREAM_COUNT
+	};
+
+	// positions : xyz = 초기 위치, w = inverse mass
+	ParticleStore(vku::Allocator& allocator, UploadService& uploads, const std::vector<glm::vec4>& positions);
+	ParticleStore(const ParticleStore& rhs) = delete;
+	ParticleStore(ParticleStore&& rhs) = delete;
+	ParticleStore& operator=(const ParticleStore& rhs) = delete;
+	ParticleStore& operator=(ParticleStore&& rhs) = delete;
+	~ParticleStore() = default;
+
+	vk::Buffer Buffer() const { return *buffer_; }
+	vk::DeviceSize Offset(Stream stream) const { return offsets_[static_cast<uint32_t>(stream)]; }
+	vk::DeviceSize Range() const { return range_; }
+	vk::DescriptorBufferInfo DescriptorInfo(Stream stream) const { return { *buffer_, Offset(stream), range_ }; }
+
+	// 모든 stream 을 초기 상태로 되돌린다 (predicted = previous = positions, velocity / delta = 0). copy 는 uploads 의 다음 Flush 에 포함
+	void Upload(UploadService& uploads, const std::vector<glm::vec4>& positions);
+	// stream 하나를 host 로 읽어온다. queue idle 까지 대기
+	std::vector<glm::vec4> Download(vku::Allocator& allocator, vk::raii::Queue& queue, vk::raii::CommandPool& commandPool, Stream stream);
+
+	uint32_t particle_count_ = 0;
+
+private:
+	vk::raii::Buffer buffer_{ nullptr };
+	vku::Allocation buffer_memory_;
+
+	std::array<vk::DeviceSize, PARTICLE_STREAM_COUNT> offsets_{};
+	vk::DeviceSize range_ = 0;
+	vk::DeviceSize size_ = 0;
+};
@@ -2,18 +2,31 @@
 
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <iomanip>
 #include <stdexcept>
 #include <vector>
 #include <cstring>
 #include <cstdlib>
 #include <memory>
 #include <algorithm>
+#include <numeric>
 #include <limits>
 #include <array>
 #include <cassert>
 #include <chrono>
 #include <unordered_map>
 #include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <queue>
+#include <deque>
+#include <tuple>
+#include <latch>
+#include <atomic>
 
 #define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
 #include <vulkan/vulkan.hpp>
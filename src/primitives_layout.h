@@ -0,0 +1,48 @@
+// GPU primitive (gpu_primitives.h) layout.
+// C++ // GPU primitive (gpu_primitives.h) layout.
+// C++ 와 GLSL (#include "primitives_layout.h") 이 같은 정의를 사용한다.
+// 모든 primitive 의 workgroup 크기는 specialization constant 0 (local_size_x_id = 0)
+#ifndef PRIMITIVES_LAYOUT_H
+#define PRIMITIVES_LAYOUT_H
+
+// prefix sum : level 마다 set 하나
+#define SCAN_BINDING_INPUT  0 // uint[] : scan 할 값 (위 level 은 아래 level 의 block 합)
+#define SCAN_BINDING_OUTPUT 1 // uint[] : exclusive scan 결과 (input 과 같은 buffer 여도 된다)
+#define SCAN_BINDING_SUMS   2 // uint[] : workgroup 마다 block 합 (다음 level 의 input)
+#define SCAN_BINDING_COUNT  3
+
+// reduction : level 마다 set 하나. 연산은 specialization constant 1
+#define REDUCE_BINDING_INPUT  0 // uint[] : 줄일 값 (위 level 은 아래 level 의 workgroup 결과)
+#define REDUCE_BINDING_OUTPUT 1 // uint[] : workgroup 마다 결과 하나 (마지막 level 은 결과 buffer)
+#define REDUCE_BINDING_COUNT  2
+
+#define REDUCE_OP_SUM 0
+#define REDUCE_OP_MIN 1
+#define REDUCE_OP_MAX 2
+
+// thread 하나가 먼저 혼자 줄이는 원소 수
+#define REDUCE_ITEMS_PER_THREAD 8
+
+// stream compaction : flags 의 exclusive scan 이 출력 위치
+#define COMPACT_BINDING_VALUES  0 // uint[] : 입력
+#define COMPACT_BINDING_FLAGS   1 // uint[] : 0 / 1. 1 인 원소만 남긴다
+#define COMPACT_BINDING_OFFSETS 2 // uint[] : flags 의 exclusive scan
+#define COMPACT_BINDING_OUTPUT  3 // uint[] : 남은 원소 (입력 순서 유지)
+#define COMPACT_BINDING_RESULT  4 // uint   : 남은 원소 수
+#define COMPACT_BINDING_COUNT   5
+
+// radix sort (LSD, 8 bit 씩 4 pass). pass 마다 keys / values 를 ping-pong
+#define RADIX_BINDING_KEYS_IN    0 // uint[]
+#define RADIX_BINDING_VALUES_IN  1 // uint[]
+#define RADIX_BINDING_KEYS_OUT   2 // uint[]
+#define RADIX_BINDING_VALUES_OUT 3 // uint[]
+#define RADIX_BINDING_HISTOGRAM  4 // uint[RADIX_BUCKETS * tile 수] : digit 순서 -> tile 순서 (scan 하면 출력 위치)
+#define RADIX_BINDING_COUNT      5
+
+#define RADIX_BITS    8
+#define RADIX_BUCKETS 256
+#define RADIX_PASSES  4
+// workgroup 하나가 맡는 tile = workgroup 크기 x RADIX_TILE_ROUNDS 개. scatter 는 round 순서대로 처리해서 안정 정렬을 유지한다
+#define RADIX_TILE_ROUNDS 8
+
+#endif
@@ -1,4 +1,5 @@
-#include "model.h"
+#include "mesh_instance.h"
+#include <limits> // std::numeric_limits #include "mesh_instance.h"
 #include <limits> // std::numeric_limits 사용
 
 #include "ray.h"
@@ -9,10 +10,11 @@ Ray::Ray(const glm::vec3& origin, const glm::vec3& direction)
 }
 
 // 이 함수가 바로 네가 올린 RaySphereIntersect의 GLM 버전이야.
-bool Ray::Intersects(const Model& model, float& dist) const
+bool Ray::Intersects(const MeshInstance& instance, float& dist) const
 {
     // 광선의 시작점에서 구의 중심을 향하는 벡터
-    glm::vec3 oc = origin - model.position_;
+    glm::vec3 oc = origin - instance.BoundsCenter();
+    const float radius = instance.BoundsRadius();
 
     // 2차 방정식의 계수 계산
     // a = dot(D, D) : 광선 방향 벡터의 내적. 정규화되어 있으므로 항상 1.0
@@ -22,7 +24,7 @@ bool Ray::Intersects(const Model& model, float& dist) const
     const float b = 2.0f * glm::dot(oc, direction);
 
     // c = dot(OC, OC) - r^2
-    const float c = glm::dot(oc, oc) - model.radius_ * model.radius_;
+    const float c = glm::dot(oc, oc) - radius * radius;
 
     // 판별식 (b^2 - 4ac)
     const float discriminant = b * b - 4.0f * a * c;
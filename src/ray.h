@@ -1,6 +1,19 @@
 #pragma once
 
-class Model;
+class MeshInstance;
+
+struct BoundingSphere
+{
+    glm::vec3 center{ 0.0f };
+    float radius = 0.0f;
+};
+
+class Ray
+{
+public:
+    // #pragma once
+
+class MeshInstance;
 
 struct BoundingSphere
 {
@@ -17,7 +30,7 @@ public:
     // 광선과 구의 충돌을 검사하는 멤버 함수
     // dist: [출력용] 충돌 시, 광선 시작점부터의 거리를 담을 변수
     // 반환값: 충돌 여부
-    bool Intersects(const Model& model, float& dist) const;
+    bool Intersects(const MeshInstance& instance, float& dist) const;
 
 public:
     glm::vec3 origin;
@@ -0,0 +1,22 @@
+// cloth compute // cloth compute 의 Sim UBO (std140) layout.
+// GLSL 은 #include "sim_layout.h" 로 아래 uniform block 을 쓰고, C++ 은 sim_params.h 의 SimParams 가 같은 순서로 맞춘다.
+// field 를 바꾸면 여기와 SimParams 두 곳만 고친다 (크기는 SIM_PARAMS_SIZE 로 static_assert)
+#ifndef SIM_LAYOUT_H
+#define SIM_LAYOUT_H
+
+// 4 bytes scalar 15 개
+#define SIM_PARAMS_SIZE 60
+
+#ifndef __cplusplus
+layout(set = 0, binding = 0, std140) uniform Sim {
+    float dt, gravityY; uint numIters; float stretchCompliance;
+    float restitution; uint numParticles;
+    float shearCompliance, bendCompliance;
+    uint solverMode; float relaxation;
+    uint numColliders, firstCollider;
+    float friction, collisionMargin;
+    float selfCollisionDistance;
+} U;
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "sim_layout.h"
+
+enum class SolverMode : uint32_t
+{
+	GaussSeidel = 0, // graph coloring, color 留덈떎 dispatch
+	Jacobi = 1       // #pragma once
+
+#include "sim_layout.h"
+
+enum class SolverMode : uint32_t
+{
+	GaussSeidel = 0, // graph coloring, color 마다 dispatch
+	Jacobi = 1       // 전체 constraint 를 한 번에, atomicAdd 로 누적
+};
+
+// shader 의 Sim UBO (sim_layout.h) 와 같은 layout (std140)
+struct SimParams
+{
+	float dt = 1.0f / 60.0f;
+	float gravityY = -9.8f;
+	uint32_t numIters = 10;
+	float stretchCompliance = 0.0f; // α_stretch
+	float restitution = 0.0f;       // 충돌 반발 (법선 방향으로 들어오던 속도에 곱해 되돌린다)
+	uint32_t numParticles = 0;
+	float shearCompliance = 1e-6f;  // α_shear
+	float bendCompliance = 1e-4f;   // α_bend
+	SolverMode solverMode = SolverMode::GaussSeidel;
+	float relaxation = 1.5f;        // Jacobi ω
+	uint32_t numColliders = 0;      // 이번 step 의 collider 수 (ColliderSet)
+	uint32_t firstCollider = 0;     // collider buffer 안의 frame slot 시작
+	float friction = 0.3f;          // 충돌 마찰 (μ)
+	float collisionMargin = 0.01f;  // particle 을 표면에서 이만큼 띄운다 (천 두께)
+	float selfCollisionDistance = 0.0f; // particle 끼리 최소 거리 (SpatialHash). 0 이면 self-collision 끔
+};
+static_assert(sizeof(SimParams) == SIM_PARAMS_SIZE);
+
+// 기본 천 grid. Context 와 --cpu-reference 가 같은 값에서 시작한다
+constexpr int kClothNx = 30;
+constexpr int kClothNy = 30;
+constexpr float kClothSpacing = 0.1f;
@@ -0,0 +1,66 @@
+#include "sim_scheduler.h"
+
+SimScheduler::SimScheduler(float rate, uint32_t substeps, uint32_t maxStepsPerFrame)
+	: fixed_step_(1.0f / rate), substeps_(std::max(substeps, 1u)), max_steps_per_frame_(std::max(maxStepsPerFrame, 1u))
+{
+	if (!(rate > 0.0f)) {
+		throw std::runtime_error("simulation rate must be positive!");
+	}
+}
+
+uint32_t SimScheduler::Advance(float frameDt)
+{
+	accumulator_ += std::max(frameDt, 0.0f);
+
+	uint32_t steps = static_cast<uint32_t>(std::min(accumulator_ / fixed_step_, static_cast<double>(std::numeric_limits<uint32_t>::max())));
+	accumulator_ -= static_cast<double>(steps) * fixed_step_;
+	// 諛섏삱由#include "sim_scheduler.h"
+
+SimScheduler::SimScheduler(float rate, uint32_t substeps, uint32_t maxStepsPerFrame)
+	: fixed_step_(1.0f / rate), substeps_(std::max(substeps, 1u)), max_steps_per_frame_(std::max(maxStepsPerFrame, 1u))
+{
+	if (!(rate > 0.0f)) {
+		throw std::runtime_error("simulation rate must be positive!");
+	}
+}
+
+uint32_t SimScheduler::Advance(float frameDt)
+{
+	accumulator_ += std::max(frameDt, 0.0f);
+
+	uint32_t steps = static_cast<uint32_t>(std::min(accumulator_ / fixed_step_, static_cast<double>(std::numeric_limits<uint32_t>::max())));
+	accumulator_ -= static_cast<double>(steps) * fixed_step_;
+	// 반올림 오차로 음수가 되거나 fixed step 을 넘지 않도록. 정확히 fixed step 인 경우는 Alpha 에서 1 아래로 자른다
+	accumulator_ = std::clamp(accumulator_, 0.0, static_cast<double>(fixed_step_));
+	last_dropped_ = 0;
+	if (steps > max_steps_per_frame_) {
+		last_dropped_ = steps - max_steps_per_frame_;
+		dropped_steps_ += last_dropped_;
+		steps = max_steps_per_frame_;
+	}
+
+	last_steps_ = steps;
+	return steps;
+}
+
+void SimScheduler::DrawImgui()
+{
+	float rate = 1.0f / fixed_step_;
+	if (ImGui::SliderFloat("Sim rate (Hz)", &rate, 30.0f, 240.0f, "%.0f")) {
+		fixed_step_ = 1.0f / rate;
+		accumulator_ = std::min(accumulator_, static_cast<double>(fixed_step_));
+	}
+
+	int substeps = static_cast<int>(substeps_);
+	if (ImGui::SliderInt("Substeps", &substeps, 1, 16)) {
+		substeps_ = static_cast<uint32_t>(substeps);
+	}
+
+	int maxSteps = static_cast<int>(max_steps_per_frame_);
+	if (ImGui::SliderInt("Max steps / frame", &maxSteps, 1, 16)) {
+		max_steps_per_frame_ = static_cast<uint32_t>(maxSteps);
+	}
+
+	ImGui::Text("Steps this frame %u (dt %.2f ms x %u), alpha %.2f", last_steps_, SubstepDt() * 1000.0f, substeps_, Alpha());
+	ImGui::Text("Dropped steps %llu", static_cast<unsigned long long>(dropped_steps_));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// render frame 怨#pragma once
+
+// render frame 과 무관하게 고정 dt 로 시뮬레이션을 진행한다.
+// frame 시간을 accumulator 에 쌓아 fixed step 씩 꺼내고, step 하나는 substep 개의 XPBD small step (dt = fixed step / substeps).
+// 한 frame 에 max steps 보다 많이 밀리면 나머지 step 은 버린다 (멈췄다 돌아와도 따라잡느라 더 느려지지 않는다).
+// 그릴 때는 마지막 두 step 의 상태를 Alpha() 로 보간한다
+class SimScheduler
+{
+public:
+	SimScheduler(float rate, uint32_t substeps, uint32_t maxStepsPerFrame);
+	SimScheduler(const SimScheduler& rhs) = delete;
+	SimScheduler(SimScheduler&& rhs) = delete;
+	SimScheduler& operator=(const SimScheduler& rhs) = delete;
+	SimScheduler& operator=(SimScheduler&& rhs) = delete;
+	~SimScheduler() = default;
+
+	// frame 시간을 쌓고 이번 frame 에 진행할 step 수를 돌려준다
+	uint32_t Advance(float frameDt);
+
+	float FixedStep() const { return fixed_step_; }
+	float SubstepDt() const { return fixed_step_ / static_cast<float>(substeps_); }
+	uint32_t Substeps() const { return substeps_; }
+	// 마지막 Advance 가 accumulator 에서 꺼낸 시간 (버린 step 포함). 그동안 실제로 흐른 시간이라 collider 속도처럼 외부 움직임에 쓴다
+	float ElapsedTime() const { return static_cast<float>(last_steps_ + last_dropped_) * fixed_step_; }
+	// [0, 1). 0 = 마지막 step 직전 상태, 1 에 가까울수록 마지막 step 상태
+	// accumulator 가 fixed step 까지 clamp 되거나 float 로 반올림되면 1 이 될 수 있어 1 바로 아래로 자른다
+	float Alpha() const { return std::min(static_cast<float>(accumulator_ / fixed_step_), std::nextafter(1.0f, 0.0f)); }
+
+	void DrawImgui();
+
+private:
+	float fixed_step_;
+	uint32_t substeps_;
+	uint32_t max_steps_per_frame_;
+
+	// headless 처럼 frame dt 가 fixed step 과 같으면 매 frame 정확히 step 하나가 되도록 double 로 쌓는다
+	double accumulator_ = 0.0;
+	uint32_t last_steps_ = 0;
+	uint32_t last_dropped_ = 0;
+	uint64_t dropped_steps_ = 0;
+};
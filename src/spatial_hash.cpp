@@ -0,0 +1,212 @@
+#include "particle_store.h"
+
+#include "spatial_hash.h"
+
+namespace
+{
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+
+	void AddComputeBarrier(const vk::raii::CommandBuffer& cmd)
+	{
+		AddBarrier(cmd,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+	}
+}
+
+uint32_t SpatialHash::TableSize(uint32_t particleCount)
+{
+	uint32_t size = 64;
+	while (size < 2 * particleCount) size *= 2;
+	return size;
+}
+
+SpatialHash::SpatialHash(vk::raii::Device& device, vku::Allocator& allocator, UploadService& uploads, const ParticleStore& particles, const std::vector<glm::vec4>& restPositions)
+	: device_(device), particle_count_(particles.particle_count_), table_size_(TableSize(particles.particle_count_))
+{
+	static_assert(sizeof(PushConstants) == 16);
+
+	vku::CreateSSBO(allocator, uploads, sizeof(glm::vec4) * restPositions.size(), restPositions,
+		vk::BufferUsageFlagBits::eStorageBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, rest_buffer_, rest_memory_);
+	vku::CreateBuffer(allocator, sizeof(uint32_t) * particle_count_, vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::MemoryPropertyFlagBits::eDeviceLocal, cells_buffer_, cells_memory_);
+	vku::CreateBuffer(allocator, sizeof(uint32_t) * particle_count_, vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::MemoryPropertyFlagBits::eDeviceLocal, ranks_buffer_, ranks_memory_);
+	// counts / starts / sorted #include "particle_store.h"
+
+#include "spatial_hash.h"
+
+namespace
+{
+	void AddBarrier(const vk::raii::CommandBuffer& cmd,
+		vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess)
+	{
+		vk::MemoryBarrier2 barrier{ .srcStageMask = srcStage, .srcAccessMask = srcAccess, .dstStageMask = dstStage, .dstAccessMask = dstAccess };
+		cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+
+	void AddComputeBarrier(const vk::raii::CommandBuffer& cmd)
+	{
+		AddBarrier(cmd,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderWrite,
+			vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+	}
+}
+
+uint32_t SpatialHash::TableSize(uint32_t particleCount)
+{
+	uint32_t size = 64;
+	while (size < 2 * particleCount) size *= 2;
+	return size;
+}
+
+SpatialHash::SpatialHash(vk::raii::Device& device, vku::Allocator& allocator, UploadService& uploads, const ParticleStore& particles, const std::vector<glm::vec4>& restPositions)
+	: device_(device), particle_count_(particles.particle_count_), table_size_(TableSize(particles.particle_count_))
+{
+	static_assert(sizeof(PushConstants) == 16);
+
+	vku::CreateSSBO(allocator, uploads, sizeof(glm::vec4) * restPositions.size(), restPositions,
+		vk::BufferUsageFlagBits::eStorageBuffer, vk::MemoryPropertyFlagBits::eDeviceLocal, rest_buffer_, rest_memory_);
+	vku::CreateBuffer(allocator, sizeof(uint32_t) * particle_count_, vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::MemoryPropertyFlagBits::eDeviceLocal, cells_buffer_, cells_memory_);
+	vku::CreateBuffer(allocator, sizeof(uint32_t) * particle_count_, vk::BufferUsageFlagBits::eStorageBuffer,
+		vk::MemoryPropertyFlagBits::eDeviceLocal, ranks_buffer_, ranks_memory_);
+	// counts / starts / sorted 는 검증용 Download 를 위해 transfer src 도
+	vku::CreateBuffer(allocator, sizeof(uint32_t) * particle_count_, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+		vk::MemoryPropertyFlagBits::eDeviceLocal, sorted_buffer_, sorted_memory_);
+	// counts 는 build 마다 fillBuffer 로 비운다
+	vku::CreateBuffer(allocator, sizeof(uint32_t) * table_size_, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc,
+		vk::MemoryPropertyFlagBits::eDeviceLocal, counts_buffer_, counts_memory_);
+	vku::CreateBuffer(allocator, sizeof(uint32_t) * table_size_, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+		vk::MemoryPropertyFlagBits::eDeviceLocal, starts_buffer_, starts_memory_);
+
+	std::array<vk::DescriptorSetLayoutBinding, HASH_BINDING_COUNT> layoutBindings;
+	for (uint32_t binding = 0; binding < HASH_BINDING_COUNT; ++binding) {
+		layoutBindings[binding] = vk::DescriptorSetLayoutBinding{ binding, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute };
+	}
+	vk::DescriptorSetLayoutCreateInfo layoutInfo{ .bindingCount = static_cast<uint32_t>(layoutBindings.size()), .pBindings = layoutBindings.data() };
+	set_layout_ = vk::raii::DescriptorSetLayout(device_, layoutInfo);
+
+	vk::DescriptorPoolSize poolSize{ vk::DescriptorType::eStorageBuffer, HASH_BINDING_COUNT };
+	vk::DescriptorPoolCreateInfo poolInfo{
+		.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,
+		.maxSets = 1,
+		.poolSizeCount = 1,
+		.pPoolSizes = &poolSize
+	};
+	descriptor_pool_ = vk::raii::DescriptorPool(device_, poolInfo);
+	vk::DescriptorSetAllocateInfo allocInfo{ .descriptorPool = *descriptor_pool_, .descriptorSetCount = 1, .pSetLayouts = &*set_layout_ };
+	set_ = std::move(vk::raii::DescriptorSets{ device_, allocInfo }.front());
+
+	std::array<vk::DescriptorBufferInfo, HASH_BINDING_COUNT> infos;
+	infos[HASH_BINDING_PREDICTED] = particles.DescriptorInfo(ParticleStore::Stream::Predicted);
+	infos[HASH_BINDING_DELTAS] = particles.DescriptorInfo(ParticleStore::Stream::Deltas);
+	infos[HASH_BINDING_REST] = { *rest_buffer_, 0, VK_WHOLE_SIZE };
+	infos[HASH_BINDING_CELLS] = { *cells_buffer_, 0, VK_WHOLE_SIZE };
+	infos[HASH_BINDING_RANKS] = { *ranks_buffer_, 0, VK_WHOLE_SIZE };
+	infos[HASH_BINDING_COUNTS] = { *counts_buffer_, 0, VK_WHOLE_SIZE };
+	infos[HASH_BINDING_STARTS] = { *starts_buffer_, 0, VK_WHOLE_SIZE };
+	infos[HASH_BINDING_SORTED] = { *sorted_buffer_, 0, VK_WHOLE_SIZE };
+
+	std::array<vk::WriteDescriptorSet, HASH_BINDING_COUNT> writes;
+	for (uint32_t binding = 0; binding < HASH_BINDING_COUNT; ++binding) {
+		writes[binding] = vk::WriteDescriptorSet{
+			.dstSet = *set_,
+			.dstBinding = binding,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = vk::DescriptorType::eStorageBuffer,
+			.pBufferInfo = &infos[binding]
+		};
+	}
+	device_.updateDescriptorSets(writes, {});
+
+	// counts -> starts
+	prefix_sum_ = std::make_unique<vku::PrefixSum>(device_, allocator, table_size_);
+	prefix_sum_->SetBuffers(infos[HASH_BINDING_COUNTS], infos[HASH_BINDING_STARTS]);
+
+	vk::PushConstantRange pushConstantRange{ .stageFlags = vk::ShaderStageFlagBits::eCompute, .offset = 0, .size = sizeof(PushConstants) };
+	vk::PipelineLayoutCreateInfo pipelineLayoutInfo{ .setLayoutCount = 1, .pSetLayouts = &*set_layout_, .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange };
+	pipeline_layout_ = vk::raii::PipelineLayout(device_, pipelineLayoutInfo);
+
+	auto createPipeline = [&](const std::string& path) {
+		vk::raii::ShaderModule shaderModule = vku::CreateShaderModule(device_, vku::ReadFile(path));
+		vk::PipelineShaderStageCreateInfo stageInfo{ .stage = vk::ShaderStageFlagBits::eCompute, .module = shaderModule, .pName = "main" };
+		vk::ComputePipelineCreateInfo pipelineInfo{ .stage = stageInfo, .layout = *pipeline_layout_ };
+		return vk::raii::Pipeline(device_, nullptr, pipelineInfo);
+	};
+	count_pipeline_ = createPipeline("shaders/hash_count.comp.spv");
+	scatter_pipeline_ = createPipeline("shaders/hash_scatter.comp.spv");
+	collide_pipeline_ = createPipeline("shaders/self_collide.comp.spv");
+}
+
+void SpatialHash::BindAndPush(const vk::raii::CommandBuffer& cmd, float distance) const
+{
+	PushConstants pc{ .particleCount = particle_count_, .tableMask = table_size_ - 1, .cellSize = distance, .distance = distance };
+	cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *pipeline_layout_, 0, { *set_ }, {});
+	cmd.pushConstants<PushConstants>(*pipeline_layout_, vk::ShaderStageFlagBits::eCompute, 0, pc);
+}
+
+void SpatialHash::RecordBuild(const vk::raii::CommandBuffer& cmd, float distance)
+{
+	const uint32_t groups = (particle_count_ + HASH_GROUP_SIZE - 1) / HASH_GROUP_SIZE;
+
+	// 지난 step 의 self_collide 가 counts 를 다 읽은 뒤에 비운다
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite,
+		vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite);
+	cmd.fillBuffer(*counts_buffer_, 0, VK_WHOLE_SIZE, 0);
+	AddBarrier(cmd,
+		vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite,
+		vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite);
+
+	BindAndPush(cmd, distance);
+	cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *count_pipeline_);
+	cmd.dispatch(groups, 1, 1);
+	AddComputeBarrier(cmd);
+
+	prefix_sum_->Record(cmd, table_size_);
+
+	// PrefixSum 이 set 0 을 바꿨다
+	BindAndPush(cmd, distance);
+	cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *scatter_pipeline_);
+	cmd.dispatch(groups, 1, 1);
+	AddComputeBarrier(cmd);
+}
+
+void SpatialHash::RecordSolve(const vk::raii::CommandBuffer& cmd, float distance)
+{
+	BindAndPush(cmd, distance);
+	cmd.bindPipeline(vk::PipelineBindPoint::eCompute, *collide_pipeline_);
+	cmd.dispatch((particle_count_ + HASH_GROUP_SIZE - 1) / HASH_GROUP_SIZE, 1, 1);
+	AddComputeBarrier(cmd);
+}
+
+SpatialHash::Table SpatialHash::Download(vku::Allocator& allocator, vk::raii::Queue& queue, vk::raii::CommandPool& commandPool)
+{
+	auto download = [&](vk::raii::Buffer& buffer, uint32_t count) {
+		const vk::DeviceSize size = sizeof(uint32_t) * count;
+		vk::raii::Buffer stagingBuffer(nullptr);
+		vku::Allocation stagingMemory;
+		vku::CreateBuffer(allocator, size,
+			vk::BufferUsageFlagBits::eTransferDst,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+			stagingBuffer, stagingMemory);
+		vku::CopyBuffer(allocator.Device(), queue, commandPool, buffer, stagingBuffer, size);
+
+		std::vector<uint32_t> result(count);
+		std::memcpy(result.data(), stagingMemory.Mapped(), size);
+		return result;
+	};
+
+	Table table;
+	table.counts = download(counts_buffer_, table_size_);
+	table.starts = download(starts_buffer_, table_size_);
+	table.sorted = download(sorted_buffer_, particle_count_);
+	return table;
+}
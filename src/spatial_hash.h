@@ -0,0 +1,99 @@
+#pragma once
+
+class ParticleStore;
+
+#include "vulkan_utils.h"
+#include "spatial_hash_layout.h"
+#include "gpu_primitives.h"
+
+// spatial_hash.glsl #pragma once
+
+class ParticleStore;
+
+#include "vulkan_utils.h"
+#include "spatial_hash_layout.h"
+#include "gpu_primitives.h"
+
+// spatial_hash.glsl 의 HashCell / HashBucket 과 같은 계산 (CPU reference solver 도 같은 bucket 을 쓴다)
+inline glm::ivec3 SpatialHashCell(const glm::vec3& p, float cellSize)
+{
+	return glm::ivec3(glm::floor(p / cellSize));
+}
+
+inline uint32_t SpatialHashBucket(const glm::ivec3& cell, uint32_t tableMask)
+{
+	const glm::uvec3 c(cell);
+	return ((c.x * HASH_PRIME_X) ^ (c.y * HASH_PRIME_Y) ^ (c.z * HASH_PRIME_Z)) & tableMask;
+}
+
+// 천 self-collision 용 uniform grid 를 hash table 로 (Teschner et al. 2003). cell 크기 = 최소 거리라 이웃 27 cell 만 보면 된다.
+// step 마다 integrate 직후 predicted 위치로 한 번 만든다 : bucket 별 count (atomicAdd 로 순서도 받는다) -> PrefixSum 으로 시작 위치
+// -> 시작 + 순서 자리에 particle 번호 (counting sort). solver iteration 마다 같은 table 로 밀어내는 보정을 deltas 에 누적한다.
+// 한 step 안에서 particle 이 움직이는 거리는 보통 cell 보다 훨씬 작으므로 table 은 다시 만들지 않는다.
+// set 0 을 자기 layout 으로 bind 하므로 Record* 뒤에 호출한 쪽이 자기 set 을 다시 bind 해야 한다
+class SpatialHash
+{
+public:
+	// restPositions : BuildClothParticles 결과. 처음부터 distance 보다 가까운 쌍은 밀어내지 않는다
+	SpatialHash(vk::raii::Device& device, vku::Allocator& allocator, UploadService& uploads, const ParticleStore& particles, const std::vector<glm::vec4>& restPositions);
+	SpatialHash(const SpatialHash& rhs) = delete;
+	SpatialHash(SpatialHash&& rhs) = delete;
+	SpatialHash& operator=(const SpatialHash& rhs) = delete;
+	SpatialHash& operator=(SpatialHash&& rhs) = delete;
+	~SpatialHash() = default;
+
+	// predicted 를 compute shader 에서 읽을 수 있어야 한다. 끝나면 table 을 compute shader 에서 읽을 수 있다
+	void RecordBuild(const vk::raii::CommandBuffer& cmd, float distance);
+	// distance 안의 particle 쌍을 밀어내는 보정 (xyz 고정소수점 합, w = 쌍 수) 을 deltas 에 쓴다. 적용은 호출하는 쪽 (jacobi_apply)
+	void RecordSolve(const vk::raii::CommandBuffer& cmd, float distance);
+
+	uint32_t TableSize() const { return table_size_; }
+
+	// 검증용 (tools/spatial_hash_check.cpp) : 마지막 build 의 table 을 host 로 읽어온다. queue idle 까지 대기
+	struct Table {
+		std::vector<uint32_t> counts;
+		std::vector<uint32_t> starts;
+		std::vector<uint32_t> sorted;
+	};
+	Table Download(vku::Allocator& allocator, vk::raii::Queue& queue, vk::raii::CommandPool& commandPool);
+
+	// bucket 수 : particle 수의 2 배 이상인 2 의 거듭제곱 (bucket 하나에 평균 0.5 개 이하)
+	static uint32_t TableSize(uint32_t particleCount);
+
+private:
+	struct PushConstants {
+		uint32_t particleCount;
+		uint32_t tableMask;
+		float cellSize;
+		float distance;
+	};
+
+	void BindAndPush(const vk::raii::CommandBuffer& cmd, float distance) const;
+
+	vk::raii::Device& device_;
+	uint32_t particle_count_;
+	uint32_t table_size_;
+
+	vk::raii::Buffer rest_buffer_{ nullptr };
+	vku::Allocation rest_memory_;
+	vk::raii::Buffer cells_buffer_{ nullptr };
+	vku::Allocation cells_memory_;
+	vk::raii::Buffer ranks_buffer_{ nullptr };
+	vku::Allocation ranks_memory_;
+	vk::raii::Buffer counts_buffer_{ nullptr };
+	vku::Allocation counts_memory_;
+	vk::raii::Buffer starts_buffer_{ nullptr };
+	vku::Allocation starts_memory_;
+	vk::raii::Buffer sorted_buffer_{ nullptr };
+	vku::Allocation sorted_memory_;
+
+	std::unique_ptr<vku::PrefixSum> prefix_sum_;
+
+	vk::raii::DescriptorSetLayout set_layout_{ nullptr };
+	vk::raii::DescriptorPool descriptor_pool_{ nullptr };
+	vk::raii::DescriptorSet set_{ nullptr };
+	vk::raii::PipelineLayout pipeline_layout_{ nullptr };
+	vk::raii::Pipeline count_pipeline_{ nullptr };
+	vk::raii::Pipeline scatter_pipeline_{ nullptr };
+	vk::raii::Pipeline collide_pipeline_{ nullptr };
+};
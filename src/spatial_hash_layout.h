@@ -0,0 +1,25 @@
+// Cloth self-collision spatial hash layout.
+// C++ (spatial_hash.h, cpu_cloth_solver.cpp) // Cloth self-collision spatial hash layout.
+// C++ (spatial_hash.h, cpu_cloth_solver.cpp) 와 GLSL (#include "spatial_hash_layout.h") 이 같은 정의를 사용한다.
+#ifndef SPATIAL_HASH_LAYOUT_H
+#define SPATIAL_HASH_LAYOUT_H
+
+// hash set
+#define HASH_BINDING_PREDICTED 0 // vec4[]  : particle stream (PARTICLE_STREAM_PREDICTED)
+#define HASH_BINDING_DELTAS    1 // ivec4[] : particle stream (PARTICLE_STREAM_DELTAS). 밀어내는 보정을 누적
+#define HASH_BINDING_REST      2 // vec4[]  : 처음 (펼친) 위치. 원래 가까운 particle 끼리는 밀어내지 않는다
+#define HASH_BINDING_CELLS     3 // uint[]  : particle -> bucket
+#define HASH_BINDING_RANKS     4 // uint[]  : bucket 안에서 particle 의 순서 (count pass 의 atomicAdd 결과)
+#define HASH_BINDING_COUNTS    5 // uint[]  : bucket 마다 particle 수
+#define HASH_BINDING_STARTS    6 // uint[]  : bucket 마다 sorted 안의 시작 (counts 의 exclusive scan). 끝 = start + count
+#define HASH_BINDING_SORTED    7 // uint[]  : bucket 순서로 정렬한 particle 번호
+#define HASH_BINDING_COUNT     8
+
+#define HASH_GROUP_SIZE 128
+
+// Teschner et al. 2003. 정수 cell 좌표를 uint 로 보고 곱한 뒤 xor (overflow 는 wrap)
+#define HASH_PRIME_X 73856093u
+#define HASH_PRIME_Y 19349663u
+#define HASH_PRIME_Z 83492791u
+
+#endif
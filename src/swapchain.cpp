@@ -55,6 +55,66 @@ vk::SurfaceFormatKHR Swapchain::ChooseSwapSurfaceFormat(const std::vector<vk::Su
 	return formatIt != availableFormats.end() ? *formatIt : availableFormats[0];
 }
 
+vk::PresentModeKHR Swapchain::ChooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) {
+	for (const auto& availablePresentMode : availablePresentModes) {
+		if (availablePresentMode == vk::PresentModeKHR::eImmediate) {
+			// #include "swapchain.h"
+#include "camera.h"
+
+Swapchain::Swapchain(
+	GLFWwindow* glfwWindow,
+	vk::raii::Device& device,
+	vk::raii::PhysicalDevice& physicalDevice,
+	vk::SampleCountFlagBits msaaSamples,
+	vk::raii::SurfaceKHR& surface
+) : glfw_window_(glfwWindow)
+{
+	CreateSwapchain(physicalDevice, device, surface);
+	CreateImageViews(device);
+}
+
+Swapchain::~Swapchain()
+{
+}
+
+void Swapchain::CreateSwapchain(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vk::raii::SurfaceKHR& surface) {
+	auto surfaceCapabilities = physicalDevice.getSurfaceCapabilitiesKHR(surface);
+	swapchain_extent_ = ChooseSwapExtent(surfaceCapabilities);
+	swapchain_surface_format_ = ChooseSwapSurfaceFormat(physicalDevice.getSurfaceFormatsKHR(surface));
+	vk::SwapchainCreateInfoKHR swapChainCreateInfo{ .surface = surface,
+													.minImageCount = ChooseSwapMinImageCount(surfaceCapabilities),
+													.imageFormat = swapchain_surface_format_.format,
+													.imageColorSpace = swapchain_surface_format_.colorSpace,
+													.imageExtent = swapchain_extent_,
+													.imageArrayLayers = 1,
+													.imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
+													.imageSharingMode = vk::SharingMode::eExclusive,
+													.preTransform = surfaceCapabilities.currentTransform,
+													.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
+													.presentMode = ChooseSwapPresentMode(physicalDevice.getSurfacePresentModesKHR(surface)),
+													.clipped = true };
+
+	swapchain_ = vk::raii::SwapchainKHR(device, swapChainCreateInfo);
+	swapchain_images_ = swapchain_.getImages();
+	image_count_ = swapchain_images_.size();
+}
+
+uint32_t Swapchain::ChooseSwapMinImageCount(vk::SurfaceCapabilitiesKHR const& surfaceCapabilities) {
+	min_image_count_ = std::max(3u, surfaceCapabilities.minImageCount);
+	if ((0 < surfaceCapabilities.maxImageCount) && (surfaceCapabilities.maxImageCount < min_image_count_)) {
+		min_image_count_ = surfaceCapabilities.maxImageCount;
+	}
+	return min_image_count_;
+}
+
+vk::SurfaceFormatKHR Swapchain::ChooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats) {
+	assert(!availableFormats.empty());
+	const auto formatIt = std::ranges::find_if(
+		availableFormats,
+		[](const auto& format) { return format.format == vk::Format::eB8G8R8A8Srgb && format.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear; });
+	return formatIt != availableFormats.end() ? *formatIt : availableFormats[0];
+}
+
 vk::PresentModeKHR Swapchain::ChooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) {
 	for (const auto& availablePresentMode : availablePresentModes) {
 		if (availablePresentMode == vk::PresentModeKHR::eImmediate) {
@@ -91,7 +151,7 @@ void Swapchain::CleanupSwapChain() {
 	swapchain_ = nullptr;
 }
 
-void Swapchain::RecreateSwapChain(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vk::raii::SurfaceKHR& surface) {
+void Swapchain::RecreateSwapChain(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vk::raii::SurfaceKHR& surface, std::mutex& queueMutex) {
 	int width = 0, height = 0;
 	glfwGetFramebufferSize(glfw_window_, &width, &height);
 	while (width == 0 || height == 0) {
@@ -99,7 +159,11 @@ void Swapchain::RecreateSwapChain(vk::raii::PhysicalDevice& physicalDevice, vk::
 		glfwWaitEvents();
 	}
 
-	device.waitIdle();
+	{
+		// 최소화된 동안 (위 loop) 은 잡지 않는다. upload worker 가 그동안 멈추지 않도록
+		std::lock_guard queueLock(queueMutex);
+		device.waitIdle();
+	}
 
 	CleanupSwapChain();
 	CreateSwapchain(physicalDevice, device, surface);
@@ -0,0 +1,142 @@
+#include "cpu_profiler.h"
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	workers_.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		workers_.emplace_back([this]() { WorkerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(mutex_);
+		stop_ = true;
+	}
+	cv_.notify_all();
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	PE_CPU_THREAD_NAME("ThreadPool worker");
+
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex_);
+			cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+			if (stop_ && tasks_.empty()) return;
+			task = std::move(tasks_.front());
+			tasks_.pop();
+		}
+		task();
+	}
+}
+
+void ThreadPool::ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t begin, uint32_t end)>& body)
+{
+	if (count == 0) return;
+
+	grain = std::max(grain, 1u);
+	const uint32_t chunkCount = std::min((count + grain - 1) / grain, ThreadCount() + 1);
+	if (chunkCount <= 1) {
+		body(0, count);
+		return;
+	}
+
+	// body 媛#include "cpu_profiler.h"
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	workers_.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		workers_.emplace_back([this]() { WorkerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(mutex_);
+		stop_ = true;
+	}
+	cv_.notify_all();
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	PE_CPU_THREAD_NAME("ThreadPool worker");
+
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex_);
+			cv_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+			if (stop_ && tasks_.empty()) return;
+			task = std::move(tasks_.front());
+			tasks_.pop();
+		}
+		task();
+	}
+}
+
+void ThreadPool::ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t begin, uint32_t end)>& body)
+{
+	if (count == 0) return;
+
+	grain = std::max(grain, 1u);
+	const uint32_t chunkCount = std::min((count + grain - 1) / grain, ThreadCount() + 1);
+	if (chunkCount <= 1) {
+		body(0, count);
+		return;
+	}
+
+	// body 가 던진 예외는 처음 것만 모아 두었다가 모든 chunk 가 끝난 뒤 호출한 thread 에서 다시 던진다.
+	// chunk 가 던져도 count_down 은 해야 wait 가 끝나고, worker 밖으로 나가면 std::terminate
+	std::exception_ptr error;
+	std::mutex errorMutex;
+	auto run = [&body, &error, &errorMutex](uint32_t begin, uint32_t end) {
+		PE_CPU_SCOPE("ParallelFor chunk");
+		try {
+			if (begin < end) body(begin, end);
+		}
+		catch (...) {
+			std::lock_guard lock(errorMutex);
+			if (!error) error = std::current_exception();
+		}
+	};
+
+	// chunk 0 은 호출한 thread 가 직접 처리
+	const uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+	std::latch done(chunkCount - 1);
+	{
+		std::lock_guard lock(mutex_);
+		for (uint32_t chunk = 1; chunk < chunkCount; ++chunk) {
+			const uint32_t begin = chunk * chunkSize;
+			const uint32_t end = std::min(count, begin + chunkSize);
+			tasks_.emplace([&run, &done, begin, end]() {
+				run(begin, end);
+				done.count_down();
+			});
+		}
+	}
+	cv_.notify_all();
+
+	run(0, std::min(count, chunkSize));
+	{
+		PE_CPU_SCOPE("ParallelFor wait");
+		done.wait();
+	}
+	if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// 怨좎젙 #pragma once
+
+// 고정 크기 worker thread pool.
+// Submit 은 future 를 돌려주고, ParallelFor 는 [0, count) 를 grain 단위로 나눠 호출 thread 와 worker 가 같이 처리한다.
+// worker 안에서 ParallelFor 를 다시 부르면 안 된다 (모든 worker 가 기다리는 상태가 될 수 있음).
+// ParallelFor 의 body 가 던지면 모든 chunk 가 끝난 뒤 첫 예외를 호출한 thread 에서 다시 던진다.
+class ThreadPool
+{
+public:
+	explicit ThreadPool(uint32_t threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1);
+	ThreadPool(const ThreadPool& rhs) = delete;
+	ThreadPool(ThreadPool&& rhs) = delete;
+	ThreadPool& operator=(const ThreadPool& rhs) = delete;
+	ThreadPool& operator=(ThreadPool&& rhs) = delete;
+	~ThreadPool();
+
+	template<typename F>
+	auto Submit(F&& task) -> std::future<std::invoke_result_t<F>>
+	{
+		using R = std::invoke_result_t<F>;
+		auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+		std::future<R> future = packaged->get_future();
+		{
+			std::lock_guard lock(mutex_);
+			tasks_.emplace([packaged]() { (*packaged)(); });
+		}
+		cv_.notify_one();
+		return future;
+	}
+
+	void ParallelFor(uint32_t count, uint32_t grain, const std::function<void(uint32_t begin, uint32_t end)>& body);
+
+	uint32_t ThreadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+	void WorkerLoop();
+
+	std::vector<std::thread> workers_;
+	std::queue<std::function<void()>> tasks_;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	bool stop_ = false;
+};
@@ -0,0 +1,348 @@
+#include "vulkan_utils.h"
+
+#include "upload_service.h"
+
+UploadService::UploadService(vku::Allocator& allocator, vk::raii::Queue& queue, uint32_t queueFamily, vk::raii::Queue* transferQueue, uint32_t transferFamily, vk::DeviceSize stagingSize)
+	: allocator_(allocator), queue_(queue), queue_family_(queueFamily),
+	transfer_queue_(transferQueue && transferFamily != queueFamily ? transferQueue : nullptr), transfer_family_(transferFamily),
+	staging_size_(stagingSize)
+{
+	vk::raii::Device& device = allocator_.Device();
+
+	queue_pool_ = vk::raii::CommandPool(device, { .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer, .queueFamilyIndex = queue_family_ });
+	if (transfer_queue_) {
+		transfer_pool_ = vk::raii::CommandPool(device, { .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer, .queueFamilyIndex = transfer_family_ });
+	}
+
+	vk::SemaphoreTypeCreateInfo semaphoreType{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+	timeline_ = vk::raii::Semaphore(device, { .pNext = &semaphoreType });
+
+	// #include "vulkan_utils.h"
+
+#include "upload_service.h"
+
+UploadService::UploadService(vku::Allocator& allocator, vk::raii::Queue& queue, uint32_t queueFamily, vk::raii::Queue* transferQueue, uint32_t transferFamily, vk::DeviceSize stagingSize)
+	: allocator_(allocator), queue_(queue), queue_family_(queueFamily),
+	transfer_queue_(transferQueue && transferFamily != queueFamily ? transferQueue : nullptr), transfer_family_(transferFamily),
+	staging_size_(stagingSize)
+{
+	vk::raii::Device& device = allocator_.Device();
+
+	queue_pool_ = vk::raii::CommandPool(device, { .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer, .queueFamilyIndex = queue_family_ });
+	if (transfer_queue_) {
+		transfer_pool_ = vk::raii::CommandPool(device, { .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer, .queueFamilyIndex = transfer_family_ });
+	}
+
+	vk::SemaphoreTypeCreateInfo semaphoreType{ .semaphoreType = vk::SemaphoreType::eTimeline, .initialValue = 0 };
+	timeline_ = vk::raii::Semaphore(device, { .pNext = &semaphoreType });
+
+	// 압축 texture block (16 bytes) 과 optimalBufferCopyOffsetAlignment 를 모두 만족하도록
+	const auto limits = allocator_.PhysicalDevice().getProperties().limits;
+	staging_alignment_ = std::max<vk::DeviceSize>(16, limits.optimalBufferCopyOffsetAlignment);
+
+	vku::CreateBuffer(allocator_, staging_size_, vk::BufferUsageFlagBits::eTransferSrc,
+		vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+		staging_buffer_, staging_memory_);
+}
+
+UploadService::~UploadService()
+{
+	std::lock_guard lock(mutex_);
+	WaitLocked(FlushLocked());
+}
+
+UploadService::Batch& UploadService::CurrentBatch()
+{
+	if (!current_) {
+		if (!free_batches_.empty()) {
+			current_ = std::move(free_batches_.back());
+			free_batches_.pop_back();
+		}
+		else {
+			current_ = std::make_unique<Batch>();
+			vk::raii::Device& device = allocator_.Device();
+			vk::CommandBufferAllocateInfo allocInfo{ .commandPool = transfer_queue_ ? *transfer_pool_ : *queue_pool_, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 };
+			current_->transfer = std::move(vk::raii::CommandBuffers(device, allocInfo).front());
+			if (transfer_queue_) {
+				allocInfo.commandPool = *queue_pool_;
+				current_->acquire = std::move(vk::raii::CommandBuffers(device, allocInfo).front());
+			}
+		}
+	}
+
+	if (!current_->recording) {
+		current_->transfer.reset();
+		current_->transfer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		current_->recording = true;
+	}
+	return *current_;
+}
+
+std::tuple<vk::Buffer, vk::DeviceSize, std::byte*> UploadService::AllocateStaging(vk::DeviceSize size)
+{
+	// ring 보다 크면 이 batch 동안만 쓸 임시 buffer
+	if (size > staging_size_ / 2) {
+		Batch& batch = CurrentBatch();
+		vk::raii::Buffer buffer{ nullptr };
+		vku::Allocation memory;
+		vku::CreateBuffer(allocator_, size, vk::BufferUsageFlagBits::eTransferSrc,
+			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, buffer, memory);
+		const vk::Buffer handle = *buffer;
+		auto* mapped = static_cast<std::byte*>(memory.Mapped());
+		batch.overflow_buffers.push_back(std::move(buffer));
+		batch.overflow_memory.push_back(std::move(memory));
+		return { handle, 0, mapped };
+	}
+
+	for (;;) {
+		uint64_t offset = (ring_head_ + staging_alignment_ - 1) & ~(staging_alignment_ - 1);
+		// ring 끝을 넘으면 처음으로 돌아간다 (남은 꼬리는 버림)
+		if (offset % staging_size_ + size > staging_size_) {
+			offset += staging_size_ - offset % staging_size_;
+		}
+
+		if (offset + size - ring_tail_ <= staging_size_) {
+			ring_head_ = offset + size;
+			return { *staging_buffer_, offset % staging_size_, static_cast<std::byte*>(staging_memory_.Mapped()) + offset % staging_size_ };
+		}
+
+		// 공간이 없으면 끝난 batch 부터 회수하고, 그래도 없으면 가장 오래된 batch 를 기다린다
+		Retire();
+		if (offset + size - ring_tail_ <= staging_size_) continue;
+
+		if (in_flight_.empty()) {
+			FlushLocked();
+		}
+		if (!in_flight_.empty()) {
+			WaitLocked(in_flight_.front()->ticket);
+		}
+	}
+}
+
+void UploadService::UploadBuffer(vk::Buffer dst, vk::DeviceSize dstOffset, const void* data, vk::DeviceSize size)
+{
+	if (size == 0) return;
+
+	std::lock_guard lock(mutex_);
+	auto [staging, stagingOffset, mapped] = AllocateStaging(size);
+	std::memcpy(mapped, data, size);
+
+	Batch& batch = CurrentBatch();
+	batch.transfer.copyBuffer(staging, dst, vk::BufferCopy(stagingOffset, dstOffset, size));
+
+	if (transfer_queue_) {
+		// transfer family 에서 release, graphics family 에서 acquire
+		vk::BufferMemoryBarrier2 release{
+			.srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+			.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.srcQueueFamilyIndex = transfer_family_,
+			.dstQueueFamilyIndex = queue_family_,
+			.buffer = dst,
+			.offset = dstOffset,
+			.size = size
+		};
+		batch.transfer.pipelineBarrier2(vk::DependencyInfo{ .bufferMemoryBarrierCount = 1, .pBufferMemoryBarriers = &release });
+
+		vk::BufferMemoryBarrier2 acquire = release;
+		acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+		acquire.srcAccessMask = {};
+		acquire.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+		acquire.dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+		batch.buffer_acquires.push_back(acquire);
+	}
+	uploaded_bytes_ += size;
+}
+
+void UploadService::UploadImage(vk::Image dst, uint32_t width, uint32_t height, const void* data, vk::DeviceSize size)
+{
+	std::lock_guard lock(mutex_);
+	auto [staging, stagingOffset, mapped] = AllocateStaging(size);
+	std::memcpy(mapped, data, size);
+
+	Batch& batch = CurrentBatch();
+	const vk::ImageSubresourceRange range{ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 };
+
+	vk::ImageMemoryBarrier2 toTransfer{
+		.srcStageMask = vk::PipelineStageFlagBits2::eNone,
+		.dstStageMask = vk::PipelineStageFlagBits2::eTransfer,
+		.dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+		.oldLayout = vk::ImageLayout::eUndefined,
+		.newLayout = vk::ImageLayout::eTransferDstOptimal,
+		.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+		.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+		.image = dst,
+		.subresourceRange = range
+	};
+	batch.transfer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toTransfer });
+
+	vk::BufferImageCopy region{
+		.bufferOffset = stagingOffset,
+		.bufferRowLength = 0,
+		.bufferImageHeight = 0,
+		.imageSubresource = { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+		.imageOffset = { 0, 0, 0 },
+		.imageExtent = { width, height, 1 }
+	};
+	batch.transfer.copyBufferToImage(staging, dst, vk::ImageLayout::eTransferDstOptimal, region);
+
+	vk::ImageMemoryBarrier2 toShader{
+		.srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+		.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+		.dstStageMask = vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+		.dstAccessMask = vk::AccessFlagBits2::eShaderRead,
+		.oldLayout = vk::ImageLayout::eTransferDstOptimal,
+		.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+		.srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+		.dstQueueFamilyIndex = vk::QueueFamilyIgnored,
+		.image = dst,
+		.subresourceRange = range
+	};
+
+	if (transfer_queue_) {
+		// layout 전환은 release / acquire 양쪽에 같은 값으로 적는다
+		vk::ImageMemoryBarrier2 release = toShader;
+		release.dstStageMask = vk::PipelineStageFlagBits2::eNone;
+		release.dstAccessMask = {};
+		release.srcQueueFamilyIndex = transfer_family_;
+		release.dstQueueFamilyIndex = queue_family_;
+		batch.transfer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &release });
+
+		vk::ImageMemoryBarrier2 acquire = toShader;
+		acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+		acquire.srcAccessMask = {};
+		acquire.srcQueueFamilyIndex = transfer_family_;
+		acquire.dstQueueFamilyIndex = queue_family_;
+		batch.image_acquires.push_back(acquire);
+	}
+	else {
+		batch.transfer.pipelineBarrier2(vk::DependencyInfo{ .imageMemoryBarrierCount = 1, .pImageMemoryBarriers = &toShader });
+	}
+	uploaded_bytes_ += size;
+}
+
+UploadTicket UploadService::Flush()
+{
+	std::lock_guard lock(mutex_);
+	return FlushLocked();
+}
+
+UploadTicket UploadService::FlushLocked()
+{
+	if (!current_ || !current_->recording) return last_ticket_;
+
+	std::unique_ptr<Batch> batch = std::move(current_);
+	if (!transfer_queue_) {
+		// 같은 queue 의 이후 submit 이 copy 결과를 보도록
+		vk::MemoryBarrier2 barrier{
+			.srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+			.srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+			.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+			.dstAccessMask = vk::AccessFlagBits2::eMemoryRead
+		};
+		batch->transfer.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+	}
+	batch->transfer.end();
+	batch->recording = false;
+
+	const uint64_t copyValue = ++last_ticket_;
+	vk::TimelineSemaphoreSubmitInfo copyTimeline{ .signalSemaphoreValueCount = 1, .pSignalSemaphoreValues = &copyValue };
+	vk::SubmitInfo copySubmit{
+		.pNext = &copyTimeline,
+		.commandBufferCount = 1,
+		.pCommandBuffers = &*batch->transfer,
+		.signalSemaphoreCount = 1,
+		.pSignalSemaphores = &*timeline_
+	};
+	{
+		// transfer queue 는 여기서만 쓰지만 (mutex_ 로 충분) graphics queue 는 Context 와 같이 쓴다
+		std::lock_guard queueLock(queue_mutex_);
+		(transfer_queue_ ? *transfer_queue_ : queue_).submit(copySubmit, nullptr);
+	}
+	++submit_count_;
+
+	if (transfer_queue_) {
+		// graphics queue 에서 ownership acquire. copy 가 끝나기를 GPU 에서 기다린다
+		batch->acquire.reset();
+		batch->acquire.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		batch->acquire.pipelineBarrier2(vk::DependencyInfo{
+			.bufferMemoryBarrierCount = static_cast<uint32_t>(batch->buffer_acquires.size()),
+			.pBufferMemoryBarriers = batch->buffer_acquires.data(),
+			.imageMemoryBarrierCount = static_cast<uint32_t>(batch->image_acquires.size()),
+			.pImageMemoryBarriers = batch->image_acquires.data()
+		});
+		batch->acquire.end();
+
+		const uint64_t acquireValue = ++last_ticket_;
+		const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+		vk::TimelineSemaphoreSubmitInfo acquireTimeline{
+			.waitSemaphoreValueCount = 1,
+			.pWaitSemaphoreValues = &copyValue,
+			.signalSemaphoreValueCount = 1,
+			.pSignalSemaphoreValues = &acquireValue
+		};
+		vk::SubmitInfo acquireSubmit{
+			.pNext = &acquireTimeline,
+			.waitSemaphoreCount = 1,
+			.pWaitSemaphores = &*timeline_,
+			.pWaitDstStageMask = &waitStage,
+			.commandBufferCount = 1,
+			.pCommandBuffers = &*batch->acquire,
+			.signalSemaphoreCount = 1,
+			.pSignalSemaphores = &*timeline_
+		};
+		{
+			std::lock_guard queueLock(queue_mutex_);
+			queue_.submit(acquireSubmit, nullptr);
+		}
+		++submit_count_;
+	}
+
+	batch->ticket = last_ticket_;
+	batch->ring_end = ring_head_;
+	in_flight_.push_back(std::move(batch));
+	return last_ticket_;
+}
+
+void UploadService::Retire()
+{
+	const uint64_t completed = timeline_.getCounterValue();
+	while (!in_flight_.empty() && in_flight_.front()->ticket <= completed) {
+		std::unique_ptr<Batch> batch = std::move(in_flight_.front());
+		in_flight_.pop_front();
+
+		ring_tail_ = batch->ring_end;
+		batch->overflow_buffers.clear();
+		batch->overflow_memory.clear();
+		batch->buffer_acquires.clear();
+		batch->image_acquires.clear();
+		free_batches_.push_back(std::move(batch));
+	}
+	if (in_flight_.empty() && !current_) {
+		// GPU 가 읽는 staging 이 없으면 ring 을 처음부터 다시 쓴다
+		ring_head_ = ring_tail_ = 0;
+	}
+}
+
+void UploadService::Wait(UploadTicket ticket)
+{
+	std::lock_guard lock(mutex_);
+	WaitLocked(ticket);
+}
+
+void UploadService::WaitLocked(UploadTicket ticket)
+{
+	if (ticket == 0) return;
+
+	vk::SemaphoreWaitInfo waitInfo{
+		.semaphoreCount = 1,
+		.pSemaphores = &*timeline_,
+		.pValues = &ticket
+	};
+	while (vk::Result::eTimeout == allocator_.Device().waitSemaphores(waitInfo, UINT64_MAX));
+	Retire();
+}
+
+bool UploadService::IsComplete(UploadTicket ticket) const
+{
+	return timeline_.getCounterValue() >= ticket;
+}
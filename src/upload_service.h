@@ -0,0 +1,93 @@
+#pragma once
+
+#include "vulkan_allocator.h"
+
+// Flush 媛#pragma once
+
+#include "vulkan_allocator.h"
+
+// Flush 가 돌려주는 timeline semaphore 값. 이 값에 도달하면 그 batch 의 copy 가 모두 끝난 것
+using UploadTicket = uint64_t;
+
+// host -> device upload 를 모아서 한 번에 submit 한다.
+// staging 은 계속 map 된 ring buffer 하나를 돌려쓰고, ring 이 차면 가장 오래된 batch 만 기다린다.
+// transfer 전용 queue family 가 있으면 거기서 copy 하고, graphics queue 에서 ownership 을 acquire 한다.
+// 여러 thread 에서 Upload* 를 불러도 된다. 대상 resource 는 ticket 이 끝날 때까지 살아있어야 한다.
+// ring 이 차면 worker thread 에서도 submit 하므로, queue 를 같이 쓰는 쪽은 submit / present / waitIdle 을 QueueMutex() 안에서 해야 한다.
+class UploadService
+{
+public:
+	// transferQueue 가 nullptr 이면 graphics queue 에서 copy
+	UploadService(vku::Allocator& allocator, vk::raii::Queue& queue, uint32_t queueFamily, vk::raii::Queue* transferQueue, uint32_t transferFamily, vk::DeviceSize stagingSize = 64ull << 20);
+	UploadService(const UploadService& rhs) = delete;
+	UploadService(UploadService&& rhs) = delete;
+	UploadService& operator=(const UploadService& rhs) = delete;
+	UploadService& operator=(UploadService&& rhs) = delete;
+	~UploadService();
+
+	void UploadBuffer(vk::Buffer dst, vk::DeviceSize dstOffset, const void* data, vk::DeviceSize size);
+	// mip 0 / layer 0 만. UNDEFINED -> (copy) -> SHADER_READ_ONLY_OPTIMAL
+	void UploadImage(vk::Image dst, uint32_t width, uint32_t height, const void* data, vk::DeviceSize size);
+
+	// 지금까지 기록한 copy 를 submit. 기록한 게 없으면 마지막 ticket 을 그대로 돌려준다
+	UploadTicket Flush();
+	void Wait(UploadTicket ticket);
+	bool IsComplete(UploadTicket ticket) const;
+
+	bool UsesTransferQueue() const { return transfer_queue_ != nullptr; }
+	uint32_t SubmitCount() const { return submit_count_; }
+	vk::DeviceSize UploadedBytes() const { return uploaded_bytes_; }
+
+	// queue (외부 동기화 대상) 를 쓰는 모든 곳이 잡는 mutex. 순서는 Upload* / Flush 의 내부 mutex -> queue mutex 라서
+	// 이걸 잡은 채로 Upload* / Flush / Wait 를 부르면 안 된다
+	std::mutex& QueueMutex() { return queue_mutex_; }
+
+private:
+	struct Batch {
+		vk::raii::CommandBuffer transfer{ nullptr };
+		vk::raii::CommandBuffer acquire{ nullptr }; // transfer queue 를 쓸 때만
+		UploadTicket ticket = 0;
+		uint64_t ring_end = 0;
+		// ring 보다 큰 upload 용 임시 staging
+		std::vector<vk::raii::Buffer> overflow_buffers;
+		std::vector<vku::Allocation> overflow_memory;
+		std::vector<vk::BufferMemoryBarrier2> buffer_acquires;
+		std::vector<vk::ImageMemoryBarrier2> image_acquires;
+		bool recording = false;
+	};
+
+	// staging 공간을 잡고 (buffer, offset, mapped) 를 돌려준다. mutex_ 를 잡은 상태에서 호출
+	std::tuple<vk::Buffer, vk::DeviceSize, std::byte*> AllocateStaging(vk::DeviceSize size);
+	Batch& CurrentBatch();
+	UploadTicket FlushLocked();
+	void Retire();
+	void WaitLocked(UploadTicket ticket);
+
+	vku::Allocator& allocator_;
+	vk::raii::Queue& queue_;
+	uint32_t queue_family_;
+	vk::raii::Queue* transfer_queue_;
+	uint32_t transfer_family_;
+
+	vk::raii::CommandPool queue_pool_{ nullptr };
+	vk::raii::CommandPool transfer_pool_{ nullptr };
+	vk::raii::Semaphore timeline_{ nullptr };
+	UploadTicket last_ticket_ = 0;
+
+	vk::raii::Buffer staging_buffer_{ nullptr };
+	vku::Allocation staging_memory_;
+	vk::DeviceSize staging_size_;
+	vk::DeviceSize staging_alignment_;
+	uint64_t ring_head_ = 0; // 누적 byte (offset = head % size)
+	uint64_t ring_tail_ = 0; // 아직 GPU 가 읽고 있을 수 있는 가장 오래된 위치
+
+	std::unique_ptr<Batch> current_;
+	std::deque<std::unique_ptr<Batch>> in_flight_;
+	std::vector<std::unique_ptr<Batch>> free_batches_;
+
+	uint32_t submit_count_ = 0;
+	vk::DeviceSize uploaded_bytes_ = 0;
+
+	mutable std::mutex mutex_;
+	std::mutex queue_mutex_;
+};
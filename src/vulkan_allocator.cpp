@@ -0,0 +1,294 @@
+#include "vulkan_utils.h"
+
+#include "vulkan_allocator.h"
+
+namespace vku
+{
+	namespace {
+		// buddy 理쒖냼 #include "vulkan_utils.h"
+
+#include "vulkan_allocator.h"
+
+namespace vku
+{
+	namespace {
+		// buddy 최소 단위. order n 의 크기는 kMinAllocation << n
+		constexpr vk::DeviceSize kMinAllocation = 256;
+
+		uint32_t OrderFor(vk::DeviceSize size)
+		{
+			uint32_t order = 0;
+			while ((kMinAllocation << order) < size) ++order;
+			return order;
+		}
+	}
+
+	struct Allocator::Block {
+		vk::raii::DeviceMemory memory{ nullptr };
+		vk::DeviceSize size = 0;
+		uint32_t memory_type = 0;
+		bool linear = true;
+		bool dedicated = false;
+		void* mapped = nullptr;
+
+		// order 별 free 구간의 offset
+		std::vector<std::vector<vk::DeviceSize>> free_lists;
+		vk::DeviceSize allocated = 0;
+		vk::DeviceSize requested = 0;
+		uint32_t allocation_count = 0;
+	};
+
+	// ===== Allocation =====
+
+	Allocation::Allocation(Allocation&& rhs) noexcept
+	{
+		*this = std::move(rhs);
+	}
+
+	Allocation& Allocation::operator=(Allocation&& rhs) noexcept
+	{
+		if (this != &rhs) {
+			Reset();
+			owner_ = std::exchange(rhs.owner_, nullptr);
+			block_ = std::exchange(rhs.block_, nullptr);
+			memory_ = std::exchange(rhs.memory_, nullptr);
+			offset_ = std::exchange(rhs.offset_, 0);
+			size_ = std::exchange(rhs.size_, 0);
+			order_ = std::exchange(rhs.order_, 0);
+			mapped_ = std::exchange(rhs.mapped_, nullptr);
+		}
+		return *this;
+	}
+
+	void Allocation::Reset()
+	{
+		if (owner_) {
+			owner_->Free(*this);
+		}
+		owner_ = nullptr;
+		block_ = nullptr;
+		memory_ = nullptr;
+		offset_ = 0;
+		size_ = 0;
+		mapped_ = nullptr;
+	}
+
+	// ===== Allocator =====
+
+	Allocator::Allocator(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vk::DeviceSize blockSize)
+		: physical_device_(physicalDevice), device_(device), memory_properties_(physicalDevice.getMemoryProperties())
+	{
+		max_order_ = OrderFor(blockSize);
+		block_size_ = kMinAllocation << max_order_;
+
+		const vk::MemoryPropertyFlags directFlags = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; ++i) {
+			const vk::MemoryType& type = memory_properties_.memoryTypes[i];
+			if ((type.propertyFlags & directFlags) == directFlags && memory_properties_.memoryHeaps[type.heapIndex].size > (256ull << 20)) {
+				direct_upload_ = true;
+				break;
+			}
+		}
+	}
+
+	Allocator::~Allocator()
+	{
+		// 남은 allocation 은 memory 가 먼저 해제되므로 이후 쓰면 안 된다
+		std::lock_guard lock(mutex_);
+		for (const auto& block : blocks_) {
+			if (block->allocation_count > 0) {
+				std::cerr << "vku::Allocator destroyed with " << block->allocation_count << " live allocation(s)" << std::endl;
+			}
+		}
+	}
+
+	Allocation Allocator::AllocateForBuffer(const vk::raii::Buffer& buffer, vk::MemoryPropertyFlags properties)
+	{
+		return Allocate(buffer.getMemoryRequirements(), properties, true, nullptr);
+	}
+
+	Allocation Allocator::AllocateForImage(const vk::raii::Image& image, vk::MemoryPropertyFlags properties)
+	{
+		// render target / texture 처럼 큰 image 는 driver 가 최적 배치를 할 수 있도록 dedicated
+		const vk::MemoryRequirements requirements = image.getMemoryRequirements();
+		const bool dedicated = requirements.size >= block_size_ / 4;
+		return Allocate(requirements, properties, false, dedicated ? *image : vk::Image{});
+	}
+
+	Allocator::Block* Allocator::CreateBlock(uint32_t memoryType, bool linear, vk::DeviceSize size, bool dedicated, vk::Image dedicatedImage)
+	{
+		vk::MemoryDedicatedAllocateInfo dedicatedInfo{ .image = dedicatedImage };
+		vk::MemoryAllocateInfo allocInfo{
+			.pNext = dedicatedImage ? &dedicatedInfo : nullptr,
+			.allocationSize = size,
+			.memoryTypeIndex = memoryType
+		};
+
+		auto block = std::make_unique<Block>();
+		block->memory = vk::raii::DeviceMemory(device_, allocInfo);
+		block->size = size;
+		block->memory_type = memoryType;
+		block->linear = linear;
+		block->dedicated = dedicated;
+
+		if (memory_properties_.memoryTypes[memoryType].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible) {
+			block->mapped = block->memory.mapMemory(0, size);
+		}
+
+		if (!dedicated) {
+			block->free_lists.resize(max_order_ + 1);
+			block->free_lists[max_order_].push_back(0);
+		}
+
+		blocks_.push_back(std::move(block));
+		return blocks_.back().get();
+	}
+
+	Allocation Allocator::Allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear, vk::Image dedicatedImage)
+	{
+		const uint32_t memoryType = FindMemoryType(physical_device_, requirements.memoryTypeBits, properties);
+
+		std::lock_guard lock(mutex_);
+
+		// owner_ 는 마지막에 채운다 (중간에 throw 하면 빈 allocation 으로 정리되도록)
+		Allocation allocation;
+		allocation.size_ = requirements.size;
+
+		// buddy 구간은 자기 크기로 정렬되므로 alignment 보다 크게 올리면 정렬이 보장된다
+		const vk::DeviceSize rounded = std::max(requirements.size, requirements.alignment);
+		if (dedicatedImage || rounded > block_size_ / 2) {
+			Block* block = CreateBlock(memoryType, linear, requirements.size, true, dedicatedImage);
+			block->allocated = block->requested = requirements.size;
+			block->allocation_count = 1;
+
+			allocation.owner_ = this;
+			allocation.block_ = block;
+			allocation.memory_ = *block->memory;
+			allocation.mapped_ = block->mapped;
+			return allocation;
+		}
+
+		const uint32_t order = OrderFor(rounded);
+
+		// 같은 종류의 block 중에서 order 이상의 free 구간이 있는 첫 block
+		Block* target = nullptr;
+		uint32_t found = 0;
+		for (const auto& block : blocks_) {
+			if (block->dedicated || block->memory_type != memoryType || block->linear != linear) continue;
+			for (uint32_t o = order; o <= max_order_; ++o) {
+				if (!block->free_lists[o].empty()) {
+					target = block.get();
+					found = o;
+					break;
+				}
+			}
+			if (target) break;
+		}
+		if (!target) {
+			target = CreateBlock(memoryType, linear, block_size_, false, nullptr);
+			found = max_order_;
+		}
+
+		// 필요한 order 까지 반으로 쪼개며 오른쪽 buddy 를 free list 에 넣는다
+		const vk::DeviceSize offset = target->free_lists[found].back();
+		target->free_lists[found].pop_back();
+		while (found > order) {
+			--found;
+			target->free_lists[found].push_back(offset + (kMinAllocation << found));
+		}
+
+		target->allocated += kMinAllocation << order;
+		target->requested += requirements.size;
+		target->allocation_count++;
+
+		allocation.owner_ = this;
+		allocation.block_ = target;
+		allocation.memory_ = *target->memory;
+		allocation.offset_ = offset;
+		allocation.order_ = order;
+		allocation.mapped_ = target->mapped ? static_cast<std::byte*>(target->mapped) + offset : nullptr;
+		return allocation;
+	}
+
+	void Allocator::Free(Allocation& allocation)
+	{
+		std::lock_guard lock(mutex_);
+
+		Block* block = static_cast<Block*>(allocation.block_);
+		auto eraseBlock = [&]() {
+			std::erase_if(blocks_, [block](const std::unique_ptr<Block>& b) { return b.get() == block; });
+		};
+
+		if (block->dedicated) {
+			eraseBlock();
+			return;
+		}
+
+		// buddy 가 free 면 합치면서 위 order 로 올라간다
+		vk::DeviceSize offset = allocation.offset_;
+		uint32_t order = allocation.order_;
+		block->allocated -= kMinAllocation << order;
+		block->requested -= allocation.size_;
+		block->allocation_count--;
+
+		while (order < max_order_) {
+			const vk::DeviceSize buddy = offset ^ (kMinAllocation << order);
+			auto& list = block->free_lists[order];
+			auto it = std::find(list.begin(), list.end(), buddy);
+			if (it == list.end()) break;
+			list.erase(it);
+			offset = std::min(offset, buddy);
+			++order;
+		}
+		block->free_lists[order].push_back(offset);
+
+		// 완전히 빈 block 은 같은 종류의 다른 block 이 있으면 반납
+		if (block->allocation_count == 0) {
+			const bool hasSibling = std::ranges::any_of(blocks_, [block](const std::unique_ptr<Block>& b) {
+				return b.get() != block && !b->dedicated && b->memory_type == block->memory_type && b->linear == block->linear;
+			});
+			if (hasSibling) eraseBlock();
+		}
+	}
+
+	AllocatorStats Allocator::Stats() const
+	{
+		std::lock_guard lock(mutex_);
+
+		AllocatorStats stats;
+		vk::DeviceSize freeBytes = 0;
+		for (const auto& block : blocks_) {
+			stats.block_bytes += block->size;
+			stats.allocated_bytes += block->allocated;
+			stats.requested_bytes += block->requested;
+			stats.allocation_count += block->allocation_count;
+			if (block->dedicated) {
+				stats.dedicated_count++;
+				continue;
+			}
+			stats.block_count++;
+			for (uint32_t o = 0; o <= max_order_; ++o) {
+				const vk::DeviceSize size = kMinAllocation << o;
+				freeBytes += size * block->free_lists[o].size();
+				if (!block->free_lists[o].empty()) stats.largest_free = std::max(stats.largest_free, size);
+			}
+		}
+
+		if (freeBytes > 0) {
+			stats.external_fragmentation = 1.0f - static_cast<float>(stats.largest_free) / static_cast<float>(freeBytes);
+		}
+		if (stats.allocated_bytes > 0) {
+			stats.internal_fragmentation = 1.0f - static_cast<float>(stats.requested_bytes) / static_cast<float>(stats.allocated_bytes);
+		}
+		return stats;
+	}
+
+	void Allocator::DrawImgui() const
+	{
+		const AllocatorStats stats = Stats();
+		const float mb = 1.0f / (1024.0f * 1024.0f);
+		ImGui::Text("Blocks %u, dedicated %u, allocations %u", stats.block_count, stats.dedicated_count, stats.allocation_count);
+		ImGui::Text("Reserved %.1f MB, used %.2f MB (requested %.2f MB)", stats.block_bytes * mb, stats.allocated_bytes * mb, stats.requested_bytes * mb);
+		ImGui::Text("Fragmentation : external %.1f%%, internal %.1f%%", stats.external_fragmentation * 100.0f, stats.internal_fragmentation * 100.0f);
+	}
+}
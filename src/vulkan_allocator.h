@@ -0,0 +1,103 @@
+#pragma once
+
+namespace vku
+{
+	class Allocator;
+
+	// Allocator #pragma once
+
+namespace vku
+{
+	class Allocator;
+
+	// Allocator 에서 받은 memory 한 조각. 소멸 시 Allocator 로 돌려준다.
+	// host visible memory 는 block 단위로 계속 map 되어 있으므로 Mapped() 로 바로 쓸 수 있다.
+	class Allocation
+	{
+	public:
+		Allocation() = default;
+		Allocation(std::nullptr_t) {}
+		Allocation(const Allocation& rhs) = delete;
+		Allocation(Allocation&& rhs) noexcept;
+		Allocation& operator=(const Allocation& rhs) = delete;
+		Allocation& operator=(Allocation&& rhs) noexcept;
+		~Allocation() { Reset(); }
+
+		void Reset();
+
+		vk::DeviceMemory Memory() const { return memory_; }
+		vk::DeviceSize Offset() const { return offset_; }
+		vk::DeviceSize Size() const { return size_; }
+		void* Mapped() const { return mapped_; }
+		explicit operator bool() const { return owner_ != nullptr; }
+
+	private:
+		friend class Allocator;
+
+		Allocator* owner_ = nullptr;
+		void* block_ = nullptr;
+		vk::DeviceMemory memory_;
+		vk::DeviceSize offset_ = 0;
+		vk::DeviceSize size_ = 0;
+		uint32_t order_ = 0;
+		void* mapped_ = nullptr;
+	};
+
+	struct AllocatorStats {
+		vk::DeviceSize block_bytes = 0;      // vkAllocateMemory 로 잡은 전체 크기 (dedicated 포함)
+		vk::DeviceSize allocated_bytes = 0;  // buddy 단위로 올림한 사용량
+		vk::DeviceSize requested_bytes = 0;  // 실제 요청 크기의 합
+		vk::DeviceSize largest_free = 0;
+		uint32_t block_count = 0;
+		uint32_t dedicated_count = 0;
+		uint32_t allocation_count = 0;
+		float external_fragmentation = 0.0f; // 1 - (가장 큰 free 구간 / 전체 free)
+		float internal_fragmentation = 0.0f; // 1 - (요청 크기 / 올림한 크기)
+	};
+
+	// memory type (와 buffer / image 구분) 마다 큰 block 을 잡아 buddy 방식으로 나눠준다.
+	// block 크기의 절반을 넘는 요청과 큰 image 는 dedicated allocation 으로 따로 잡는다.
+	// 여러 thread 에서 불러도 된다.
+	class Allocator
+	{
+	public:
+		Allocator(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device, vk::DeviceSize blockSize = 64ull << 20);
+		Allocator(const Allocator& rhs) = delete;
+		Allocator(Allocator&& rhs) = delete;
+		Allocator& operator=(const Allocator& rhs) = delete;
+		Allocator& operator=(Allocator&& rhs) = delete;
+		~Allocator();
+
+		Allocation AllocateForBuffer(const vk::raii::Buffer& buffer, vk::MemoryPropertyFlags properties);
+		Allocation AllocateForImage(const vk::raii::Image& image, vk::MemoryPropertyFlags properties);
+
+		AllocatorStats Stats() const;
+		void DrawImgui() const;
+
+		// device local memory 를 host 에서 직접 쓸 수 있는지 (UMA / resizable BAR).
+		// 256 MiB 짜리 기본 BAR window 는 제외한다
+		bool SupportsDirectUpload() const { return direct_upload_; }
+
+		vk::raii::PhysicalDevice& PhysicalDevice() { return physical_device_; }
+		vk::raii::Device& Device() { return device_; }
+
+	private:
+		friend class Allocation;
+
+		struct Block;
+
+		Allocation Allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear, vk::Image dedicatedImage);
+		Block* CreateBlock(uint32_t memoryType, bool linear, vk::DeviceSize size, bool dedicated, vk::Image dedicatedImage);
+		void Free(Allocation& allocation);
+
+		vk::raii::PhysicalDevice& physical_device_;
+		vk::raii::Device& device_;
+		vk::PhysicalDeviceMemoryProperties memory_properties_;
+		vk::DeviceSize block_size_;
+		uint32_t max_order_ = 0;
+		bool direct_upload_ = false;
+
+		mutable std::mutex mutex_;
+		std::vector<std::unique_ptr<Block>> blocks_;
+	};
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "vulkan_allocator.h"
+#include "upload_service.h"
+
 namespace vku
 {
 	struct Counts {
@@ -41,7 +44,7 @@ namespace vku
 		throw std::runtime_error("failed to find suitable memory type!");
 	}
 
-	inline void CreateImage(vk::raii::PhysicalDevice& physicalDevice,  vk::raii::Device& device, uint32_t width, uint32_t height, uint32_t mipLevels, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image& image, vk::raii::DeviceMemory& imageMemory) {
+	inline void CreateImage(Allocator& allocator, uint32_t width, uint32_t height, uint32_t mipLevels, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image& image, Allocation& imageMemory) {
 		vk::ImageCreateInfo imageInfo{
 			   .imageType = vk::ImageType::e2D,
 			   .format = format,
@@ -55,15 +58,123 @@ namespace vku
 			   .initialLayout = vk::ImageLayout::eUndefined
 		};
 
-		image = vk::raii::Image(device, imageInfo);
+		image = vk::raii::Image(allocator.Device(), imageInfo);
+		imageMemory = allocator.AllocateForImage(image, properties);
+		image.bindMemory(imageMemory.Memory(), imageMemory.Offset());
+	}
 
-		vk::MemoryRequirements memRequirements = image.getMemoryRequirements();
-		vk::MemoryAllocateInfo allocInfo{
-			.allocationSize = memRequirements.size,
-			.memoryTypeIndex = FindMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties)
+	inline vk::raii::ImageView CreateImageView(vk::raii::Device& device, vk::raii::Image& image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels) {
+		vk::ImageViewCreateInfo viewInfo{
+				.image = image,
+				.viewType = vk::ImageViewType::e2D,
+				.format = format,
+				.subresourceRange = { aspectFlags, 0, mipLevels, 0, 1 }
 		};
-		imageMemory = vk::raii::DeviceMemory(device, allocInfo);
-		image.bindMemory(imageMemory, 0);
+		return vk::raii::ImageView(device, viewInfo);
+	}
+
+	inline vk::Format FindSupportedFormat(vk::raii::PhysicalDevice& physicalDevice, const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features) {
+		auto formatIt = std::ranges::find_if(candidates, [&](auto const format) {
+			vk::FormatProperties props = physicalDevice.getFormatProperties(format);
+			return (((tiling == vk::ImageTiling::eLinear) && ((props.linearTilingFeatures & features) == features)) ||
+				((tiling == vk::ImageTiling::eOptimal) && ((props.optimalTilingFeatures & features) == features)));
+			});
+		if (formatIt == candidates.end())
+		{
+			throw std::runtime_error("failed to find supported format!");
+		}
+		return *formatIt;
+	}
+
+	inline vk::Format FindDepthFormat(vk::raii::PhysicalDevice& physicalDevice) {
+		return FindSupportedFormat(physicalDevice,
+			{ vk::Format::eD32Sfloat, vk::Format::eD32SfloatS8Uint, vk::Format::eD24UnormS8Uint },
+			vk::ImageTiling::eOptimal,
+			vk::FormatFeatureFlagBits::eDepthStencilAttachment
+		);
+	}
+
+	inline void CreateBuffer(Allocator& allocator, vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Buffer& buffer, Allocation& bufferMemory) 
+	{
+		vk::BufferCreateInfo bufferInfo{ .size = size, .usage = usage, .sharingMode = vk::SharingMode::eExclusive };
+		buffer = vk::raii::Buffer(allocator.Device(), bufferInfo);
+		bufferMemory = allocator.AllocateForBuffer(buffer, properties);
+		buffer.bindMemory(bufferMemory.Memory(), bufferMemory.Offset());
+	}
+
+	inline void CopyBuffer(vk::raii::Device& device, vk::raii::Queue& queue, vk::raii::CommandPool& commandPool, vk::raii::Buffer& srcBuffer, vk::raii::Buffer& dstBuffer, vk::DeviceSize size, vk::DeviceSize srcOffset = 0, vk::DeviceSize dstOffset = 0) {
+		vk::CommandBufferAllocateInfo allocInfo{ .commandPool = commandPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 };
+		vk::raii::CommandBuffer commandCopyBuffer = std::move(device.allocateCommandBuffers(allocInfo).front());
+		commandCopyBuffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+		commandCopyBuffer.copyBuffer(*srcBuffer, *dstBuffer, vk::BufferCopy(srcOffset, dstOffset, size));
+		commandCopyBuffer.end();
+		queue.submit(vk::SubmitInfo{ .commandBufferCount = 1, .pCommandBuffers = &*commandCopyBuffer }, nullptr);
+		queue.waitIdle();
+	}
+
+	// #pragma once
+
+#include "vulkan_allocator.h"
+#include "upload_service.h"
+
+namespace vku
+{
+	struct Counts {
+		uint32_t ubo = 0;
+		uint32_t ubo_dynamic = 0;
+		uint32_t sb = 0;
+		uint32_t sampler = 0;
+		uint32_t layout = 0;
+	};
+
+	inline [[nodiscard]] vk::raii::ShaderModule CreateShaderModule(vk::raii::Device& device, const std::vector<char>& code) {
+		vk::ShaderModuleCreateInfo createInfo{ .codeSize = code.size(), .pCode = reinterpret_cast<const uint32_t*>(code.data()) };
+		vk::raii::ShaderModule shaderModule{ device, createInfo };
+
+		return shaderModule;
+	}
+
+	inline std::vector<char> ReadFile(const std::string& filename) {
+		std::ifstream file(filename, std::ios::ate | std::ios::binary);
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open file!");
+		}
+		std::vector<char> buffer(file.tellg());
+		file.seekg(0, std::ios::beg);
+		file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		file.close();
+		return buffer;
+	}
+
+	inline uint32_t FindMemoryType(vk::raii::PhysicalDevice& physicalDevice, uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
+		vk::PhysicalDeviceMemoryProperties memProperties = physicalDevice.getMemoryProperties();
+
+		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+			if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+				return i;
+			}
+		}
+
+		throw std::runtime_error("failed to find suitable memory type!");
+	}
+
+	inline void CreateImage(Allocator& allocator, uint32_t width, uint32_t height, uint32_t mipLevels, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Image& image, Allocation& imageMemory) {
+		vk::ImageCreateInfo imageInfo{
+			   .imageType = vk::ImageType::e2D,
+			   .format = format,
+			   .extent = {width, height, 1},
+			   .mipLevels = mipLevels,
+			   .arrayLayers = 1,
+			   .samples = numSamples,
+			   .tiling = tiling,
+			   .usage = usage,
+			   .sharingMode = vk::SharingMode::eExclusive,
+			   .initialLayout = vk::ImageLayout::eUndefined
+		};
+
+		image = vk::raii::Image(allocator.Device(), imageInfo);
+		imageMemory = allocator.AllocateForImage(image, properties);
+		image.bindMemory(imageMemory.Memory(), imageMemory.Offset());
 	}
 
 	inline vk::raii::ImageView CreateImageView(vk::raii::Device& device, vk::raii::Image& image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels) {
@@ -97,120 +208,82 @@ namespace vku
 		);
 	}
 
-	inline void CreateBuffer(vk::raii::PhysicalDevice& physicalDevice, vk::raii::Device& device,  vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Buffer& buffer, vk::raii::DeviceMemory& bufferMemory) 
+	inline void CreateBuffer(Allocator& allocator, vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::raii::Buffer& buffer, Allocation& bufferMemory) 
 	{
 		vk::BufferCreateInfo bufferInfo{ .size = size, .usage = usage, .sharingMode = vk::SharingMode::eExclusive };
-		buffer = vk::raii::Buffer(device, bufferInfo);
-		vk::MemoryRequirements memRequirements = buffer.getMemoryRequirements();
-		vk::MemoryAllocateInfo allocInfo{ .allocationSize = memRequirements.size, .memoryTypeIndex = FindMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties) };
-		bufferMemory = vk::raii::DeviceMemory(device, allocInfo);
-		buffer.bindMemory(bufferMemory, 0);
+		buffer = vk::raii::Buffer(allocator.Device(), bufferInfo);
+		bufferMemory = allocator.AllocateForBuffer(buffer, properties);
+		buffer.bindMemory(bufferMemory.Memory(), bufferMemory.Offset());
 	}
 
-	inline void CopyBuffer(vk::raii::Device& device, vk::raii::Queue& queue, vk::raii::CommandPool& commandPool, vk::raii::Buffer& srcBuffer, vk::raii::Buffer& dstBuffer, vk::DeviceSize size) {
+	inline void CopyBuffer(vk::raii::Device& device, vk::raii::Queue& queue, vk::raii::CommandPool& commandPool, vk::raii::Buffer& srcBuffer, vk::raii::Buffer& dstBuffer, vk::DeviceSize size, vk::DeviceSize srcOffset = 0, vk::DeviceSize dstOffset = 0) {
 		vk::CommandBufferAllocateInfo allocInfo{ .commandPool = commandPool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 };
 		vk::raii::CommandBuffer commandCopyBuffer = std::move(device.allocateCommandBuffers(allocInfo).front());
 		commandCopyBuffer.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
-		commandCopyBuffer.copyBuffer(*srcBuffer, *dstBuffer, vk::BufferCopy(0, 0, size));
+		commandCopyBuffer.copyBuffer(*srcBuffer, *dstBuffer, vk::BufferCopy(srcOffset, dstOffset, size));
 		commandCopyBuffer.end();
 		queue.submit(vk::SubmitInfo{ .commandBufferCount = 1, .pCommandBuffers = &*commandCopyBuffer }, nullptr);
 		queue.waitIdle();
 	}
 
+	// 한 번 쓰고 GPU 가 읽기만 하는 buffer. UMA / resizable BAR 면 staging 없이 바로 쓰고, 아니면 uploads 에 copy 를 기록
+	inline void CreateBufferWithData(Allocator& allocator, UploadService& uploads, vk::BufferUsageFlags usage, const void* data, vk::DeviceSize size, vk::raii::Buffer& buffer, Allocation& bufferMemory)
+	{
+		if (allocator.SupportsDirectUpload()) {
+			CreateBuffer(allocator, size, usage,
+				vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+				buffer, bufferMemory);
+			std::memcpy(bufferMemory.Mapped(), data, size);
+			return;
+		}
+
+		CreateBuffer(allocator, size, usage | vk::BufferUsageFlagBits::eTransferDst, vk::MemoryPropertyFlagBits::eDeviceLocal, buffer, bufferMemory);
+		uploads.UploadBuffer(*buffer, 0, data, size);
+	}
+
+	// 아래 helper 들은 copy 를 uploads 에 기록만 한다. 사용 전에 uploads.Flush() 의 ticket 을 기다릴 것
 	template<typename T>
 	inline void CreateVertexBuffer(
-		vk::raii::PhysicalDevice& physicalDevice, 
-		vk::raii::Device& device,
-		vk::raii::Queue& queue,
-		vk::raii::CommandPool& commandPool,
+		Allocator& allocator,
+		UploadService& uploads,
 		const std::vector<T>& vertices,
 		vk::raii::Buffer& vertexBuffer,
-		vk::raii::DeviceMemory& vertexBufferMemory)
+		Allocation& vertexBufferMemory)
 	{
-		vk::DeviceSize bufferSize = sizeof(T) * vertices.size();
-
-		vk::raii::Buffer stagingBuffer(nullptr);
-		vk::raii::DeviceMemory stagingMemory(nullptr);
-		CreateBuffer(physicalDevice, device, bufferSize,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-			stagingBuffer, stagingMemory);
-
-		void* data = stagingMemory.mapMemory(0, bufferSize);
-		std::memcpy(data, vertices.data(), (size_t)bufferSize);
-		stagingMemory.unmapMemory();
-
-		CreateBuffer(physicalDevice, device, bufferSize,
-			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-			vk::MemoryPropertyFlagBits::eDeviceLocal,
-			vertexBuffer, vertexBufferMemory);
-
-		CopyBuffer(device, queue, commandPool, stagingBuffer, vertexBuffer, bufferSize);
+		CreateBufferWithData(allocator, uploads, vk::BufferUsageFlagBits::eVertexBuffer, vertices.data(), sizeof(T) * vertices.size(), vertexBuffer, vertexBufferMemory);
 	}
 
 	template<typename T>
 	inline void CreateIndexBuffer(
-		vk::raii::PhysicalDevice& physicalDevice,
-		vk::raii::Device& device,
-		vk::raii::Queue& queue,
-		vk::raii::CommandPool& commandPool,
+		Allocator& allocator,
+		UploadService& uploads,
 		const std::vector<T>& indices,
 		vk::raii::Buffer& indexBuffer,
-		vk::raii::DeviceMemory& indexBufferMemory)
+		Allocation& indexBufferMemory)
 	{
-		vk::DeviceSize bufferSize = sizeof(T) * indices.size();
-
-		vk::raii::Buffer stagingBuffer(nullptr);
-		vk::raii::DeviceMemory stagingMemory(nullptr);
-		CreateBuffer(physicalDevice, device, bufferSize,
-			vk::BufferUsageFlagBits::eTransferSrc,
-			vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-			stagingBuffer, stagingMemory);
-
-		void* data = stagingMemory.mapMemory(0, bufferSize);
-		std::memcpy(data, indices.data(), (size_t)bufferSize);
-		stagingMemory.unmapMemory();
-
-		CreateBuffer(physicalDevice, device, bufferSize,
-			vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-			vk::MemoryPropertyFlagBits::eDeviceLocal,
-			indexBuffer, indexBufferMemory);
-
-		CopyBuffer(device, queue, commandPool, stagingBuffer, indexBuffer, bufferSize);
+		CreateBufferWithData(allocator, uploads, vk::BufferUsageFlagBits::eIndexBuffer, indices.data(), sizeof(T) * indices.size(), indexBuffer, indexBufferMemory);
 	}
 
 	template <typename T>
 	inline void CreateSSBO(
-		vk::raii::PhysicalDevice& physicalDevice,
-		vk::raii::Device& device,
-		vk::raii::Queue& queue,
-		vk::raii::CommandPool& commandPool,
+		Allocator& allocator,
+		UploadService& uploads,
 		vk::DeviceSize bufferSize,
-		vk::BufferUsageFlags stagingUsage, 
-		vk::MemoryPropertyFlags stagingProperties,
-		std::vector<T>& data,
+		const std::vector<T>& data,
 		vk::BufferUsageFlags ssboUsage,
 		vk::MemoryPropertyFlags ssboProperties,
 		vk::raii::Buffer& ssbo, 
-		vk::raii::DeviceMemory& ssboMem
+		Allocation& ssboMem
 	)
 	{
-		vk::raii::Buffer stagingBuffer({});
-		vk::raii::DeviceMemory stagingBufferMemory({});
-		vku::CreateBuffer(physicalDevice, device, bufferSize, stagingUsage, stagingProperties, stagingBuffer, stagingBufferMemory);
-
-		void* dataStaging = stagingBufferMemory.mapMemory(0, bufferSize);
-		memcpy(dataStaging, data.data(), (size_t)bufferSize);
-		stagingBufferMemory.unmapMemory();
-
 		ssbo.clear();
-		ssboMem.clear();
+		ssboMem.Reset();
 
 		vk::raii::Buffer shaderStorageBufferTemp({});
-		vk::raii::DeviceMemory shaderStorageBufferTempMemory({});
-		vku::CreateBuffer(physicalDevice, device, bufferSize, ssboUsage, ssboProperties, shaderStorageBufferTemp, shaderStorageBufferTempMemory);
-		vku::CopyBuffer(device, queue, commandPool, stagingBuffer, shaderStorageBufferTemp, bufferSize);
+		Allocation shaderStorageBufferTempMemory;
+		vku::CreateBuffer(allocator, bufferSize, ssboUsage | vk::BufferUsageFlagBits::eTransferDst, ssboProperties, shaderStorageBufferTemp, shaderStorageBufferTempMemory);
+		uploads.UploadBuffer(*shaderStorageBufferTemp, 0, data.data(), bufferSize);
 		ssbo = std::move(shaderStorageBufferTemp);
 		ssboMem = std::move(shaderStorageBufferTempMemory);
 	}
-}
\ No newline at end of file
+}
@@ -1,10 +1,28 @@
 #include "context.h"
 #include "camera.h"
 #include "mouse_interactor.h"
+#include "cpu_profiler.h"
 
 #include "window.h"
 
-Window::Window()
+Window::Window(const AppOptions& options)
+	: init_width_(options.width), init_height_(options.height), cpu_trace_output_(options.cpu_trace_output)
+{
+	glfwInit();
+
+	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+	glfw_window_ = glfwCreateWindow(init_width_, init_height_, "Vulkan", nullptr, nullptr);
+
+	// #include "context.h"
+#include "camera.h"
+#include "mouse_interactor.h"
+#include "cpu_profiler.h"
+
+#include "window.h"
+
+Window::Window(const AppOptions& options)
+	: init_width_(options.width), init_height_(options.height), cpu_trace_output_(options.cpu_trace_output)
 {
 	glfwInit();
 
@@ -26,7 +44,7 @@ Window::Window()
 		std::cerr << "Failure creating glfw window " << std::endl;
 	}
 
-	ctx_ = std::make_unique<Context>(glfw_window_, init_width_, init_height_);
+	ctx_ = std::make_unique<Context>(glfw_window_, init_width_, init_height_, options);
 	camera_ = std::make_unique<Camera>();
 	mouse_interactor_ = std::make_unique<MouseInteractor>();
 
@@ -112,6 +130,15 @@ void Window::OnKey(int key, int scancode, int action, int mods) {
 			glfwSetInputMode(glfw_window_, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 		}
 	}
+
+	// F9 : 지금까지의 CPU 구간 기록을 Chrome trace 로 저장
+	if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+#if PE_CPU_PROFILER_ENABLED
+		CpuProfiler::WriteChromeTrace("cpu_trace.json");
+#else
+		std::cout << "cpu profiler is disabled (build with POWERENGINE_CPU_PROFILER=ON)" << std::endl;
+#endif
+	}
 }
 
 void Window::OnMouseClick(int button, int action, int mods)
@@ -138,18 +165,32 @@ void Window::run()
 	double lastTime = glfwGetTime();
 
 	while (!glfwWindowShouldClose(glfw_window_)) {
+		PE_CPU_SCOPE("Frame");
+
 		double current = glfwGetTime();
 		float dt = static_cast<float>(current - lastTime);
 		lastTime = current;
 
-		glfwPollEvents();
-		ProcessKeyboard(dt);
+		{
+			PE_CPU_SCOPE("glfwPollEvents");
+			glfwPollEvents();
+		}
+		{
+			PE_CPU_SCOPE("ProcessKeyboard");
+			ProcessKeyboard(dt);
+		}
 
 		ctx_->Update(*camera_, *mouse_interactor_, dt);
 		ctx_->Draw();
 	}
 
 	ctx_->WaitIdle();
+
+#if PE_CPU_PROFILER_ENABLED
+	if (!cpu_trace_output_.empty()) {
+		CpuProfiler::WriteChromeTrace(cpu_trace_output_);
+	}
+#endif
 }
 
 void Window::ProcessKeyboard(float dt) {
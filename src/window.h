@@ -1,6 +1,7 @@
 #pragma once
 
 #include "camera.h"
+#include "app_options.h"
 
 class Context;
 struct Camera;
@@ -9,7 +10,30 @@ class MouseInteractor;
 class Window
 {
 public:
-    Window();
+    explicit Window(const AppOptions& options);
+    Window(const Window& rhs) = delete;
+    Window(Window&& rhs) = delete;
+    ~Window();
+
+    Window& operator=(const Window& rhs) = delete;
+    Window& operator=(Window&& rhs) = delete;
+
+    void run();
+
+private:
+    // GLFW媛#pragma once
+
+#include "camera.h"
+#include "app_options.h"
+
+class Context;
+struct Camera;
+class MouseInteractor;
+
+class Window
+{
+public:
+    explicit Window(const AppOptions& options);
     Window(const Window& rhs) = delete;
     Window(Window&& rhs) = delete;
     ~Window();
@@ -46,5 +70,7 @@ private:
 
     bool first_mouse_ = true;
 
+    std::string cpu_trace_output_;
+
     void ProcessKeyboard(float dt);
 };
@@ -0,0 +1,238 @@
+// GPU primitive (gpu_primitives.h) 寃// GPU primitive (gpu_primitives.h) 검증 + 대역폭 측정. window 없이 compute queue 하나만 쓴다
+// 무작위 입력으로 scan / reduce / compact / radix sort 를 돌려 std:: 결과와 비교하고, timestamp query 로 잰 최소 시간과
+// 유효 대역폭 (입력 + 출력 byte / 시간) 을 출력한다. 먼저 workgroup / tile 경계 전후의 작은 크기들로 꼬리 처리를 검증하고
+// 마지막에 count 로 측정한다. 하나라도 다르면 0 이 아닌 값으로 끝난다. build 디렉터리에서 실행 (shaders/*.spv 를 읽는다)
+//   gpu_primitives_bench [count] [iterations]
+#include "headless_device.h"
+#include "gpu_primitives.h"
+
+namespace {
+    struct Gpu : HeadlessDevice {
+        vk::raii::QueryPool query_pool{ nullptr };
+        float timestamp_period_ns = 0.0f;
+        uint64_t timestamp_mask = ~0ull;
+    };
+
+    void CreateGpu(Gpu& gpu)
+    {
+        CreateHeadlessDevice(gpu, "gpu_primitives_bench");
+        if (gpu.timestamp_valid_bits == 0) {
+            throw std::runtime_error("compute queue does not support timestamps!");
+        }
+        gpu.timestamp_mask = gpu.timestamp_valid_bits >= 64 ? ~0ull : ((1ull << gpu.timestamp_valid_bits) - 1);
+        gpu.timestamp_period_ns = gpu.physical_device.getProperties().limits.timestampPeriod;
+        gpu.query_pool = vk::raii::QueryPool(gpu.device, vk::QueryPoolCreateInfo{ .queryType = vk::QueryType::eTimestamp, .queryCount = 2 });
+    }
+
+    struct DeviceArray {
+        vk::raii::Buffer buffer{ nullptr };
+        vku::Allocation memory;
+        uint32_t count = 0;
+
+        vk::DescriptorBufferInfo Info() const { return { *buffer, 0, VK_WHOLE_SIZE }; }
+    };
+
+    void CreateArray(Gpu& gpu, uint32_t count, DeviceArray& array)
+    {
+        array.count = count;
+        vku::CreateBuffer(*gpu.allocator, sizeof(uint32_t) * std::max(count, 1u),
+            vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, array.buffer, array.memory);
+    }
+
+    void Upload(Gpu& gpu, const std::vector<uint32_t>& data, DeviceArray& array)
+    {
+        const vk::DeviceSize size = sizeof(uint32_t) * data.size();
+        vk::raii::Buffer staging{ nullptr };
+        vku::Allocation stagingMemory;
+        vku::CreateBuffer(*gpu.allocator, size, vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, staging, stagingMemory);
+        std::memcpy(stagingMemory.Mapped(), data.data(), size);
+        vku::CopyBuffer(gpu.device, gpu.queue, gpu.command_pool, staging, array.buffer, size);
+    }
+
+    std::vector<uint32_t> Download(Gpu& gpu, DeviceArray& array, uint32_t count)
+    {
+        const vk::DeviceSize size = sizeof(uint32_t) * count;
+        vk::raii::Buffer staging{ nullptr };
+        vku::Allocation stagingMemory;
+        vku::CreateBuffer(*gpu.allocator, size, vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, staging, stagingMemory);
+        vku::CopyBuffer(gpu.device, gpu.queue, gpu.command_pool, array.buffer, staging, size);
+        std::vector<uint32_t> data(count);
+        std::memcpy(data.data(), stagingMemory.Mapped(), size);
+        return data;
+    }
+
+    // prepare (입력 복원 copy 등) 는 시간에 넣지 않는다. iteration 중 최소 GPU 시간 (ms)
+    template <typename Prepare, typename Run>
+    double TimeBest(Gpu& gpu, uint32_t iterations, Prepare&& prepare, Run&& run)
+    {
+        vk::CommandBufferAllocateInfo allocInfo{ .commandPool = *gpu.command_pool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 };
+        vk::raii::CommandBuffer cmd = std::move(gpu.device.allocateCommandBuffers(allocInfo).front());
+
+        double best = std::numeric_limits<double>::max();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            cmd.reset();
+            cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+            cmd.resetQueryPool(*gpu.query_pool, 0, 2);
+            prepare(cmd);
+            vk::MemoryBarrier2 barrier{
+                .srcStageMask = vk::PipelineStageFlagBits2::eTransfer | vk::PipelineStageFlagBits2::eComputeShader,
+                .srcAccessMask = vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eShaderWrite,
+                .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                .dstAccessMask = vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite
+            };
+            cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+            cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *gpu.query_pool, 0);
+            run(cmd);
+            cmd.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands, *gpu.query_pool, 1);
+            cmd.end();
+            gpu.queue.submit(vk::SubmitInfo{ .commandBufferCount = 1, .pCommandBuffers = &*cmd }, nullptr);
+            gpu.queue.waitIdle();
+
+            auto [result, timestamps] = gpu.query_pool.getResults<uint64_t>(0, 2, 2 * sizeof(uint64_t), sizeof(uint64_t),
+                vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+            const uint64_t ticks = ((timestamps[1] & gpu.timestamp_mask) - (timestamps[0] & gpu.timestamp_mask)) & gpu.timestamp_mask;
+            best = std::min(best, static_cast<double>(ticks) * gpu.timestamp_period_ns * 1e-6);
+        }
+        return best;
+    }
+
+    void RecordCopy(const vk::raii::CommandBuffer& cmd, const DeviceArray& src, const DeviceArray& dst)
+    {
+        cmd.copyBuffer(*src.buffer, *dst.buffer, vk::BufferCopy(0, 0, sizeof(uint32_t) * src.count));
+    }
+
+    bool Report(const char* name, double ms, double bytes, bool ok, double mkeys = 0.0)
+    {
+        std::cout << std::left << std::setw(10) << name << std::right
+            << std::setw(9) << ms << " ms  " << std::setw(8) << bytes / (ms * 1e6) << " GB/s";
+        if (mkeys > 0.0) std::cout << "  " << std::setw(8) << mkeys << " Mkeys/s";
+        std::cout << (ok ? "" : "  ** mismatch **") << std::endl;
+        return ok;
+    }
+}
+
+    // count 개 무작위 입력으로 모든 primitive 를 돌린다. 다르면 false
+    bool RunAll(Gpu& gpu, uint32_t count, uint32_t iterations, std::mt19937& rng)
+    {
+        std::vector<uint32_t> keys(count), small(count), flags(count), indices(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            keys[i] = rng();
+            small[i] = rng() & 0xff;
+            flags[i] = rng() & 1u;
+            indices[i] = i;
+        }
+
+        DeviceArray keysSource, smallSource, flagsArray, indicesSource, work, work2, result;
+        CreateArray(gpu, count, keysSource);
+        CreateArray(gpu, count, smallSource);
+        CreateArray(gpu, count, flagsArray);
+        CreateArray(gpu, count, indicesSource);
+        CreateArray(gpu, count, work);
+        CreateArray(gpu, count, work2);
+        CreateArray(gpu, 1, result);
+        Upload(gpu, keys, keysSource);
+        Upload(gpu, small, smallSource);
+        Upload(gpu, flags, flagsArray);
+        Upload(gpu, indices, indicesSource);
+
+        std::cout << count << " elements, best of " << iterations << std::endl;
+        const double n = static_cast<double>(count);
+        const auto nothing = [](const vk::raii::CommandBuffer&) {};
+        bool ok = true;
+
+        // exclusive scan : 읽기 n + 쓰기 n
+        {
+            vku::PrefixSum scan(gpu.device, *gpu.allocator, count);
+            scan.SetBuffers(smallSource.Info(), work.Info());
+            const double ms = TimeBest(gpu, iterations, nothing, [&](const vk::raii::CommandBuffer& cmd) { scan.Record(cmd, count); });
+
+            std::vector<uint32_t> expected(count);
+            std::exclusive_scan(small.begin(), small.end(), expected.begin(), 0u);
+            ok &= Report("scan", ms, 8.0 * n, Download(gpu, work, count) == expected);
+        }
+
+        // reduce : 읽기 n. 합은 uint32 에서 wrap
+        for (vku::ReduceOp op : { vku::ReduceOp::Sum, vku::ReduceOp::Min, vku::ReduceOp::Max }) {
+            vku::Reduce reduce(gpu.device, *gpu.allocator, count, op);
+            reduce.SetBuffers(keysSource.Info(), result.Info());
+            const double ms = TimeBest(gpu, iterations, nothing, [&](const vk::raii::CommandBuffer& cmd) { reduce.Record(cmd, count); });
+
+            uint32_t expected = 0;
+            const char* name = "";
+            switch (op) {
+            case vku::ReduceOp::Sum: expected = std::reduce(keys.begin(), keys.end(), 0u); name = "reduce+"; break;
+            case vku::ReduceOp::Min: expected = *std::min_element(keys.begin(), keys.end()); name = "reduce<"; break;
+            case vku::ReduceOp::Max: expected = *std::max_element(keys.begin(), keys.end()); name = "reduce>"; break;
+            }
+            ok &= Report(name, ms, 4.0 * n, Download(gpu, result, 1).front() == expected);
+        }
+
+        // compact : values / flags 읽기 + 남은 원소 쓰기
+        {
+            vku::Compact compact(gpu.device, *gpu.allocator, count);
+            compact.SetBuffers(keysSource.Info(), flagsArray.Info(), work.Info(), result.Info());
+            const double ms = TimeBest(gpu, iterations, nothing, [&](const vk::raii::CommandBuffer& cmd) { compact.Record(cmd, count); });
+
+            std::vector<uint32_t> expected;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (flags[i]) expected.push_back(keys[i]);
+            }
+            // 남은 원소가 없으면 읽어올 것도 없다 (크기 0 인 staging buffer 는 만들 수 없다)
+            const uint32_t kept = Download(gpu, result, 1).front();
+            const bool same = kept == expected.size() && (kept == 0 || Download(gpu, work, kept) == expected);
+            ok &= Report("compact", ms, 8.0 * n + 4.0 * static_cast<double>(expected.size()), same);
+        }
+
+        // radix sort : key / value 를 pass 마다 읽고 쓴다 (histogram pass 의 key 읽기 제외)
+        {
+            vku::RadixSort sort(gpu.device, *gpu.allocator, count);
+            sort.SetBuffers(work.Info(), work2.Info());
+            const double ms = TimeBest(gpu, iterations,
+                [&](const vk::raii::CommandBuffer& cmd) { RecordCopy(cmd, keysSource, work); RecordCopy(cmd, indicesSource, work2); },
+                [&](const vk::raii::CommandBuffer& cmd) { sort.Record(cmd, count); });
+
+            // 같은 key 는 입력 순서 (= value 오름차순) 여야 한다
+            std::vector<uint32_t> order = indices;
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+            std::vector<uint32_t> expectedKeys(count);
+            std::transform(order.begin(), order.end(), expectedKeys.begin(), [&](uint32_t i) { return keys[i]; });
+            const bool same = Download(gpu, work, count) == expectedKeys && Download(gpu, work2, count) == order;
+            ok &= Report("sort", ms, 16.0 * n * RADIX_PASSES, same, n / (ms * 1e3));
+        }
+
+        return ok;
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t count = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : (1u << 22);
+    const uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 10;
+    if (count == 0) {
+        std::cerr << "count must be positive" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Gpu gpu;
+        CreateGpu(gpu);
+        std::cout << std::fixed << std::setprecision(3);
+
+        // workgroup 256, reduce / radix tile 2048 (= 256 * 8) 전후와 level 이 늘어나는 크기
+        std::mt19937 rng(1234);
+        bool ok = true;
+        for (uint32_t size : { 1u, 255u, 256u, 257u, 2047u, 2049u, 65537u, 100003u }) {
+            ok &= RunAll(gpu, size, 1, rng);
+        }
+        ok &= RunAll(gpu, count, iterations, rng);
+
+        std::cout << (ok ? "all passed" : "FAILED") << std::endl;
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
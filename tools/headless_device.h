@@ -0,0 +1,78 @@
+#pragma once
+
+// tools 怨듭슜 : window / surface #pragma once
+
+// tools 공용 : window / surface 없이 compute queue 하나로 Vulkan device 를 만든다
+#include "vulkan_utils.h"
+
+struct HeadlessDevice {
+    vk::raii::Context context;
+    vk::raii::Instance instance{ nullptr };
+    vk::raii::PhysicalDevice physical_device{ nullptr };
+    vk::raii::Device device{ nullptr };
+    vk::raii::Queue queue{ nullptr };
+    uint32_t queue_family = ~0u;
+    uint32_t timestamp_valid_bits = 0; // 0 이면 이 queue 에서 timestamp 를 쓸 수 없다
+    vk::raii::CommandPool command_pool{ nullptr };
+    std::unique_ptr<vku::Allocator> allocator;
+};
+
+// Vulkan 1.3 이고 compute queue 가 있는 첫 device. timestamp 를 쓸 수 있는 queue family 를 먼저 고른다.
+// UploadService 가 timeline semaphore 를, primitive 들이 synchronization2 를 쓴다
+inline void CreateHeadlessDevice(HeadlessDevice& gpu, const char* applicationName)
+{
+    const vk::ApplicationInfo appInfo{ .pApplicationName = applicationName,
+                .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
+                .pEngineName = "Power Engine",
+                .engineVersion = VK_MAKE_VERSION(1, 0, 0),
+                .apiVersion = vk::ApiVersion13 };
+    gpu.instance = vk::raii::Instance(gpu.context, vk::InstanceCreateInfo{ .pApplicationInfo = &appInfo });
+
+    for (vk::raii::PhysicalDevice& physicalDevice : gpu.instance.enumeratePhysicalDevices()) {
+        if (physicalDevice.getProperties().apiVersion < VK_API_VERSION_1_3) continue;
+        const std::vector<vk::QueueFamilyProperties> families = physicalDevice.getQueueFamilyProperties();
+        uint32_t family = ~0u;
+        for (uint32_t i = 0; i < families.size(); ++i) {
+            if (!(families[i].queueFlags & vk::QueueFlagBits::eCompute)) continue;
+            if (family == ~0u || (families[family].timestampValidBits == 0 && families[i].timestampValidBits != 0)) {
+                family = i;
+            }
+        }
+        if (family != ~0u) {
+            gpu.queue_family = family;
+            gpu.timestamp_valid_bits = families[family].timestampValidBits;
+            gpu.physical_device = std::move(physicalDevice);
+            break;
+        }
+    }
+    if (gpu.queue_family == ~0u) {
+        throw std::runtime_error("failed to find a Vulkan 1.3 device with a compute queue!");
+    }
+    std::cout << "device : " << gpu.physical_device.getProperties().deviceName.data() << std::endl;
+
+    vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features> featureChain = {
+        {},
+        { .timelineSemaphore = vk::True },
+        { .synchronization2 = vk::True }
+    };
+    float queuePriority = 0.0f;
+    vk::DeviceQueueCreateInfo queueInfo{ .queueFamilyIndex = gpu.queue_family, .queueCount = 1, .pQueuePriorities = &queuePriority };
+    vk::DeviceCreateInfo deviceInfo{ .pNext = &featureChain.get<vk::PhysicalDeviceFeatures2>(), .queueCreateInfoCount = 1, .pQueueCreateInfos = &queueInfo };
+    gpu.device = vk::raii::Device(gpu.physical_device, deviceInfo);
+    gpu.queue = vk::raii::Queue(gpu.device, gpu.queue_family, 0);
+    gpu.command_pool = vk::raii::CommandPool(gpu.device, vk::CommandPoolCreateInfo{ .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer, .queueFamilyIndex = gpu.queue_family });
+    gpu.allocator = std::make_unique<vku::Allocator>(gpu.physical_device, gpu.device);
+}
+
+// command buffer 하나에 record 를 기록해서 submit 하고 queue idle 까지 기다린다
+template <typename F>
+inline void SubmitAndWait(HeadlessDevice& gpu, F&& record)
+{
+    vk::CommandBufferAllocateInfo allocInfo{ .commandPool = *gpu.command_pool, .level = vk::CommandBufferLevel::ePrimary, .commandBufferCount = 1 };
+    vk::raii::CommandBuffer cmd = std::move(gpu.device.allocateCommandBuffers(allocInfo).front());
+    cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    record(cmd);
+    cmd.end();
+    gpu.queue.submit(vk::SubmitInfo{ .commandBufferCount = 1, .pCommandBuffers = &*cmd }, nullptr);
+    gpu.queue.waitIdle();
+}
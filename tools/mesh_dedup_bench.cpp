@@ -0,0 +1,93 @@
+// vertex dedup micro-benchmark : 諛깅쭔 triangle grid 瑜// vertex dedup micro-benchmark : 백만 triangle grid 를 glTF 처럼 triangle 마다 vertex 를 풀어놓은 뒤
+// 예전 방식 (std::unordered_map + std::hash<Vertex>, index 마다 한 번 더 lookup) 과 VertexDeduplicator 를 비교한다
+//   mesh_dedup_bench [iterations]
+#include "vertex.h"
+#include "mesh_import.h"
+
+namespace {
+    // (n+1)^2 개의 unique vertex, 2n^2 개의 triangle. n = 708 이면 약 100만 triangle
+    std::vector<Vertex> BuildUnindexedGrid(int n)
+    {
+        std::vector<Vertex> corners;
+        corners.reserve(static_cast<size_t>(n + 1) * (n + 1));
+        for (int y = 0; y <= n; ++y) {
+            for (int x = 0; x <= n; ++x) {
+                const float u = static_cast<float>(x) / n;
+                const float v = static_cast<float>(y) / n;
+                corners.push_back({ glm::vec3(u * 2.0f - 1.0f, std::sin(u * 12.0f) * std::cos(v * 9.0f) * 0.1f, v * 2.0f - 1.0f), glm::vec2(u, v) });
+            }
+        }
+
+        std::vector<Vertex> soup;
+        soup.reserve(static_cast<size_t>(n) * n * 6);
+        auto at = [&](int x, int y) { return corners[static_cast<size_t>(y) * (n + 1) + x]; };
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                soup.push_back(at(x, y)); soup.push_back(at(x, y + 1)); soup.push_back(at(x + 1, y));
+                soup.push_back(at(x + 1, y)); soup.push_back(at(x, y + 1)); soup.push_back(at(x + 1, y + 1));
+            }
+        }
+        return soup;
+    }
+
+    // 예전 Model::LoadModel 과 같은 방식
+    void DedupLegacy(const std::vector<Vertex>& soup, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+        for (const Vertex& vertex : soup) {
+            if (!uniqueVertices.contains(vertex)) {
+                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(vertex);
+            }
+        }
+        for (const Vertex& vertex : soup) {
+            indices.push_back(uniqueVertices[vertex]);
+        }
+    }
+
+    void DedupFlat(const std::vector<Vertex>& soup, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        vertices.reserve(soup.size());
+        indices.reserve(soup.size());
+        VertexDeduplicator dedup(vertices, soup.size());
+        for (const Vertex& vertex : soup) {
+            indices.push_back(dedup.Insert(vertex));
+        }
+    }
+
+    template <typename F>
+    double BestOf(uint32_t iterations, const std::vector<Vertex>& soup, F&& dedup, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            vertices.clear(); vertices.shrink_to_fit();
+            indices.clear(); indices.shrink_to_fit();
+
+            const auto start = std::chrono::steady_clock::now();
+            dedup(soup, vertices, indices);
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    const uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 5;
+
+    const std::vector<Vertex> soup = BuildUnindexedGrid(708);
+    std::cout << soup.size() / 3 << " triangles, " << soup.size() << " vertex references" << std::endl;
+
+    std::vector<Vertex> legacyVertices, flatVertices;
+    std::vector<uint32_t> legacyIndices, flatIndices;
+    const double legacyMs = BestOf(iterations, soup, DedupLegacy, legacyVertices, legacyIndices);
+    const double flatMs = BestOf(iterations, soup, DedupFlat, flatVertices, flatIndices);
+
+    // 두 방식 모두 처음 나온 순서대로 vertex 를 추가하므로 결과가 같아야 한다
+    const bool same = legacyIndices == flatIndices && legacyVertices.size() == flatVertices.size();
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "unordered_map : " << legacyMs << " ms (" << legacyVertices.size() << " unique)" << std::endl
+        << "flat hash     : " << flatMs << " ms (" << flatVertices.size() << " unique)" << std::endl
+        << "speedup       : " << legacyMs / flatMs << "x" << (same ? "" : "  ** results differ **") << std::endl;
+    return same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// mesh tool (pmesh_convert, mesh_dedup_bench) #pragma once
+
+// mesh tool (pmesh_convert, mesh_dedup_bench) 용 pch. src/pch.h 에서 window / GPU 쪽 (GLFW, ImGui, KTX) 을 뺀 것.
+// Vulkan 은 Vertex 의 vertex input description 때문에 header 만 쓴다 (loader 는 link 하지 않는다)
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <unordered_map>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <queue>
+#include <deque>
+#include <tuple>
+#include <latch>
+#include <atomic>
+
+#define VULKAN_HPP_DISPATCH_LOADER_DYNAMIC 1
+#include <vulkan/vulkan.hpp>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_RIGHT_HANDED
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include <tiny_gltf.h>
@@ -0,0 +1,62 @@
+// glTF -> .pmesh 蹂// glTF -> .pmesh 변환기. asset pipeline 에서 cache 를 미리 구워두면 첫 실행에서도 import 를 건너뛴다
+//   pmesh_convert <model.gltf>...          각 model 옆에 <model>.pmesh 를 쓴다
+//   pmesh_convert <model.gltf> -o <out>    출력 경로 지정 (입력 1개일 때만)
+#include "vertex.h"
+#include "mesh_import.h"
+#include "mesh_cache.h"
+#include "mesh_lod.h"
+#include "meshlet.h"
+#include "mesh_sdf.h"
+
+int main(int argc, char** argv) {
+    try {
+        std::vector<std::string> inputs;
+        std::string output;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "-o" && i + 1 < argc) {
+                output = argv[++i];
+            }
+            else {
+                inputs.push_back(arg);
+            }
+        }
+
+        if (inputs.empty() || (!output.empty() && inputs.size() != 1)) {
+            std::cerr << "usage: pmesh_convert <model.gltf>... | pmesh_convert <model.gltf> -o <out.pmesh>" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        for (const std::string& input : inputs) {
+            const auto start = std::chrono::steady_clock::now();
+
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+            ImportGltfMesh(input, vertices, indices);
+            std::vector<pmesh::Lod> lods;
+            BuildLodChain(vertices, indices, lods);
+            pmesh::Meshlets meshlets;
+            BuildMeshlets(vertices, indices.data(), lods[0].index_count, meshlets);
+            pmesh::Sdf sdf;
+            BakeSdf(vertices, indices, lods, sdf);
+
+            const std::string path = output.empty() ? pmesh::CachePathFor(input) : output;
+            pmesh::Write(path, pmesh::HashSource(input), pmesh::StampSource(input), vertices, indices, lods, meshlets, sdf);
+
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << input << " -> " << path << ": " << vertices.size() << " vertices, "
+                << lods[0].index_count / 3 << " triangles, " << lods.size() << " LODs (";
+            for (size_t i = 0; i < lods.size(); ++i) {
+                std::cout << (i ? " / " : "") << lods[i].index_count / 3;
+            }
+            std::cout << "), " << meshlets.meshlets.size() << " meshlets, SDF " << sdf.volume.resolution.x << "x" << sdf.volume.resolution.y << "x"
+                << sdf.volume.resolution.z << ", " << ms << " ms" << std::endl;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+// 泥// 천 self-collision 의 spatial hash build (hash_count -> PrefixSum -> hash_scatter) 를 CPU counting sort 와 비교한다.
+// window 없이 compute queue 하나만 쓰고, 하나라도 다르면 0 이 아닌 값으로 끝난다. build 디렉터리에서 실행 (shaders/*.spv 를 읽는다)
+//   spatial_hash_check
+#include "headless_device.h"
+#include "upload_service.h"
+#include "particle_store.h"
+#include "spatial_hash.h"
+
+namespace {
+    // 1. PrefixSum 단독 : workgroup (256) 경계와 level 이 늘어나는 경계 전후
+    bool CheckPrefixSum(HeadlessDevice& gpu, uint32_t count, std::mt19937& rng)
+    {
+        std::vector<uint32_t> values(count);
+        for (uint32_t& v : values) v = rng() & 0xff;
+
+        const vk::DeviceSize size = sizeof(uint32_t) * count;
+        vk::raii::Buffer input{ nullptr }, output{ nullptr }, staging{ nullptr };
+        vku::Allocation inputMemory, outputMemory, stagingMemory;
+        vku::CreateBuffer(*gpu.allocator, size, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, input, inputMemory);
+        vku::CreateBuffer(*gpu.allocator, size, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, output, outputMemory);
+        vku::CreateBuffer(*gpu.allocator, size, vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, staging, stagingMemory);
+        std::memcpy(stagingMemory.Mapped(), values.data(), size);
+        vku::CopyBuffer(gpu.device, gpu.queue, gpu.command_pool, staging, input, size);
+
+        vku::PrefixSum scan(gpu.device, *gpu.allocator, count);
+        scan.SetBuffers({ *input, 0, VK_WHOLE_SIZE }, { *output, 0, VK_WHOLE_SIZE });
+        SubmitAndWait(gpu, [&](const vk::raii::CommandBuffer& cmd) {
+            scan.Record(cmd, count);
+            vk::MemoryBarrier2 barrier{
+                .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader, .srcAccessMask = vk::AccessFlagBits2::eShaderWrite,
+                .dstStageMask = vk::PipelineStageFlagBits2::eTransfer, .dstAccessMask = vk::AccessFlagBits2::eTransferRead
+            };
+            cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+            cmd.copyBuffer(*output, *staging, vk::BufferCopy(0, 0, size));
+        });
+
+        std::vector<uint32_t> expected(count), result(count);
+        std::exclusive_scan(values.begin(), values.end(), expected.begin(), 0u);
+        std::memcpy(result.data(), stagingMemory.Mapped(), size);
+
+        const auto mismatch = std::mismatch(result.begin(), result.end(), expected.begin());
+        const bool ok = mismatch.first == result.end();
+        std::cout << "prefix sum  " << std::setw(8) << count;
+        if (ok) {
+            std::cout << "  ok" << std::endl;
+        }
+        else {
+            std::cout << "  ** mismatch at " << (mismatch.first - result.begin()) << " : " << *mismatch.first << " != " << *mismatch.second << " **" << std::endl;
+        }
+        return ok;
+    }
+
+    // 2. hash build : bucket 별 count / 시작 위치는 정확히 같아야 하고, bucket 안의 순서는 atomicAdd 순서라
+    // 정렬해서 CPU counting sort (particle 번호 오름차순) 와 비교한다
+    bool CheckHashBuild(HeadlessDevice& gpu, UploadService& uploads, const char* name, const std::vector<glm::vec4>& positions, float distance)
+    {
+        ParticleStore particles(*gpu.allocator, uploads, positions);
+        SpatialHash hash(gpu.device, *gpu.allocator, uploads, particles, positions);
+        uploads.Wait(uploads.Flush());
+
+        SubmitAndWait(gpu, [&](const vk::raii::CommandBuffer& cmd) {
+            hash.RecordBuild(cmd, distance);
+            vk::MemoryBarrier2 barrier{
+                .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader, .srcAccessMask = vk::AccessFlagBits2::eShaderWrite,
+                .dstStageMask = vk::PipelineStageFlagBits2::eTransfer, .dstAccessMask = vk::AccessFlagBits2::eTransferRead
+            };
+            cmd.pipelineBarrier2(vk::DependencyInfo{ .memoryBarrierCount = 1, .pMemoryBarriers = &barrier });
+        });
+        const SpatialHash::Table table = hash.Download(*gpu.allocator, gpu.queue, gpu.command_pool);
+
+        const uint32_t count = static_cast<uint32_t>(positions.size());
+        const uint32_t tableMask = hash.TableSize() - 1;
+        std::vector<uint32_t> buckets(count), counts(hash.TableSize(), 0u), starts(hash.TableSize());
+        for (uint32_t i = 0; i < count; ++i) {
+            buckets[i] = SpatialHashBucket(SpatialHashCell(glm::vec3(positions[i]), distance), tableMask);
+            ++counts[buckets[i]];
+        }
+        std::exclusive_scan(counts.begin(), counts.end(), starts.begin(), 0u);
+        std::vector<uint32_t> sorted(count);
+        std::vector<uint32_t> cursor = starts;
+        for (uint32_t i = 0; i < count; ++i) {
+            sorted[cursor[buckets[i]]++] = i;
+        }
+
+        uint32_t maxBucket = 0;
+        uint32_t badCounts = 0, badStarts = 0, badBuckets = 0;
+        for (uint32_t b = 0; b < hash.TableSize(); ++b) {
+            maxBucket = std::max(maxBucket, counts[b]);
+            if (table.counts[b] != counts[b]) { ++badCounts; continue; }
+            if (table.starts[b] != starts[b]) { ++badStarts; continue; }
+            std::vector<uint32_t> slice(table.sorted.begin() + starts[b], table.sorted.begin() + starts[b] + counts[b]);
+            std::sort(slice.begin(), slice.end());
+            if (!std::equal(slice.begin(), slice.end(), sorted.begin() + starts[b])) ++badBuckets;
+        }
+
+        const bool ok = badCounts == 0 && badStarts == 0 && badBuckets == 0;
+        std::cout << "hash build  " << std::setw(8) << count << "  " << std::left << std::setw(10) << name << std::right
+            << "  table " << hash.TableSize() << ", largest bucket " << maxBucket;
+        if (ok) {
+            std::cout << "  ok" << std::endl;
+        }
+        else {
+            std::cout << "  ** bad counts " << badCounts << ", starts " << badStarts << ", buckets " << badBuckets << " **" << std::endl;
+        }
+        return ok;
+    }
+
+    // GPU 의 p / cellSize 는 정확히 반올림된다는 보장이 없어 cell 경계 위의 점은 CPU 와 다른 cell 로 갈 수 있다.
+    // 그래서 점은 cell 중심에서 0.4 cell 안쪽에만 둔다
+    glm::vec4 PointInCell(const glm::ivec3& cell, float cellSize, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> jitter(-0.4f, 0.4f);
+        const glm::vec3 p = (glm::vec3(cell) + 0.5f + glm::vec3(jitter(rng), jitter(rng), jitter(rng))) * cellSize;
+        return glm::vec4(p, 1.0f);
+    }
+
+    // 넓게 흩어진 점 : 대부분 bucket 에 하나, 가끔 hash 충돌
+    std::vector<glm::vec4> RandomPositions(uint32_t count, float cellSize, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<int> cell(-200, 200);
+        std::vector<glm::vec4> positions(count);
+        for (glm::vec4& p : positions) p = PointInCell({ cell(rng), cell(rng), cell(rng) }, cellSize, rng);
+        return positions;
+    }
+
+    // 원점 근처 (음수 좌표 포함) 의 3x3x3 cell 에 몰린 점 : 큰 bucket 에서 atomicAdd 가 많이 겹친다
+    std::vector<glm::vec4> ClusteredPositions(uint32_t count, float cellSize, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<int> cell(-2, 0);
+        std::vector<glm::vec4> positions(count);
+        for (glm::vec4& p : positions) p = PointInCell({ cell(rng), cell(rng), cell(rng) }, cellSize, rng);
+        return positions;
+    }
+}
+
+int main() {
+    try {
+        HeadlessDevice gpu;
+        CreateHeadlessDevice(gpu, "spatial_hash_check");
+        UploadService uploads(*gpu.allocator, gpu.queue, gpu.queue_family, nullptr, gpu.queue_family);
+
+        std::mt19937 rng(1234);
+        bool ok = true;
+
+        for (uint32_t count : { 1u, 255u, 256u, 257u, 65535u, 65537u, 1000003u }) {
+            ok &= CheckPrefixSum(gpu, count, rng);
+        }
+
+        constexpr float kDistance = 0.05f;
+        for (uint32_t count : { 1u, 127u, 129u, 1000u, 100003u }) {
+            ok &= CheckHashBuild(gpu, uploads, "random", RandomPositions(count, kDistance, rng), kDistance);
+            ok &= CheckHashBuild(gpu, uploads, "clustered", ClusteredPositions(count, kDistance, rng), kDistance);
+        }
+
+        std::cout << (ok ? "all passed" : "FAILED") << std::endl;
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}